@@ -35,3 +35,14 @@ AbstractCliFormatter::AbstractCliFormatter(AbstractCliIO* io)
 AbstractCliFormatter::~AbstractCliFormatter()
 {
 }
+
+bool AbstractCliFormatter::hasPendingCommands() const
+{
+  return false;
+}
+
+QStringList AbstractCliFormatter::nextArguments(QStringList& files)
+{
+  files.clear();
+  return QStringList();
+}
@@ -128,6 +128,22 @@ public:
    */
   virtual void finishWriting() = 0;
 
+  /**
+   * Check if commands of a request containing multiple commands are pending.
+   * The default implementation returns false.
+   * @return true if nextArguments() will return a command.
+   */
+  virtual bool hasPendingCommands() const;
+
+  /**
+   * Get the next pending command of a request containing multiple commands.
+   * The default implementation returns an empty list.
+   * @param files if the command has its own list of files to operate on,
+   * they are returned here, else the list is cleared
+   * @return list of command and arguments, empty if no command is pending.
+   */
+  virtual QStringList nextArguments(QStringList& files);
+
 protected:
   /**
    * Access to CLI I/O.
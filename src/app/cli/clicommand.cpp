@@ -35,12 +35,15 @@
 #include "kid3cli.h"
 #include "kid3application.h"
 #include "fileproxymodel.h"
+#include "fileproxymodeliterator.h"
 #include "frametablemodel.h"
 #include "filefilter.h"
+#include "trackdata.h"
 #include "importconfig.h"
 #include "exportconfig.h"
 #include "filterconfig.h"
 #include "fileconfig.h"
+#include "tagmemorytracker.h"
 #include "rendirconfig.h"
 #include "batchimportconfig.h"
 #include "formatconfig.h"
@@ -51,6 +54,7 @@
 #include "batchimporter.h"
 #include "downloadclient.h"
 #include "dirrenamer.h"
+#include "coverartexporter.h"
 
 namespace {
 
@@ -444,6 +448,44 @@ void TimeoutCommand::startCommand()
 }
 
 
+MemoryCommand::MemoryCommand(Kid3Cli* processor)
+  : CliCommand(processor, QLatin1String("memory"),
+               tr("Show memory used by tags"),
+               QLatin1String("[S]\nS = \"off\" | ") + tr("Maximum") +
+               QLatin1String(" [MiB]"))
+{
+}
+
+void MemoryCommand::startCommand()
+{
+  TaggedFileSystemModel* model = cli()->app()->getFileSystemModel();
+  TagMemoryTracker* tracker = model->tagMemoryTracker();
+  if (args().size() > 1) {
+    const QString& val = args().at(1);
+    if (val == QLatin1String("off")) {
+      model->setTagMemoryBudget(0);
+    } else {
+      bool ok;
+      qint64 mib = val.toLongLong(&ok);
+      if (!ok || mib < 0) {
+        showUsage();
+        return;
+      }
+      model->setTagMemoryBudget(mib * 1024 * 1024);
+    }
+  }
+  // Report the usage after pending evictions.
+  tracker->update();
+  cli()->writeResult(QVariantMap{
+    {QLatin1String("tagMemory"), QVariantMap{
+       {QLatin1String("usage"), tracker->usage()},
+       {QLatin1String("budget"), tracker->budget()},
+       {QLatin1String("files"), tracker->numLoadedFiles()}
+     }}
+  });
+}
+
+
 QuitCommand::QuitCommand(Kid3Cli* processor)
   : CliCommand(processor, QLatin1String("exit"), tr("Quit application"),
                QLatin1String("[S]\nS = \"force\""))
@@ -896,6 +938,109 @@ void ExportCommand::startCommand()
 }
 
 
+ExportCoverArtCommand::ExportCoverArtCommand(Kid3Cli* processor)
+  : CliCommand(processor, QLatin1String("exportcovers"),
+               tr("Export embedded pictures"),
+               QLatin1String("P [F] [T]"))
+{
+  // Exporting a large folder tree can take a long time.
+  setTimeout(-1);
+}
+
+void ExportCoverArtCommand::startCommand()
+{
+  if (args().size() > 1) {
+    const QString outputDir = QDir(args().at(1)).absolutePath();
+    Frame::TagVersion tagMask = Frame::TagNone;
+    QString format;
+    for (int i = 2; i < args().size(); ++i) {
+      bool ok = false;
+      if (tagMask == Frame::TagNone) {
+        tagMask = getTagMaskParameter(i, false);
+        ok = tagMask != Frame::TagNone;
+      }
+      if (!ok && format.isEmpty()) {
+        format = args().at(i);
+      }
+    }
+    if (tagMask == Frame::TagNone) {
+      tagMask = cli()->tagMask();
+    }
+    if (format.isEmpty()) {
+      format = QLatin1String("%{artist} - %{album}");
+    }
+    cli()->app()->exportCoverArt(outputDir, format, tagMask);
+  } else {
+    showUsage();
+    terminate();
+  }
+}
+
+void ExportCoverArtCommand::connectResultSignal()
+{
+  connect(cli()->app()->getCoverArtExporter(), &CoverArtExporter::exportEvent,
+          this, &ExportCoverArtCommand::onExportEvent);
+}
+
+void ExportCoverArtCommand::disconnectResultSignal()
+{
+  CoverArtExporter* exporter = cli()->app()->getCoverArtExporter();
+  exporter->abort();
+  disconnect(exporter, &CoverArtExporter::exportEvent,
+             this, &ExportCoverArtCommand::onExportEvent);
+}
+
+void ExportCoverArtCommand::onExportEvent(int type, const QString& filePath,
+                                          const QString& outputPath)
+{
+  QString typeStr;
+  bool finish = false;
+  switch (type) {
+  case CoverArtExporter::Started:
+    typeStr = QLatin1String("started");
+    break;
+  case CoverArtExporter::Exported:
+    typeStr = QLatin1String("exported");
+    break;
+  case CoverArtExporter::Duplicate:
+    typeStr = QLatin1String("duplicate");
+    break;
+  case CoverArtExporter::NoPicture:
+    typeStr = QLatin1String("noPicture");
+    break;
+  case CoverArtExporter::Error:
+    typeStr = QLatin1String("error");
+    break;
+  case CoverArtExporter::Finished:
+    typeStr = QLatin1String("finished");
+    finish = true;
+    break;
+  case CoverArtExporter::Aborted:
+    typeStr = QLatin1String("aborted");
+    finish = true;
+    break;
+  }
+  QVariantMap event{{QLatin1String("type"), typeStr}};
+  if (finish) {
+    CoverArtExporter* exporter = cli()->app()->getCoverArtExporter();
+    event.insert(QLatin1String("data"),
+                 tr("%1 exported, %2 duplicates")
+                 .arg(exporter->exportedCount())
+                 .arg(exporter->duplicateCount()));
+  } else if (!filePath.isEmpty()) {
+    QVariantMap data{{QLatin1String("source"), filePath}};
+    if (!outputPath.isEmpty()) {
+      data.insert(QLatin1String("destination"), outputPath);
+    }
+    event.insert(QLatin1String("data"), data);
+  }
+  cli()->writeResult(QVariantMap{{QLatin1String("event"), event}});
+  if (finish) {
+    terminate();
+  }
+}
+
+
 PlaylistCommand::PlaylistCommand(Kid3Cli* processor)
   : CliCommand(processor, QLatin1String("playlist"), tr("Create playlist"))
 {
@@ -946,8 +1091,9 @@ void TextEncodingCommand::startCommand()
 
 RenameDirectoryCommand::RenameDirectoryCommand(Kid3Cli* processor)
   : CliCommand(processor, QLatin1String("renamedir"), tr("Rename folder"),
-       QLatin1String("[F] [S] [T]\nS = \"create\" | \"rename\" | \"dryrun\"")),
-    m_dryRun(false)
+       QLatin1String("[F] [S] [T]\n"
+                     "S = \"create\" | \"rename\" | \"dryrun\" | \"diff\"")),
+    m_dryRun(false), m_diff(false)
 {
 }
 
@@ -957,6 +1103,7 @@ void RenameDirectoryCommand::startCommand()
   QString format;
   bool create = false;
   m_dryRun = false;
+  m_diff = false;
   for (int i = 1; i < args().size(); ++i) {
     bool ok = false;
     if (tagMask == Frame::TagNone) {
@@ -971,6 +1118,9 @@ void RenameDirectoryCommand::startCommand()
         create = false;
       } else if (param == QLatin1String("dryrun")) {
         m_dryRun = true;
+      } else if (param == QLatin1String("diff")) {
+        m_dryRun = true;
+        m_diff = true;
       } else if (format.isEmpty()) {
         format = param;
       }
@@ -1008,6 +1158,10 @@ void RenameDirectoryCommand::disconnectResultSignal()
 
 void RenameDirectoryCommand::onActionScheduled(const QStringList& actionStrs)
 {
+  if (m_diff) {
+    // Only the resulting file paths are reported in diff mode.
+    return;
+  }
   QVariantMap event{{QLatin1String("type"), actionStrs.at(0)}};
   QVariantMap data;
   if (actionStrs.size() > 1) {
@@ -1024,6 +1178,17 @@ void RenameDirectoryCommand::onActionScheduled(const QStringList& actionStrs)
 
 void RenameDirectoryCommand::onRenameActionsScheduled()
 {
+  if (m_diff) {
+    QVariantList moves;
+    const auto fileMoves = cli()->app()->getDirRenamer()->getFileMoves();
+    for (const auto& fileMove : fileMoves) {
+      moves.append(QVariantMap{
+        {QLatin1String("source"), fileMove.first},
+        {QLatin1String("destination"), fileMove.second}
+      });
+    }
+    cli()->writeResult(QVariantMap{{QLatin1String("diff"), moves}});
+  }
   if (!m_dryRun) {
     QString errMsg = cli()->app()->performRenameActions();
     if (errMsg.isEmpty()) {
@@ -1153,6 +1318,200 @@ void FilterCommand::onFileFiltered(int type, const QString& fileName)
 }
 
 
+QueryCommand::QueryCommand(Kid3Cli* processor)
+  : CliCommand(processor, QLatin1String("query"), tr("Query tags of files"),
+               QLatin1String("S [\"where\" F|S] [\"in\" P] [T]\nS = ") +
+               tr("Comma separated frame names") + QLatin1String(", ") +
+               tr("Filter name")),
+    m_iterator(nullptr), m_fileFilter(nullptr), m_tagMask(Frame::TagNone),
+    m_waitingForDirectory(false), m_restoringDirectory(false)
+{
+  // Iterating over a large folder tree can take a long time.
+  setTimeout(-1);
+}
+
+void QueryCommand::startCommand()
+{
+  const QStringList& a = args();
+  const int numArgs = a.size();
+  m_waitingForDirectory = false;
+  m_restoringDirectory = false;
+  m_previousPaths.clear();
+  m_formats.clear();
+  QStringList columns;
+  if (numArgs > 1) {
+    const QStringList names = a.at(1).split(QLatin1Char(','));
+    for (const QString& name : names) {
+      QString column = name.trimmed();
+      if (!column.isEmpty()) {
+        m_formats.append(QLatin1String("%{") + column + QLatin1Char('}'));
+        columns.append(column);
+      }
+    }
+  }
+  if (columns.isEmpty()) {
+    showUsage();
+    terminate();
+    return;
+  }
+
+  QString expression, path;
+  int tagMaskIdx = -1;
+  for (int i = 2; i < numArgs; ++i) {
+    const QString& arg = a.at(i);
+    if (arg == QLatin1String("where") && i + 1 < numArgs) {
+      expression = a.at(++i);
+    } else if (arg == QLatin1String("in") && i + 1 < numArgs) {
+      path = a.at(++i);
+    } else if (tagMaskIdx == -1) {
+      tagMaskIdx = i;
+    } else {
+      showUsage();
+      terminate();
+      return;
+    }
+  }
+  m_tagMask = tagMaskIdx != -1 ? getTagMaskParameter(tagMaskIdx)
+                               : cli()->tagMask();
+
+  if (!expression.isEmpty()) {
+    int fltIdx = FilterConfig::instance().filterNames().indexOf(expression);
+    if (fltIdx != -1) {
+      expression = FilterConfig::instance().filterExpressions().at(fltIdx);
+    } else if (!expression.contains(QLatin1Char('%'))) {
+      setError(tr("%1 not found.").arg(expression));
+      terminate();
+      return;
+    }
+  }
+  if (!m_fileFilter) {
+    m_fileFilter = new FileFilter(this);
+  }
+  m_fileFilter->setFilterExpression(expression);
+  m_fileFilter->initParser();
+
+  cli()->writeResult(QVariantMap{{QLatin1String("columns"), columns}});
+
+  if (!path.isEmpty() &&
+      QDir(path).absolutePath() != cli()->app()->getDirPath()) {
+    // The query is read-only, the current folder and selection are opened
+    // again when it is finished.
+    const QString dirPath = cli()->app()->getDirPath();
+    if (!dirPath.isEmpty()) {
+      m_previousPaths = QStringList(dirPath) +
+          cli()->app()->getSelectedFilePaths(false);
+    }
+    m_waitingForDirectory = true;
+    if (!cli()->openDirectory(Kid3Cli::expandWildcards({path}))) {
+      m_waitingForDirectory = false;
+      m_previousPaths.clear();
+      setError(tr("%1 does not exist").arg(path));
+      terminate();
+    }
+  } else {
+    startIteration();
+  }
+}
+
+void QueryCommand::connectResultSignal()
+{
+  connect(cli()->app(), &Kid3Application::directoryOpened,
+          this, &QueryCommand::onDirectoryOpened);
+}
+
+void QueryCommand::disconnectResultSignal()
+{
+  disconnect(cli()->app(), &Kid3Application::directoryOpened,
+             this, &QueryCommand::onDirectoryOpened);
+  if (m_iterator) {
+    m_iterator->abort();
+    disconnect(m_iterator, &FileProxyModelIterator::nextReady,
+               this, &QueryCommand::onNextFile);
+  }
+}
+
+void QueryCommand::onDirectoryOpened()
+{
+  if (m_waitingForDirectory) {
+    m_waitingForDirectory = false;
+    startIteration();
+  } else if (m_restoringDirectory) {
+    m_restoringDirectory = false;
+    terminate();
+  }
+}
+
+void QueryCommand::startIteration()
+{
+  if (!m_iterator) {
+    m_iterator = new FileProxyModelIterator(
+          cli()->app()->getFileProxyModel());
+  }
+  connect(m_iterator, &FileProxyModelIterator::nextReady,
+          this, &QueryCommand::onNextFile);
+  m_iterator->start(cli()->app()->getRootIndex());
+}
+
+/**
+ * Open the folder and selection which were current before the query
+ * and terminate the command.
+ */
+void QueryCommand::finishIteration()
+{
+  m_iterator->abort();
+  disconnect(m_iterator, &FileProxyModelIterator::nextReady,
+             this, &QueryCommand::onNextFile);
+  if (!m_previousPaths.isEmpty()) {
+    const QStringList paths = m_previousPaths;
+    m_previousPaths.clear();
+    m_restoringDirectory = true;
+    if (cli()->app()->openDirectory(paths)) {
+      QDir::setCurrent(cli()->app()->getDirPath());
+      return;
+    }
+    m_restoringDirectory = false;
+  }
+  terminate();
+}
+
+/**
+ * Write a row for a file if it passes the filter.
+ * Tags are read on demand and freed again if they were not read before.
+ *
+ * @param index index of file in file proxy model, invalid when finished
+ */
+void QueryCommand::onNextFile(const QPersistentModelIndex& index)
+{
+  if (!index.isValid()) {
+    finishIteration();
+    return;
+  }
+  if (TaggedFile* taggedFile = FileProxyModel::getTaggedFileOfIndex(index)) {
+    bool tagInfoRead = taggedFile->isTagInformationRead();
+    taggedFile = FileProxyModel::readTagsFromTaggedFile(taggedFile);
+    bool ok;
+    bool pass = m_fileFilter->filter(*taggedFile, &ok);
+    if (!ok) {
+      setError(QLatin1String("parse error"));
+      finishIteration();
+      return;
+    }
+    if (pass) {
+      ImportTrackData trackData(*taggedFile, m_tagMask);
+      const QStringList& formats = m_formats;
+      QVariantList row;
+      for (const QString& format : formats) {
+        row.append(trackData.formatString(format));
+      }
+      cli()->writeResult(QVariantMap{{QLatin1String("row"), row}});
+    }
+    if (!tagInfoRead && !taggedFile->isChanged()) {
+      taggedFile->clearTags(false);
+    }
+  }
+}
+
+
 ToId3v24Command::ToId3v24Command(Kid3Cli* processor)
   : CliCommand(processor, QLatin1String("to24"), tr("Convert ID3v2.3 to ID3v2.4"))
 {
@@ -32,7 +32,10 @@
 #include "externalprocess.h"
 
 class QModelIndex;
+class QPersistentModelIndex;
 class Kid3Cli;
+class FileProxyModelIterator;
+class FileFilter;
 
 /**
  * Base class for command line interface command.
@@ -239,6 +242,18 @@ protected:
 };
 
 
+/** Show and limit memory used by tags. */
+class MemoryCommand : public CliCommand {
+  Q_OBJECT
+public:
+  /** Constructor. */
+  explicit MemoryCommand(Kid3Cli* processor);
+
+protected:
+  virtual void startCommand() override;
+};
+
+
 /** Quit application. */
 class QuitCommand : public CliCommand {
   Q_OBJECT
@@ -417,6 +432,23 @@ protected:
   virtual void startCommand() override;
 };
 
+/** Export embedded pictures to image files. */
+class ExportCoverArtCommand : public CliCommand {
+  Q_OBJECT
+public:
+  /** Constructor. */
+  explicit ExportCoverArtCommand(Kid3Cli* processor);
+
+protected:
+  virtual void startCommand() override;
+  virtual void connectResultSignal() override;
+  virtual void disconnectResultSignal() override;
+
+private slots:
+  void onExportEvent(int type, const QString& filePath,
+                     const QString& outputPath);
+};
+
 /** Create playlist file. */
 class PlaylistCommand : public CliCommand {
   Q_OBJECT
@@ -479,6 +511,7 @@ private slots:
 
 private:
   bool m_dryRun;
+  bool m_diff;
 };
 
 /** Number tracks. */
@@ -508,6 +541,36 @@ private slots:
   void onFileFiltered(int type, const QString& fileName);
 };
 
+/** Query tags of multiple files, one row per file. */
+class QueryCommand : public CliCommand {
+  Q_OBJECT
+public:
+  /** Constructor. */
+  explicit QueryCommand(Kid3Cli* processor);
+
+protected:
+  virtual void startCommand() override;
+  virtual void connectResultSignal() override;
+  virtual void disconnectResultSignal() override;
+
+private slots:
+  void onDirectoryOpened();
+  void onNextFile(const QPersistentModelIndex& index);
+
+private:
+  void startIteration();
+  void finishIteration();
+
+  FileProxyModelIterator* m_iterator;
+  FileFilter* m_fileFilter;
+  QStringList m_formats;
+  /** Folder and selected files to open again when an "in" folder is done */
+  QStringList m_previousPaths;
+  Frame::TagVersion m_tagMask;
+  bool m_waitingForDirectory;
+  bool m_restoringDirectory;
+};
+
 /** Convert ID3v2.3 to ID3v2.4. */
 class ToId3v24Command : public CliCommand {
   Q_OBJECT
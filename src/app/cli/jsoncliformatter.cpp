@@ -67,11 +67,69 @@ int jsonRpcErrorCode(CliError errorCode)
   return code;
 }
 
+/**
+ * Get command and arguments from a JSON request object.
+ * @param obj JSON request with "method" and optional "params"
+ * @return list of command and arguments, empty if no method found.
+ */
+QStringList argumentsFromRequest(const QJsonObject& obj)
+{
+  QStringList args;
+  auto method = obj.value(QLatin1String("method")).toString();
+  if (!method.isEmpty()) {
+    args.append(method);
+    const auto params = obj.value(QLatin1String("params")).toArray();
+    for (const auto& param : params) {
+      QString arg = param.toString();
+      if (arg.isEmpty()) {
+        if (param.isArray()) {
+          // Special handling for tags parameter of the form [1, 2]
+          const auto elements = param.toArray();
+          for (const auto& element : elements) {
+            int tagNr = element.toInt();
+            if (tagNr > 0 && tagNr <= Frame::Tag_NumValues) {
+              arg += QLatin1Char('0' + static_cast<char>(tagNr));
+            } else {
+              arg.clear();
+              break;
+            }
+          }
+        } else if (param.isDouble()) {
+          // Allow integer numbers, for example for track numbers
+          int argInt = param.toInt(INT_MIN);
+          if (argInt != INT_MIN) {
+            arg = QString::number(argInt);
+          }
+        } else if (param.isBool()) {
+          arg = QLatin1String(param.toBool() ? "true" : "false");
+        }
+      }
+      args.append(arg);
+    }
+  }
+  return args;
+}
+
+/**
+ * Serialize a JSON value in compact form.
+ * @param value JSON value, can also be a string, number or array
+ * @return compact JSON text.
+ */
+QString compactJson(const QJsonValue& value)
+{
+  // QJsonDocument only serializes objects and arrays, so the value is wrapped
+  // into an array and the brackets are removed again.
+  QByteArray json = QJsonDocument(QJsonArray{value})
+      .toJson(QJsonDocument::Compact);
+  return QString::fromUtf8(json.constData() + 1, json.size() - 2);
+}
+
 }
 
 
 JsonCliFormatter::JsonCliFormatter(AbstractCliIO* io)
-  : AbstractCliFormatter(io), m_compact(false)
+  : AbstractCliFormatter(io), m_batchResponseCount(0), m_compact(false),
+    m_batchRunning(false), m_notification(false)
 {
 }
 
@@ -86,63 +144,48 @@ void JsonCliFormatter::clear()
   m_errorMessage.clear();
   m_args.clear();
   m_response = QJsonObject();
-  m_compact = false;
+  m_streamKey.clear();
+  m_streamedResult.clear();
+  m_notification = false;
+  if (!m_batchRunning) {
+    m_compact = false;
+  }
 }
 
 QStringList JsonCliFormatter::parseArguments(const QString& line)
 {
   m_errorMessage.clear();
   m_args.clear();
+  m_notification = false;
   if (m_jsonRequest.isEmpty()) {
     m_jsonRequest = line.trimmed();
-    if (!m_jsonRequest.startsWith(QLatin1Char('{'))) {
+    if (!m_jsonRequest.startsWith(QLatin1Char('{')) &&
+        !m_jsonRequest.startsWith(QLatin1Char('['))) {
       m_jsonRequest.clear();
     }
   } else {
     m_jsonRequest.append(line.trimmed());
   }
   if (!m_jsonRequest.isEmpty()) {
-    if (!m_jsonRequest.endsWith(QLatin1Char('}'))) {
+    if (!m_jsonRequest.endsWith(QLatin1Char(
+          m_jsonRequest.startsWith(QLatin1Char('[')) ? ']' : '}'))) {
       // Probably partial JSON request
       return QStringList();
     }
     m_compact = m_jsonRequest.contains(QLatin1String("\"method\":\""));
     QJsonParseError error;
     auto doc = QJsonDocument::fromJson(m_jsonRequest.toUtf8(), &error);
-    if (!doc.isNull()) {
+    if (doc.isArray()) {
+      parseBatchRequest(doc.array());
+      if (m_errorMessage.isEmpty()) {
+        m_jsonRequest.clear();
+        return QStringList();
+      }
+    } else if (!doc.isNull()) {
       QJsonObject obj = doc.object();
       if (!obj.isEmpty()) {
-        auto method = obj.value(QLatin1String("method")).toString();
-        if (!method.isEmpty()) {
-          m_args.append(method);
-          const auto params = obj.value(QLatin1String("params")).toArray();
-          for (const auto& param : params) {
-            QString arg = param.toString();
-            if (arg.isEmpty()) {
-              if (param.isArray()) {
-                // Special handling for tags parameter of the form [1, 2]
-                const auto elements = param.toArray();
-                for (const auto& element : elements) {
-                  int tagNr = element.toInt();
-                  if (tagNr > 0 && tagNr <= Frame::Tag_NumValues) {
-                    arg += QLatin1Char('0' + static_cast<char>(tagNr));
-                  } else {
-                    arg.clear();
-                    break;
-                  }
-                }
-              } else if (param.isDouble()) {
-                // Allow integer numbers, for example for track numbers
-                int argInt = param.toInt(INT_MIN);
-                if (argInt != INT_MIN) {
-                  arg = QString::number(argInt);
-                }
-              } else if (param.isBool()) {
-                arg = QLatin1String(param.toBool() ? "true" : "false");
-              }
-            }
-            m_args.append(arg);
-          }
+        m_args = argumentsFromRequest(obj);
+        if (!m_args.isEmpty()) {
           // A JSON-RPC ID is used in the response and to store that a JSON
           // request is running.
           m_jsonId = obj.value(QLatin1String("id"))
@@ -151,7 +194,9 @@ QStringList JsonCliFormatter::parseArguments(const QString& line)
       }
     }
     if (m_args.isEmpty()) {
-      auto errStr = error.error != QJsonParseError::NoError
+      auto errStr = !m_errorMessage.isEmpty()
+          ? m_errorMessage
+          : error.error != QJsonParseError::NoError
           ? error.errorString() : QLatin1String("missing method");
       if (!errStr.isEmpty()) {
         m_errorMessage = errStr + QLatin1String(": ") + m_jsonRequest;
@@ -166,6 +211,58 @@ QStringList JsonCliFormatter::parseArguments(const QString& line)
   return m_args;
 }
 
+/**
+ * Queue the requests of a batch request.
+ * The requests are executed one after the other using nextArguments().
+ * @param requests array with request objects
+ */
+void JsonCliFormatter::parseBatchRequest(const QJsonArray& requests)
+{
+  if (requests.isEmpty()) {
+    m_errorMessage = QLatin1String("empty batch");
+    return;
+  }
+  m_batchRequests.clear();
+  m_batchRequests.reserve(requests.size());
+  for (const auto& request : requests) {
+    m_batchRequests.append(request);
+  }
+  m_batchResponseCount = 0;
+  m_batchRunning = true;
+}
+
+bool JsonCliFormatter::hasPendingCommands() const
+{
+  return !m_batchRequests.isEmpty();
+}
+
+QStringList JsonCliFormatter::nextArguments(QStringList& files)
+{
+  files.clear();
+  while (!m_batchRequests.isEmpty()) {
+    const QJsonObject obj = m_batchRequests.takeFirst().toObject();
+    m_args = argumentsFromRequest(obj);
+    // A request with "jsonrpc" and without "id" is a notification,
+    // no response is written.
+    m_notification = obj.contains(QLatin1String("jsonrpc")) &&
+        !obj.contains(QLatin1String("id"));
+    m_jsonId = obj.value(QLatin1String("id")).toString(QLatin1String(""));
+    if (!m_args.isEmpty()) {
+      const auto fileValues = obj.value(QLatin1String("files")).toArray();
+      for (const auto& fileValue : fileValues) {
+        files.append(fileValue.toString());
+      }
+      return m_args;
+    }
+    m_notification = false;
+    writeErrorMessage(QLatin1String("missing method"),
+                      jsonRpcErrorCode(CliError::InvalidRequest));
+    finishWriting();
+    clear();
+  }
+  return QStringList();
+}
+
 QString JsonCliFormatter::getErrorMessage() const
 {
   return m_errorMessage;
@@ -179,7 +276,7 @@ bool JsonCliFormatter::isIncomplete() const
 bool JsonCliFormatter::isFormatRecognized() const
 {
   return !m_jsonId.isNull() || !m_jsonRequest.isEmpty() ||
-      !m_errorMessage.isEmpty();
+      !m_errorMessage.isEmpty() || m_batchRunning;
 }
 
 void JsonCliFormatter::writeError(CliError errorCode)
@@ -231,16 +328,53 @@ void JsonCliFormatter::writeResult(const QStringList& strs)
 
 void JsonCliFormatter::writeResult(const QVariantMap& map)
 {
-  QJsonObject result;
   if (map.size() == 1 && map.contains(QLatin1String("event"))) {
-    result = m_response.value(QLatin1String("result")).toObject();
-    auto events = result.value(QLatin1String("events")).toArray();
-    events.append(QJsonValue::fromVariant(map.value(QLatin1String("event"))));
-    result.insert(QLatin1String("events"), events);
+    writeStreamedElement(
+          QLatin1String("events"),
+          QJsonValue::fromVariant(map.value(QLatin1String("event"))));
+  } else if (map.size() == 1 && map.contains(QLatin1String("row"))) {
+    writeStreamedElement(
+          QLatin1String("rows"),
+          QJsonValue::fromVariant(map.value(QLatin1String("row"))));
   } else {
-    result = QJsonObject::fromVariantMap(map);
+    m_response.insert(QLatin1String("result"),
+                      QJsonObject::fromVariantMap(map));
   }
-  m_response.insert(QLatin1String("result"), result);
+}
+
+/**
+ * Append an element of an array in the result object.
+ * The elements are serialized as they are produced into the text of the
+ * result object, so that long results are not copied with every element.
+ * The result is completed and written in finishWriting().
+ * @param key name of array in result object
+ * @param value element to append to array
+ */
+void JsonCliFormatter::writeStreamedElement(const QString& key,
+                                            const QJsonValue& value)
+{
+  if (m_notification) {
+    return;
+  }
+  if (m_streamKey.isEmpty()) {
+    // Start of result with the members already set, e.g. the "columns" of
+    // a query.
+    m_streamedResult = compactJson(m_response.value(QLatin1String("result"))
+                                   .toObject());
+    m_streamedResult.chop(1);
+    if (m_streamedResult.size() > 1) {
+      m_streamedResult += QLatin1Char(',');
+    }
+    m_streamedResult += compactJson(key) % QLatin1String(":[");
+    m_response.remove(QLatin1String("result"));
+  } else if (m_streamKey != key) {
+    m_streamedResult += QLatin1String("],") % compactJson(key) %
+        QLatin1String(":[");
+  } else {
+    m_streamedResult += QLatin1Char(',');
+  }
+  m_streamKey = key;
+  m_streamedResult += compactJson(value);
 }
 
 void JsonCliFormatter::writeResult(bool result)
@@ -250,6 +384,10 @@ void JsonCliFormatter::writeResult(bool result)
 
 void JsonCliFormatter::finishWriting()
 {
+  if (!m_streamKey.isEmpty()) {
+    finishStreamedResponse();
+    return;
+  }
   if (m_response.isEmpty()) {
     m_response.insert(QLatin1String("result"), QJsonValue::Null);
   }
@@ -257,8 +395,67 @@ void JsonCliFormatter::finishWriting()
     m_response.insert(QLatin1String("jsonrpc"), QLatin1String("2.0"));
     m_response.insert(QLatin1String("id"), m_jsonId);
   }
-  io()->writeLine(QString::fromUtf8(
-                    QJsonDocument(m_response).toJson(
-                      m_compact ? QJsonDocument::Compact
-                                : QJsonDocument::Indented)));
+  writeResponse(QString::fromUtf8(
+                  QJsonDocument(m_response).toJson(
+                    m_compact || m_batchRunning ? QJsonDocument::Compact
+                                                : QJsonDocument::Indented)));
+}
+
+/**
+ * Complete a response whose result arrays were built with
+ * writeStreamedElement() and write it.
+ */
+void JsonCliFormatter::finishStreamedResponse()
+{
+  m_response.remove(QLatin1String("result"));
+  if (!m_jsonId.isEmpty()) {
+    m_response.insert(QLatin1String("jsonrpc"), QLatin1String("2.0"));
+    m_response.insert(QLatin1String("id"), m_jsonId);
+  }
+  // Remaining members, e.g. an error which occurred after some rows, are
+  // sorted before "result" as in QJsonDocument.
+  QString response = compactJson(m_response);
+  response.chop(1);
+  if (response.size() > 1) {
+    response += QLatin1Char(',');
+  }
+  response += QLatin1String("\"result\":") % m_streamedResult %
+      QLatin1String("]}}");
+  m_streamedResult.clear();
+  m_streamKey.clear();
+  if (!m_compact && !m_batchRunning) {
+    response = QString::fromUtf8(
+          QJsonDocument::fromJson(response.toUtf8())
+          .toJson(QJsonDocument::Indented));
+  }
+  writeResponse(response);
+}
+
+/**
+ * Write a complete response.
+ * A single response is written directly, the responses of a batch are
+ * collected and written as a single line with an array when the last
+ * request of the batch is finished.
+ * @param response JSON text of response
+ */
+void JsonCliFormatter::writeResponse(const QString& response)
+{
+  if (!m_batchRunning) {
+    io()->writeLine(response);
+    return;
+  }
+
+  if (!m_notification) {
+    m_batchResponses += QLatin1Char(m_batchResponseCount == 0 ? '[' : ',');
+    m_batchResponses += response;
+    ++m_batchResponseCount;
+  }
+  if (m_batchRequests.isEmpty()) {
+    if (m_batchResponseCount > 0) {
+      io()->writeLine(m_batchResponses + QLatin1Char(']'));
+    }
+    m_batchResponses.clear();
+    m_batchResponseCount = 0;
+    m_batchRunning = false;
+  }
 }
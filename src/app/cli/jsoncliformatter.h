@@ -30,6 +30,8 @@
 #include "abstractcliformatter.h"
 
 class QJsonObject;
+class QJsonArray;
+class QJsonValue;
 
 /**
  * CLI formatter with JSON input and output.
@@ -128,13 +130,45 @@ public:
    */
   virtual void finishWriting() override;
 
+  /**
+   * Check if commands of a batch request are pending.
+   * @return true if nextArguments() will return a command.
+   */
+  virtual bool hasPendingCommands() const override;
+
+  /**
+   * Get the next pending command of a batch request.
+   * @param files if the request has a "files" list, it is returned here,
+   * else the list is cleared
+   * @return list of command and arguments, empty if no command is pending.
+   */
+  virtual QStringList nextArguments(QStringList& files) override;
+
 private:
   void writeErrorMessage(const QString& msg, int code);
+  void parseBatchRequest(const QJsonArray& requests);
+  void writeStreamedElement(const QString& key, const QJsonValue& value);
+  void finishStreamedResponse();
+  void writeResponse(const QString& response);
 
   QString m_jsonRequest;
   QString m_jsonId;
   QString m_errorMessage;
   QStringList m_args;
   QJsonObject m_response;
+  /** Name of result array whose elements are appended, empty if none */
+  QString m_streamKey;
+  /** Incomplete JSON text of result object with streamed arrays */
+  QString m_streamedResult;
+  /** Requests of a batch which are not yet executed */
+  QList<QJsonValue> m_batchRequests;
+  /** Responses of the current batch, written when the batch is finished */
+  QString m_batchResponses;
+  /** Number of responses collected for the current batch */
+  int m_batchResponseCount;
   bool m_compact;
+  /** true while a batch request is executed */
+  bool m_batchRunning;
+  /** true if the current request is a JSON-RPC notification */
+  bool m_notification;
 };
@@ -178,7 +178,8 @@ Kid3Cli::Kid3Cli(Kid3Application* app,
                  AbstractCliIO* io, const QStringList& args, QObject* parent) :
   AbstractCli(io, parent),
   m_app(app), m_args(args),
-  m_tagMask(Frame::TagV2V1), m_timeoutMs(0), m_fileNameChanged(false)
+  m_tagMask(Frame::TagV2V1), m_timeoutMs(0), m_fileNameChanged(false),
+  m_selectionSaved(false)
 {
   m_formatters << new JsonCliFormatter(io)
                << new TextCliFormatter(io);
@@ -190,6 +191,7 @@ Kid3Cli::Kid3Cli(Kid3Application* app,
 
   m_cmds << new HelpCommand(this)
          << new TimeoutCommand(this)
+         << new MemoryCommand(this)
          << new QuitCommand(this)
          << new CdCommand(this)
          << new PwdCommand(this)
@@ -204,6 +206,7 @@ Kid3Cli::Kid3Cli(Kid3Application* app,
          << new BatchImportCommand(this)
          << new AlbumArtCommand(this)
          << new ExportCommand(this)
+         << new ExportCoverArtCommand(this)
          << new PlaylistCommand(this)
          << new FilenameFormatCommand(this)
          << new TagFormatCommand(this)
@@ -211,6 +214,7 @@ Kid3Cli::Kid3Cli(Kid3Application* app,
          << new RenameDirectoryCommand(this)
          << new NumberTracksCommand(this)
          << new FilterCommand(this)
+         << new QueryCommand(this)
          << new ToId3v24Command(this)
          << new ToId3v23Command(this)
          << new TagToFilenameCommand(this)
@@ -267,6 +271,16 @@ CliCommand* Kid3Cli::commandForArgs(const QString& line)
     }
   }
 
+  return commandForName(args);
+}
+
+/**
+ * Get command for a list of command and arguments.
+ * @param args command name and arguments
+ * @return command, 0 if no command found.
+ */
+CliCommand* Kid3Cli::commandForName(const QStringList& args)
+{
   if (!args.isEmpty()) {
     const QString& name = args.at(0);
     for (auto it = m_cmds.begin(); it != m_cmds.end(); ++it) { // clazy:exclude=detaching-member
@@ -280,6 +294,88 @@ CliCommand* Kid3Cli::commandForArgs(const QString& line)
   return nullptr;
 }
 
+/**
+ * Execute the next pending command of a request with multiple commands.
+ * @param finishedSlot slot to be invoked when the command is finished
+ * @return true if a command was started, false if no command is pending.
+ */
+bool Kid3Cli::executeNextPendingCommand(void (Kid3Cli::*finishedSlot)())
+{
+  QStringList files;
+  QStringList args;
+  // A previous request with its own files has finished.
+  restoreSelection();
+  while (!(args = m_formatter->nextArguments(files)).isEmpty()) {
+    if (!files.isEmpty()) {
+      // The command operates on its own files.
+      saveSelection();
+      m_app->deselectAllFiles();
+      if (!selectFile(expandWildcards(files))) {
+        restoreSelection();
+        writeError(tr("%1 not found").arg(files.join(QLatin1String(", "))),
+                   CliError::InvalidParams);
+        finishWriting();
+        continue;
+      }
+    }
+    if (CliCommand* cmd = commandForName(args)) {
+      connect(cmd, &CliCommand::finished, this, finishedSlot);
+      cmd->execute();
+      return true;
+    }
+    writeErrorCode(CliError::MethodNotFound);
+    finishWriting();
+  }
+  return false;
+}
+
+/**
+ * Remember the current file selection before a request selects its own
+ * files.
+ */
+void Kid3Cli::saveSelection()
+{
+  if (m_selectionSaved)
+    return;
+
+  QItemSelectionModel* selModel = m_app->getFileSelectionModel();
+  m_savedSelection.clear();
+  const QModelIndexList rows = selModel->selectedRows();
+  for (const QModelIndex& index : rows) {
+    m_savedSelection.append(QPersistentModelIndex(index));
+  }
+  m_savedCurrentIndex = selModel->currentIndex();
+  m_selectionSaved = true;
+}
+
+/**
+ * Restore the file selection saved with saveSelection().
+ */
+void Kid3Cli::restoreSelection()
+{
+  if (!m_selectionSaved)
+    return;
+
+  m_selectionSaved = false;
+  QItemSelectionModel* selModel = m_app->getFileSelectionModel();
+  QItemSelection selection;
+  for (const QPersistentModelIndex& index : qAsConst(m_savedSelection)) {
+    if (index.isValid()) {
+      selection.select(index, index);
+    }
+  }
+  m_savedSelection.clear();
+  // Selection changes are propagated to the frame models by the
+  // selectionChanged() signal connected to Kid3Application::fileSelected().
+  selModel->select(selection, QItemSelectionModel::ClearAndSelect |
+                              QItemSelectionModel::Rows);
+  if (m_savedCurrentIndex.isValid()) {
+    selModel->setCurrentIndex(m_savedCurrentIndex,
+                              QItemSelectionModel::NoUpdate);
+  }
+  m_savedCurrentIndex = QPersistentModelIndex();
+}
+
 /**
  * Display help about available commands.
  * @param cmdName command name, for all commands if empty
@@ -691,6 +787,10 @@ void Kid3Cli::readLine(const QString& line)
   if (cmd) {
     connect(cmd, &CliCommand::finished, this, &Kid3Cli::onCommandFinished);
     cmd->execute();
+  } else if (m_formatter->hasPendingCommands()) {
+    if (!executeNextPendingCommand(&Kid3Cli::onCommandFinished)) {
+      promptNextLine();
+    }
   } else {
     if (!m_formatter->isIncomplete()) {
       QString errorMsg = m_formatter->getErrorMessage();
@@ -718,7 +818,9 @@ void Kid3Cli::onCommandFinished() {
       }
     }
     cmd->clear();
-    promptNextLine();
+    if (!executeNextPendingCommand(&Kid3Cli::onCommandFinished)) {
+      promptNextLine();
+    }
   }
 }
 
@@ -730,7 +832,9 @@ void Kid3Cli::onArgCommandFinished() {
     disconnect(cmd, &CliCommand::finished, this, &Kid3Cli::onArgCommandFinished);
     if (!cmd->hasError()) {
       cmd->clear();
-      executeNextArgCommand();
+      if (!executeNextPendingCommand(&Kid3Cli::onArgCommandFinished)) {
+        executeNextArgCommand();
+      }
     } else {
       QString msg(cmd->getErrorMessage());
       if (!msg.startsWith(QLatin1Char('_'))) {
@@ -738,7 +842,10 @@ void Kid3Cli::onArgCommandFinished() {
       }
       cmd->clear();
       setReturnCode(1);
-      terminate();
+      // The remaining commands of a batch are still executed.
+      if (!executeNextPendingCommand(&Kid3Cli::onArgCommandFinished)) {
+        terminate();
+      }
     }
   }
 }
@@ -822,6 +929,10 @@ void Kid3Cli::executeNextArgCommand()
   if (cmd) {
     connect(cmd, &CliCommand::finished, this, &Kid3Cli::onArgCommandFinished);
     cmd->execute();
+  } else if (m_formatter->hasPendingCommands()) {
+    if (!executeNextPendingCommand(&Kid3Cli::onArgCommandFinished)) {
+      executeNextArgCommand();
+    }
   } else {
     QString errorMsg = m_formatter->getErrorMessage();
     if (errorMsg.isEmpty()) {
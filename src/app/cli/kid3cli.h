@@ -29,6 +29,7 @@
 #include "abstractcli.h"
 #include "frame.h"
 #include "cliconfig.h"
+#include <QPersistentModelIndex>
 #ifdef HAVE_READLINE
 #include <QScopedPointer>
 #endif
@@ -239,6 +240,31 @@ private:
    */
   CliCommand* commandForArgs(const QString& line);
 
+  /**
+   * Get command for a list of command and arguments.
+   * @param args command name and arguments
+   * @return command, 0 if no command found.
+   */
+  CliCommand* commandForName(const QStringList& args);
+
+  /**
+   * Execute the next pending command of a request with multiple commands.
+   * @param finishedSlot slot to be invoked when the command is finished
+   * @return true if a command was started, false if no command is pending.
+   */
+  bool executeNextPendingCommand(void (Kid3Cli::*finishedSlot)());
+
+  /**
+   * Remember the current file selection before a request selects its own
+   * files.
+   */
+  void saveSelection();
+
+  /**
+   * Restore the file selection saved with saveSelection().
+   */
+  void restoreSelection();
+
   QVariantList listFiles(const FileProxyModel* model,
                            const QModelIndex& parent);
   bool parseOptions();
@@ -260,4 +286,8 @@ private:
   /** Overwrites command timeout, -1 to switch off, 0 for defaults, else ms. */
   int m_timeoutMs;
   bool m_fileNameChanged;
+  /** Selection saved while a request operates on its own files. */
+  QList<QPersistentModelIndex> m_savedSelection;
+  QPersistentModelIndex m_savedCurrentIndex;
+  bool m_selectionSaved;
 };
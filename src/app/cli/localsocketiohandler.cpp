@@ -0,0 +1,178 @@
+/**
+ * \file localsocketiohandler.cpp
+ * CLI I/O Handler for a local socket server.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "localsocketiohandler.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTextStream>
+
+/**
+ * Constructor.
+ * @param serverName name of local socket, can be an absolute path
+ */
+LocalSocketIOHandler::LocalSocketIOHandler(const QString& serverName)
+  : m_serverName(serverName), m_server(nullptr), m_socket(nullptr),
+    m_lineRequested(false)
+{
+}
+
+/**
+ * Start processing.
+ */
+void LocalSocketIOHandler::start()
+{
+  m_server = new QLocalServer(this);
+  m_server->setSocketOptions(QLocalServer::UserAccessOption);
+  connect(m_server, &QLocalServer::newConnection,
+          this, &LocalSocketIOHandler::onNewConnection);
+  // Remove a socket file left over by a crashed server.
+  QLocalServer::removeServer(m_serverName);
+  m_lineRequested = true;
+  if (!m_server->listen(m_serverName)) {
+    QTextStream(stderr) << m_server->errorString() << QLatin1Char('\n');
+    // A null line terminates the command line processor.
+    m_lineRequested = false;
+    emit lineReady(QString());
+  }
+}
+
+/**
+ * Stop processing.
+ */
+void LocalSocketIOHandler::stop()
+{
+  if (m_socket) {
+    m_socket->flush();
+    m_socket->disconnectFromServer();
+  }
+  if (m_server) {
+    m_server->close();
+  }
+  deleteLater();
+}
+
+/**
+ * Read the next line.
+ * When the line is ready, lineReady() is emitted.
+ */
+void LocalSocketIOHandler::readLine()
+{
+  m_lineRequested = true;
+  if (m_socket) {
+    processInput();
+  } else {
+    acceptNextConnection();
+  }
+}
+
+/**
+ * Serve next pending connection if no client is currently served.
+ */
+void LocalSocketIOHandler::onNewConnection()
+{
+  if (!m_socket) {
+    acceptNextConnection();
+  }
+}
+
+/**
+ * Start serving the next pending connection, if there is one.
+ */
+void LocalSocketIOHandler::acceptNextConnection()
+{
+  m_socket = m_server ? m_server->nextPendingConnection() : nullptr;
+  if (m_socket) {
+    connect(m_socket, &QLocalSocket::readyRead,
+            this, &LocalSocketIOHandler::processInput);
+    connect(m_socket, &QLocalSocket::disconnected,
+            this, &LocalSocketIOHandler::processInput);
+    processInput();
+  }
+}
+
+/**
+ * Emit lineReady() if a line is requested and available from the client.
+ */
+void LocalSocketIOHandler::processInput()
+{
+  if (!m_lineRequested || !m_socket)
+    return;
+
+  // Empty lines are skipped, a null line would terminate the server.
+  while (m_socket->canReadLine()) {
+    QByteArray line = m_socket->readLine();
+    line.chop(line.endsWith("\r\n") ? 2 : 1);
+    if (!line.isEmpty()) {
+      m_lineRequested = false;
+      emit lineReady(QString::fromUtf8(line));
+      return;
+    }
+  }
+  if (m_socket->state() != QLocalSocket::ConnectedState) {
+    // The client has disconnected, process a last line without line feed
+    // and continue with the next client.
+    QByteArray line = m_socket->readAll();
+    m_socket->deleteLater();
+    m_socket = nullptr;
+    if (!line.isEmpty()) {
+      m_lineRequested = false;
+      emit lineReady(QString::fromUtf8(line));
+    } else {
+      acceptNextConnection();
+    }
+  }
+}
+
+/**
+ * Write a line to the connected client.
+ * @param line line to write
+ */
+void LocalSocketIOHandler::writeLine(const QString& line)
+{
+  if (m_socket && m_socket->state() == QLocalSocket::ConnectedState) {
+    m_socket->write(line.toUtf8());
+    m_socket->write("\n", 1);
+  }
+}
+
+/**
+ * Write an error line to the connected client.
+ * @param line line to write
+ */
+void LocalSocketIOHandler::writeErrorLine(const QString& line)
+{
+  writeLine(line);
+}
+
+/**
+ * Flush the output to the connected client.
+ */
+void LocalSocketIOHandler::flushStandardOutput()
+{
+  if (m_socket && m_socket->state() == QLocalSocket::ConnectedState) {
+    m_socket->flush();
+  }
+}
@@ -0,0 +1,110 @@
+/**
+ * \file localsocketiohandler.h
+ * CLI I/O Handler for a local socket server.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "abstractcli.h"
+
+class QLocalServer;
+class QLocalSocket;
+
+/**
+ * CLI I/O Handler for a local socket server.
+ * Lines are read from the connected client, responses are written back to
+ * it. Clients are served one after the other, so that a single application
+ * instance with its loaded tags can process the commands of many clients.
+ */
+class LocalSocketIOHandler : public AbstractCliIO {
+  Q_OBJECT
+public:
+  /**
+   * Constructor.
+   * @param serverName name of local socket, can be an absolute path
+   */
+  explicit LocalSocketIOHandler(const QString& serverName);
+
+  /**
+   * Destructor.
+   */
+  virtual ~LocalSocketIOHandler() override = default;
+
+  /**
+   * Write a line to the connected client.
+   * @param line line to write
+   */
+  virtual void writeLine(const QString& line) override;
+
+  /**
+   * Write an error line to the connected client.
+   * @param line line to write
+   */
+  virtual void writeErrorLine(const QString& line) override;
+
+  /**
+   * Flush the output to the connected client.
+   */
+  virtual void flushStandardOutput() override;
+
+  /**
+   * Read the next line.
+   * When the line is ready, lineReady() is emitted.
+   */
+  virtual void readLine() override;
+
+public slots:
+  /**
+   * Start processing.
+   * This will start listening on the local socket. lineReady() is emitted
+   * when the first line is ready. To request subsequent lines, readLine()
+   * has to be called.
+   */
+  virtual void start() override;
+
+  /**
+   * Stop processing.
+   * This will close the server and finally delete this object.
+   */
+  virtual void stop() override;
+
+private slots:
+  /**
+   * Emit lineReady() if a line is requested and available from the client.
+   */
+  void processInput();
+
+  /**
+   * Serve next pending connection if no client is currently served.
+   */
+  void onNewConnection();
+
+private:
+  void acceptNextConnection();
+
+  QString m_serverName;
+  QLocalServer* m_server;
+  QLocalSocket* m_socket;
+  bool m_lineRequested;
+};
@@ -32,8 +32,10 @@
 #include "kid3cli.h"
 #include "loadtranslation.h"
 #include "standardiohandler.h"
+#include "localsocketiohandler.h"
 #include "coreplatformtools.h"
 #include "kid3application.h"
+#include "tracer.h"
 
 #if defined Q_OS_WIN32 && defined Q_CC_MINGW
 // Disable command line globbing to avoid crash in QCoreApplication::arguments()
@@ -62,8 +64,32 @@ int main(int argc, char* argv[])
 #endif
 
   QStringList args = QCoreApplication::arguments();
-  if (args.size() > 1 && args.at(1) == QLatin1String("--portable")) {
-    args.removeAt(1);
+  // The leading options can be given in any order.
+  bool portable = false;
+  bool dbus = false;
+  QString serverName;
+  QString traceFilePath;
+  while (args.size() > 1) {
+    const QString option = args.at(1);
+    if (option == QLatin1String("--portable")) {
+      portable = true;
+      args.removeAt(1);
+#ifdef HAVE_QTDBUS
+    } else if (option == QLatin1String("--dbus")) {
+      dbus = true;
+      args.removeAt(1);
+#endif
+    } else if (args.size() > 2 && option == QLatin1String("--server")) {
+      serverName = args.at(2);
+      args.erase(args.begin() + 1, args.begin() + 3);
+    } else if (args.size() > 2 && option == QLatin1String("--trace")) {
+      traceFilePath = args.at(2);
+      args.erase(args.begin() + 1, args.begin() + 3);
+    } else {
+      break;
+    }
+  }
+  if (portable) {
     qputenv("KID3_CONFIG_FILE",
             QCoreApplication::applicationDirPath().toLatin1() + "/kid3.ini");
   }
@@ -83,12 +109,24 @@ int main(int argc, char* argv[])
   ICorePlatformTools* platformTools = new CorePlatformTools;
   auto kid3App = new Kid3Application(platformTools);
 #ifdef HAVE_QTDBUS
-  if (args.size() > 1 && args.at(1) == QLatin1String("--dbus")) {
-    args.removeAt(1);
+  if (dbus) {
     kid3App->activateDbusInterface();
   }
+#else
+  Q_UNUSED(dbus)
 #endif
-  Kid3Cli kid3cli(kid3App, new StandardIOHandler("kid3-cli> "), args);
+  AbstractCliIO* io;
+  if (!serverName.isEmpty()) {
+    // Serve commands from clients connecting to a local socket.
+    io = new LocalSocketIOHandler(serverName);
+  } else {
+    io = new StandardIOHandler("kid3-cli> ");
+  }
+  if (!traceFilePath.isEmpty()) {
+    // Record a performance trace, it is written when the application exits.
+    Tracer::instance().start(traceFilePath);
+  }
+  Kid3Cli kid3cli(kid3App, io, args);
   QTimer::singleShot(0, &kid3cli, &Kid3Cli::execute);
   int rc = QCoreApplication::exec();
   delete kid3App;
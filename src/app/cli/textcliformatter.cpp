@@ -298,6 +298,42 @@ void TextCliFormatter::writeResult(const QVariantMap& map)
     } else if (key == QLatin1String("timeout")) {
       QString value = it.value().toString();
       io()->writeLine(tr("Timeout") % QLatin1String(": ") % value);
+    } else if (key == QLatin1String("tagMemory")) {
+      QVariantMap value = it.value().toMap();
+      const qint64 budget = value.value(QLatin1String("budget")).toLongLong();
+      QString text;
+      if (budget > 0) {
+        text = tr("%1 of %2 MiB, %n files", "",
+                  value.value(QLatin1String("files")).toInt())
+            .arg(value.value(QLatin1String("usage")).toLongLong() / 1048576.0,
+                 0, 'f', 1)
+            .arg(budget / 1048576);
+      } else {
+        text = QLatin1String("off");
+      }
+      io()->writeLine(tr("Tag memory") % QLatin1String(": ") % text);
+    } else if (key == QLatin1String("columns") ||
+               key == QLatin1String("row")) {
+      // Tab separated values, tabs and line breaks inside values are
+      // replaced by spaces to keep one line per row.
+      QStringList fields;
+      const QVariantList values = it.value().toList();
+      for (const QVariant& var : values) {
+        QString field = var.toString();
+        field.replace(QLatin1Char('\t'), QLatin1Char(' '));
+        field.replace(QLatin1Char('\n'), QLatin1Char(' '));
+        fields.append(field);
+      }
+      io()->writeLine(fields.join(QLatin1Char('\t')));
+    } else if (key == QLatin1String("diff")) {
+      const QVariantList moves = it.value().toList();
+      for (const QVariant& var : moves) {
+        const QVariantMap move = var.toMap();
+        io()->writeLine(QLatin1String("- ") +
+                        move.value(QLatin1String("source")).toString());
+        io()->writeLine(QLatin1String("+ ") +
+                        move.value(QLatin1String("destination")).toString());
+      }
     } else if (key == QLatin1String("event")) {
       QVariantMap value = it.value().toMap();
       QString type = value.value(QLatin1String("type")).toString();
@@ -322,6 +358,12 @@ void TextCliFormatter::writeResult(const QVariantMap& map)
         eventText = tr("Aborted");
       } else if (type == QLatin1String("error")) {
         eventText = tr("Error");
+      } else if (type == QLatin1String("exported")) {
+        eventText = tr("Exported");
+      } else if (type == QLatin1String("duplicate")) {
+        eventText = tr("Duplicate");
+      } else if (type == QLatin1String("noPicture")) {
+        eventText = tr("No picture");
       } else if (type == QLatin1String("parseError")) {
         eventText = QLatin1String("parse error");
       } else {
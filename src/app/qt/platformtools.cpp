@@ -125,6 +125,34 @@ QObject* PlatformTools::createAudioPlayer(Kid3Application* app,
   return GuiPlatformTools::createAudioPlayer(app, dbusEnabled);
 }
 
+/**
+ * Check if pictures can be converted with convertPicture().
+ * @return true if convertPicture() is supported.
+ */
+bool PlatformTools::canConvertPicture() const
+{
+  return GuiPlatformTools::canConvertPicture();
+}
+
+/**
+ * Resize and recompress a picture.
+ * This method is called from worker threads.
+ * @param data picture data
+ * @param maxDimension maximum width and height in pixels, 0 for no limit
+ * @param maxBytes maximum size of picture data in bytes, 0 for no limit
+ * @param format image format of converted picture, e.g. "JPG" or "PNG"
+ * @param quality quality of converted picture, 0..100
+ * @return converted picture data, empty if the picture does not exceed
+ *         the limits or cannot be converted.
+ */
+QByteArray PlatformTools::convertPicture(
+    const QByteArray& data, int maxDimension, int maxBytes,
+    const QString& format, int quality) const
+{
+  return GuiPlatformTools::convertPicture(data, maxDimension, maxBytes,
+                                          format, quality);
+}
+
 /**
  * Move file or directory to trash.
  *
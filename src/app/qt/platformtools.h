@@ -82,6 +82,27 @@ public:
   virtual QObject* createAudioPlayer(Kid3Application* app,
                                      bool dbusEnabled) const override;
 
+  /**
+   * Check if pictures can be converted with convertPicture().
+   * @return true if convertPicture() is supported.
+   */
+  virtual bool canConvertPicture() const override;
+
+  /**
+   * Resize and recompress a picture.
+   * This method is called from worker threads.
+   * @param data picture data
+   * @param maxDimension maximum width and height in pixels, 0 for no limit
+   * @param maxBytes maximum size of picture data in bytes, 0 for no limit
+   * @param format image format of converted picture, e.g. "JPG" or "PNG"
+   * @param quality quality of converted picture, 0..100
+   * @return converted picture data, empty if the picture does not exceed
+   *         the limits or cannot be converted.
+   */
+  virtual QByteArray convertPicture(const QByteArray& data, int maxDimension,
+                                    int maxBytes, const QString& format,
+                                    int quality) const override;
+
   /**
    * Move file or directory to trash.
    *
@@ -47,6 +47,7 @@ BatchImportConfig::BatchImportConfig()
     QLatin1String("MusicBrainz") <<
     QLatin1String("Discogs") <<
     QLatin1String("Cover Art") <<
+    QLatin1String("Offline Mirror") <<
     QLatin1String("Custom Profile");
   m_profileSources <<
     QLatin1String("MusicBrainz Release:75:SAC;Discogs:75:SAC;Amazon:75:SAC;"
@@ -54,6 +55,7 @@ BatchImportConfig::BatchImportConfig()
     QLatin1String("MusicBrainz Release:75:SAC") <<
     QLatin1String("Discogs:75:SAC") <<
     QLatin1String("Amazon:75:C;Discogs:75:C;MusicBrainz Release:75:C") <<
+    QLatin1String("Offline Mirror:75:SA") <<
     QLatin1String("");
 }
 
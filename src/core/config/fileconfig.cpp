@@ -86,6 +86,8 @@ FileConfig::FileConfig()
     m_formatFromFilenameText(QString::fromLatin1(defaultFromFilenameFormats[0])),
     m_defaultCoverFileName(QLatin1String("folder.jpg")),
     m_textEncoding(QLatin1String("System")),
+    m_tagMemoryBudget(0),
+    m_tagPrefetchCount(3),
     m_preserveTime(false),
     m_markChanges(true),
     m_loadLastOpenedFile(true),
@@ -115,6 +117,9 @@ void FileConfig::writeToConfig(ISettings* config) const
   config->setValue(QLatin1String("PreserveTime"), QVariant(m_preserveTime));
   config->setValue(QLatin1String("MarkChanges"), QVariant(m_markChanges));
   config->setValue(QLatin1String("LoadLastOpenedFile"), QVariant(m_loadLastOpenedFile));
+  config->setValue(QLatin1String("TagMemoryBudget"), QVariant(m_tagMemoryBudget));
+  config->setValue(QLatin1String("TagPrefetchCount"), QVariant(m_tagPrefetchCount));
+  config->setValue(QLatin1String("TraceFile"), QVariant(m_traceFile));
   config->setValue(QLatin1String("TextEncoding"), QVariant(m_textEncoding));
   config->setValue(QLatin1String("DefaultCoverFileName"), QVariant(m_defaultCoverFileName));
   config->endGroup();
@@ -163,6 +168,12 @@ void FileConfig::readFromConfig(ISettings* config)
                     QString::fromLatin1(defaultFromFilenameFormats[0])).toString();
   m_loadLastOpenedFile = config->value(QLatin1String("LoadLastOpenedFile"),
                                        m_loadLastOpenedFile).toBool();
+  m_tagMemoryBudget = config->value(QLatin1String("TagMemoryBudget"),
+                                    m_tagMemoryBudget).toInt();
+  m_tagPrefetchCount = config->value(QLatin1String("TagPrefetchCount"),
+                                     m_tagPrefetchCount).toInt();
+  m_traceFile = config->value(QLatin1String("TraceFile"),
+                              m_traceFile).toString();
   m_textEncoding = config->value(QLatin1String("TextEncoding"),
                                  QLatin1String("System")).toString();
   m_defaultCoverFileName = config->value(QLatin1String("DefaultCoverFileName"),
@@ -333,3 +344,27 @@ void FileConfig::setLoadLastOpenedFile(bool loadLastOpenedFile)
     emit loadLastOpenedFileChanged(m_loadLastOpenedFile);
   }
 }
+
+void FileConfig::setTagMemoryBudget(int tagMemoryBudget)
+{
+  if (m_tagMemoryBudget != tagMemoryBudget) {
+    m_tagMemoryBudget = tagMemoryBudget;
+    emit tagMemoryBudgetChanged(m_tagMemoryBudget);
+  }
+}
+
+void FileConfig::setTagPrefetchCount(int tagPrefetchCount)
+{
+  if (m_tagPrefetchCount != tagPrefetchCount) {
+    m_tagPrefetchCount = tagPrefetchCount;
+    emit tagPrefetchCountChanged(m_tagPrefetchCount);
+  }
+}
+
+void FileConfig::setTraceFile(const QString& traceFile)
+{
+  if (m_traceFile != traceFile) {
+    m_traceFile = traceFile;
+    emit traceFileChanged(m_traceFile);
+  }
+}
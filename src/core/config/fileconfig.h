@@ -84,6 +84,15 @@ class KID3_CORE_EXPORT FileConfig : public StoredConfig<FileConfig> {
   /** true to open last opened file on startup */
   Q_PROPERTY(bool loadLastOpenedFile READ loadLastOpenedFile
              WRITE setLoadLastOpenedFile NOTIFY loadLastOpenedFileChanged)
+  /** maximum memory used for tags of files in MiB, 0 for unlimited */
+  Q_PROPERTY(int tagMemoryBudget READ tagMemoryBudget
+             WRITE setTagMemoryBudget NOTIFY tagMemoryBudgetChanged)
+  /** number of following files whose tags are read in advance, 0 for off */
+  Q_PROPERTY(int tagPrefetchCount READ tagPrefetchCount
+             WRITE setTagPrefetchCount NOTIFY tagPrefetchCountChanged)
+  /** path to file where a performance trace is written, empty if off */
+  Q_PROPERTY(QString traceFile READ traceFile
+             WRITE setTraceFile NOTIFY traceFileChanged)
 
 public:
   /**
@@ -208,6 +217,24 @@ public:
   /** Set if the last opened file is loaded on startup. */
   void setLoadLastOpenedFile(bool loadLastOpenedFile);
 
+  /** Get maximum memory used for tags of files in MiB, 0 for unlimited. */
+  int tagMemoryBudget() const { return m_tagMemoryBudget; }
+
+  /** Set maximum memory used for tags of files in MiB, 0 for unlimited. */
+  void setTagMemoryBudget(int tagMemoryBudget);
+
+  /** Get number of following files whose tags are read in advance. */
+  int tagPrefetchCount() const { return m_tagPrefetchCount; }
+
+  /** Set number of following files whose tags are read in advance. */
+  void setTagPrefetchCount(int tagPrefetchCount);
+
+  /** Get path to file where a performance trace is written. */
+  QString traceFile() const { return m_traceFile; }
+
+  /** Set path to file where a performance trace is written, empty if off. */
+  void setTraceFile(const QString& traceFile);
+
 signals:
   /** Emitted when @a nameFilter changed. */
   void nameFilterChanged(const QString& nameFilter);
@@ -254,6 +281,15 @@ signals:
   /** Emitted when @a loadLastOpenedFile changed. */
   void loadLastOpenedFileChanged(bool loadLastOpenedFile);
 
+  /** Emitted when @a tagMemoryBudget changed. */
+  void tagMemoryBudgetChanged(int tagMemoryBudget);
+
+  /** Emitted when @a tagPrefetchCount changed. */
+  void tagPrefetchCountChanged(int tagPrefetchCount);
+
+  /** Emitted when @a traceFile changed. */
+  void traceFileChanged(const QString& traceFile);
+
 private:
   friend FileConfig& StoredConfig<FileConfig>::instance();
 
@@ -269,6 +305,9 @@ private:
   QString m_defaultCoverFileName;
   QString m_lastOpenedFile;
   QString m_textEncoding;
+  QString m_traceFile;
+  int m_tagMemoryBudget;
+  int m_tagPrefetchCount;
   bool m_preserveTime;
   bool m_markChanges;
   bool m_loadLastOpenedFile;
@@ -239,7 +239,12 @@ TagConfig::TagConfig()
     m_trackNumberDigits(1),
     m_taggedFileFeatures(0),
     m_maximumPictureSize(131072),
+    m_maximumNormalizedPictureSize(131072),
+    m_maximumPictureDimension(1000),
+    m_pictureFormat(QLatin1String("JPG")),
+    m_pictureQuality(85),
     m_markOversizedPictures(false),
+    m_normalizePictures(false),
     m_markStandardViolations(true),
     m_onlyCustomGenres(false),
     m_markTruncations(true),
@@ -273,6 +278,16 @@ void TagConfig::writeToConfig(ISettings* config) const
                    QVariant(m_markOversizedPictures));
   config->setValue(QLatin1String("MaximumPictureSize"),
                    QVariant(m_maximumPictureSize));
+  config->setValue(QLatin1String("NormalizePictures"),
+                   QVariant(m_normalizePictures));
+  config->setValue(QLatin1String("MaximumNormalizedPictureSize"),
+                   QVariant(m_maximumNormalizedPictureSize));
+  config->setValue(QLatin1String("MaximumPictureDimension"),
+                   QVariant(m_maximumPictureDimension));
+  config->setValue(QLatin1String("PictureFormat"),
+                   QVariant(m_pictureFormat));
+  config->setValue(QLatin1String("PictureQuality"),
+                   QVariant(m_pictureQuality));
   config->setValue(QLatin1String("MarkStandardViolations"),
                    QVariant(m_markStandardViolations));
   config->setValue(QLatin1String("EnableTotalNumberOfTracks"),
@@ -334,6 +349,18 @@ void TagConfig::readFromConfig(ISettings* config)
                                           m_markOversizedPictures).toBool();
   m_maximumPictureSize = config->value(QLatin1String("MaximumPictureSize"),
                                        m_maximumPictureSize).toInt();
+  m_normalizePictures = config->value(QLatin1String("NormalizePictures"),
+                                      m_normalizePictures).toBool();
+  m_maximumNormalizedPictureSize =
+      config->value(QLatin1String("MaximumNormalizedPictureSize"),
+                    m_maximumNormalizedPictureSize).toInt();
+  m_maximumPictureDimension =
+      config->value(QLatin1String("MaximumPictureDimension"),
+                    m_maximumPictureDimension).toInt();
+  m_pictureFormat = config->value(QLatin1String("PictureFormat"),
+                                  m_pictureFormat).toString();
+  m_pictureQuality = config->value(QLatin1String("PictureQuality"),
+                                   m_pictureQuality).toInt();
   m_markStandardViolations =
       config->value(QLatin1String("MarkStandardViolations"),
                     m_markStandardViolations).toBool();
@@ -460,6 +487,52 @@ void TagConfig::setMaximumPictureSize(int maximumPictureSize)
   }
 }
 
+/** Set true to resize and recompress pictures when saving. */
+void TagConfig::setNormalizePictures(bool normalizePictures)
+{
+  if (m_normalizePictures != normalizePictures) {
+    m_normalizePictures = normalizePictures;
+    emit normalizePicturesChanged(m_normalizePictures);
+  }
+}
+
+/** Set maximum size of normalized pictures in bytes. */
+void TagConfig::setMaximumNormalizedPictureSize(
+    int maximumNormalizedPictureSize)
+{
+  if (m_maximumNormalizedPictureSize != maximumNormalizedPictureSize) {
+    m_maximumNormalizedPictureSize = maximumNormalizedPictureSize;
+    emit maximumNormalizedPictureSizeChanged(m_maximumNormalizedPictureSize);
+  }
+}
+
+/** Set maximum width and height of pictures in pixels. */
+void TagConfig::setMaximumPictureDimension(int maximumPictureDimension)
+{
+  if (m_maximumPictureDimension != maximumPictureDimension) {
+    m_maximumPictureDimension = maximumPictureDimension;
+    emit maximumPictureDimensionChanged(m_maximumPictureDimension);
+  }
+}
+
+/** Set image format used for normalized pictures. */
+void TagConfig::setPictureFormat(const QString& pictureFormat)
+{
+  if (m_pictureFormat != pictureFormat) {
+    m_pictureFormat = pictureFormat;
+    emit pictureFormatChanged(m_pictureFormat);
+  }
+}
+
+/** Set quality used for normalized pictures. */
+void TagConfig::setPictureQuality(int pictureQuality)
+{
+  if (m_pictureQuality != pictureQuality) {
+    m_pictureQuality = pictureQuality;
+    emit pictureQualityChanged(m_pictureQuality);
+  }
+}
+
 /** Set true to mark standard violations. */
 void TagConfig::setMarkStandardViolations(bool markStandardViolations)
 {
@@ -51,6 +51,24 @@ class KID3_CORE_EXPORT TagConfig : public StoredConfig<TagConfig> {
   /** Maximum size of picture in bytes */
   Q_PROPERTY(int maximumPictureSize READ maximumPictureSize
              WRITE setMaximumPictureSize NOTIFY maximumPictureSizeChanged)
+  /** true to resize and recompress pictures when saving */
+  Q_PROPERTY(bool normalizePictures READ normalizePictures
+             WRITE setNormalizePictures NOTIFY normalizePicturesChanged)
+  /** Maximum size of normalized pictures in bytes */
+  Q_PROPERTY(int maximumNormalizedPictureSize
+             READ maximumNormalizedPictureSize
+             WRITE setMaximumNormalizedPictureSize
+             NOTIFY maximumNormalizedPictureSizeChanged)
+  /** Maximum width and height of pictures in pixels */
+  Q_PROPERTY(int maximumPictureDimension READ maximumPictureDimension
+             WRITE setMaximumPictureDimension
+             NOTIFY maximumPictureDimensionChanged)
+  /** Image format used for normalized pictures, "JPG" or "PNG" */
+  Q_PROPERTY(QString pictureFormat READ pictureFormat WRITE setPictureFormat
+             NOTIFY pictureFormatChanged)
+  /** Quality used for normalized pictures, 0..100 */
+  Q_PROPERTY(int pictureQuality READ pictureQuality WRITE setPictureQuality
+             NOTIFY pictureQualityChanged)
   /** true to mark standard violations */
   Q_PROPERTY(bool markStandardViolations READ markStandardViolations
              WRITE setMarkStandardViolations NOTIFY markStandardViolationsChanged)
@@ -198,6 +216,46 @@ public:
   /** Set maximum size of picture in bytes. */
   void setMaximumPictureSize(int maximumPictureSize);
 
+  /**
+   * true to resize and recompress pictures when saving.
+   * Pictures larger than maximumNormalizedPictureSize() bytes or
+   * maximumPictureDimension() pixels are converted to pictureFormat().
+   */
+  bool normalizePictures() const { return m_normalizePictures; }
+
+  /** Set true to resize and recompress pictures when saving. */
+  void setNormalizePictures(bool normalizePictures);
+
+  /**
+   * Maximum size of normalized pictures in bytes.
+   * This limit is independent of maximumPictureSize(), which is only used
+   * to mark oversized pictures.
+   */
+  int maximumNormalizedPictureSize() const {
+    return m_maximumNormalizedPictureSize;
+  }
+
+  /** Set maximum size of normalized pictures in bytes. */
+  void setMaximumNormalizedPictureSize(int maximumNormalizedPictureSize);
+
+  /** Maximum width and height of pictures in pixels */
+  int maximumPictureDimension() const { return m_maximumPictureDimension; }
+
+  /** Set maximum width and height of pictures in pixels. */
+  void setMaximumPictureDimension(int maximumPictureDimension);
+
+  /** Image format used for normalized pictures, "JPG" or "PNG" */
+  QString pictureFormat() const { return m_pictureFormat; }
+
+  /** Set image format used for normalized pictures. */
+  void setPictureFormat(const QString& pictureFormat);
+
+  /** Quality used for normalized pictures, 0..100 */
+  int pictureQuality() const { return m_pictureQuality; }
+
+  /** Set quality used for normalized pictures. */
+  void setPictureQuality(int pictureQuality);
+
   /** true to mark standard violations */
   bool markStandardViolations() const { return m_markStandardViolations; }
 
@@ -473,6 +531,21 @@ signals:
   /** Emitted when @a maximumPictureSize changed. */
   void maximumPictureSizeChanged(int maximumPictureSize);
 
+  /** Emitted when @a normalizePictures changed. */
+  void normalizePicturesChanged(bool normalizePictures);
+
+  /** Emitted when @a maximumNormalizedPictureSize changed. */
+  void maximumNormalizedPictureSizeChanged(int maximumNormalizedPictureSize);
+
+  /** Emitted when @a maximumPictureDimension changed. */
+  void maximumPictureDimensionChanged(int maximumPictureDimension);
+
+  /** Emitted when @a pictureFormat changed. */
+  void pictureFormatChanged(const QString& pictureFormat);
+
+  /** Emitted when @a pictureQuality changed. */
+  void pictureQualityChanged(int pictureQuality);
+
   /** Emitted when @a markTruncations changed. */
   void markOversizedPicturesChanged(bool markOversizedPictures);
 
@@ -557,7 +630,12 @@ private:
   QStringList m_availablePlugins;
   int m_taggedFileFeatures;
   int m_maximumPictureSize;
+  int m_maximumNormalizedPictureSize;
+  int m_maximumPictureDimension;
+  QString m_pictureFormat;
+  int m_pictureQuality;
   bool m_markOversizedPictures;
+  bool m_normalizePictures;
   bool m_markStandardViolations;
   bool m_onlyCustomGenres;
   bool m_markTruncations;
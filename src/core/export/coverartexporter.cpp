@@ -0,0 +1,318 @@
+/**
+ * \file coverartexporter.cpp
+ * Export embedded cover art to image files.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "coverartexporter.h"
+#include <QRunnable>
+#include <QCryptographicHash>
+#include <QMimeDatabase>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+#include "taggedfile.h"
+#include "taggedfilesystemmodel.h"
+#include "trackdata.h"
+
+namespace {
+
+/**
+ * Get file name suffix for picture data.
+ * @param data picture data
+ * @return suffix including dot.
+ */
+QString suffixForPictureData(const QByteArray& data)
+{
+  QMimeDatabase mimeDb;
+  QString suffix = mimeDb.mimeTypeForData(data).preferredSuffix();
+  if (suffix.isEmpty()) {
+    suffix = QLatin1String("bin");
+  }
+  return QLatin1Char('.') + suffix;
+}
+
+}
+
+/**
+ * Job extracting the picture of a file and writing it to an image file.
+ */
+class CoverArtExporter::ExportJob : public QRunnable {
+public:
+  ExportJob(CoverArtExporter* exporter, const QString& filePath,
+            const QString& baseName, const QByteArray& data)
+    : m_exporter(exporter), m_filePath(filePath), m_baseName(baseName),
+      m_data(data) {
+  }
+
+  virtual void run() override;
+
+private:
+  void report(EventType type, const QString& outputPath = QString()) {
+    QMetaObject::invokeMethod(m_exporter, "onJobFinished",
+                              Qt::QueuedConnection,
+                              Q_ARG(int, type),
+                              Q_ARG(QString, m_filePath),
+                              Q_ARG(QString, outputPath));
+  }
+
+  CoverArtExporter* m_exporter;
+  const QString m_filePath;
+  const QString m_baseName;
+  QByteArray m_data;
+};
+
+void CoverArtExporter::ExportJob::run()
+{
+  if (m_exporter->isAborted()) {
+    report(Aborted);
+    return;
+  }
+  if (m_data.isEmpty()) {
+    m_data = TaggedFileSystemModel::readPictureData(m_filePath);
+  }
+  if (m_data.isEmpty()) {
+    report(NoPicture);
+    return;
+  }
+  const QByteArray hash =
+      QCryptographicHash::hash(m_data, QCryptographicHash::Sha1);
+  bool duplicate;
+  const QString outputPath = m_exporter->reserveOutputPath(
+        hash, m_baseName, suffixForPictureData(m_data), &duplicate);
+  if (duplicate) {
+    report(Duplicate, outputPath);
+    return;
+  }
+  QDir().mkpath(QFileInfo(outputPath).absolutePath());
+  QFile file(outputPath);
+  if (file.open(QIODevice::WriteOnly) &&
+      file.write(m_data) == m_data.size()) {
+    report(Exported, outputPath);
+  } else {
+    {
+      QMutexLocker locker(&m_exporter->m_mutex);
+      m_exporter->m_writtenHashes.remove(hash);
+    }
+    report(Error, outputPath);
+  }
+}
+
+
+/**
+ * Constructor.
+ * @param parent parent object
+ */
+CoverArtExporter::CoverArtExporter(QObject* parent) : QObject(parent),
+  m_tagVersion(Frame::TagVAll), m_aborted(0), m_pendingJobs(0),
+  m_exportedCount(0), m_duplicateCount(0), m_finishing(false)
+{
+  setObjectName(QLatin1String("CoverArtExporter"));
+}
+
+/**
+ * Destructor.
+ */
+CoverArtExporter::~CoverArtExporter()
+{
+  abort();
+  m_threadPool.waitForDone();
+}
+
+/**
+ * Abort operation.
+ */
+void CoverArtExporter::abort()
+{
+  m_aborted.storeRelease(1);
+}
+
+/**
+ * Check if operation is aborted.
+ *
+ * @return true if aborted.
+ */
+bool CoverArtExporter::isAborted() const
+{
+  return m_aborted.loadAcquire() != 0;
+}
+
+/**
+ * Clear state which is reported by isAborted().
+ */
+void CoverArtExporter::clearAborted()
+{
+  m_aborted.storeRelease(0);
+}
+
+/**
+ * Check if the tags have to be read to generate the file names.
+ * @return true if the format contains format codes.
+ */
+bool CoverArtExporter::formatNeedsTags() const
+{
+  return m_format.contains(QLatin1Char('%'));
+}
+
+/**
+ * Generate file name without extension according to current settings.
+ *
+ * @param taggedFile file to get information from
+ *
+ * @return file name relative to output folder.
+ */
+QString CoverArtExporter::generateBaseName(TaggedFile& taggedFile) const
+{
+  QString baseName;
+  if (formatNeedsTags()) {
+    TrackData trackData(taggedFile, m_tagVersion);
+    TrackDataFormatReplacer fmt(trackData, m_format);
+    fmt.replacePercentCodes(FormatReplacer::FSF_ReplaceSeparators);
+    baseName = fmt.getString();
+  } else {
+    baseName = m_format;
+  }
+  // Do not allow absolute paths or empty path components.
+  QStringList components = baseName.split(QLatin1Char('/'));
+  components.removeAll(QString());
+  components.removeAll(QLatin1String("."));
+  components.removeAll(QLatin1String(".."));
+  baseName = components.join(QLatin1Char('/'));
+  if (baseName.isEmpty()) {
+    baseName = QFileInfo(taggedFile.getFilename()).completeBaseName();
+  }
+  return baseName;
+}
+
+/**
+ * Start an export.
+ * Has to be called before adding files.
+ */
+void CoverArtExporter::start()
+{
+  m_threadPool.waitForDone();
+  m_writtenHashes.clear();
+  m_usedPaths.clear();
+  m_pendingJobs = 0;
+  m_exportedCount = 0;
+  m_duplicateCount = 0;
+  m_finishing = false;
+  emit exportEvent(Started, QString(), QString());
+}
+
+/**
+ * Add a file to the export.
+ * The picture is extracted and written in a background thread.
+ *
+ * @param filePath path to file
+ * @param baseName file name generated with generateBaseName()
+ * @param data picture data, if empty the picture is read from the file
+ */
+void CoverArtExporter::addFile(const QString& filePath,
+                               const QString& baseName,
+                               const QByteArray& data)
+{
+  ++m_pendingJobs;
+  m_threadPool.start(new ExportJob(this, filePath, baseName, data));
+}
+
+/**
+ * Terminate adding files.
+ * Finished is reported when all pending jobs are done.
+ */
+void CoverArtExporter::finish()
+{
+  m_finishing = true;
+  checkFinished();
+}
+
+/**
+ * Called in the main thread when a job is finished.
+ * @param type event type
+ * @param filePath path to file containing picture
+ * @param outputPath path to written image file
+ */
+void CoverArtExporter::onJobFinished(int type, const QString& filePath,
+                                     const QString& outputPath)
+{
+  --m_pendingJobs;
+  if (type == Exported) {
+    ++m_exportedCount;
+  } else if (type == Duplicate) {
+    ++m_duplicateCount;
+  }
+  if (type != Aborted) {
+    emit exportEvent(type, filePath, outputPath);
+  }
+  checkFinished();
+}
+
+/**
+ * Report end of export if all files are added and all jobs are done.
+ */
+void CoverArtExporter::checkFinished()
+{
+  if (m_finishing && m_pendingJobs == 0) {
+    m_finishing = false;
+    emit exportEvent(isAborted() ? Aborted : Finished, QString(), QString());
+  }
+}
+
+/**
+ * Get the path of the image file for a picture.
+ * Called from the worker threads.
+ *
+ * @param hash hash of picture data
+ * @param baseName file name without extension relative to output folder
+ * @param suffix file name extension including dot
+ * @param duplicate true is returned here if an identical picture is already
+ * written
+ *
+ * @return path to image file.
+ */
+QString CoverArtExporter::reserveOutputPath(
+    const QByteArray& hash, const QString& baseName, const QString& suffix,
+    bool* duplicate)
+{
+  QMutexLocker locker(&m_mutex);
+  auto it = m_writtenHashes.constFind(hash);
+  if (it != m_writtenHashes.constEnd()) {
+    *duplicate = true;
+    return *it;
+  }
+  *duplicate = false;
+  QString path = m_outputDir;
+  if (!path.isEmpty() && !path.endsWith(QLatin1Char('/'))) {
+    path += QLatin1Char('/');
+  }
+  path += baseName;
+  if (m_usedPaths.contains(path + suffix)) {
+    // A different picture already uses this name, make it unique.
+    path += QLatin1Char('-');
+    path += QString::fromLatin1(hash.toHex().left(8));
+  }
+  path += suffix;
+  m_usedPaths.insert(path);
+  m_writtenHashes.insert(hash, path);
+  return path;
+}
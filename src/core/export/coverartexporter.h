@@ -0,0 +1,199 @@
+/**
+ * \file coverartexporter.h
+ * Export embedded cover art to image files.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QThreadPool>
+#include "frame.h"
+#include "iabortable.h"
+#include "kid3api.h"
+
+class TaggedFile;
+
+/**
+ * Exports the pictures embedded in files to image files.
+ *
+ * The names of the image files are generated from the tags using a format
+ * string. The pictures are extracted from the files and written in a thread
+ * pool, identical pictures are only written once.
+ */
+class KID3_CORE_EXPORT CoverArtExporter : public QObject, public IAbortable {
+  Q_OBJECT
+  Q_ENUMS(EventType)
+public:
+  /** Type of event reported with exportEvent(). */
+  enum EventType {
+    Started,   /**< Export started */
+    Exported,  /**< Picture written to file */
+    Duplicate, /**< Identical picture already written */
+    NoPicture, /**< File does not contain a picture */
+    Error,     /**< Picture could not be written */
+    Finished,  /**< Export finished */
+    Aborted    /**< Export aborted */
+  };
+
+  /**
+   * Constructor.
+   * @param parent parent object
+   */
+  explicit CoverArtExporter(QObject* parent = nullptr);
+
+  /**
+   * Destructor.
+   * Waits until all pending jobs are finished.
+   */
+  virtual ~CoverArtExporter() override;
+
+  /**
+   * Abort operation.
+   */
+  virtual void abort() override;
+
+  /**
+   * Check if operation is aborted.
+   *
+   * @return true if aborted.
+   */
+  virtual bool isAborted() const override;
+
+  /**
+   * Clear state which is reported by isAborted().
+   */
+  virtual void clearAborted() override;
+
+  /**
+   * Set version of tags used to generate the file names.
+   * @param tagVersion tag version
+   */
+  void setTagVersion(Frame::TagVersion tagVersion) {
+    m_tagVersion = tagVersion;
+  }
+
+  /**
+   * Set format to generate the file names without extension.
+   * The format can contain directory separators to create subfolders.
+   * @param format format with codes supported by TrackDataFormatReplacer
+   */
+  void setFormat(const QString& format) { m_format = format; }
+
+  /**
+   * Set folder where the image files are written.
+   * @param dirPath path to folder
+   */
+  void setOutputDirectory(const QString& dirPath) { m_outputDir = dirPath; }
+
+  /**
+   * Check if the tags have to be read to generate the file names.
+   * @return true if the format contains format codes.
+   */
+  bool formatNeedsTags() const;
+
+  /**
+   * Generate file name without extension according to current settings.
+   *
+   * @param taggedFile file to get information from
+   *
+   * @return file name relative to output folder.
+   */
+  QString generateBaseName(TaggedFile& taggedFile) const;
+
+  /**
+   * Start an export.
+   * Has to be called before adding files.
+   */
+  void start();
+
+  /**
+   * Add a file to the export.
+   * The picture is extracted and written in a background thread.
+   *
+   * @param filePath path to file
+   * @param baseName file name generated with generateBaseName()
+   * @param data picture data, if empty the picture is read from the file
+   */
+  void addFile(const QString& filePath, const QString& baseName,
+               const QByteArray& data = QByteArray());
+
+  /**
+   * Terminate adding files.
+   * Finished is reported when all pending jobs are done.
+   */
+  void finish();
+
+  /**
+   * Get number of written image files.
+   * @return number of files exported.
+   */
+  int exportedCount() const { return m_exportedCount; }
+
+  /**
+   * Get number of pictures which were not written because an identical
+   * picture was already written.
+   * @return number of duplicates.
+   */
+  int duplicateCount() const { return m_duplicateCount; }
+
+signals:
+  /**
+   * Emitted to report progress of the export.
+   * @param type event type, enum EventType
+   * @param filePath path to file containing picture
+   * @param outputPath path to written image file
+   */
+  void exportEvent(int type, const QString& filePath,
+                   const QString& outputPath);
+
+private slots:
+  void onJobFinished(int type, const QString& filePath,
+                     const QString& outputPath);
+
+private:
+  class ExportJob;
+
+  QString reserveOutputPath(const QByteArray& hash, const QString& baseName,
+                            const QString& suffix, bool* duplicate);
+  void checkFinished();
+
+  QString m_format;
+  QString m_outputDir;
+  Frame::TagVersion m_tagVersion;
+  QThreadPool m_threadPool;
+  QMutex m_mutex;
+  /** Output path of written pictures indexed by hash of picture data */
+  QHash<QByteArray, QString> m_writtenHashes;
+  QSet<QString> m_usedPaths;
+  QAtomicInt m_aborted;
+  int m_pendingJobs;
+  int m_exportedCount;
+  int m_duplicateCount;
+  bool m_finishing;
+};
@@ -28,6 +28,7 @@
 #include "serverimporter.h"
 #include "trackdatamodel.h"
 #include "downloadclient.h"
+#include "coverartfetcher.h"
 #include "pictureframe.h"
 #include "fileconfig.h"
 #include "formatconfig.h"
@@ -47,14 +48,15 @@ enum DataFlags {
  */
 BatchImporter::BatchImporter(QNetworkAccessManager* netMgr)
   : QObject(netMgr),
-    m_downloadClient(new DownloadClient(netMgr)),
+    m_coverArtFetcher(new CoverArtFetcher(netMgr, this)),
     m_currentImporter(nullptr), m_trackDataModel(nullptr), m_albumModel(nullptr),
     m_tagVersion(Frame::TagNone), m_state(Idle),
     m_trackListNr(-1), m_sourceNr(-1), m_albumNr(-1),
-    m_requestedData(0), m_importedData(0)
+    m_requestedData(0), m_importedData(0),
+    m_resumeAlbumNr(-1), m_retryingCovers(false)
 {
-  connect(m_downloadClient, &DownloadClient::downloadFinished,
-          this, &BatchImporter::onImageDownloaded);
+  connect(m_coverArtFetcher, &CoverArtFetcher::imageFetched,
+          this, &BatchImporter::onImageFetched);
   m_frameFilter.enableAll();
 }
 
@@ -85,6 +87,12 @@ void BatchImporter::start(const QList<ImportTrackDataVector>& trackLists,
   m_tagVersion = tagVersion;
   emit reportImportEvent(Started, profile.getName());
   m_trackListNr = -1;
+  m_coverRequests.clear();
+  m_coverRetries.clear();
+  m_failedCoverUrls.clear();
+  m_resumeAlbumNr = -1;
+  m_retryingCovers = false;
+  m_coverArtFetcher->clear();
   m_state = CheckNextTrackList;
   stateTransition();
 }
@@ -117,10 +125,10 @@ void BatchImporter::abort()
 {
   State oldState = m_state;
   m_state = ImportAborted;
-  if (oldState == Idle) {
-    stateTransition();
-  } else if (oldState == GettingCover) {
-    m_downloadClient->cancelDownload();
+  m_coverArtFetcher->abort();
+  m_coverRequests.clear();
+  m_coverRetries.clear();
+  if (oldState == Idle || oldState == WaitingForCovers) {
     stateTransition();
   }
 }
@@ -132,7 +140,11 @@ void BatchImporter::stateTransition()
     m_trackListNr = -1;
     break;
   case CheckNextTrackList:
-    if (m_trackDataModel) {
+    if (m_retryingCovers) {
+      // Only the album of a failed cover is retried.
+      m_state = WaitingForCovers;
+      stateTransition();
+    } else if (m_trackDataModel) {
       bool searchKeyFound = false;
       forever {
         ++m_trackListNr;
@@ -165,9 +177,7 @@ void BatchImporter::stateTransition()
         m_importedData = 0;
         m_state = CheckNextSource;
       } else {
-        emit reportImportEvent(Finished, QString());
-        emit finished();
-        m_state = Idle;
+        m_state = WaitingForCovers;
       }
       stateTransition();
     }
@@ -265,17 +275,22 @@ void BatchImporter::stateTransition()
         QUrl coverArtUrl = m_trackDataModel->getTrackData().getCoverArtUrl();
         if (!coverArtUrl.isEmpty()) {
           imgUrl = DownloadClient::getImageUrl(coverArtUrl);
-          if (!imgUrl.isEmpty()) {
+          if (!imgUrl.isEmpty() && !m_failedCoverUrls.contains(imgUrl)) {
             emit reportImportEvent(FetchingCoverArt,
                                    coverArtUrl.toString());
-            m_downloadClient->startDownload(imgUrl);
+            // The import continues while the cover is downloaded. If it
+            // turns out to be invalid, the next albums are checked later.
+            m_coverRequests.insert(imgUrl, {
+              m_trackListNr, m_sourceNr, m_albumNr, m_requestedData,
+              m_importedData, m_currentArtist, m_currentAlbum
+            });
+            m_coverArtFetcher->fetch(imgUrl);
+            m_importedData |= CoverArt;
           }
         }
       }
-      if (imgUrl.isEmpty()) {
-        m_state = CheckIfDone;
-        stateTransition();
-      }
+      m_state = CheckIfDone;
+      stateTransition();
     }
     break;
   case CheckIfDone:
@@ -286,6 +301,39 @@ void BatchImporter::stateTransition()
     }
     stateTransition();
     break;
+  case WaitingForCovers:
+    if (!m_coverRequests.isEmpty()) {
+      // Continued in onImageFetched().
+      break;
+    }
+    if (!m_coverRetries.isEmpty() && m_trackDataModel) {
+      const CoverRequest retry = m_coverRetries.takeFirst();
+      m_trackListNr = retry.trackListNr;
+      m_sourceNr = retry.sourceNr;
+      m_requestedData = retry.requestedData;
+      m_importedData = retry.importedData;
+      m_currentArtist = retry.artist;
+      m_currentAlbum = retry.album;
+      m_currentImporter = getImporter(
+            m_profile.getSources().at(m_sourceNr).getName());
+      m_trackDataModel->setTrackData(m_trackLists.at(m_trackListNr));
+      m_resumeAlbumNr = retry.albumNr;
+      m_retryingCovers = true;
+      if (m_currentImporter) {
+        emit reportImportEvent(SourceSelected,
+                               QString::fromLatin1(m_currentImporter->name()));
+        m_state = GettingAlbumList;
+      } else {
+        m_state = CheckNextSource;
+      }
+    } else {
+      m_retryingCovers = false;
+      emit reportImportEvent(Finished, QString());
+      emit finished();
+      m_state = Idle;
+    }
+    stateTransition();
+    break;
   case ImportAborted:
     emit reportImportEvent(Aborted, QString());
     break;
@@ -303,6 +351,11 @@ void BatchImporter::onFindFinished(const QByteArray& searchStr)
   } else if (m_currentImporter) {
     m_currentImporter->parseFindResults(searchStr);
     m_albumModel = m_currentImporter->getAlbumListModel();
+    if (m_resumeAlbumNr >= 0) {
+      // Continue after the album whose cover was invalid.
+      m_albumNr = m_resumeAlbumNr;
+      m_resumeAlbumNr = -1;
+    }
     m_state = CheckNextAlbum;
     stateTransition();
   }
@@ -390,31 +443,42 @@ void BatchImporter::onAlbumProgress(const QString& text, int step, int total)
   }
 }
 
-void BatchImporter::onImageDownloaded(const QByteArray& data,
-                                    const QString& mimeType, const QString& url)
+void BatchImporter::onImageFetched(const QUrl& url, const QByteArray& data,
+                                   const QString& mimeType)
 {
-  if (m_state == ImportAborted) {
-    stateTransition();
-  } else {
-    if (data.size() >= 1024) {
-      if (mimeType.startsWith(QLatin1String("image")) && m_trackDataModel) {
-        emit reportImportEvent(CoverArtReceived, url);
-        PictureFrame frame(data, url, PictureFrame::PT_CoverFront, mimeType);
-        ImportTrackDataVector trackDataVector(m_trackDataModel->getTrackData());
-        for (auto it = trackDataVector.begin(); it != trackDataVector.end(); ++it) {
-          if (TaggedFile* taggedFile = it->getTaggedFile()) {
-            taggedFile->readTags(false);
-            taggedFile->addFrame(Frame::Tag_Picture, frame);
-          }
+  const QList<CoverRequest> requests = m_coverRequests.values(url);
+  m_coverRequests.remove(url);
+  if (m_state == ImportAborted || requests.isEmpty()) {
+    return;
+  }
+  if (CoverArtFetcher::isValidImage(data, mimeType)) {
+    const QString urlStr = url.toString();
+    emit reportImportEvent(CoverArtReceived, urlStr);
+    PictureFrame frame(data, urlStr, PictureFrame::PT_CoverFront, mimeType);
+    for (const CoverRequest& request : requests) {
+      const ImportTrackDataVector& trackDataVector =
+          m_trackLists.at(request.trackListNr);
+      for (auto it = trackDataVector.constBegin();
+           it != trackDataVector.constEnd();
+           ++it) {
+        if (TaggedFile* taggedFile = it->getTaggedFile()) {
+          taggedFile->readTags(false);
+          taggedFile->addFrame(Frame::Tag_Picture, frame);
         }
-        m_importedData |= CoverArt;
       }
-    } else {
-      // Probably an invalid 1x1 picture from Amazon
-      emit reportImportEvent(CoverArtReceived,
-                             tr("Invalid File"));
     }
-    m_state = CheckIfDone;
+  } else {
+    // Probably an invalid 1x1 picture from Amazon
+    emit reportImportEvent(CoverArtReceived,
+                           tr("Invalid File"));
+    m_failedCoverUrls.insert(url);
+    for (const CoverRequest& request : requests) {
+      if (request.requestedData & CoverArt) {
+        m_coverRetries.append(request);
+      }
+    }
+  }
+  if (m_state == WaitingForCovers) {
     stateTransition();
   }
 }
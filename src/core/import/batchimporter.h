@@ -27,12 +27,14 @@
 #pragma once
 
 #include <QObject>
+#include <QMultiHash>
+#include <QSet>
 #include "trackdata.h"
 #include "batchimportprofile.h"
 #include "iabortable.h"
 
 class QNetworkAccessManager;
-class DownloadClient;
+class CoverArtFetcher;
 class ServerImporter;
 class TrackDataModel;
 class AlbumListModel;
@@ -140,8 +142,8 @@ private slots:
   void onFindProgress(const QString& text, int step, int total);
   void onAlbumFinished(const QByteArray& albumStr);
   void onAlbumProgress(const QString& text, int step, int total);
-  void onImageDownloaded(const QByteArray& data, const QString& mimeType,
-                         const QString& url);
+  void onImageFetched(const QUrl& url, const QByteArray& data,
+                      const QString& mimeType);
 
 private:
   enum State {
@@ -153,13 +155,28 @@ private:
     GettingTracks,
     GettingCover,
     CheckIfDone,
+    WaitingForCovers,
     ImportAborted
   };
 
+  /**
+   * Position in the import for which a cover is downloaded, used to apply
+   * the cover and to continue with the next album if it is invalid.
+   */
+  struct CoverRequest {
+    int trackListNr;
+    int sourceNr;
+    int albumNr;
+    int requestedData;
+    int importedData;
+    QString artist;
+    QString album;
+  };
+
   void stateTransition();
   ServerImporter* getImporter(const QString& name);
 
-  DownloadClient* m_downloadClient;
+  CoverArtFetcher* m_coverArtFetcher;
   QList<ServerImporter*> m_importers;
   ServerImporter* m_currentImporter;
   TrackDataModel* m_trackDataModel;
@@ -179,4 +196,11 @@ private:
   QString m_currentArtist;
   QString m_currentAlbum;
   FrameFilter m_frameFilter;
+  /** Covers being downloaded */
+  QMultiHash<QUrl, CoverRequest> m_coverRequests;
+  /** Positions to continue from after an invalid cover */
+  QList<CoverRequest> m_coverRetries;
+  QSet<QUrl> m_failedCoverUrls;
+  int m_resumeAlbumNr;
+  bool m_retryingCovers;
 };
@@ -0,0 +1,310 @@
+/**
+ * \file coverartfetcher.cpp
+ * Concurrent download of cover art with a disk cache.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "coverartfetcher.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <algorithm>
+#include "downloadclient.h"
+
+namespace {
+
+/** Maximum number of simultaneous downloads */
+const int MAX_PARALLEL_DOWNLOADS = 4;
+/** Maximum size of disk cache, least recently written images are removed */
+const qint64 MAX_CACHE_SIZE = 100 * 1024 * 1024;
+/** Maximum size of images kept in memory */
+const int MAX_MEMORY_CACHE_COST = 16 * 1024 * 1024;
+/** Magic number of cache files */
+const quint32 CACHE_FILE_MAGIC = 0x4b334341;
+/** Version of cache file format */
+const quint32 CACHE_FILE_VERSION = 1;
+
+}
+
+/**
+ * Constructor.
+ * @param netMgr network access manager
+ * @param parent parent object
+ */
+CoverArtFetcher::CoverArtFetcher(QNetworkAccessManager* netMgr,
+                                 QObject* parent)
+  : QObject(parent), m_netMgr(netMgr),
+    m_cacheDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+               QLatin1String("/coverart/downloads")),
+    m_images(MAX_MEMORY_CACHE_COST), m_numClients(0)
+{
+  setObjectName(QLatin1String("CoverArtFetcher"));
+}
+
+/**
+ * Request an image.
+ * imageFetched() is always emitted asynchronously, also if the image is
+ * found in a cache.
+ *
+ * @param url URL of image
+ */
+void CoverArtFetcher::fetch(const QUrl& url)
+{
+  if (m_queue.contains(url) ||
+      std::find(m_activeUrls.constBegin(), m_activeUrls.constEnd(), url) !=
+      m_activeUrls.constEnd()) {
+    // Already requested, imageFetched() will be emitted for it.
+    return;
+  }
+  if (m_invalidUrls.contains(url) || m_images.contains(url) ||
+      cacheImage(url)) {
+    QMetaObject::invokeMethod(this, "emitCachedImage", Qt::QueuedConnection,
+                              Q_ARG(QUrl, url));
+    return;
+  }
+  m_queue.append(url);
+  startDownloads();
+}
+
+/**
+ * Emit imageFetched() for an image in the memory cache.
+ * If the image has been removed from the memory cache in the meantime, it
+ * is read again from the disk cache or downloaded.
+ * @param url URL of image
+ */
+void CoverArtFetcher::emitCachedImage(const QUrl& url)
+{
+  if (m_invalidUrls.contains(url)) {
+    emit imageFetched(url, QByteArray(), QString());
+  } else if (const Image* image = m_images.object(url)) {
+    emit imageFetched(url, image->data, image->mimeType);
+  } else if (cacheImage(url)) {
+    image = m_images.object(url);
+    emit imageFetched(url, image->data, image->mimeType);
+  } else {
+    m_queue.append(url);
+    startDownloads();
+  }
+}
+
+/**
+ * Read an image from the disk cache into the memory cache.
+ * @param url URL of image
+ * @return true if image found in disk cache.
+ */
+bool CoverArtFetcher::cacheImage(const QUrl& url)
+{
+  Image image;
+  return readCacheFile(url, image) &&
+      m_images.insert(url, new Image(image), image.data.size());
+}
+
+/**
+ * Abort all pending downloads.
+ */
+void CoverArtFetcher::abort()
+{
+  m_queue.clear();
+  for (auto it = m_activeUrls.constBegin(); it != m_activeUrls.constEnd();
+       ++it) {
+    it.key()->cancelDownload();
+    m_idleClients.append(it.key());
+  }
+  m_activeUrls.clear();
+}
+
+/**
+ * Clear images kept in memory.
+ * The images in the disk cache are kept, but the cache is reduced to
+ * its maximum size.
+ */
+void CoverArtFetcher::clear()
+{
+  m_images.clear();
+  m_invalidUrls.clear();
+  pruneCache();
+}
+
+/**
+ * Check if downloaded data is a valid image.
+ *
+ * @param data downloaded data
+ * @param mimeType content type
+ *
+ * @return true if valid, false e.g. for an invalid 1x1 picture from Amazon.
+ */
+bool CoverArtFetcher::isValidImage(const QByteArray& data,
+                                   const QString& mimeType)
+{
+  return data.size() >= 1024 && mimeType.startsWith(QLatin1String("image"));
+}
+
+/**
+ * Start downloads of queued URLs while download clients are available.
+ */
+void CoverArtFetcher::startDownloads()
+{
+  while (!m_queue.isEmpty()) {
+    DownloadClient* client;
+    if (!m_idleClients.isEmpty()) {
+      client = m_idleClients.takeLast();
+    } else if (m_numClients < MAX_PARALLEL_DOWNLOADS) {
+      client = new DownloadClient(m_netMgr);
+      ++m_numClients;
+      connect(client, &DownloadClient::downloadFinished,
+              this, [this, client](const QByteArray& data,
+                                   const QString& mimeType, const QString&) {
+        onDownloadFinished(client, data, mimeType);
+      });
+    } else {
+      break;
+    }
+    const QUrl url = m_queue.takeFirst();
+    m_activeUrls.insert(client, url);
+    client->startDownload(url);
+  }
+}
+
+/**
+ * Called when a download client has finished.
+ *
+ * @param client download client
+ * @param data received data
+ * @param mimeType content type
+ */
+void CoverArtFetcher::onDownloadFinished(DownloadClient* client,
+                                         const QByteArray& data,
+                                         const QString& mimeType)
+{
+  auto it = m_activeUrls.find(client);
+  if (it == m_activeUrls.end())
+    return;
+
+  const QUrl url = it.value();
+  m_activeUrls.erase(it);
+  m_idleClients.append(client);
+  if (isValidImage(data, mimeType)) {
+    Image* image = new Image;
+    image->data = data;
+    image->mimeType = mimeType;
+    writeCacheFile(url, *image);
+    m_images.insert(url, image, data.size());
+  } else {
+    m_invalidUrls.insert(url);
+  }
+  startDownloads();
+  emit imageFetched(url, data, mimeType);
+}
+
+/**
+ * Get path of cache file for an image.
+ * @param url URL of image
+ * @return file path, empty if the disk cache is disabled.
+ */
+QString CoverArtFetcher::cacheFilePath(const QUrl& url) const
+{
+  if (m_cacheDir.isEmpty())
+    return QString();
+
+  const QByteArray hash = QCryptographicHash::hash(
+        url.toEncoded(), QCryptographicHash::Sha1);
+  return m_cacheDir + QLatin1Char('/') + QString::fromLatin1(hash.toHex()) +
+      QLatin1String(".img");
+}
+
+/**
+ * Read an image from the disk cache.
+ *
+ * @param url URL of image
+ * @param image the image is returned here
+ *
+ * @return true if image found in cache.
+ */
+bool CoverArtFetcher::readCacheFile(const QUrl& url, Image& image) const
+{
+  QFile file(cacheFilePath(url));
+  if (file.fileName().isEmpty() || !file.open(QIODevice::ReadOnly))
+    return false;
+
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_5_6);
+  quint32 magic, version;
+  QUrl cachedUrl;
+  stream >> magic >> version;
+  if (magic != CACHE_FILE_MAGIC || version != CACHE_FILE_VERSION)
+    return false;
+
+  stream >> cachedUrl >> image.mimeType >> image.data;
+  return stream.status() == QDataStream::Ok && cachedUrl == url &&
+      isValidImage(image.data, image.mimeType);
+}
+
+/**
+ * Store an image in the disk cache.
+ * @param url URL of image
+ * @param image image data
+ */
+void CoverArtFetcher::writeCacheFile(const QUrl& url, const Image& image) const
+{
+  const QString filePath = cacheFilePath(url);
+  if (filePath.isEmpty() || !QDir().mkpath(m_cacheDir))
+    return;
+
+  QFile file(filePath);
+  if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << CACHE_FILE_MAGIC << CACHE_FILE_VERSION << url
+           << image.mimeType << image.data;
+    if (stream.status() != QDataStream::Ok) {
+      file.remove();
+    }
+  }
+}
+
+/**
+ * Remove the least recently written images if the disk cache is larger
+ * than its maximum size.
+ */
+void CoverArtFetcher::pruneCache() const
+{
+  if (m_cacheDir.isEmpty())
+    return;
+
+  QFileInfoList files = QDir(m_cacheDir).entryInfoList(
+        {QLatin1String("*.img")}, QDir::Files, QDir::Time);
+  qint64 size = 0;
+  for (const QFileInfo& fi : qAsConst(files)) {
+    size += fi.size();
+  }
+  // The files are sorted by time, newest first.
+  while (size > MAX_CACHE_SIZE && !files.isEmpty()) {
+    const QFileInfo fi = files.takeLast();
+    if (QFile::remove(fi.filePath())) {
+      size -= fi.size();
+    }
+  }
+}
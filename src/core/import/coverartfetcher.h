@@ -0,0 +1,158 @@
+/**
+ * \file coverartfetcher.h
+ * Concurrent download of cover art with a disk cache.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QUrl>
+#include <QHash>
+#include <QSet>
+#include <QCache>
+#include <QList>
+#include "kid3api.h"
+
+class QNetworkAccessManager;
+class DownloadClient;
+
+/**
+ * Downloads cover art images concurrently.
+ *
+ * Each URL is only downloaded once, further requests for the same URL are
+ * answered when the download is finished or from memory. Valid images are
+ * stored in a cache directory, so that they do not have to be downloaded
+ * again in later imports. Only the most recently fetched images are kept in
+ * memory, others are read again from the cache directory.
+ */
+class KID3_CORE_EXPORT CoverArtFetcher : public QObject {
+  Q_OBJECT
+public:
+  /**
+   * Constructor.
+   * @param netMgr network access manager
+   * @param parent parent object
+   */
+  CoverArtFetcher(QNetworkAccessManager* netMgr, QObject* parent = nullptr);
+
+  /**
+   * Destructor.
+   */
+  virtual ~CoverArtFetcher() override = default;
+
+  /**
+   * Set directory used to cache images.
+   * @param dirPath path to directory, empty to disable the disk cache
+   */
+  void setCacheDirectory(const QString& dirPath) { m_cacheDir = dirPath; }
+
+  /**
+   * Get directory used to cache images.
+   * @return path to directory, by default "coverart/downloads" in the cache
+   * location.
+   */
+  QString cacheDirectory() const { return m_cacheDir; }
+
+  /**
+   * Request an image.
+   * imageFetched() is always emitted asynchronously, also if the image is
+   * found in a cache.
+   *
+   * @param url URL of image
+   */
+  void fetch(const QUrl& url);
+
+  /**
+   * Get number of images which are requested but not yet fetched.
+   * @return number of pending URLs.
+   */
+  int pendingCount() const { return m_queue.size() + m_activeUrls.size(); }
+
+  /**
+   * Abort all pending downloads.
+   */
+  void abort();
+
+  /**
+   * Clear images kept in memory.
+   * The images in the disk cache are kept, but the cache is reduced to
+   * its maximum size.
+   */
+  void clear();
+
+  /**
+   * Check if downloaded data is a valid image.
+   *
+   * @param data downloaded data
+   * @param mimeType content type
+   *
+   * @return true if valid, false e.g. for an invalid 1x1 picture from Amazon.
+   */
+  static bool isValidImage(const QByteArray& data, const QString& mimeType);
+
+signals:
+  /**
+   * Emitted when a requested image is fetched.
+   *
+   * @param url URL passed to fetch()
+   * @param data image data, can be invalid, see isValidImage(), empty if
+   * an invalid image is requested again
+   * @param mimeType content type of image
+   */
+  void imageFetched(const QUrl& url, const QByteArray& data,
+                    const QString& mimeType);
+
+private slots:
+  void emitCachedImage(const QUrl& url);
+
+private:
+  /** Image kept in memory, the cost in the memory cache is its size. */
+  struct Image {
+    QByteArray data;
+    QString mimeType;
+  };
+
+  bool cacheImage(const QUrl& url);
+  void startDownloads();
+  void onDownloadFinished(DownloadClient* client, const QByteArray& data,
+                          const QString& mimeType);
+  QString cacheFilePath(const QUrl& url) const;
+  bool readCacheFile(const QUrl& url, Image& image) const;
+  void writeCacheFile(const QUrl& url, const Image& image) const;
+  void pruneCache() const;
+
+  QNetworkAccessManager* m_netMgr;
+  QString m_cacheDir;
+  /** Recently fetched valid images */
+  QCache<QUrl, Image> m_images;
+  /** URLs of invalid images, so that they are not fetched again */
+  QSet<QUrl> m_invalidUrls;
+  /** URLs waiting for a free download client */
+  QList<QUrl> m_queue;
+  /** URLs being downloaded, indexed by client */
+  QHash<DownloadClient*, QUrl> m_activeUrls;
+  /** Download clients which are not busy */
+  QList<DownloadClient*> m_idleClients;
+  int m_numClients;
+};
@@ -29,38 +29,8 @@
 #include <QNetworkRequest>
 #include <QNetworkProxy>
 #include <QByteArray>
-#include <QTimer>
-#include <QDateTime>
 #include "networkconfig.h"
 
-
-/** Time when last request was sent to server */
-QMap<QString, QDateTime> HttpClient::s_lastRequestTime;
-/** Minimum interval between two requests to server in ms */
-QMap<QString, int> HttpClient::s_minimumRequestInterval;
-
-/**
- * Used to initialize the minimum interval for some servers
- * at static initialization time.
- *
- * Rate limit requests to servers, MusicBrainz and Discogs impose a limit of
- * one request per second
- * http://musicbrainz.org/doc/XML_Web_Service/Rate_Limiting#Source_IP_address
- * http://www.discogs.com/developers/accessing.html#rate-limiting
- */
-static struct MinimumRequestIntervalInitializer {
-  MinimumRequestIntervalInitializer() {
-    HttpClient::s_minimumRequestInterval[QLatin1String("musicbrainz.org")] = 1000;
-    HttpClient::s_minimumRequestInterval[QLatin1String("api.discogs.com")] = 1000;
-    HttpClient::s_minimumRequestInterval[QLatin1String("www.discogs.com")] = 1000;
-    HttpClient::s_minimumRequestInterval[QLatin1String("www.amazon.com")] = 1000;
-    HttpClient::s_minimumRequestInterval[QLatin1String("images.amazon.com")] = 1000;
-    HttpClient::s_minimumRequestInterval[QLatin1String("www.gnudb.org")] = 1000;
-    HttpClient::s_minimumRequestInterval[QLatin1String("gnudb.gnudb.org")] = 1000;
-    HttpClient::s_minimumRequestInterval[QLatin1String("api.acoustid.org")] = 1000;
-  }
-} minimumRequestIntervalInitializer;
-
 /**
  * Constructor.
  *
@@ -68,11 +38,10 @@ static struct MinimumRequestIntervalInitializer {
  */
 HttpClient::HttpClient(QNetworkAccessManager* netMgr)
   : QObject(netMgr), m_netMgr(netMgr), m_rcvBodyLen(0),
-    m_requestTimer(new QTimer(this))
+    m_scheduler(HttpRequestScheduler::instance(netMgr)),
+    m_priority(HttpRequestScheduler::MetadataPriority)
 {
   setObjectName(QLatin1String("HttpClient"));
-  m_requestTimer->setSingleShot(true);
-  connect(m_requestTimer, &QTimer::timeout, this, &HttpClient::delayedSendRequest);
 }
 
 /**
@@ -80,9 +49,14 @@ HttpClient::HttpClient(QNetworkAccessManager* netMgr)
  */
 HttpClient::~HttpClient()
 {
+  if (m_scheduler) {
+    m_scheduler->cancel(this);
+  }
   if (m_reply) {
+    // Only disconnect from this client, the scheduler has to be notified
+    // when the request is finished.
+    m_reply->disconnect(this);
     m_reply->close();
-    m_reply->disconnect();
     m_reply->deleteLater();
   }
 }
@@ -114,23 +88,10 @@ void HttpClient::networkReplyFinished()
         }
         if (redirectUrl.isValid()) {
           reply->deleteLater();
-
-          QNetworkRequest request(redirectUrl);
-          reply = m_netMgr->get(request);
-          m_reply = reply;
-          connect(reply, &QNetworkReply::finished,
-                  this, &HttpClient::networkReplyFinished);
-          connect(reply, &QNetworkReply::downloadProgress,
-                  this, &HttpClient::networkReplyProgress);
-#if QT_VERSION >= 0x050f00
-          connect(reply, &QNetworkReply::errorOccurred,
-                  this, &HttpClient::networkReplyError);
-#else
-          connect(reply,
-                  static_cast<void (QNetworkReply::*)(QNetworkReply::NetworkError)>(
-                    &QNetworkReply::error),
-                  this, &HttpClient::networkReplyError);
-#endif
+          if (m_scheduler) {
+            m_scheduler->enqueue(this, QNetworkRequest(redirectUrl),
+                                 m_priority);
+          }
           return;
         }
       }
@@ -172,23 +133,6 @@ void HttpClient::networkReplyError(QNetworkReply::NetworkError)
  */
 void HttpClient::sendRequest(const QUrl& url, const RawHeaderMap& headers)
 {
-  QString host = url.host();
-  qint64 msSinceLastRequest;
-  int minimumRequestInterval;
-  QDateTime now = QDateTime::currentDateTime();
-  QDateTime lastRequestTime = s_lastRequestTime.value(host);
-  if (lastRequestTime.isValid() &&
-      (minimumRequestInterval = s_minimumRequestInterval.value(host)) > 0 &&
-      (msSinceLastRequest = lastRequestTime.msecsTo(now)) <
-      minimumRequestInterval) {
-    // Delay request to comply with minimum interval
-    m_delayedSendRequestContext.url = url;
-    m_delayedSendRequestContext.headers = headers;
-    m_requestTimer->start(minimumRequestInterval -
-                          static_cast<int>(msSinceLastRequest));
-    return;
-  }
-
   m_rcvBodyLen = 0;
   m_rcvBodyType = QLatin1String("");
   QString proxy, username, password;
@@ -211,7 +155,19 @@ void HttpClient::sendRequest(const QUrl& url, const RawHeaderMap& headers)
   for (auto it = headers.constBegin(); it != headers.constEnd(); ++it) {
     request.setRawHeader(it.key(), it.value());
   }
-  QNetworkReply* reply = m_netMgr->get(request);
+  if (m_scheduler) {
+    // The request is delayed by the scheduler to comply with the minimum
+    // interval of the host and sent when requestStarted() is called.
+    m_scheduler->enqueue(this, request, m_priority);
+  }
+}
+
+/**
+ * Called by the scheduler when the request has been sent.
+ * @param reply network reply
+ */
+void HttpClient::requestStarted(QNetworkReply* reply)
+{
   m_reply = reply;
   connect(reply, &QNetworkReply::finished,
           this, &HttpClient::networkReplyFinished);
@@ -226,7 +182,6 @@ void HttpClient::sendRequest(const QUrl& url, const RawHeaderMap& headers)
             &QNetworkReply::error),
           this, &HttpClient::networkReplyError);
 #endif
-  s_lastRequestTime[host] = now;
   emitProgress(tr("Request sent..."), 0, 0);
 }
 
@@ -250,20 +205,14 @@ void HttpClient::sendRequest(const QString& server, const QString& path,
   sendRequest(url, headers);
 }
 
-/**
- * Called to start delayed sendRequest().
- */
-void HttpClient::delayedSendRequest()
-{
-  sendRequest(m_delayedSendRequestContext.url,
-              m_delayedSendRequestContext.headers);
-}
-
 /**
  * Abort request.
  */
 void HttpClient::abort()
 {
+  if (m_scheduler) {
+    m_scheduler->cancel(this);
+  }
   if (m_reply) {
     m_reply->abort();
   }
@@ -31,12 +31,11 @@
 #include <QNetworkReply>
 #include <QPointer>
 #include <QMap>
+#include "httprequestscheduler.h"
 #include "kid3api.h"
 
 class QByteArray;
 class QNetworkAccessManager;
-class QDateTime;
-class QTimer;
 
 /**
  * Client to connect to HTTP server.
@@ -85,6 +84,15 @@ public:
    */
   void abort();
 
+  /**
+   * Set priority of requests.
+   * @param priority priority used for the requests of this client,
+   * default is HttpRequestScheduler::MetadataPriority
+   */
+  void setPriority(HttpRequestScheduler::Priority priority) {
+    m_priority = priority;
+  }
+
   /**
    * Get content length.
    * @return size of body in bytes, 0 if unknown.
@@ -141,12 +149,15 @@ private slots:
    */
   void networkReplyError(QNetworkReply::NetworkError code);
 
+private:
+  friend class HttpRequestScheduler;
+
   /**
-   * Called to start delayed sendRequest().
+   * Called by the scheduler when the request has been sent.
+   * @param reply network reply
    */
-  void delayedSendRequest();
+  void requestStarted(QNetworkReply* reply);
 
-private:
   /**
    * Emit a progress signal with step/total steps.
    *
@@ -186,18 +197,8 @@ private:
   unsigned long m_rcvBodyLen;
   /** content type */
   QString m_rcvBodyType;
-  /** Timer used to delay requests */
-  QTimer* m_requestTimer;
-  /** Context for delayedSendRequest() */
-  struct {
-    QUrl url;
-    RawHeaderMap headers;
-  } m_delayedSendRequestContext;
-
-  friend struct MinimumRequestIntervalInitializer;
-
-  /** Time when last request was sent to server */
-  static QMap<QString, QDateTime> s_lastRequestTime;
-  /** Minimum interval between two requests to server in ms */
-  static QMap<QString, int> s_minimumRequestInterval;
+  /** Scheduler shared by the clients of the network access manager */
+  QPointer<HttpRequestScheduler> m_scheduler;
+  /** Priority of requests */
+  HttpRequestScheduler::Priority m_priority;
 };
@@ -0,0 +1,231 @@
+/**
+ * \file httprequestscheduler.cpp
+ * Shared scheduler for HTTP requests.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "httprequestscheduler.h"
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QTimer>
+#include "httpclient.h"
+
+namespace {
+
+/**
+ * Maximum number of running requests per host, this is the number of
+ * connections which QNetworkAccessManager opens to a HTTP/1.1 host.
+ */
+const int MAX_RUNNING_REQUESTS_PER_HOST = 6;
+
+}
+
+/**
+ * Get the scheduler for a network access manager.
+ * The scheduler is created as a child of @a netMgr if it does not exist.
+ *
+ * @param netMgr network access manager
+ *
+ * @return scheduler.
+ */
+HttpRequestScheduler* HttpRequestScheduler::instance(
+    QNetworkAccessManager* netMgr)
+{
+  auto scheduler = netMgr->findChild<HttpRequestScheduler*>(
+        QString(), Qt::FindDirectChildrenOnly);
+  if (!scheduler) {
+    scheduler = new HttpRequestScheduler(netMgr);
+  }
+  return scheduler;
+}
+
+/**
+ * Constructor.
+ *
+ * Rate limit requests to servers, MusicBrainz and Discogs impose a limit of
+ * one request per second
+ * http://musicbrainz.org/doc/XML_Web_Service/Rate_Limiting#Source_IP_address
+ * http://www.discogs.com/developers/accessing.html#rate-limiting
+ *
+ * @param netMgr network access manager
+ */
+HttpRequestScheduler::HttpRequestScheduler(QNetworkAccessManager* netMgr)
+  : QObject(netMgr), m_netMgr(netMgr)
+{
+  setObjectName(QLatin1String("HttpRequestScheduler"));
+  static const char* const rateLimitedHosts[] = {
+    "musicbrainz.org", "api.discogs.com", "www.discogs.com", "www.amazon.com",
+    "images.amazon.com", "www.gnudb.org", "gnudb.gnudb.org", "api.acoustid.org"
+  };
+  for (auto host : rateLimitedHosts) {
+    m_minimumRequestIntervals.insert(QString::fromLatin1(host), 1000);
+  }
+}
+
+/**
+ * Set minimum interval between the start of two requests to a host.
+ *
+ * @param host host name
+ * @param msec interval in milliseconds, 0 if not limited
+ */
+void HttpRequestScheduler::setMinimumRequestInterval(const QString& host,
+                                                     int msec)
+{
+  if (msec > 0) {
+    m_minimumRequestIntervals.insert(host, msec);
+  } else {
+    m_minimumRequestIntervals.remove(host);
+  }
+}
+
+/**
+ * Queue a GET request.
+ * A client can only have one pending request, a request which is still
+ * waiting in the queue is replaced.
+ *
+ * @param client client which is notified when the request is started
+ * @param request network request
+ * @param priority priority of request
+ */
+void HttpRequestScheduler::enqueue(HttpClient* client,
+                                   const QNetworkRequest& request,
+                                   Priority priority)
+{
+  cancel(client);
+  const QString host = request.url().host();
+  PendingRequest pending;
+  pending.client = client;
+  pending.request = request;
+  // Also order the requests which are queued in the network access manager
+  // while waiting for a free connection.
+  pending.request.setPriority(priority == MetadataPriority
+                              ? QNetworkRequest::HighPriority
+                              : QNetworkRequest::LowPriority);
+  m_hostQueues[host].requests[priority].append(pending);
+  processQueue(host);
+}
+
+/**
+ * Remove the pending requests of a client from the queues.
+ * @param client HTTP client
+ */
+void HttpRequestScheduler::cancel(HttpClient* client)
+{
+  for (auto it = m_hostQueues.begin(); it != m_hostQueues.end(); ++it) {
+    for (auto& requests : it->requests) {
+      for (auto reqIt = requests.begin(); reqIt != requests.end();) {
+        if (reqIt->client == client) {
+          reqIt = requests.erase(reqIt);
+        } else {
+          ++reqIt;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Get number of requests waiting in the queue of a host.
+ * @param host host name
+ * @return number of pending requests.
+ */
+int HttpRequestScheduler::pendingRequestCount(const QString& host) const
+{
+  int count = 0;
+  auto it = m_hostQueues.constFind(host);
+  if (it != m_hostQueues.constEnd()) {
+    for (const auto& requests : it->requests) {
+      count += requests.size();
+    }
+  }
+  return count;
+}
+
+/**
+ * Start the pending requests of a host which are allowed to run.
+ * @param host host name
+ */
+void HttpRequestScheduler::processQueue(const QString& host)
+{
+  const int interval = minimumRequestInterval(host);
+  forever {
+    // The queue is looked up again in each iteration because starting a
+    // request notifies the client, which can queue further requests.
+    auto it = m_hostQueues.find(host);
+    if (it == m_hostQueues.end() || it->timerActive ||
+        it->numRunning >= MAX_RUNNING_REQUESTS_PER_HOST)
+      break;
+
+    QList<PendingRequest>* requests = nullptr;
+    for (auto& prioRequests : it->requests) {
+      // Skip requests of clients which have been deleted.
+      while (!prioRequests.isEmpty() && !prioRequests.first().client) {
+        prioRequests.removeFirst();
+      }
+      if (!prioRequests.isEmpty()) {
+        requests = &prioRequests;
+        break;
+      }
+    }
+    if (!requests)
+      break;
+
+    if (interval > 0 && it->lastStart.isValid()) {
+      const qint64 elapsed = it->lastStart.elapsed();
+      if (elapsed < interval) {
+        it->timerActive = true;
+        QTimer::singleShot(static_cast<int>(interval - elapsed), this,
+                           [this, host]() {
+          auto timerIt = m_hostQueues.find(host);
+          if (timerIt != m_hostQueues.end()) {
+            timerIt->timerActive = false;
+            processQueue(host);
+          }
+        });
+        break;
+      }
+    }
+
+    PendingRequest pending = requests->takeFirst();
+    it->lastStart.start();
+    ++it->numRunning;
+    QNetworkReply* reply = m_netMgr->get(pending.request);
+    connect(reply, &QNetworkReply::finished, this, [this, host]() {
+      requestFinished(host);
+    });
+    pending.client->requestStarted(reply);
+  }
+}
+
+/**
+ * Called when a request to a host is finished.
+ * @param host host name
+ */
+void HttpRequestScheduler::requestFinished(const QString& host)
+{
+  auto it = m_hostQueues.find(host);
+  if (it != m_hostQueues.end() && it->numRunning > 0) {
+    --it->numRunning;
+    processQueue(host);
+  }
+}
@@ -0,0 +1,139 @@
+/**
+ * \file httprequestscheduler.h
+ * Shared scheduler for HTTP requests.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <QNetworkRequest>
+#include "kid3api.h"
+
+class QNetworkAccessManager;
+class HttpClient;
+
+/**
+ * Schedules the requests of all HTTP clients using the same network access
+ * manager.
+ *
+ * The requests are queued per host. Metadata requests are started before
+ * image requests, and the minimum interval between two requests to a host
+ * is enforced for all clients together. The network access manager keeps
+ * the connections to a host alive and reuses them. The number of running
+ * requests per host is limited to the number of connections it opens to a
+ * host, so that pending requests are started in the order of their priority.
+ */
+class KID3_CORE_EXPORT HttpRequestScheduler : public QObject {
+  Q_OBJECT
+public:
+  /** Priority of a request. */
+  enum Priority {
+    MetadataPriority, /**< Request for metadata, started first */
+    ImagePriority,    /**< Request for an image */
+    NumPriorities     /**< Number of priorities */
+  };
+
+  /**
+   * Get the scheduler for a network access manager.
+   * The scheduler is created as a child of @a netMgr if it does not exist.
+   *
+   * @param netMgr network access manager
+   *
+   * @return scheduler.
+   */
+  static HttpRequestScheduler* instance(QNetworkAccessManager* netMgr);
+
+  /**
+   * Set minimum interval between the start of two requests to a host.
+   *
+   * @param host host name
+   * @param msec interval in milliseconds, 0 if not limited
+   */
+  void setMinimumRequestInterval(const QString& host, int msec);
+
+  /**
+   * Get minimum interval between the start of two requests to a host.
+   *
+   * @param host host name
+   *
+   * @return interval in milliseconds, 0 if not limited.
+   */
+  int minimumRequestInterval(const QString& host) const {
+    return m_minimumRequestIntervals.value(host);
+  }
+
+  /**
+   * Queue a GET request.
+   * A client can only have one pending request, a request which is still
+   * waiting in the queue is replaced.
+   *
+   * @param client client which is notified when the request is started
+   * @param request network request
+   * @param priority priority of request
+   */
+  void enqueue(HttpClient* client, const QNetworkRequest& request,
+               Priority priority);
+
+  /**
+   * Remove the pending requests of a client from the queues.
+   * @param client HTTP client
+   */
+  void cancel(HttpClient* client);
+
+  /**
+   * Get number of requests waiting in the queue of a host.
+   * @param host host name
+   * @return number of pending requests.
+   */
+  int pendingRequestCount(const QString& host) const;
+
+private:
+  /** Request waiting to be started. */
+  struct PendingRequest {
+    QPointer<HttpClient> client;
+    QNetworkRequest request;
+  };
+
+  /** Requests and state of a host. */
+  struct HostQueue {
+    HostQueue() : numRunning(0), timerActive(false) {}
+    QList<PendingRequest> requests[NumPriorities];
+    QElapsedTimer lastStart;
+    int numRunning;
+    bool timerActive;
+  };
+
+  explicit HttpRequestScheduler(QNetworkAccessManager* netMgr);
+
+  void processQueue(const QString& host);
+  void requestFinished(const QString& host);
+
+  QNetworkAccessManager* m_netMgr;
+  QHash<QString, HostQueue> m_hostQueues;
+  QHash<QString, int> m_minimumRequestIntervals;
+};
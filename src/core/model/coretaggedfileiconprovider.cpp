@@ -69,6 +69,27 @@ QVariant CoreTaggedFileIconProvider::iconForTaggedFile(const TaggedFile* taggedF
   return QVariant();
 }
 
+/**
+ * Get a thumbnail of the cover art embedded in a file.
+ * If the thumbnail is not yet available, it can be created asynchronously
+ * and TaggedFileSystemModel::notifyCoverArtChanged() be called when it is
+ * ready.
+ *
+ * @param filePath path to file
+ * @param lastModified modification time of file, used to detect
+ *                     outdated thumbnails
+ *
+ * @return thumbnail, null if not available. The default implementation
+ *         returns a null variant.
+ */
+QVariant CoreTaggedFileIconProvider::coverArtForFile(
+    const QString& filePath, const QDateTime& lastModified)
+{
+  Q_UNUSED(filePath)
+  Q_UNUSED(lastModified)
+  return QVariant();
+}
+
 /**
  * Get an icon ID for a tagged file.
  *
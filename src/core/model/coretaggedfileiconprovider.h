@@ -30,6 +30,8 @@
 
 class QVariant;
 class QSize;
+class QString;
+class QDateTime;
 class TaggedFile;
 
 /**
@@ -106,6 +108,22 @@ public:
    */
   virtual QVariant backgroundForTaggedFile(const TaggedFile* taggedFile);
 
+  /**
+   * Get a thumbnail of the cover art embedded in a file.
+   * If the thumbnail is not yet available, it can be created asynchronously
+   * and TaggedFileSystemModel::notifyCoverArtChanged() be called when it is
+   * ready.
+   *
+   * @param filePath path to file
+   * @param lastModified modification time of file, used to detect
+   *                     outdated thumbnails
+   *
+   * @return thumbnail, null if not available. The default implementation
+   *         returns a null variant.
+   */
+  virtual QVariant coverArtForFile(const QString& filePath,
+                                   const QDateTime& lastModified);
+
   /**
    * Get brush with color for a context.
    * @param context color context
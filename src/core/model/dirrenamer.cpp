@@ -453,6 +453,31 @@ QString DirRenamer::generateNewDirname(TaggedFile* taggedFile, QString* olddir)
 void DirRenamer::clearActions()
 {
   m_actions.clear();
+  m_actionSources.clear();
+  m_actionDestinations.clear();
+  m_renamedDirectories.clear();
+  m_fileMoves.clear();
+}
+
+/**
+ * Rebuild the indexes of the sources and destinations of the actions.
+ */
+void DirRenamer::rebuildActionIndexes()
+{
+  m_actionSources.clear();
+  m_actionDestinations.clear();
+  m_renamedDirectories.clear();
+  for (const RenameAction& action : qAsConst(m_actions)) {
+    if (!action.m_src.isEmpty()) {
+      m_actionSources.insert(action.m_src);
+      if (action.m_type == RenameAction::RenameDirectory) {
+        m_renamedDirectories.insert(action.m_src, action.m_dest);
+      }
+    }
+    if (!action.m_dest.isEmpty()) {
+      m_actionDestinations.insert(action.m_dest);
+    }
+  }
 }
 
 /**
@@ -467,15 +492,21 @@ void DirRenamer::addAction(RenameAction::Type type, const QString& src, const QS
                            const QPersistentModelIndex& index)
 {
   // do not add an action if the source or destination is already in an action
-  for (auto it = m_actions.constBegin(); it != m_actions.constEnd(); ++it) {
-    if ((!src.isEmpty() && (*it).m_src == src) ||
-        (!dest.isEmpty() && (*it).m_dest == dest)){
-      return;
-    }
+  if (actionHasSource(src) || actionHasDestination(dest)) {
+    return;
   }
 
   RenameAction action(type, src, dest, index);
   m_actions.append(action);
+  if (!src.isEmpty()) {
+    m_actionSources.insert(src);
+    if (type == RenameAction::RenameDirectory) {
+      m_renamedDirectories.insert(src, dest);
+    }
+  }
+  if (!dest.isEmpty()) {
+    m_actionDestinations.insert(dest);
+  }
   if (!m_fmtContext->hasAggregatedCodes()) {
     emit actionScheduled(describeAction(action));
   }
@@ -499,15 +530,7 @@ void DirRenamer::addAction(RenameAction::Type type, const QString& dest)
  */
 bool DirRenamer::actionHasSource(const QString& src) const
 {
-  if (src.isEmpty()) {
-    return false;
-  }
-  for (auto it = m_actions.constBegin(); it != m_actions.constEnd(); ++it) {
-    if ((*it).m_src == src) {
-      return true;
-    }
-  }
-  return false;
+  return !src.isEmpty() && m_actionSources.contains(src);
 }
 
 /**
@@ -517,15 +540,7 @@ bool DirRenamer::actionHasSource(const QString& src) const
  */
 bool DirRenamer::actionHasDestination(const QString& dest) const
 {
-  if (dest.isEmpty()) {
-    return false;
-  }
-  for (auto it = m_actions.constBegin(); it != m_actions.constEnd(); ++it) {
-    if ((*it).m_dest == dest) {
-      return true;
-    }
-  }
-  return false;
+  return !dest.isEmpty() && m_actionDestinations.contains(dest);
 }
 
 /**
@@ -535,17 +550,13 @@ bool DirRenamer::actionHasDestination(const QString& dest) const
  */
 void DirRenamer::replaceIfAlreadyRenamed(QString& src) const
 {
-  bool found = true;
-  for (int i = 0; found && i <  5; ++i) {
-    found = false;
-    for (auto it = m_actions.constBegin(); it != m_actions.constEnd(); ++it) {
-      if ((*it).m_type == RenameAction::RenameDirectory &&
-          (*it).m_src == src) {
-        src = (*it).m_dest;
-        found = true;
-        break;
-      }
+  // Follow a chain of at most five renames to avoid endless loops.
+  for (int i = 0; i < 5; ++i) {
+    auto it = m_renamedDirectories.constFind(src);
+    if (it == m_renamedDirectories.constEnd()) {
+      break;
     }
+    src = *it;
   }
 }
 
@@ -558,6 +569,8 @@ void DirRenamer::scheduleAction(TaggedFile* taggedFile)
 {
   QString currentDirname;
   QString newDirname(generateNewDirname(taggedFile, &currentDirname));
+  const QString oldDirname(currentDirname);
+  bool tooDifferent = false;
   bool again = false;
   for (int round = 0; round < 2; ++round) {
     replaceIfAlreadyRenamed(currentDirname);
@@ -622,11 +635,16 @@ void DirRenamer::scheduleAction(TaggedFile* taggedFile)
         } else {
           // new directory name is too different
           addAction(RenameAction::ReportError, tr("New folder name is too different\n"));
+          tooDifferent = true;
         }
       }
     }
     if (!again) break;
   }
+  if (!tooDifferent && currentDirname != oldDirname) {
+    const QString fileName = QLatin1Char('/') + taggedFile->getFilename();
+    m_fileMoves.append({oldDirname + fileName, currentDirname + fileName});
+  }
 }
 
 /**
@@ -643,6 +661,12 @@ void DirRenamer::endScheduleActions()
       }
       emit actionScheduled(describeAction(action));
     }
+    for (auto& fileMove : m_fileMoves) {
+      for (const auto& replacement : replacements) {
+        fileMove.second.replace(replacement.first, replacement.second);
+      }
+    }
+    rebuildActionIndexes();
   }
 }
 
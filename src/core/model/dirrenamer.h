@@ -28,6 +28,8 @@
 
 #include <QObject>
 #include <QString>
+#include <QSet>
+#include <QHash>
 #include <QPersistentModelIndex>
 #include "frame.h"
 #include "iabortable.h"
@@ -124,6 +126,16 @@ public:
    */
   void performActions(QString* errorMsg);
 
+  /**
+   * Get the paths of the files which are moved by the scheduled actions.
+   * This can be used to preview the effect of the actions before
+   * performActions() is called.
+   *
+   * @return list of (old file path, new file path) pairs in the order in
+   *         which the files were scheduled.
+   */
+  QList<QPair<QString, QString>> getFileMoves() const { return m_fileMoves; }
+
   /**
    * Set directory name.
    * This should be done before calling performActions(), so that the directory
@@ -298,8 +310,21 @@ private:
    */
   QStringList describeAction(const RenameAction& action) const;
 
+  /**
+   * Rebuild the indexes of the sources and destinations of the actions.
+   */
+  void rebuildActionIndexes();
+
   DirNameFormatReplacerContext* m_fmtContext;
   RenameActionList m_actions;
+  /** Sources of all actions in m_actions */
+  QSet<QString> m_actionSources;
+  /** Destinations of all actions in m_actions */
+  QSet<QString> m_actionDestinations;
+  /** Destinations of directory rename actions indexed by their sources */
+  QHash<QString, QString> m_renamedDirectories;
+  /** (old path, new path) pairs of the files moved by the actions */
+  QList<QPair<QString, QString>> m_fileMoves;
   Frame::TagVersion m_tagVersion;
   QString m_format;
   QString m_dirName;
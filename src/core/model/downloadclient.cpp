@@ -36,6 +36,8 @@
 DownloadClient::DownloadClient(QNetworkAccessManager* netMgr)
   : HttpClient(netMgr), m_canceled(false)
 {
+  // Imports are not delayed by downloads of cover art from the same host.
+  setPriority(HttpRequestScheduler::ImagePriority);
   connect(this, &HttpClient::bytesReceived,
           this, &DownloadClient::requestFinished);
 }
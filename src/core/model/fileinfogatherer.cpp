@@ -60,6 +60,7 @@
 #  include "qplatformdefs.h"
 #endif
 #include "abstractfiledecorationprovider.h"
+#include "tracer.h"
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -399,6 +400,7 @@ ExtendedInformation FileInfoGatherer::getInfo(const QFileInfo &fileInfo) const
  */
 void FileInfoGatherer::getFileInfos(const QString &path, const QStringList &files)
 {
+    TraceSpan span("listDirectory");
     // List drives
     if (path.isEmpty()) {
 #ifdef QT_BUILD_INTERNAL
@@ -258,7 +258,8 @@ Qt::ItemFlags FileProxyModel::flags(const QModelIndex& index) const
       itemFlags &= ~Qt::ItemIsDragEnabled;
     }
   }
-  if (index.column() < TaggedFileSystemModel::NUM_FILESYSTEM_COLUMNS) {
+  if (index.column() < TaggedFileSystemModel::NUM_FILESYSTEM_COLUMNS ||
+      (m_fsModel && index.column() == m_fsModel->coverArtColumn())) {
     // Prevent inplace editing (i.e. renaming) of files and directories.
     itemFlags &= ~Qt::ItemIsEditable;
   } else {
@@ -604,7 +605,7 @@ QString FileProxyModel::getPathIfIndexOfDir(const QModelIndex& index) {
  */
 TaggedFile* FileProxyModel::readWithId3V24(TaggedFile* taggedFile)
 {
-  const QPersistentModelIndex& index = taggedFile->getIndex();
+  const QModelIndex index = taggedFile->getIndex();
   if (TaggedFile* tagLibFile = TaggedFileSystemModel::createTaggedFile(
           TaggedFile::TF_ID3v24, taggedFile->getFilename(), index)) {
     if (index.isValid()) {
@@ -631,7 +632,7 @@ TaggedFile* FileProxyModel::readWithId3V24(TaggedFile* taggedFile)
  */
 TaggedFile* FileProxyModel::readWithId3V23(TaggedFile* taggedFile)
 {
-  const QPersistentModelIndex& index = taggedFile->getIndex();
+  const QModelIndex index = taggedFile->getIndex();
   if (TaggedFile* id3libFile = TaggedFileSystemModel::createTaggedFile(
           TaggedFile::TF_ID3v23, taggedFile->getFilename(), index)) {
     if (index.isValid()) {
@@ -684,7 +685,7 @@ TaggedFile* FileProxyModel::readWithId3V24IfId3V24(TaggedFile* taggedFile)
  */
 TaggedFile* FileProxyModel::readWithOggFlac(TaggedFile* taggedFile)
 {
-  const QPersistentModelIndex& index = taggedFile->getIndex();
+  const QModelIndex index = taggedFile->getIndex();
   if (TaggedFile* tagLibFile = TaggedFileSystemModel::createTaggedFile(
           TaggedFile::TF_OggFlac, taggedFile->getFilename(), index)) {
     if (index.isValid()) {
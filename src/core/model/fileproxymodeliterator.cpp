@@ -26,8 +26,20 @@
 
 #include "fileproxymodeliterator.h"
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QHash>
 #include "fileproxymodel.h"
 
+namespace {
+
+/**
+ * Maximum time in milliseconds to iterate before control is given back to
+ * the event loop to keep the GUI responsive.
+ */
+const qint64 TIME_SLICE_MS = 20;
+
+}
+
 /**
  * Constructor.
  *
@@ -71,7 +83,7 @@ void FileProxyModelIterator::clearAborted()
  */
 void FileProxyModelIterator::start(const QPersistentModelIndex& rootIdx)
 {
-  m_nodes.clear();
+  m_dirNodes.clear();
   m_rootIndexes.clear();
   m_rootIndexes.append(rootIdx);
   m_numDone = 0;
@@ -86,60 +98,132 @@ void FileProxyModelIterator::start(const QPersistentModelIndex& rootIdx)
  */
 void FileProxyModelIterator::start(const QList<QPersistentModelIndex>& indexes)
 {
-  m_nodes.clear();
+  m_dirNodes.clear();
   m_rootIndexes = indexes;
   m_numDone = 0;
   m_aborted = false;
   fetchNext();
 }
 
+/**
+ * Get amount of work to do.
+ * @return number of nodes which have to be processed.
+ */
+int FileProxyModelIterator::getWorkToDo() const
+{
+  int numNodes = m_rootIndexes.size();
+  for (const DirectoryNode& dirNode : m_dirNodes) {
+    numNodes += dirNode.children.size();
+  }
+  return numNodes;
+}
+
+/**
+ * Get index of next child of a directory.
+ * The row stored with the child name is checked, if the model has changed
+ * in the meantime, the rows of all remaining children are looked up again.
+ *
+ * @param dirNode directory node, children are removed if no longer in model
+ *
+ * @return index of last child in @a dirNode, invalid if no children left.
+ */
+QModelIndex FileProxyModelIterator::nextChildIndex(DirectoryNode& dirNode) const
+{
+  if (dirNode.children.isEmpty() || !dirNode.index.isValid()) {
+    dirNode.children.clear();
+    return QModelIndex();
+  }
+  const QPair<QString, int>& child = dirNode.children.constLast();
+  QModelIndex idx = m_model->index(child.second, 0, dirNode.index);
+  if (idx.isValid() && idx.data().toString() == child.first) {
+    return idx;
+  }
+
+  QHash<QString, int> rowOfName;
+  const int numRows = m_model->rowCount(dirNode.index);
+  rowOfName.reserve(numRows);
+  for (int row = 0; row < numRows; ++row) {
+    rowOfName.insert(m_model->index(row, 0, dirNode.index).data().toString(),
+                     row);
+  }
+  QVector<QPair<QString, int>> children;
+  children.reserve(dirNode.children.size());
+  for (const auto& nameRow : qAsConst(dirNode.children)) {
+    auto it = rowOfName.constFind(nameRow.first);
+    if (it != rowOfName.constEnd()) {
+      children.append({nameRow.first, *it});
+    }
+  }
+  dirNode.children.swap(children);
+  return dirNode.children.isEmpty()
+      ? QModelIndex()
+      : m_model->index(dirNode.children.constLast().second, 0, dirNode.index);
+}
+
 /**
  * Fetch next index.
  */
 void FileProxyModelIterator::fetchNext()
 {
-  int count = 0;
+  QElapsedTimer timer;
+  timer.start();
   while (!m_aborted) {
-    if (m_nodes.isEmpty()) {
+    QModelIndex idx;
+    if (m_dirNodes.isEmpty()) {
       if (m_rootIndexes.isEmpty()) {
         break;
-      } else {
-        m_nodes.push(m_rootIndexes.takeFirst());
       }
-    }
-    m_nextIdx = m_nodes.top();
-    if (m_nextIdx.isValid()) {
-      if (m_model->isDir(m_nextIdx) && m_model->canFetchMore(m_nextIdx)) {
-        connect(m_model, &FileProxyModel::sortingFinished,
-                this, &FileProxyModelIterator::onDirectoryLoaded);
-        m_model->fetchMore(m_nextIdx);
-        return;
+      idx = m_rootIndexes.first();
+      if (!idx.isValid()) {
+        m_rootIndexes.removeFirst();
+        continue;
       }
-      if (++count >= 10) {
-        // Avoid spinning too long to keep the GUI responsive.
-        QTimer::singleShot(0, this, &FileProxyModelIterator::fetchNext);
-        return;
+    } else {
+      idx = nextChildIndex(m_dirNodes.last());
+      if (!idx.isValid()) {
+        m_dirNodes.removeLast();
+        continue;
       }
-      m_nodes.pop();
-      ++m_numDone;
-      const int numRows = m_model->rowCount(m_nextIdx);
-      QStack<QPersistentModelIndex> childNodes;
-      childNodes.reserve(numRows);
+    }
+    if (m_model->isDir(idx) && m_model->canFetchMore(idx)) {
+      m_nextIdx = idx;
+      connect(m_model, &FileProxyModel::sortingFinished,
+              this, &FileProxyModelIterator::onDirectoryLoaded);
+      m_model->fetchMore(idx);
+      return;
+    }
+    if (timer.elapsed() >= TIME_SLICE_MS) {
+      // Avoid spinning too long to keep the GUI responsive.
+      QTimer::singleShot(0, this, &FileProxyModelIterator::fetchNext);
+      return;
+    }
+    if (m_dirNodes.isEmpty()) {
+      m_rootIndexes.removeFirst();
+    } else {
+      m_dirNodes.last().children.removeLast();
+    }
+    ++m_numDone;
+    const int numRows = m_model->rowCount(idx);
+    if (numRows > 0) {
+      // Get the names only once and sort them instead of the indexes.
+      DirectoryNode dirNode;
+      dirNode.index = idx;
+      dirNode.children.reserve(numRows);
       for (int row = numRows - 1; row >= 0; --row) {
-        childNodes.push(m_model->index(row, 0, m_nextIdx));
+        dirNode.children.append(
+          {m_model->index(row, 0, idx).data().toString(), row});
       }
-      std::stable_sort(childNodes.begin(), childNodes.end(),
-                  [](const QPersistentModelIndex& lhs,
-                     const QPersistentModelIndex& rhs) {
-        return lhs.data().toString().compare(rhs.data().toString()) > 0;
+      std::stable_sort(dirNode.children.begin(), dirNode.children.end(),
+                       [](const QPair<QString, int>& lhs,
+                          const QPair<QString, int>& rhs) {
+        return lhs.first.compare(rhs.first) > 0;
       });
-      m_nodes += childNodes;
-      emit nextReady(m_nextIdx);
-    } else {
-      m_nodes.pop();
+      m_dirNodes.append(dirNode);
     }
+    m_nextIdx = idx;
+    emit nextReady(m_nextIdx);
   }
-  m_nodes.clear();
+  m_dirNodes.clear();
   m_rootIndexes.clear();
   m_nextIdx = QPersistentModelIndex();
   emit nextReady(m_nextIdx);
@@ -27,7 +27,8 @@
 #pragma once
 
 #include <QObject>
-#include <QStack>
+#include <QVector>
+#include <QPair>
 #include <QPersistentModelIndex>
 #include "iabortable.h"
 #include "kid3api.h"
@@ -42,7 +43,7 @@ class FileProxyModel;
  * continuously and waits for them to be fetched. Therefore the routine
  * doing the actual work has to be connected with a slot and will be called
  * when file nodes are available. The iteration will also be suspended after
- * some files so that other slots can be processed and the GUI remains
+ * a time slice so that other slots can be processed and the GUI remains
  * responsive. If the iteration shall stop before all files are processed,
  * abort() shall be called.
  */
@@ -96,7 +97,7 @@ public:
    * Get amount of work to do.
    * @return number of nodes which have to be processed.
    */
-  int getWorkToDo() const { return m_nodes.size() + m_rootIndexes.size(); }
+  int getWorkToDo() const;
 
   /**
    * Get amount of work done.
@@ -124,8 +125,21 @@ private slots:
   void fetchNext();
 
 private:
+  /**
+   * Children of a directory which still have to be processed.
+   * Only the directory is referenced by a persistent index, the children
+   * are stored with their name and row, sorted in descending order of the
+   * names, so that the next child is at the end.
+   */
+  struct DirectoryNode {
+    QPersistentModelIndex index;
+    QVector<QPair<QString, int>> children;
+  };
+
+  QModelIndex nextChildIndex(DirectoryNode& dirNode) const;
+
   QList<QPersistentModelIndex> m_rootIndexes;
-  QStack<QPersistentModelIndex> m_nodes;
+  QVector<DirectoryNode> m_dirNodes;
   FileProxyModel* m_model;
   QPersistentModelIndex m_nextIdx;
   int m_numDone;
@@ -10,6 +10,7 @@
  * - Remove moc includes
  * - Remove dependencies to Qt5::Widgets
  * - Do not display a message box from setData(), this will crash without GUI
+ * - Data owned by nodes and lightweight node handles (Kid3 extension)
  */
 /****************************************************************************
 **
@@ -615,7 +616,7 @@ QModelIndex FileSystemModel::parent(const QModelIndex &index) const
     // get the parent's row
     FileSystemModelPrivate::FileSystemNode *grandParentNode = parentNode->parent;
     Q_ASSERT(grandParentNode->children.contains(parentNode->fileName));
-    int visualRow = d->translateVisibleLocation(grandParentNode, grandParentNode->visibleLocation(grandParentNode->children.value(parentNode->fileName)->fileName));
+    int visualRow = d->translateVisibleLocation(grandParentNode, grandParentNode->visibleLocation(parentNode));
     if (visualRow == -1)
         return QModelIndex();
     return createIndex(visualRow, 0, parentNode);
@@ -638,7 +639,7 @@ QModelIndex FileSystemModelPrivate::index(const FileSystemModelPrivate::FileSyst
     if (!node->isVisible)
         return QModelIndex();
 
-    int visualRow = translateVisibleLocation(parentNode, parentNode->visibleLocation(node->fileName));
+    int visualRow = translateVisibleLocation(parentNode, parentNode->visibleLocation(node));
     return q->createIndex(visualRow, column, const_cast<FileSystemNode*>(node));
 }
 
@@ -935,7 +936,7 @@ bool FileSystemModel::setData(const QModelIndex &idx, const QVariant &value, int
 
         FileSystemModelPrivate::FileSystemNode *indexNode = d->node(idx);
         FileSystemModelPrivate::FileSystemNode *parentNode = indexNode->parent;
-        int visibleLocation = parentNode->visibleLocation(parentNode->children.value(indexNode->fileName)->fileName);
+        int visibleLocation = parentNode->visibleLocation(indexNode);
 
         parentNode->visibleChildren.removeAt(visibleLocation);
         std::unique_ptr<FileSystemModelPrivate::FileSystemNode> nodeToRename(parentNode->children.take(oldName));
@@ -1143,6 +1144,7 @@ void FileSystemModelPrivate::sortChildren(int column, const QModelIndex &parent)
     std::sort(values.begin(), values.end(), ms);
     // First update the new visible list
     indexNode->visibleChildren.clear();
+    indexNode->staleLocationHintsFrom = INT_MAX;
     //No more dirty item we reset our internal dirty index
     indexNode->dirtyChildrenIndex = -1;
     const int numValues = values.count();
@@ -1150,6 +1152,7 @@ void FileSystemModelPrivate::sortChildren(int column, const QModelIndex &parent)
     for (int i = 0; i < numValues; ++i) {
         indexNode->visibleChildren.append(values.at(i)->fileName);
         values.at(i)->isVisible = true;
+        values.at(i)->visibleLocationHint = i;
     }
 
     if (!disableRecursiveSort) {
@@ -1336,6 +1339,144 @@ QString FileSystemModelPrivate::filePath(const QModelIndex &index) const
     return fullPath;
 }
 
+/*!
+    \internal
+
+    Kid3: Path of \a node, walks up the nodes without computing any rows.
+*/
+QString FileSystemModelPrivate::filePath(const FileSystemNode *node) const
+{
+    QStringList path;
+    while (node && node != &root) {
+        path.prepend(node->fileName);
+        node = node->parent;
+    }
+    QString fullPath = QDir::fromNativeSeparators(path.join(QDir::separator()));
+#if !defined(Q_OS_WIN)
+    if ((fullPath.length() > 2) && fullPath[0] == QLatin1Char('/') && fullPath[1] == QLatin1Char('/'))
+        fullPath = fullPath.mid(1);
+#else
+    if (fullPath.length() == 2 && fullPath.endsWith(QLatin1Char(':')))
+        fullPath.append(QLatin1Char('/'));
+#endif
+    return fullPath;
+}
+
+/*!
+    Kid3: Returns the data owned by the node of \a index, 0 if not set.
+*/
+FileSystemModel::NodeData *FileSystemModel::nodeData(const QModelIndex &index) const
+{
+    Q_D(const FileSystemModel);
+    if (!d->indexValid(index))
+        return Q_NULLPTR;
+    return d->node(index)->data;
+}
+
+/*!
+    Kid3: Set \a data owned by the node of \a index.
+    Existing data of the node is deleted. The data is deleted together with
+    the node, so no persistent index is needed to keep track of it.
+*/
+void FileSystemModel::setNodeData(const QModelIndex &index, NodeData *data)
+{
+    Q_D(FileSystemModel);
+    if (!d->indexValid(index)) {
+        delete data;
+        return;
+    }
+    FileSystemModelPrivate::FileSystemNode *indexNode = d->node(index);
+    if (indexNode->data != data) {
+        delete indexNode->data;
+        indexNode->data = data;
+    }
+}
+
+/*!
+    Kid3: Delete the data of all nodes.
+*/
+void FileSystemModel::clearNodeData()
+{
+    Q_D(FileSystemModel);
+    d->root.clearData();
+}
+
+/*!
+    Kid3: Returns the data of all nodes which have data.
+*/
+QList<FileSystemModel::NodeData *> FileSystemModel::allNodeData() const
+{
+    Q_D(const FileSystemModel);
+    QList<NodeData *> result;
+    d->root.collectData(result);
+    return result;
+}
+
+/*!
+    Kid3: Returns a handle for the node of \a index.
+    The handle stays valid until the node is removed, i.e. as long as data
+    set with setNodeData() exists, and is not affected by row changes.
+*/
+const void *FileSystemModel::nodeHandle(const QModelIndex &index)
+{
+    return index.isValid() ? index.internalPointer() : Q_NULLPTR;
+}
+
+/*!
+    Kid3: Returns the index of the node with \a handle.
+*/
+QModelIndex FileSystemModel::indexForNodeHandle(const void *handle, int column) const
+{
+    Q_D(const FileSystemModel);
+    return handle ? d->index(static_cast<const FileSystemModelPrivate::FileSystemNode *>(handle), column)
+                  : QModelIndex();
+}
+
+/*!
+    Kid3: Returns the path of the node with \a handle.
+*/
+QString FileSystemModel::filePathForNodeHandle(const void *handle) const
+{
+    Q_D(const FileSystemModel);
+    const FileSystemModelPrivate::FileSystemNode *dirNode =
+        static_cast<const FileSystemModelPrivate::FileSystemNode *>(handle);
+    QString fullPath = d->filePath(dirNode);
+    if (dirNode && dirNode->isSymLink()
+#ifndef QT_NO_FILESYSTEMWATCHER
+        && d->fileInfoGatherer.resolveSymlinks()
+#endif
+        && d->resolvedSymLinks.contains(fullPath)
+        && dirNode->isDir()) {
+        QFileInfo resolvedInfo(fullPath);
+        resolvedInfo = QFileInfo(resolvedInfo.canonicalFilePath());
+        if (resolvedInfo.exists())
+            return resolvedInfo.filePath();
+    }
+    return fullPath;
+}
+
+/*!
+    Kid3: Returns the file name of the node with \a handle.
+*/
+QString FileSystemModel::fileNameForNodeHandle(const void *handle) const
+{
+    return handle ? static_cast<const FileSystemModelPrivate::FileSystemNode *>(handle)->fileName
+                  : QString();
+}
+
+/*!
+    Kid3: Returns the handle of the parent node of the node with \a handle,
+    0 for top level nodes.
+*/
+const void *FileSystemModel::parentNodeHandle(const void *handle) const
+{
+    Q_D(const FileSystemModel);
+    const FileSystemModelPrivate::FileSystemNode *parentNode = handle
+        ? static_cast<const FileSystemModelPrivate::FileSystemNode *>(handle)->parent
+        : Q_NULLPTR;
+    return parentNode != &d->root ? parentNode : Q_NULLPTR;
+}
+
 /*!
     Create a directory with the \a name in the \a parent model index.
 */
@@ -1771,7 +1912,7 @@ void FileSystemModelPrivate::removeNode(FileSystemModelPrivate::FileSystemNode *
     QModelIndex parent = index(parentNode);
     bool indexHidden = isHiddenByFilter(parentNode, parent);
 
-    int vLocation = parentNode->visibleLocation(name);
+    int vLocation = parentNode->visibleLocation(parentNode->children.value(name));
     if (vLocation >= 0 && !indexHidden)
         q->beginRemoveRows(parent, translateVisibleLocation(parentNode, vLocation),
                                        translateVisibleLocation(parentNode, vLocation));
@@ -1782,10 +1923,15 @@ void FileSystemModelPrivate::removeNode(FileSystemModelPrivate::FileSystemNode *
         fileInfoGatherer.removePath(node->info->fileInfo().filePath());
     }
 #endif
+    // Kid3: Users of the node data, e.g. tagged files, may still be active
+    // when the file is removed, so the data is deleted later.
+    detachNodeData(node);
     delete node;
     // cleanup sort files after removing rather then re-sorting which is O(n)
-    if (vLocation >= 0)
+    if (vLocation >= 0) {
         parentNode->visibleChildren.removeAt(vLocation);
+        parentNode->visibleChildRemoved(vLocation);
+    }
     if (vLocation >= 0 && !indexHidden)
         q->endRemoveRows();
 }
@@ -1811,8 +1957,10 @@ void FileSystemModelPrivate::addVisibleFiles(FileSystemNode *parentNode, const Q
         parentNode->dirtyChildrenIndex = parentNode->visibleChildren.count();
 
     for (const auto &newFile : newFiles) {
+        FileSystemNode *newNode = parentNode->children.value(newFile);
+        newNode->visibleLocationHint = parentNode->visibleChildren.count();
         parentNode->visibleChildren.append(newFile);
-        parentNode->children.value(newFile)->isVisible = true;
+        newNode->isVisible = true;
     }
     if (!indexHidden)
       q->endInsertRows();
@@ -1837,6 +1985,7 @@ void FileSystemModelPrivate::removeVisibleFile(FileSystemNode *parentNode, int v
                                        translateVisibleLocation(parentNode, vLocation));
     parentNode->children.value(parentNode->visibleChildren.at(vLocation))->isVisible = false;
     parentNode->visibleChildren.removeAt(vLocation);
+    parentNode->visibleChildRemoved(vLocation);
     if (!indexHidden)
         q->endRemoveRows();
 }
@@ -1890,7 +2039,7 @@ void FileSystemModelPrivate::_q_fileSystemChanged(const QString &path, const QVe
                 }
             } else {
                 if (node->isVisible) {
-                    int visibleLocation = parentNode->visibleLocation(fileName);
+                    int visibleLocation = parentNode->visibleLocation(node);
                     removeVisibleFile(parentNode, visibleLocation);
                 } else {
                     // The file is not visible, don't do anything
@@ -1919,8 +2068,10 @@ void FileSystemModelPrivate::_q_fileSystemChanged(const QString &path, const QVe
         }*/
         max = value;
         min = value;
-        int visibleMin = parentNode->visibleLocation(min);
-        int visibleMax = parentNode->visibleLocation(max);
+        // Kid3: look up the row of the node instead of searching its name
+        const FileSystemNode *rowNode = parentNode->children.value(min);
+        int visibleMin = rowNode ? parentNode->visibleLocation(rowNode) : -1;
+        int visibleMax = visibleMin;
         if (visibleMin >= 0
             && visibleMin < parentNode->visibleChildren.count()
             && parentNode->visibleChildren.at(visibleMin) == min
@@ -1956,6 +2107,42 @@ void FileSystemModelPrivate::_q_resolvedName(const QString &fileName, const QStr
     resolvedSymLinks[fileName] = resolvedName;
 }
 
+/*!
+    \internal
+
+    Kid3: Detach the data of \a node and its children, so that it is not
+    deleted together with the nodes. The data is deleted from the event loop.
+*/
+void FileSystemModelPrivate::detachNodeData(FileSystemNode *node)
+{
+    if (node->data) {
+        node->data->nodeRemoved();
+        removedNodeData.append(node->data);
+        node->data = Q_NULLPTR;
+        if (!removedNodeDataTimer.isActive())
+            removedNodeDataTimer.start(0);
+    }
+#if QT_VERSION >= 0x050700
+    for (FileSystemNode *child : qAsConst(node->children))
+#else
+    const auto constChildren = node->children;
+    for (FileSystemNode *child : constChildren)
+#endif
+        detachNodeData(child);
+}
+
+/*!
+    \internal
+
+    Kid3: Delete the data of removed nodes.
+*/
+void FileSystemModelPrivate::deleteRemovedNodeData()
+{
+    const QList<FileSystemModel::NodeData *> nodeData = removedNodeData;
+    removedNodeData.clear();
+    qDeleteAll(nodeData);
+}
+
 void FileSystemModelPrivate::clear()
 {
     forceSort = true;
@@ -1965,6 +2152,8 @@ void FileSystemModelPrivate::clear()
     fileInfoGatherer.clear();
 #endif
     delayedSortTimer.stop();
+    removedNodeDataTimer.stop();
+    deleteRemovedNodeData();
     bypassFilters.clear();
     resolvedSymLinks.clear();
     root.clear();
@@ -1990,6 +2179,7 @@ void FileSystemModelPrivate::init()
                q, SIGNAL(directoryLoaded(QString)));
 #endif // !QT_NO_FILESYSTEMWATCHER
     q->connect(&delayedSortTimer, SIGNAL(timeout()), q, SLOT(_q_performDelayedSort()), Qt::QueuedConnection);
+    q->connect(&removedNodeDataTimer, &QTimer::timeout, q, [this]() { deleteRemovedNodeData(); });
 
 #if QT_VERSION >= 0x050f00
     roleNames.insert(FileSystemModel::FileIconRole, QByteArrayLiteral("fileIcon")); // == Qt::decoration
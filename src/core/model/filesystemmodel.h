@@ -9,6 +9,7 @@
  * - Allow compilation without Qt private headers (USE_QT_PRIVATE_HEADERS)
  * - Replace include guards by #pragma once
  * - Remove dependencies to Qt5::Widgets
+ * - Data owned by nodes and lightweight node handles (Kid3 extension)
  */
 /****************************************************************************
 **
@@ -158,6 +159,24 @@ public:
     QFileInfo fileInfo(const QModelIndex &index) const;
     bool remove(const QModelIndex &index);
 
+    // Kid3 extension: data owned by nodes and lightweight node handles
+    class NodeData {
+    public:
+        virtual ~NodeData() = default;
+        // Called when the node is removed, the data is deleted later from
+        // the event loop.
+        virtual void nodeRemoved() {}
+    };
+    NodeData *nodeData(const QModelIndex &index) const;
+    void setNodeData(const QModelIndex &index, NodeData *data);
+    void clearNodeData();
+    QList<NodeData *> allNodeData() const;
+    static const void *nodeHandle(const QModelIndex &index);
+    QModelIndex indexForNodeHandle(const void *handle, int column = 0) const;
+    QString filePathForNodeHandle(const void *handle) const;
+    QString fileNameForNodeHandle(const void *handle) const;
+    const void *parentNodeHandle(const void *handle) const;
+
 #if QT_VERSION < 0x050f00
     static QString wildcardToRegularExpression(const QString &pattern);
 #endif
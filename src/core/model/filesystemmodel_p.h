@@ -10,6 +10,7 @@
  * - Allow compilation with Qt versions < 5.7
  * - Replace include guards by #pragma once
  * - Remove dependencies to Qt5::Widgets
+ * - Data owned by nodes and lightweight node handles (Kid3 extension)
  */
 /****************************************************************************
 **
@@ -74,6 +75,7 @@
 #include <qfileinfo.h>
 #include <qtimer.h>
 #include <qhash.h>
+#include <climits>
 #include "abstractfiledecorationprovider.h"
 
 class ExtendedInformation;
@@ -112,11 +114,13 @@ public:
     {
     public:
         explicit FileSystemNode(const QString &filename = QString(), FileSystemNode *p = 0)
-            : fileName(filename), populatedChildren(false), isVisible(false), dirtyChildrenIndex(-1), parent(p), info(0) {}
+            : fileName(filename), populatedChildren(false), isVisible(false), dirtyChildrenIndex(-1), parent(p), info(0), data(0), visibleLocationHint(-1), staleLocationHintsFrom(INT_MAX) {}
         ~FileSystemNode() {
             qDeleteAll(children);
             delete info;
             info = 0;
+            delete data;
+            data = 0;
             parent = 0;
         }
         void clear() {
@@ -126,10 +130,35 @@ public:
             qDeleteAll(children);
             children.clear();
             visibleChildren.clear();
+            staleLocationHintsFrom = INT_MAX;
             dirtyChildrenIndex = -1;
             parent = Q_NULLPTR;
             delete info;
             info = Q_NULLPTR;
+            delete data;
+            data = Q_NULLPTR;
+        }
+        void clearData() {
+            delete data;
+            data = Q_NULLPTR;
+#if QT_VERSION >= 0x050700
+            for (FileSystemNode *child : qAsConst(children))
+#else
+            const auto constChildren = children;
+            for (FileSystemNode *child : constChildren)
+#endif
+                child->clearData();
+        }
+        void collectData(QList<FileSystemModel::NodeData *> &result) const {
+            if (data)
+                result.append(data);
+#if QT_VERSION >= 0x050700
+            for (const FileSystemNode *child : qAsConst(children))
+#else
+            const auto constChildren = children;
+            for (const FileSystemNode *child : constChildren)
+#endif
+                child->collectData(result);
         }
 
         QString fileName;
@@ -198,6 +227,38 @@ public:
         inline int visibleLocation(const QString &childName) {
             return visibleChildren.indexOf(childName);
         }
+        // Kid3: location of child in visibleChildren, the location stored
+        // with the child avoids a linear search in large folders. The
+        // locations behind removed rows are renumbered once on the next
+        // lookup, so that bulk removals do not cause a search per child.
+        inline int visibleLocation(const FileSystemNode *child) const {
+            if (!child)
+                return -1;
+            const int count = visibleChildren.count();
+            if (staleLocationHintsFrom < count &&
+                child->visibleLocationHint >= staleLocationHintsFrom)
+                renumberLocationHints();
+            const int hint = child->visibleLocationHint;
+            if (hint >= 0 && hint < count && visibleChildren.at(hint) == child->fileName)
+                return hint;
+            const int location = visibleChildren.indexOf(child->fileName);
+            child->visibleLocationHint = location;
+            return location;
+        }
+        // Kid3: to be called when visibleChildren.at(location) is removed
+        inline void visibleChildRemoved(int location) {
+            if (location < staleLocationHintsFrom)
+                staleLocationHintsFrom = location;
+        }
+        // Kid3: set the location hints of the children behind removed rows
+        void renumberLocationHints() const {
+            const int count = visibleChildren.count();
+            for (int i = staleLocationHintsFrom; i < count; ++i) {
+                if (FileSystemNode *node = children.value(visibleChildren.at(i)))
+                    node->visibleLocationHint = i;
+            }
+            staleLocationHintsFrom = INT_MAX;
+        }
         void updateIcon(AbstractFileDecorationProvider *iconProvider, const QString &path) {
             if (!iconProvider)
                 return;
@@ -251,6 +312,13 @@ public:
 
 
         ExtendedInformation *info;
+        // Kid3: data owned by node, e.g. the tagged file
+        FileSystemModel::NodeData *data;
+        // Kid3: last known location in parent->visibleChildren
+        mutable int visibleLocationHint;
+        // Kid3: first location in visibleChildren whose children have
+        // outdated location hints, INT_MAX if all are up to date
+        mutable int staleLocationHintsFrom;
 
     };
 
@@ -273,6 +341,11 @@ public:
 #endif
     {
         delayedSortTimer.setSingleShot(true);
+        removedNodeDataTimer.setSingleShot(true);
+    }
+
+    ~FileSystemModelPrivate() {
+        qDeleteAll(removedNodeData);
     }
 
     void clear();
@@ -331,6 +404,7 @@ public:
     QString name(const QModelIndex &index) const;
     QString displayName(const QModelIndex &index) const;
     QString filePath(const QModelIndex &index) const;
+    QString filePath(const FileSystemNode *node) const;
     QString size(const QModelIndex &index) const;
     static QString size(qint64 bytes);
     QString type(const QModelIndex &index) const;
@@ -340,6 +414,8 @@ public:
     void _q_performDelayedSort();
     void _q_fileSystemChanged(const QString &path, const QVector<QPair<QString, QFileInfo> > &);
     void _q_resolvedName(const QString &fileName, const QString &resolvedName);
+    void detachNodeData(FileSystemNode *node);
+    void deleteRemovedNodeData();
 
     static int naturalCompare(const QString &s1, const QString &s2, Qt::CaseSensitivity cs);
 
@@ -356,6 +432,9 @@ public:
     FileInfoGatherer fileInfoGatherer;
 #endif
     QTimer delayedSortTimer;
+    // Kid3: data of removed nodes, deleted from the event loop
+    QList<FileSystemModel::NodeData *> removedNodeData;
+    QTimer removedNodeDataTimer;
     bool forceSort;
     int sortColumn;
     Qt::SortOrder sortOrder;
@@ -32,11 +32,14 @@ namespace {
 
 QStringList createGenreItems()
 {
-  QStringList items;
-  for (const char** sl = Genres::s_strList; *sl != nullptr; ++sl) {
-    items.append(QString::fromLatin1(*sl)); // clazy:exclude=reserve-candidates
-  }
-  return items;
+  static const QStringList genreItems = [] {
+    QStringList items;
+    for (const char** sl = Genres::s_strList; *sl != nullptr; ++sl) {
+      items.append(QString::fromLatin1(*sl)); // clazy:exclude=reserve-candidates
+    }
+    return items;
+  }();
+  return genreItems;
 }
 
 }
@@ -50,12 +53,17 @@ GenreModel::GenreModel(bool id3v1, QObject* parent)
 {
   setObjectName(QLatin1String("GenreModel"));
   init();
+  const TagConfig& tagCfg = TagConfig::instance();
+  connect(&tagCfg, &TagConfig::customGenresChanged, this, &GenreModel::init);
+  connect(&tagCfg, &TagConfig::onlyCustomGenresChanged,
+          this, &GenreModel::init);
 }
 
 /**
  * Initialize module with genres.
- * This method is called by the constructor. It shall be called after
- * construction if genre settings are changed.
+ * This method is called by the constructor and when the custom genres
+ * in the tag configuration are changed. Only the rows which differ
+ * from the current genres are replaced.
  */
 void GenreModel::init()
 {
@@ -81,7 +89,36 @@ void GenreModel::init()
       items.append(*it);
     }
   }
-  setStringList(items);
+  updateGenres(items);
+}
+
+/**
+ * Replace the genres without resetting the model.
+ * The rows before the first changed genre, i.e. usually the standard
+ * genres, are kept, so that views do not lose their state.
+ * @param items genres
+ */
+void GenreModel::updateGenres(const QStringList& items)
+{
+  const QStringList oldItems = stringList();
+  if (items == oldItems)
+    return;
+
+  const int numRows = qMin(items.size(), oldItems.size());
+  int row = 0;
+  while (row < numRows && items.at(row) == oldItems.at(row)) {
+    ++row;
+  }
+  if (oldItems.size() > items.size()) {
+    removeRows(items.size(), oldItems.size() - items.size());
+  } else if (items.size() > oldItems.size()) {
+    insertRows(oldItems.size(), items.size() - oldItems.size());
+  }
+  for (; row < items.size(); ++row) {
+    if (row >= oldItems.size() || items.at(row) != oldItems.at(row)) {
+      setData(index(row, 0), items.at(row), Qt::EditRole);
+    }
+  }
 }
 
 /**
@@ -102,9 +139,7 @@ int GenreModel::getRowForGenre(const QString& genreStr)
     customIndex = Genres::count + 1;
   }
   if (genreIndex <= 0) {
-    QModelIndexList indexes = match(index(0, 0), Qt::DisplayRole, genreStr, 1,
-                                    Qt::MatchExactly | Qt::MatchCaseSensitive);
-    genreIndex = indexes.isEmpty() ? -1 : indexes.first().row();
+    genreIndex = stringList().indexOf(genreStr);
     if (genreIndex < 0) {
       genreIndex = customIndex;
       setData(index(genreIndex, 0), genreStr, Qt::EditRole);
@@ -49,8 +49,9 @@ public:
 
   /**
    * Initialize module with genres.
-   * This method is called by the constructor. It shall be called after
-   * construction if genre settings are changed.
+   * This method is called by the constructor and when the custom genres
+   * in the tag configuration are changed. Only the rows which differ
+   * from the current genres are replaced.
    */
   void init();
 
@@ -63,5 +64,7 @@ public:
   Q_INVOKABLE int getRowForGenre(const QString& genreStr);
 
 private:
+  void updateGenres(const QStringList& items);
+
   bool m_id3v1;
 };
@@ -38,6 +38,7 @@
 #include <QCoreApplication>
 #include <QPluginLoader>
 #include <QElapsedTimer>
+#include <QJsonObject>
 #include <QUrl>
 #ifdef Q_OS_MAC
 #include <CoreFoundation/CFURL.h>
@@ -66,11 +67,15 @@
 #include "textimporter.h"
 #include "importparser.h"
 #include "textexporter.h"
+#include "picturenormalizer.h"
+#include "tagprefetcher.h"
 #include "serverimporter.h"
 #include "saferename.h"
 #include "configstore.h"
 #include "formatconfig.h"
 #include "tagconfig.h"
+#include "tagmemorytracker.h"
+#include "tracer.h"
 #include "fileconfig.h"
 #include "importconfig.h"
 #include "guiconfig.h"
@@ -113,6 +118,27 @@ QString pluginFileName(const QString& pluginName)
   return fileName;
 }
 
+/**
+ * Get the name of a plugin which can be loaded on demand.
+ * Plugins declare their name in the meta data which can be read without
+ * loading the plugin library. Only importers and user command processors,
+ * which are not needed to open files, are loaded on demand.
+ * @param metaData meta data from plugin loader
+ * @return plugin name, empty if the plugin has to be loaded at startup.
+ */
+QString deferrablePluginName(const QJsonObject& metaData)
+{
+  const QString iid = metaData.value(QLatin1String("IID")).toString();
+  if (iid == QLatin1String(qobject_interface_iid<IServerImporterFactory*>()) ||
+      iid == QLatin1String(
+        qobject_interface_iid<IServerTrackImporterFactory*>()) ||
+      iid == QLatin1String(qobject_interface_iid<IUserCommandProcessor*>())) {
+    return metaData.value(QLatin1String("MetaData")).toObject()
+        .value(QLatin1String("name")).toString();
+  }
+  return QString();
+}
+
 /**
  * Get text encoding from tag config as frame text encoding.
  * @return frame text encoding.
@@ -270,6 +296,10 @@ Kid3Application::Kid3Application(ICorePlatformTools* platformTools,
   m_tagSearcher(new TagSearcher(this)),
   m_dirRenamer(new DirRenamer(this)),
   m_batchImporter(new BatchImporter(m_netMgr)),
+  m_coverArtExporter(new CoverArtExporter(this)),
+  m_tagPrefetcher(new TagPrefetcher(m_fileSelectionModel,
+                                    m_fileSystemModel->tagMemoryTracker(),
+                                    this)),
   m_player(nullptr),
   m_expressionFileFilter(nullptr),
   m_downloadImageDest(ImageForSelectedFiles),
@@ -284,7 +314,8 @@ Kid3Application::Kid3Application(ICorePlatformTools* platformTools,
 #ifdef HAVE_QTDBUS
   m_dbusEnabled(false),
 #endif
-  m_filtered(false), m_selectionOperationRunning(false)
+  m_filtered(false), m_selectionOperationRunning(false),
+  m_pictureConversionWarned(false)
 {
   const TagConfig& tagCfg = TagConfig::instance();
   FOR_ALL_TAGS(tagNr) {
@@ -311,6 +342,8 @@ Kid3Application::Kid3Application(ICorePlatformTools* platformTools,
   m_fileSystemModel->setReadOnly(false);
   const FileConfig& fileCfg = FileConfig::instance();
   m_fileSystemModel->setSortIgnoringPunctuation(fileCfg.sortIgnoringPunctuation());
+  connect(&fileCfg, &FileConfig::traceFileChanged,
+          this, &Kid3Application::setTraceFile);
   m_fileProxyModel->setSourceModel(m_fileSystemModel);
   m_dirProxyModel->setSourceModel(m_fileSystemModel);
   connect(m_fileSelectionModel,
@@ -319,6 +352,11 @@ Kid3Application::Kid3Application(ICorePlatformTools* platformTools,
   connect(m_fileSelectionModel,
           &QItemSelectionModel::selectionChanged,
           this, &Kid3Application::fileSelectionChanged);
+  connect(m_fileSelectionModel,
+          &QItemSelectionModel::currentChanged,
+          this, &Kid3Application::prefetchTagsOfNextFiles);
+  connect(&fileCfg, &FileConfig::tagPrefetchCountChanged,
+          m_tagPrefetcher, &TagPrefetcher::setCount);
   connect(m_fileProxyModel, &FileProxyModel::modifiedChanged,
           this, &Kid3Application::modifiedChanged);
 
@@ -327,6 +365,9 @@ Kid3Application::Kid3Application(ICorePlatformTools* platformTools,
   connect(m_selection, &TaggedFileSelection::fileNameModified,
           this, &Kid3Application::selectedFilesUpdated);
 
+  connect(m_batchImporter, &BatchImporter::reportImportEvent,
+          this, &Kid3Application::onBatchImportEvent);
+
   initPlugins();
   m_batchImporter->setImporters(m_importers, m_trackDataModel);
 
@@ -358,6 +399,23 @@ Kid3Application::~Kid3Application()
     m_player->setParent(0);
   }
 #endif
+  Tracer::instance().stop();
+}
+
+/**
+ * Start or stop tracing when the trace file is configured.
+ * A running trace is written when it is stopped.
+ * @param filePath path to trace file, empty to stop tracing
+ */
+void Kid3Application::setTraceFile(const QString& filePath)
+{
+  Tracer& tracer = Tracer::instance();
+  if (tracer.isActive() && tracer.filePath() != filePath) {
+    tracer.stop();
+  }
+  if (!filePath.isEmpty() && !tracer.isActive()) {
+    tracer.start(filePath);
+  }
 }
 
 /**
@@ -420,7 +478,7 @@ void Kid3Application::initPlugins()
   TagConfig& tagCfg = TagConfig::instance();
   importCfg.clearAvailablePlugins();
   tagCfg.clearAvailablePlugins();
-  const auto plugins = loadPlugins();
+  const auto plugins = loadPlugins(&m_deferredPluginPaths);
   for (QObject* plugin : plugins) {
     checkPlugin(plugin);
   }
@@ -496,9 +554,13 @@ void Kid3Application::setPluginsPathFallback(const QString& path)
 
 /**
  * Load plugins.
+ * @param deferredPluginPaths if not null, plugins which are not needed
+ * at startup (importers, user command processors) and provide their name
+ * in the plugin meta data are not loaded, their paths are appended to
+ * this list instead
  * @return list of plugin instances.
  */
-QObjectList Kid3Application::loadPlugins()
+QObjectList Kid3Application::loadPlugins(QStringList* deferredPluginPaths)
 {
   QObjectList plugins = QPluginLoader::staticInstances();
 
@@ -541,6 +603,17 @@ QObjectList Kid3Application::loadPlugins()
         continue;
       }
       QPluginLoader loader(pluginsDir.absoluteFilePath(fileName));
+      if (deferredPluginPaths) {
+        // Reading the meta data does not load the plugin library.
+        QString name = deferrablePluginName(loader.metaData());
+        if (!name.isEmpty()) {
+          availablePlugins.append(name);
+          if (!disabledPlugins.contains(name)) {
+            deferredPluginPaths->append(loader.fileName());
+          }
+          continue;
+        }
+      }
       QObject* plugin = loader.instance();
       if (plugin) {
         QString name(plugin->objectName());
@@ -571,8 +644,10 @@ void Kid3Application::checkPlugin(QObject* plugin)
       qobject_cast<IServerImporterFactory*>(plugin)) {
     ImportConfig& importCfg = ImportConfig::instance();
     QStringList availablePlugins = importCfg.availablePlugins();
-    availablePlugins.append(plugin->objectName());
-    importCfg.setAvailablePlugins(availablePlugins);
+    if (!availablePlugins.contains(plugin->objectName())) {
+      availablePlugins.append(plugin->objectName());
+      importCfg.setAvailablePlugins(availablePlugins);
+    }
     if (!importCfg.disabledPlugins().contains(plugin->objectName())) {
       const auto keys = importerFactory->serverImporterKeys();
       for (const QString& key : keys) {
@@ -585,8 +660,10 @@ void Kid3Application::checkPlugin(QObject* plugin)
       qobject_cast<IServerTrackImporterFactory*>(plugin)) {
     ImportConfig& importCfg = ImportConfig::instance();
     QStringList availablePlugins = importCfg.availablePlugins();
-    availablePlugins.append(plugin->objectName());
-    importCfg.setAvailablePlugins(availablePlugins);
+    if (!availablePlugins.contains(plugin->objectName())) {
+      availablePlugins.append(plugin->objectName());
+      importCfg.setAvailablePlugins(availablePlugins);
+    }
     if (!importCfg.disabledPlugins().contains(plugin->objectName())) {
       const auto keys = importerFactory->serverTrackImporterKeys();
       for (const QString& key : keys) {
@@ -616,20 +693,73 @@ void Kid3Application::checkPlugin(QObject* plugin)
       qobject_cast<IUserCommandProcessor*>(plugin)) {
     ImportConfig& importCfg = ImportConfig::instance();
     QStringList availablePlugins = importCfg.availablePlugins();
-    availablePlugins.append(plugin->objectName());
-    importCfg.setAvailablePlugins(availablePlugins);
+    if (!availablePlugins.contains(plugin->objectName())) {
+      availablePlugins.append(plugin->objectName());
+      importCfg.setAvailablePlugins(availablePlugins);
+    }
     if (!importCfg.disabledPlugins().contains(plugin->objectName())) {
       m_userCommandProcessors.append(userCommandProcessor);
     }
   }
 }
 
+/**
+ * Load plugins which were deferred at startup and register them.
+ * Does nothing if all plugins are already loaded.
+ */
+void Kid3Application::loadDeferredPlugins()
+{
+  if (m_deferredPluginPaths.isEmpty())
+    return;
+
+  const QStringList pluginPaths = m_deferredPluginPaths;
+  m_deferredPluginPaths.clear();
+  for (const QString& pluginPath : pluginPaths) {
+    QPluginLoader loader(pluginPath);
+    if (QObject* plugin = loader.instance()) {
+      checkPlugin(plugin);
+    }
+  }
+  m_batchImporter->setImporters(m_importers, m_trackDataModel);
+}
+
+/**
+ * Get available server importers.
+ * @return list of server importers.
+ */
+QList<ServerImporter*> Kid3Application::getServerImporters()
+{
+  loadDeferredPlugins();
+  return m_importers;
+}
+
+/**
+ * Get available server track importers.
+ * @return list of server track importers.
+ */
+QList<ServerTrackImporter*> Kid3Application::getServerTrackImporters()
+{
+  loadDeferredPlugins();
+  return m_trackImporters;
+}
+
+/**
+ * Get available user command processors.
+ * @return list of user command processors.
+ */
+QList<IUserCommandProcessor*> Kid3Application::getUserCommandProcessors()
+{
+  loadDeferredPlugins();
+  return m_userCommandProcessors;
+}
+
 /**
  * Get names of available server track importers.
  * @return list of server track importer names.
  */
-QStringList Kid3Application::getServerImporterNames() const
+QStringList Kid3Application::getServerImporterNames()
 {
+  loadDeferredPlugins();
   QStringList names;
   const auto importers = m_importers;
   for (const ServerImporter* importer : importers) {
@@ -784,6 +914,8 @@ void Kid3Application::applyChangedConfiguration()
   if (filter != oldFilter) {
     m_fileSystemModel->setFilter(filter);
   }
+  m_fileSystemModel->setTagMemoryBudget(
+        static_cast<qint64>(fileCfg.tagMemoryBudget()) * 1024 * 1024);
 }
 
 /**
@@ -812,6 +944,14 @@ void Kid3Application::readConfig()
   const TagConfig& tagCfg = TagConfig::instance();
   FrameCollection::setQuickAccessFrames(tagCfg.quickAccessFrames());
   Frame::setNamesForCustomFrames(tagCfg.customFrames());
+  m_fileSystemModel->setTagMemoryBudget(
+        static_cast<qint64>(FileConfig::instance().tagMemoryBudget()) *
+        1024 * 1024);
+  m_tagPrefetcher->setCount(FileConfig::instance().tagPrefetchCount());
+  // A trace started with a command line option is not stopped here.
+  if (!FileConfig::instance().traceFile().isEmpty()) {
+    setTraceFile(FileConfig::instance().traceFile());
+  }
 }
 
 /**
@@ -826,6 +966,8 @@ void Kid3Application::readConfig()
  */
 bool Kid3Application::openDirectory(const QStringList& paths, bool fileCheck)
 {
+  TraceSpan span("openDirectory");
+  m_tagPrefetcher->clear();
 #ifdef Q_OS_ANDROID
   const QStringList musicLocations =
       QStandardPaths::standardLocations(QStandardPaths::MusicLocation).mid(0, 1);
@@ -1045,77 +1187,27 @@ QModelIndex Kid3Application::currentOrRootIndex() const
  */
 QStringList Kid3Application::saveDirectory(QStringList* errorDescriptions)
 {
+  TraceSpan span("saveDirectory");
   QStringList errorFiles;
-  int numFiles = 0, totalFiles = 0;
+  int numFiles = 0;
   // Get number of files to be saved to display correct progressbar
-  TaggedFileIterator countIt(m_fileProxyModelRootIndex);
-  while (countIt.hasNext()) {
-    if (countIt.next()->isChanged()) {
-      ++totalFiles;
-    }
-  }
+  const QList<TaggedFile*> changedFiles = getChangedFiles();
+  int totalFiles = changedFiles.size();
   QString operationName = tr("Saving folder...");
   bool aborted = false;
   emit longRunningOperationProgress(operationName, -1, totalFiles, &aborted);
 
+  prepareChangedFilesForSaving(changedFiles);
+
   if (errorDescriptions) {
     errorDescriptions->clear();
   }
-  TaggedFileIterator it(m_fileProxyModelRootIndex);
-  while (it.hasNext()) {
-    TaggedFile* taggedFile = it.next();
-    QString fileName = taggedFile->getFilename();
-    if (taggedFile->isFilenameChanged() &&
-        Utils::replaceIllegalFileNameCharacters(fileName)) {
-      taggedFile->setFilename(fileName);
-    }
-    bool renamed = false;
-    if (errorDescriptions) {
-      errno = 0;
-    }
-    if (taggedFile->isChanged() &&
-        !taggedFile->writeTags(false, &renamed,
-                               FileConfig::instance().preserveTime())) {
-      QDir dir(taggedFile->getDirname());
-      if (dir.exists(fileName) && taggedFile->isFilenameChanged()) {
-        // File is renamed to a file name which already exists.
-        // Try another file name ending with a number.
-        QString baseName = fileName;
-        QString ext;
-        int dotPos = baseName.lastIndexOf(QLatin1Char('.'));
-        if (dotPos != -1) {
-          ext = baseName.mid(dotPos);
-          baseName.truncate(dotPos);
-        }
-        baseName.append(QLatin1Char('('));
-        ext.prepend(QLatin1Char(')'));
-        bool ok = false;
-        for (int nr = 1; nr < 100; ++nr) {
-          QString newName = baseName + QString::number(nr) + ext;
-          if (!dir.exists(newName)) {
-            taggedFile->setFilename(newName);
-            ok = taggedFile->writeTags(false, &renamed,
-                                       FileConfig::instance().preserveTime());
-            break;
-          }
-        }
-        if (ok) {
-          continue;
-        } else {
-          taggedFile->setFilename(fileName);
-        }
-      }
-      QString errorMsg = taggedFile->getAbsFilename();
-      errorFiles.push_back(errorMsg);
+  for (TaggedFile* taggedFile : changedFiles) {
+    QString errorDescription;
+    if (!saveTaggedFile(taggedFile,
+                        errorDescriptions ? &errorDescription : nullptr)) {
+      errorFiles.push_back(taggedFile->getAbsFilename());
       if (errorDescriptions) {
-        QString errorDescription;
-        const int errnum = errno;
-        if (errnum) {
-          const char* errdesc = ::strerror(errnum);
-          if (errdesc) {
-            errorDescription = QString::fromUtf8(errdesc);
-          }
-        }
         errorDescriptions->append(errorDescription);
       }
     }
@@ -1136,6 +1228,119 @@ QStringList Kid3Application::saveDirectory(QStringList* errorDescriptions)
   return errorFiles;
 }
 
+/**
+ * Get all changed files in the current directory.
+ * @return changed files.
+ */
+QList<TaggedFile*> Kid3Application::getChangedFiles() const
+{
+  QList<TaggedFile*> changedFiles;
+  TaggedFileIterator it(m_fileProxyModelRootIndex);
+  while (it.hasNext()) {
+    TaggedFile* taggedFile = it.next();
+    if (taggedFile->isChanged()) {
+      changedFiles.append(taggedFile);
+    }
+  }
+  return changedFiles;
+}
+
+/**
+ * Prepare changed files before they are saved with saveTaggedFile().
+ * Pictures are normalized if configured. If the platform cannot convert
+ * pictures (e.g. kid3-cli without QtGui), a warning is printed once and
+ * the pictures are saved unchanged.
+ *
+ * @param changedFiles files returned by getChangedFiles()
+ */
+void Kid3Application::prepareChangedFilesForSaving(
+    const QList<TaggedFile*>& changedFiles)
+{
+  if (TagConfig::instance().normalizePictures() && !changedFiles.isEmpty()) {
+    if (!m_platformTools->canConvertPicture()) {
+      if (!m_pictureConversionWarned) {
+        qWarning("Pictures are not resized and recompressed, "
+                 "picture conversion is not available.");
+        m_pictureConversionWarned = true;
+      }
+      return;
+    }
+    if (!m_pictureNormalizer) {
+      m_pictureNormalizer.reset(new PictureNormalizer(m_platformTools));
+    }
+    m_pictureNormalizer->normalizePictures(changedFiles);
+  }
+}
+
+/**
+ * Save a single changed file.
+ * If the file shall be renamed to a name which already exists, a number
+ * is appended to the file name.
+ *
+ * @param taggedFile file to save
+ * @param errorDescription if not null, the error description is returned
+ * here, a null string if none is available
+ *
+ * @return true if ok or not changed, false if the file could not be written.
+ */
+bool Kid3Application::saveTaggedFile(TaggedFile* taggedFile,
+                                     QString* errorDescription)
+{
+  QString fileName = taggedFile->getFilename();
+  if (taggedFile->isFilenameChanged() &&
+      Utils::replaceIllegalFileNameCharacters(fileName)) {
+    taggedFile->setFilename(fileName);
+  }
+  bool renamed = false;
+  if (errorDescription) {
+    errno = 0;
+  }
+  if (!taggedFile->isChanged() ||
+      taggedFile->writeTags(false, &renamed,
+                            FileConfig::instance().preserveTime())) {
+    return true;
+  }
+  QDir dir(taggedFile->getDirname());
+  if (dir.exists(fileName) && taggedFile->isFilenameChanged()) {
+    // File is renamed to a file name which already exists.
+    // Try another file name ending with a number.
+    QString baseName = fileName;
+    QString ext;
+    int dotPos = baseName.lastIndexOf(QLatin1Char('.'));
+    if (dotPos != -1) {
+      ext = baseName.mid(dotPos);
+      baseName.truncate(dotPos);
+    }
+    baseName.append(QLatin1Char('('));
+    ext.prepend(QLatin1Char(')'));
+    bool ok = false;
+    for (int nr = 1; nr < 100; ++nr) {
+      QString newName = baseName + QString::number(nr) + ext;
+      if (!dir.exists(newName)) {
+        taggedFile->setFilename(newName);
+        ok = taggedFile->writeTags(false, &renamed,
+                                   FileConfig::instance().preserveTime());
+        break;
+      }
+    }
+    if (ok) {
+      return true;
+    }
+    taggedFile->setFilename(fileName);
+  }
+  if (errorDescription) {
+    errorDescription->clear();
+    const int errnum = errno;
+    if (errnum) {
+      const char* errdesc = ::strerror(errnum);
+      if (errdesc) {
+        *errorDescription = QString::fromUtf8(errdesc);
+      }
+    }
+  }
+  return false;
+}
+
 /**
  * Save all changed files.
  * longRunningOperationProgress() is emitted while saving files.
@@ -1251,6 +1456,7 @@ void Kid3Application::selectedTagsToFrameModels(const QItemSelection& selected)
 bool Kid3Application::addTaggedFilesToSelection(
     const QList<QPersistentModelIndex>& indexes, bool startSelection)
 {
+  TraceSpan span("selectFiles");
   // It would crash if this is called while a long running selection operation
   // is in progress.
   if (m_selectionOperationRunning)
@@ -1268,9 +1474,12 @@ bool Kid3Application::addTaggedFilesToSelection(
   int longRunningTotal = 0;
   int done = 0;
   bool aborted = false;
+  TagMemoryTracker* tagMemoryTracker = m_fileSystemModel->tagMemoryTracker();
+  QSet<TaggedFile*> selectedFiles;
   for (auto it = indexes.constBegin(); it != indexes.constEnd(); ++it, ++done) {
     if (TaggedFile* taggedFile = FileProxyModel::getTaggedFileOfIndex(*it)) {
       m_selection->addTaggedFile(taggedFile);
+      selectedFiles.insert(taggedFile);
       if (!longRunningTotal) {
         if (timer.elapsed() >= 3000) {
           longRunningTotal = indexes.size();
@@ -1292,6 +1501,14 @@ bool Kid3Application::addTaggedFilesToSelection(
   }
 
   m_selection->endAddTaggedFiles();
+  // The tags of selected files must not be cleared while they are edited.
+  // They are also pinned while accounting is disabled, so that they are
+  // kept when a budget is set at runtime.
+  if (startSelection) {
+    tagMemoryTracker->setPinnedFiles(selectedFiles);
+  } else {
+    tagMemoryTracker->addPinnedFiles(selectedFiles);
+  }
 
   if (TaggedFile* taggedFile = m_selection->singleFile()) {
     FOR_ALL_TAGS(tagNr) {
@@ -1740,11 +1957,14 @@ void Kid3Application::downloadImage(const QString& url, bool allFilesInDir)
 void Kid3Application::batchImport(const BatchImportProfile& profile,
                                   Frame::TagVersion tagVersion)
 {
+  loadDeferredPlugins();
   m_batchImportProfile = &profile;
   m_batchImportTagVersion = tagVersion;
   m_batchImportAlbums.clear();
   m_batchImportTrackDataList.clear();
   m_lastProcessedDirName.clear();
+  m_fileSystemModel->tagMemoryTracker()->releaseOperationFiles(
+        m_batchImporter);
   m_batchImporter->clearAborted();
   m_batchImporter->emitReportImportEvent(BatchImporter::ReadingDirectory,
                                          QString());
@@ -1808,6 +2028,10 @@ void Kid3Application::batchImportNextFile(const QPersistentModelIndex& index)
       }
       m_batchImportTrackDataList.append(ImportTrackData(*taggedFile,
                                                       m_batchImportTagVersion));
+      // The imported data is set to the files of the track lists when the
+      // import is finished, their tags must be kept until then.
+      m_fileSystemModel->tagMemoryTracker()->addOperationFiles(
+            m_batchImporter, QSet<TaggedFile*>{taggedFile});
     }
   }
   if (terminated) {
@@ -1827,8 +2051,107 @@ void Kid3Application::batchImportNextFile(const QPersistentModelIndex& index)
       }
       m_batchImporter->start(m_batchImportAlbums, *m_batchImportProfile,
                              m_batchImportTagVersion);
+    } else {
+      m_fileSystemModel->tagMemoryTracker()->releaseOperationFiles(
+            m_batchImporter);
+    }
+  }
+}
+
+/**
+ * Release the files of a batch import when it is finished or aborted.
+ *
+ * @param type import event type, enum BatchImporter::ImportEventType
+ */
+void Kid3Application::onBatchImportEvent(int type)
+{
+  if (type == BatchImporter::Finished || type == BatchImporter::Aborted) {
+    m_batchImportAlbums.clear();
+    m_fileSystemModel->tagMemoryTracker()->releaseOperationFiles(
+          m_batchImporter);
+  }
+}
+
+/**
+ * Export the pictures embedded in the files of the selected directories.
+ * If no directories are selected, the files of the current directory are
+ * exported. The progress is reported by CoverArtExporter::exportEvent().
+ *
+ * @param outputDir folder where the image files are written
+ * @param format format to generate the file names without extension,
+ *               can contain codes supported by TrackDataFormatReplacer
+ * @param tagVersion tag versions used for the file names
+ */
+void Kid3Application::exportCoverArt(const QString& outputDir,
+                                     const QString& format,
+                                     Frame::TagVersion tagVersion)
+{
+  m_coverArtExporter->clearAborted();
+  m_coverArtExporter->setOutputDirectory(outputDir);
+  m_coverArtExporter->setFormat(format);
+  m_coverArtExporter->setTagVersion(tagVersion);
+  m_coverArtExporter->start();
+  QList<QPersistentModelIndex> indexes;
+  const auto selectedIndexes = m_fileSelectionModel->selectedRows();
+  for (const QModelIndex& index : selectedIndexes) {
+    if (m_fileProxyModel->isDir(index)) {
+      indexes.append(index);
+    }
+  }
+  if (indexes.isEmpty()) {
+    indexes.append(m_fileProxyModelRootIndex);
+  }
+
+  connect(m_fileProxyModelIterator, &FileProxyModelIterator::nextReady,
+          this, &Kid3Application::exportCoverArtNextFile);
+  m_fileProxyModelIterator->start(indexes);
+}
+
+/**
+ * Add single file to cover art export.
+ * Only the tags needed for the file name are read here, the pictures are
+ * extracted and written by the worker threads of the exporter.
+ *
+ * @param index index of file in file proxy model
+ */
+void Kid3Application::exportCoverArtNextFile(const QPersistentModelIndex& index)
+{
+  bool terminated = !index.isValid();
+  if (!terminated) {
+    if (TaggedFile* taggedFile = FileProxyModel::getTaggedFileOfIndex(index)) {
+      bool tagInfoRead = taggedFile->isTagInformationRead();
+      QByteArray data;
+      if (taggedFile->isChanged()) {
+        // Export the unsaved picture instead of the one in the file.
+        data = taggedFile->readPictureData();
+      }
+      if (m_coverArtExporter->formatNeedsTags()) {
+        taggedFile = FileProxyModel::readTagsFromTaggedFile(taggedFile);
+        // Keep the tags used for the file name until they are cleared here.
+        m_fileSystemModel->tagMemoryTracker()->setOperationFiles(
+              m_coverArtExporter, QSet<TaggedFile*>{taggedFile});
+      }
+      m_coverArtExporter->addFile(
+            taggedFile->currentFilePath(),
+            m_coverArtExporter->generateBaseName(*taggedFile), data);
+      // Free resources if tag was not read before exporting
+      if (!tagInfoRead) {
+        taggedFile->clearTags(false);
+      }
+      if (m_coverArtExporter->isAborted()) {
+        terminated = true;
+      }
     }
   }
+  if (terminated) {
+    m_fileProxyModelIterator->abort();
+    disconnect(m_fileProxyModelIterator,
+               &FileProxyModelIterator::nextReady,
+               this, &Kid3Application::exportCoverArtNextFile);
+    m_fileSystemModel->tagMemoryTracker()->releaseOperationFiles(
+          m_coverArtExporter);
+    m_coverArtExporter->finish();
+  }
 }
 
 /**
@@ -2108,16 +2431,29 @@ void Kid3Application::getTagsFromFilename(Frame::TagVersion tagMask)
 void Kid3Application::getFilenameFromTags(Frame::TagVersion tagVersion)
 {
   emit fileSelectionUpdateRequested();
+  const QString format = FileConfig::instance().toFilenameFormat();
+  const bool readDirectories =
+      TrackDataFormatReplacer::usesDirectoryStatistics(format);
+  QSet<const void*> readDirHandles;
   QItemSelectionModel* selectModel = getFileSelectionModel();
   SelectedTaggedFileIterator it(getRootIndex(),
                                 selectModel,
                                 false);
   while (it.hasNext()) {
     TaggedFile* taggedFile = it.next();
+    if (readDirectories) {
+      // The values of the directory codes shall not depend on which files
+      // have been loaded.
+      const QModelIndex dirIndex = taggedFile->getIndex().parent();
+      if (!readDirHandles.contains(FileSystemModel::nodeHandle(dirIndex))) {
+        readDirHandles.insert(FileSystemModel::nodeHandle(dirIndex));
+        m_fileSystemModel->readTagsInDirectory(dirIndex);
+      }
+    }
     TrackData trackData(*taggedFile, tagVersion);
     if (!trackData.isEmptyOrInactive()) {
       taggedFile->setFilenameFormattedIfEnabled(
-        trackData.formatFilenameFromTags(FileConfig::instance().toFilenameFormat()));
+        trackData.formatFilenameFromTags(format));
     }
   }
   emit selectedFilesUpdated();
@@ -2604,7 +2940,28 @@ bool Kid3Application::firstFile(bool select, bool onlyTaggedFiles)
  */
 bool Kid3Application::nextFile(bool select, bool onlyTaggedFiles)
 {
-  QModelIndex next(m_fileSelectionModel->currentIndex()), current;
+  QModelIndex next = getNextFileIndex(m_fileSelectionModel->currentIndex(),
+                                      onlyTaggedFiles);
+  if (!next.isValid())
+    return false;
+  m_fileSelectionModel->setCurrentIndex(next,
+    select ? QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows
+           : QItemSelectionModel::Current);
+  return true;
+}
+
+/**
+ * Get the file following a file in the order of the file proxy model.
+ *
+ * @param index index of file in file proxy model
+ * @param onlyTaggedFiles only consider tagged files
+ *
+ * @return index of next file, invalid if there is no next file.
+ */
+QModelIndex Kid3Application::getNextFileIndex(const QModelIndex& index,
+                                              bool onlyTaggedFiles) const
+{
+  QModelIndex next(index), current;
   do {
     current = next;
     next = QModelIndex();
@@ -2618,7 +2975,7 @@ bool Kid3Application::nextFile(bool select, bool onlyTaggedFiles)
         int row = parent.row();
         if (parent == getRootIndex() || !parent.isValid()) {
           // do not move beyond root index
-          return false;
+          return QModelIndex();
         }
         parent = parent.parent();
         if (row + 1 < m_fileProxyModel->rowCount(parent)) {
@@ -2628,12 +2985,27 @@ bool Kid3Application::nextFile(bool select, bool onlyTaggedFiles)
       }
     }
   } while (onlyTaggedFiles && !FileProxyModel::getTaggedFileOfIndex(next));
-  if (!next.isValid())
-    return false;
-  m_fileSelectionModel->setCurrentIndex(next,
-    select ? QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows
-           : QItemSelectionModel::Current);
-  return true;
+  return next;
+}
+
+/**
+ * Read the tags of the files following the current file in advance.
+ */
+void Kid3Application::prefetchTagsOfNextFiles()
+{
+  if (!m_tagPrefetcher->isEnabled())
+    return;
+
+  const QModelIndex current = m_fileSelectionModel->currentIndex();
+  QList<QPersistentModelIndex> nextIndexes;
+  if (FileProxyModel::getTaggedFileOfIndex(current)) {
+    QModelIndex index = current;
+    while (nextIndexes.size() < m_tagPrefetcher->count() &&
+           (index = getNextFileIndex(index, true)).isValid()) {
+      nextIndexes.append(index);
+    }
+  }
+  m_tagPrefetcher->setWindow(current, nextIndexes);
 }
 
 /**
@@ -3044,6 +3416,7 @@ void Kid3Application::proceedApplyingFilter()
  */
 void Kid3Application::filterNextFile(const QPersistentModelIndex& index)
 {
+  TraceSpan span("filterFile");
   if (!m_fileFilter)
     return;
 
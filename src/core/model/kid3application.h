@@ -40,6 +40,7 @@
 #include "downloadclient.h"
 #include "batchimporter.h"
 #include "dirrenamer.h"
+#include "coverartexporter.h"
 #include "frameeditorobject.h"
 #include "taggedfileselection.h"
 #include "trackdata.h"
@@ -71,6 +72,8 @@ class ICorePlatformTools;
 class IUserCommandProcessor;
 class ImageDataProvider;
 class FileFilter;
+class PictureNormalizer;
+class TagPrefetcher;
 
 /**
  * Kid3 application logic, independent of GUI.
@@ -111,6 +114,9 @@ class KID3_CORE_EXPORT Kid3Application : public QObject {
   Q_PROPERTY(DirRenamer* dirRenamer READ getDirRenamer CONSTANT)
   /** Batch importer. */
   Q_PROPERTY(BatchImporter* batchImporter READ getBatchImporter CONSTANT)
+  /** Cover art exporter. */
+  Q_PROPERTY(CoverArtExporter* coverArtExporter READ getCoverArtExporter
+             CONSTANT)
   /** Download client */
   Q_PROPERTY(DownloadClient* downloadClient READ getDownloadClient CONSTANT)
   Q_FLAGS(NumberTrackOption NumberTrackOptions)
@@ -260,29 +266,25 @@ public:
    * Get available server importers.
    * @return list of server importers.
    */
-  QList<ServerImporter*> getServerImporters() { return m_importers; }
+  QList<ServerImporter*> getServerImporters();
 
   /**
    * Get names of available server track importers.
    * @return list of server track importer names.
    */
-  Q_INVOKABLE QStringList getServerImporterNames() const;
+  Q_INVOKABLE QStringList getServerImporterNames();
 
   /**
    * Get available server track importers.
    * @return list of server track importers.
    */
-  QList<ServerTrackImporter*> getServerTrackImporters() {
-    return m_trackImporters;
-  }
+  QList<ServerTrackImporter*> getServerTrackImporters();
 
   /**
    * Get available user command processors.
    * @return list of user command processors.
    */
-  QList<IUserCommandProcessor*> getUserCommandProcessors() {
-    return m_userCommandProcessors;
-  }
+  QList<IUserCommandProcessor*> getUserCommandProcessors();
 
   /**
    * Get tag searcher.
@@ -302,6 +304,18 @@ public:
    */
   BatchImporter* getBatchImporter() { return m_batchImporter; }
 
+  /**
+   * Get prefetcher reading the tags of the next files in advance.
+   * @return tag prefetcher.
+   */
+  TagPrefetcher* getTagPrefetcher() { return m_tagPrefetcher; }
+
+  /**
+   * Get cover art exporter.
+   * @return cover art exporter.
+   */
+  CoverArtExporter* getCoverArtExporter() { return m_coverArtExporter; }
+
   /**
    * Get audio player.
    * This method will create an audio player if it does not already exist.
@@ -422,6 +436,36 @@ public:
    */
   Q_INVOKABLE QStringList saveDirectory();
 
+  /**
+   * Get all changed files in the current directory.
+   * @return changed files.
+   */
+  QList<TaggedFile*> getChangedFiles() const;
+
+  /**
+   * Prepare changed files before they are saved with saveTaggedFile().
+   * Pictures are normalized if configured. If the platform cannot convert
+   * pictures (e.g. kid3-cli without QtGui), a warning is printed once and
+   * the pictures are saved unchanged.
+   *
+   * @param changedFiles files returned by getChangedFiles()
+   */
+  void prepareChangedFilesForSaving(const QList<TaggedFile*>& changedFiles);
+
+  /**
+   * Save a single changed file.
+   * If the file shall be renamed to a name which already exists, a number
+   * is appended to the file name.
+   *
+   * @param taggedFile file to save
+   * @param errorDescription if not null, the error description is returned
+   * here, a null string if none is available
+   *
+   * @return true if ok or not changed, false if the file could not be written.
+   */
+  bool saveTaggedFile(TaggedFile* taggedFile,
+                      QString* errorDescription = nullptr);
+
   /**
    * Merge entries of two string lists.
    *
@@ -949,9 +993,13 @@ public:
 
   /**
    * Load plugins.
+   * @param deferredPluginPaths if not null, plugins which are not needed
+   * at startup (importers, user command processors) and provide their name
+   * in the plugin meta data are not loaded, their paths are appended to
+   * this list instead
    * @return list of plugin instances.
    */
-  static QObjectList loadPlugins();
+  static QObjectList loadPlugins(QStringList* deferredPluginPaths = nullptr);
 
 public slots:
   /**
@@ -1267,6 +1315,19 @@ public slots:
    */
   bool batchImport(const QString& profileName, Frame::TagVersion tagVersion);
 
+  /**
+   * Export the pictures embedded in the files of the selected directories.
+   * If no directories are selected, the files of the current directory are
+   * exported. The progress is reported by CoverArtExporter::exportEvent().
+   *
+   * @param outputDir folder where the image files are written
+   * @param format format to generate the file names without extension,
+   *               can contain codes supported by TrackDataFormatReplacer
+   * @param tagVersion tag versions used for the file names
+   */
+  void exportCoverArt(const QString& outputDir, const QString& format,
+                      Frame::TagVersion tagVersion = Frame::TagVAll);
+
   /**
    * Play audio file.
    */
@@ -1458,6 +1519,11 @@ private slots:
    */
   void applyFilterAfterReset();
 
+  /**
+   * Read the tags of the files following the current file in advance.
+   */
+  void prefetchTagsOfNextFiles();
+
   /**
    * Apply single file to file filter.
    *
@@ -1472,6 +1538,20 @@ private slots:
    */
   void batchImportNextFile(const QPersistentModelIndex& index);
 
+  /**
+   * Release the files of a batch import when it is finished or aborted.
+   *
+   * @param type import event type, enum BatchImporter::ImportEventType
+   */
+  void onBatchImportEvent(int type);
+
+  /**
+   * Add single file to cover art export.
+   *
+   * @param index index of file in file proxy model
+   */
+  void exportCoverArtNextFile(const QPersistentModelIndex& index);
+
   /**
    * Schedule rename action for a file.
    *
@@ -1533,18 +1613,42 @@ private slots:
    */
   void onApplicationStateChanged(Qt::ApplicationState state);
 
+  /**
+   * Start or stop tracing when the trace file is configured.
+   * A running trace is written when it is stopped.
+   * @param filePath path to trace file, empty to stop tracing
+   */
+  void setTraceFile(const QString& filePath);
+
 private:
   /**
    * Load and initialize plugins depending on configuration.
    */
   void initPlugins();
 
+  /**
+   * Get the file following a file in the order of the file proxy model.
+   *
+   * @param index index of file in file proxy model
+   * @param onlyTaggedFiles only consider tagged files
+   *
+   * @return index of next file, invalid if there is no next file.
+   */
+  QModelIndex getNextFileIndex(const QModelIndex& index,
+                               bool onlyTaggedFiles) const;
+
   /**
    * Check type of a loaded plugin and register it.
    * @param plugin instance returned by plugin loader
    */
   void checkPlugin(QObject* plugin);
 
+  /**
+   * Load plugins which were deferred at startup and register them.
+   * Does nothing if all plugins are already loaded.
+   */
+  void loadDeferredPlugins();
+
   /**
    * Update frame models to contain contents of selected files.
    * @param indexes tagged file indexes
@@ -1617,6 +1721,12 @@ private:
   DirRenamer* m_dirRenamer;
   /** Batch importer */
   BatchImporter* m_batchImporter;
+  /** Cover art exporter */
+  CoverArtExporter* m_coverArtExporter;
+  /** Picture normalizer, created when TagConfig::normalizePictures() */
+  QScopedPointer<PictureNormalizer> m_pictureNormalizer;
+  /** Tag prefetcher */
+  TagPrefetcher* m_tagPrefetcher;
   /** Audio player */
   QObject* m_player;
 #ifdef HAVE_QTDBUS
@@ -1641,6 +1751,8 @@ private:
   QList<ServerTrackImporter*> m_trackImporters;
   /** Processors for user commands */
   QList<IUserCommandProcessor*> m_userCommandProcessors;
+  /** Paths of plugins which are loaded when they are first needed */
+  QStringList m_deferredPluginPaths;
   /** Current directory */
   QString m_dirName;
   /** Stored current selection with the list of all selected items */
@@ -1689,6 +1801,8 @@ private:
   bool m_filtered;
   /** true if a selection operation is running */
   bool m_selectionOperationRunning;
+  /** true if missing picture conversion has been reported */
+  bool m_pictureConversionWarned;
 
   /** Fallback for path to search for plugins */
   static QString s_pluginsPathFallback;
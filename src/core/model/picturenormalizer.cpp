@@ -0,0 +1,187 @@
+/**
+ * \file picturenormalizer.cpp
+ * Resize and recompress pictures according to the tag configuration.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "picturenormalizer.h"
+#include <QRunnable>
+#include <QCryptographicHash>
+#include <QHash>
+#include <QVector>
+#include "icoreplatformtools.h"
+#include "taggedfile.h"
+#include "pictureframe.h"
+#include "tagconfig.h"
+#include "tracer.h"
+
+namespace {
+
+/** Maximum number of bytes used by the cached pictures. */
+const int MAX_CACHE_COST = 64 * 1024 * 1024;
+
+/**
+ * Job converting a picture in a worker thread.
+ */
+class ConvertPictureJob : public QRunnable {
+public:
+  ConvertPictureJob(const ICorePlatformTools* platformTools,
+                    const QByteArray& data, QByteArray* result,
+                    int maxDimension, int maxBytes,
+                    const QString& format, int quality)
+    : m_platformTools(platformTools), m_data(data), m_result(result),
+      m_maxDimension(maxDimension), m_maxBytes(maxBytes), m_format(format),
+      m_quality(quality) {
+  }
+
+  virtual void run() override {
+    *m_result = m_platformTools->convertPicture(
+          m_data, m_maxDimension, m_maxBytes, m_format, m_quality);
+  }
+
+private:
+  const ICorePlatformTools* m_platformTools;
+  const QByteArray m_data;
+  QByteArray* m_result;
+  const int m_maxDimension;
+  const int m_maxBytes;
+  const QString m_format;
+  const int m_quality;
+};
+
+/** Picture frame to be normalized. */
+struct PictureReference {
+  TaggedFile* taggedFile;
+  Frame::TagNumber tagNr;
+  Frame frame;
+  QByteArray hash;
+};
+
+}
+
+/**
+ * Constructor.
+ * @param platformTools platform tools used to convert pictures
+ */
+PictureNormalizer::PictureNormalizer(ICorePlatformTools* platformTools)
+  : m_platformTools(platformTools), m_cache(MAX_CACHE_COST)
+{
+}
+
+/**
+ * Destructor.
+ */
+PictureNormalizer::~PictureNormalizer()
+{
+  m_threadPool.waitForDone();
+}
+
+/**
+ * Replace the pictures of files which violate the picture policy by
+ * converted pictures.
+ * Returns when all pictures are converted.
+ *
+ * @param taggedFiles files with tags read
+ *
+ * @return number of replaced picture frames.
+ */
+int PictureNormalizer::normalizePictures(const QList<TaggedFile*>& taggedFiles)
+{
+  TraceSpan span("normalizePictures");
+  const TagConfig& tagCfg = TagConfig::instance();
+  const int maxDimension = tagCfg.maximumPictureDimension();
+  const int maxBytes = tagCfg.maximumNormalizedPictureSize();
+  const QString format = tagCfg.pictureFormat().toUpper();
+  const int quality = tagCfg.pictureQuality();
+  const QString policy = QString(QLatin1String("%1 %2 %3 %4"))
+      .arg(maxDimension).arg(maxBytes).arg(format).arg(quality);
+  if (policy != m_policy) {
+    m_cache.clear();
+    m_policy = policy;
+  }
+
+  // Collect the picture frames and the distinct pictures to be converted.
+  QList<PictureReference> pictureRefs;
+  QHash<QByteArray, QByteArray> converted;
+  QHash<QByteArray, QByteArray> sources;
+  for (TaggedFile* taggedFile : taggedFiles) {
+    FOR_ALL_TAGS(tagNr) {
+      FrameCollection frames;
+      taggedFile->getAllFrames(tagNr, frames);
+      for (const Frame& frame : frames) {
+        QByteArray data;
+        if (frame.getType() != Frame::FT_Picture ||
+            !PictureFrame::getData(frame, data) || data.isEmpty()) {
+          continue;
+        }
+        const QByteArray hash =
+            QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+        if (!converted.contains(hash) && !sources.contains(hash)) {
+          if (const QByteArray* cached = m_cache.object(hash)) {
+            converted.insert(hash, *cached);
+          } else {
+            sources.insert(hash, data);
+          }
+        }
+        pictureRefs.append({taggedFile, tagNr, frame, hash});
+      }
+    }
+  }
+
+  if (!sources.isEmpty()) {
+    const QList<QByteArray> hashes = sources.keys();
+    QVector<QByteArray> results(hashes.size());
+    QByteArray* resultData = results.data();
+    for (int i = 0; i < hashes.size(); ++i) {
+      m_threadPool.start(new ConvertPictureJob(
+            m_platformTools, sources.value(hashes.at(i)), resultData + i,
+            maxDimension, maxBytes, format, quality));
+    }
+    m_threadPool.waitForDone();
+    for (int i = 0; i < hashes.size(); ++i) {
+      const QByteArray& result = results.at(i);
+      converted.insert(hashes.at(i), result);
+      m_cache.insert(hashes.at(i), new QByteArray(result),
+                     qMax(1, static_cast<int>(result.size())));
+    }
+  }
+
+  const bool isPng = format == QLatin1String("PNG");
+  const QString mimeType = isPng
+      ? QLatin1String("image/png") : QLatin1String("image/jpeg");
+  const QString imgFormat = isPng ? QLatin1String("PNG") : QLatin1String("JPG");
+  int numReplaced = 0;
+  for (PictureReference& ref : pictureRefs) {
+    const QByteArray data = converted.value(ref.hash);
+    if (data.isEmpty()) {
+      continue;
+    }
+    PictureFrame::setData(ref.frame, data);
+    PictureFrame::setMimeType(ref.frame, mimeType);
+    PictureFrame::setImageFormat(ref.frame, imgFormat);
+    ref.frame.setValueChanged();
+    ref.taggedFile->setFrame(ref.tagNr, ref.frame);
+    ++numReplaced;
+  }
+  return numReplaced;
+}
@@ -0,0 +1,85 @@
+/**
+ * \file picturenormalizer.h
+ * Resize and recompress pictures according to the tag configuration.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QList>
+#include <QCache>
+#include <QByteArray>
+#include <QString>
+#include <QThreadPool>
+#include "kid3api.h"
+
+class TaggedFile;
+class ICorePlatformTools;
+
+/**
+ * Applies the picture policy of the tag configuration to picture frames.
+ *
+ * Pictures larger than TagConfig::maximumNormalizedPictureSize() bytes or
+ * TagConfig::maximumPictureDimension() pixels are converted using
+ * ICorePlatformTools::convertPicture(). Distinct pictures are converted in
+ * parallel in a thread pool and the results are cached by the hash of the
+ * original picture, so that a cover shared by all files of an album is only
+ * converted once.
+ */
+class KID3_CORE_EXPORT PictureNormalizer {
+public:
+  /**
+   * Constructor.
+   * @param platformTools platform tools used to convert pictures
+   */
+  explicit PictureNormalizer(ICorePlatformTools* platformTools);
+
+  /**
+   * Destructor.
+   */
+  ~PictureNormalizer();
+
+  /**
+   * Replace the pictures of files which violate the picture policy by
+   * converted pictures.
+   * Returns when all pictures are converted.
+   *
+   * @param taggedFiles files with tags read
+   *
+   * @return number of replaced picture frames.
+   */
+  int normalizePictures(const QList<TaggedFile*>& taggedFiles);
+
+private:
+  Q_DISABLE_COPY(PictureNormalizer)
+
+  ICorePlatformTools* m_platformTools;
+  QThreadPool m_threadPool;
+  /**
+   * Converted pictures indexed by hash of original picture data,
+   * empty if picture does not have to be converted.
+   */
+  QCache<QByteArray, QByteArray> m_cache;
+  /** Policy used for cached pictures */
+  QString m_policy;
+};
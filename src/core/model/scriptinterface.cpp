@@ -31,6 +31,7 @@
 #include <QFileInfo>
 #include <QCoreApplication>
 #include <QItemSelectionModel>
+#include <QTimer>
 #include "kid3application.h"
 #include "taggedfile.h"
 #include "frametablemodel.h"
@@ -40,6 +41,7 @@
 #include "modeliterator.h"
 #include "batchimportconfig.h"
 #include "batchimportprofile.h"
+#include "batchimporter.h"
 #include "fileconfig.h"
 
 /**
@@ -48,7 +50,10 @@
  * @param app parent application
  */
 ScriptInterface::ScriptInterface(Kid3Application* app)
-  : QDBusAbstractAdaptor(app), m_app(app)
+  : QDBusAbstractAdaptor(app), m_app(app), m_lastJobId(0),
+    m_openDirectoryJobId(0), m_saveJobId(0), m_batchImportJobId(0),
+    m_filterJobId(0), m_openDirectoryOk(false), m_saveAborted(false),
+    m_numFilesSaved(0), m_numFilesToSave(0)
 {
   setObjectName(QLatin1String("ScriptInterface"));
   setAutoRelaySignals(true);
@@ -674,4 +679,244 @@ void ScriptInterface::playAudio()
   m_app->playAudio();
 }
 
+/**
+ * Start opening a file or directory without waiting for it to be loaded.
+ * jobFinished() is emitted when the directory has been opened.
+ *
+ * @param path path to file or directory
+ *
+ * @return job ID, 0 if another job of this kind is running.
+ */
+int ScriptInterface::startOpenDirectory(const QString& path)
+{
+  if (m_openDirectoryJobId != 0) {
+    return 0;
+  }
+  m_openDirectoryJobId = nextJobId();
+  // The jobs are started from the event loop, so that the job ID is replied
+  // before the first signal of the job is emitted.
+  QTimer::singleShot(0, this, [this, path]() {
+    connect(m_app, &Kid3Application::directoryOpened,
+            this, &ScriptInterface::onDirectoryOpened);
+    m_openDirectoryOk = m_app->openDirectory({path}, true);
+  });
+  return m_openDirectoryJobId;
+}
+
+void ScriptInterface::onDirectoryOpened()
+{
+  disconnect(m_app, &Kid3Application::directoryOpened,
+             this, &ScriptInterface::onDirectoryOpened);
+  finishJob(m_openDirectoryJobId, m_openDirectoryOk,
+            m_openDirectoryOk ? QString()
+                              : QLatin1String("Could not open folder"));
+}
+
+/**
+ * Start saving all modified files without waiting for completion.
+ * jobProgress() is emitted for every saved file, jobFinished() at the end
+ * with the files which could not be written in its error message.
+ *
+ * @return job ID, 0 if another job of this kind is running.
+ */
+int ScriptInterface::startSave()
+{
+  if (m_saveJobId != 0) {
+    return 0;
+  }
+  m_saveJobId = nextJobId();
+  m_saveAborted = false;
+  m_saveErrorFiles.clear();
+  m_saveErrorDescriptions.clear();
+  QTimer::singleShot(0, this, [this]() {
+    const QList<TaggedFile*> changedFiles = m_app->getChangedFiles();
+    m_app->prepareChangedFilesForSaving(changedFiles);
+    // Indexes are stored because the files can be removed from the model
+    // while they are saved from the event loop.
+    m_filesToSave.clear();
+    m_filesToSave.reserve(changedFiles.size());
+    for (const TaggedFile* taggedFile : changedFiles) {
+      m_filesToSave.append(QPersistentModelIndex(taggedFile->getIndex()));
+    }
+    m_numFilesSaved = 0;
+    m_numFilesToSave = m_filesToSave.size();
+    saveNextFile();
+  });
+  return m_saveJobId;
+}
+
+/**
+ * Save the next file of the save job.
+ * A single file is saved, the next one is scheduled in the event loop, so
+ * that cancelJob() can abort the job between files.
+ */
+void ScriptInterface::saveNextFile()
+{
+  if (m_saveJobId == 0) {
+    return;
+  }
+  if (m_saveAborted || m_filesToSave.isEmpty()) {
+    m_filesToSave.clear();
+    if (!m_saveErrorFiles.isEmpty()) {
+      finishJob(m_saveJobId, false,
+                QLatin1String("Error while writing file:\n") +
+                Kid3Application::mergeStringLists(
+                  m_saveErrorFiles, m_saveErrorDescriptions,
+                  QLatin1String(": "))
+                .join(QLatin1String("\n")));
+    } else if (m_saveAborted) {
+      finishJob(m_saveJobId, false, QLatin1String("Aborted"));
+    } else {
+      finishJob(m_saveJobId, true);
+    }
+    m_saveErrorFiles.clear();
+    m_saveErrorDescriptions.clear();
+    return;
+  }
+
+  QPersistentModelIndex index = m_filesToSave.takeFirst();
+  if (TaggedFile* taggedFile = FileProxyModel::getTaggedFileOfIndex(index)) {
+    QString errorDescription;
+    if (!m_app->saveTaggedFile(taggedFile, &errorDescription)) {
+      m_saveErrorFiles.append(taggedFile->getAbsFilename());
+      m_saveErrorDescriptions.append(errorDescription);
+    }
+    emit jobProgress(m_saveJobId, taggedFile->getFilename(),
+                     ++m_numFilesSaved, m_numFilesToSave);
+  } else {
+    // The file has been removed from the model in the meantime.
+    --m_numFilesToSave;
+  }
+  QTimer::singleShot(0, this, &ScriptInterface::saveNextFile);
+}
+
+/**
+ * Start an automatic batch import without waiting for completion.
+ * Import events are reported with jobProgress().
+ *
+ * @param tagMask tag mask (bit 0 for tag 1, bit 1 for tag 2)
+ * @param profileName name of batch import profile to use
+ *
+ * @return job ID, 0 if another job of this kind is running.
+ */
+int ScriptInterface::startBatchImport(int tagMask, const QString& profileName)
+{
+  if (m_batchImportJobId != 0) {
+    return 0;
+  }
+  m_batchImportJobId = nextJobId();
+  QTimer::singleShot(0, this, [this, tagMask, profileName]() {
+    connect(m_app->getBatchImporter(), &BatchImporter::reportImportEvent,
+            this, &ScriptInterface::onBatchImportEvent);
+    if (!m_app->batchImport(profileName, Frame::tagVersionCast(tagMask))) {
+      disconnect(m_app->getBatchImporter(), &BatchImporter::reportImportEvent,
+                 this, &ScriptInterface::onBatchImportEvent);
+      finishJob(m_batchImportJobId, false,
+                QLatin1String("Profile not found: ") + profileName);
+    }
+  });
+  return m_batchImportJobId;
+}
+
+void ScriptInterface::onBatchImportEvent(int type, const QString& text)
+{
+  if (type == BatchImporter::Finished || type == BatchImporter::Aborted) {
+    disconnect(m_app->getBatchImporter(), &BatchImporter::reportImportEvent,
+               this, &ScriptInterface::onBatchImportEvent);
+    finishJob(m_batchImportJobId, type == BatchImporter::Finished,
+              type == BatchImporter::Aborted ? QLatin1String("Aborted")
+                                             : QString());
+  } else {
+    emit jobProgress(m_batchImportJobId, text, 0, 0);
+  }
+}
+
+/**
+ * Start filtering the files without waiting for completion.
+ * jobProgress() is emitted with the number of passed and checked files.
+ *
+ * @param expression filter expression
+ *
+ * @return job ID, 0 if another job of this kind is running.
+ */
+int ScriptInterface::startFilter(const QString& expression)
+{
+  if (m_filterJobId != 0) {
+    return 0;
+  }
+  m_filterJobId = nextJobId();
+  QTimer::singleShot(0, this, [this, expression]() {
+    connect(m_app, &Kid3Application::fileFiltered,
+            this, &ScriptInterface::onFileFiltered);
+    m_app->applyFilter(expression);
+  });
+  return m_filterJobId;
+}
+
+void ScriptInterface::onFileFiltered(int type, const QString& fileName,
+                                     int passed, int total)
+{
+  switch (type) {
+  case FileFilter::FilePassed:
+  case FileFilter::FileFilteredOut:
+    emit jobProgress(m_filterJobId, fileName, passed, total);
+    break;
+  case FileFilter::Finished:
+  case FileFilter::Aborted:
+  case FileFilter::ParseError:
+    disconnect(m_app, &Kid3Application::fileFiltered,
+               this, &ScriptInterface::onFileFiltered);
+    finishJob(m_filterJobId, type == FileFilter::Finished,
+              type == FileFilter::Aborted ? QLatin1String("Aborted") :
+              type == FileFilter::ParseError ? QLatin1String("Parse error")
+                                             : QString());
+    break;
+  default:
+    break;
+  }
+}
+
+/**
+ * Cancel a job started with one of the start methods.
+ * Opening a directory cannot be canceled.
+ *
+ * @param jobId job ID returned when the job was started
+ *
+ * @return true if the job is running and will be aborted.
+ */
+bool ScriptInterface::cancelJob(int jobId)
+{
+  if (jobId == 0) {
+    return false;
+  }
+  if (jobId == m_saveJobId) {
+    m_saveAborted = true;
+    return true;
+  }
+  if (jobId == m_batchImportJobId) {
+    m_app->getBatchImporter()->abort();
+    return true;
+  }
+  if (jobId == m_filterJobId) {
+    m_app->abortFilter();
+    return true;
+  }
+  return false;
+}
+
+int ScriptInterface::nextJobId()
+{
+  if (++m_lastJobId <= 0) {
+    m_lastJobId = 1;
+  }
+  return m_lastJobId;
+}
+
+void ScriptInterface::finishJob(int& jobId, bool ok, const QString& errorMsg)
+{
+  const int finishedJobId = jobId;
+  jobId = 0;
+  emit jobFinished(finishedJobId, ok, errorMsg);
+}
+
 #endif // HAVE_QTDBUS
@@ -30,6 +30,7 @@
 #ifdef HAVE_QTDBUS
 #include <QDBusAbstractAdaptor>
 #include <QStringList>
+#include <QPersistentModelIndex>
 
 class Kid3Application;
 
@@ -447,12 +448,111 @@ public slots:
    */
   void playAudio();
 
+  /**
+   * Start opening a file or directory without waiting for it to be loaded.
+   * jobFinished() is emitted when the directory has been opened.
+   *
+   * @param path path to file or directory
+   *
+   * @return job ID, 0 if another job of this kind is running.
+   */
+  int startOpenDirectory(const QString& path);
+
+  /**
+   * Start saving all modified files without waiting for completion.
+   * The files are saved one at a time from the event loop, so the job can
+   * be canceled between files. jobProgress() is emitted for every saved
+   * file with the number of saved and modified files, jobFinished() at the
+   * end with the files which could not be written in its error message.
+   *
+   * @return job ID, 0 if another job of this kind is running.
+   */
+  int startSave();
+
+  /**
+   * Start an automatic batch import without waiting for completion.
+   * Import events are reported with jobProgress().
+   *
+   * @param tagMask tag mask (bit 0 for tag 1, bit 1 for tag 2)
+   * @param profileName name of batch import profile to use
+   *
+   * @return job ID, 0 if another job of this kind is running.
+   */
+  int startBatchImport(int tagMask, const QString& profileName);
+
+  /**
+   * Start filtering the files without waiting for completion.
+   * jobProgress() is emitted with the number of passed and checked files.
+   *
+   * @param expression filter expression
+   *
+   * @return job ID, 0 if another job of this kind is running.
+   */
+  int startFilter(const QString& expression);
+
+  /**
+   * Cancel a job started with one of the start methods.
+   * Opening a directory cannot be canceled.
+   *
+   * @param jobId job ID returned when the job was started
+   *
+   * @return true if the job is running and will be aborted.
+   */
+  bool cancelJob(int jobId);
+
+signals:
+  /**
+   * Emitted to report progress of a job.
+   *
+   * For a save job, @a text is the file name, @a done the number of saved
+   * files and @a total the number of modified files. For a filter job,
+   * @a text is the file name, @a done the number of passed files and
+   * @a total the number of checked files. For a batch import job, @a text
+   * is the import event, @a done and @a total are 0.
+   *
+   * @param jobId job ID
+   * @param text description of current step
+   * @param done amount of work done
+   * @param total total amount of work, 0 if unknown
+   */
+  void jobProgress(int jobId, const QString& text, int done, int total);
+
+  /**
+   * Emitted when a job is finished.
+   *
+   * @param jobId job ID
+   * @param ok true if successful
+   * @param errorMsg error message if not successful
+   */
+  void jobFinished(int jobId, bool ok, const QString& errorMsg);
+
 private slots:
   void onRenameActionsScheduled();
+  void onDirectoryOpened();
+  void saveNextFile();
+  void onFileFiltered(int type, const QString& fileName,
+                      int passed, int total);
+  void onBatchImportEvent(int type, const QString& text);
 
 private:
+  int nextJobId();
+  void finishJob(int& jobId, bool ok, const QString& errorMsg = QString());
+
   Kid3Application* m_app;
   QString m_errorMsg;
+  int m_lastJobId;
+  int m_openDirectoryJobId;
+  int m_saveJobId;
+  int m_batchImportJobId;
+  int m_filterJobId;
+  bool m_openDirectoryOk;
+  bool m_saveAborted;
+  /** Files which still have to be saved by the save job */
+  QList<QPersistentModelIndex> m_filesToSave;
+  QStringList m_saveErrorFiles;
+  QStringList m_saveErrorDescriptions;
+  int m_numFilesSaved;
+  int m_numFilesToSave;
 };
 #else // HAVE_QTDBUS
 
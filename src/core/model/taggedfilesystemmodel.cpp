@@ -30,6 +30,8 @@
 #include "itaggedfilefactory.h"
 #include "tagconfig.h"
 #include "saferename.h"
+#include "tagmemorytracker.h"
+#include "tracer.h"
 
 /** Only defined for generation of translation files */
 #define NAME_FOR_PO QT_TRANSLATE_NOOP("QFileSystemModel", "Name")
@@ -45,9 +47,201 @@
 
 QList<ITaggedFileFactory*> TaggedFileSystemModel::s_taggedFileFactories;
 
+namespace {
+
+/** Data owned by a node of a tagged file system model. */
+class TaggedNodeData : public FileSystemModel::NodeData {
+public:
+  /**
+   * Get tagged file.
+   * @return tagged file, null for the data of a directory.
+   */
+  virtual TaggedFile* taggedFile() const { return nullptr; }
+};
+
+/** Contribution of a file to the statistics of its directory. */
+struct DirectoryContribution {
+  DirectoryContribution() : hasTags(false), duration(0) {}
+
+  bool hasTags;
+  unsigned long duration;
+  QString artist;
+  QString album;
+};
+
+class DirectoryNodeData;
+
+/**
+ * Tagged file owned by a file system model node.
+ * Storing the tagged file with its node avoids a persistent model index per
+ * file, which would have to be updated on every row change.
+ */
+class TaggedFileNodeData : public TaggedNodeData {
+public:
+  TaggedFileNodeData(TaggedFile* taggedFile, TagMemoryTracker* tracker,
+                     DirectoryNodeData* directory);
+  virtual ~TaggedFileNodeData() override {
+    // The directory data may already be deleted, it is not accessed here.
+    m_tracker->fileRemoved(m_taggedFile);
+    delete m_taggedFile;
+  }
+  virtual void nodeRemoved() override {
+    // The tagged file may still be used, e.g. by a running operation,
+    // it is deleted later from the event loop.
+    m_tracker->fileRemoved(m_taggedFile);
+    removeFromDirectory();
+    m_taggedFile->detachFromModelNode();
+  }
+  virtual TaggedFile* taggedFile() const override { return m_taggedFile; }
+  void removeFromDirectory();
+  void markDirectoryStatisticsOutdated();
+  DirectoryContribution& contribution() { return m_contribution; }
+
+private:
+  Q_DISABLE_COPY(TaggedFileNodeData)
+
+  TaggedFile* m_taggedFile;
+  TagMemoryTracker* m_tracker;
+  DirectoryNodeData* m_directory;
+  DirectoryContribution m_contribution;
+};
+
+/**
+ * Statistics of a directory owned by its file system model node.
+ * The values are updated from the contributions of its files, so they are
+ * deleted together with the node and never refer to a removed directory.
+ */
+class DirectoryNodeData : public TaggedNodeData {
+public:
+  DirectoryNodeData() = default;
+  int numFiles() const { return m_stats.numFiles; }
+  void addFile() { ++m_stats.numFiles; }
+  void removeFile(TaggedFileNodeData* fileData);
+  void markOutdated(TaggedFileNodeData* fileData) {
+    m_outdatedFiles.insert(fileData);
+  }
+  const TaggedFile::DirectoryStatistics& statistics();
+
+private:
+  Q_DISABLE_COPY(DirectoryNodeData)
+
+  void addContribution(const DirectoryContribution& contribution, int sign);
+
+  TaggedFile::DirectoryStatistics m_stats;
+  /** Number of files with read tags for each artist */
+  QHash<QString, int> m_artists;
+  /** Number of files with read tags for each album */
+  QHash<QString, int> m_albums;
+  /** Files whose tags were read, changed or cleared since the last update */
+  QSet<TaggedFileNodeData*> m_outdatedFiles;
+};
+
+TaggedFileNodeData::TaggedFileNodeData(
+    TaggedFile* taggedFile, TagMemoryTracker* tracker,
+    DirectoryNodeData* directory)
+  : m_taggedFile(taggedFile), m_tracker(tracker), m_directory(directory)
+{
+  if (m_directory) {
+    m_directory->addFile();
+    m_directory->markOutdated(this);
+  }
+}
+
+void TaggedFileNodeData::removeFromDirectory()
+{
+  if (m_directory) {
+    m_directory->removeFile(this);
+    m_directory = nullptr;
+  }
+}
+
+void TaggedFileNodeData::markDirectoryStatisticsOutdated()
+{
+  if (m_directory) {
+    m_directory->markOutdated(this);
+  }
+}
+
+void DirectoryNodeData::removeFile(TaggedFileNodeData* fileData)
+{
+  m_outdatedFiles.remove(fileData);
+  addContribution(fileData->contribution(), -1);
+  --m_stats.numFiles;
+}
+
+/**
+ * Get the statistics of the directory.
+ * Only the contributions of the files which were read, changed or cleared
+ * since the last call are calculated again, no tags are read.
+ * @return statistics.
+ */
+const TaggedFile::DirectoryStatistics& DirectoryNodeData::statistics()
+{
+  for (TaggedFileNodeData* fileData : qAsConst(m_outdatedFiles)) {
+    DirectoryContribution& contribution = fileData->contribution();
+    addContribution(contribution, -1);
+    contribution = DirectoryContribution();
+    TaggedFile* taggedFile = fileData->taggedFile();
+    if (taggedFile->isTagInformationRead()) {
+      contribution.hasTags = true;
+      contribution.duration = taggedFile->getDuration();
+      FrameCollection frames;
+      taggedFile->getAllFrames(Frame::Tag_2, frames);
+      contribution.artist = frames.getArtist();
+      contribution.album = frames.getAlbum();
+      if (contribution.artist.isEmpty() || contribution.album.isEmpty()) {
+        taggedFile->getAllFrames(Frame::Tag_1, frames);
+        if (contribution.artist.isEmpty())
+          contribution.artist = frames.getArtist();
+        if (contribution.album.isEmpty())
+          contribution.album = frames.getAlbum();
+      }
+    }
+    addContribution(contribution, 1);
+  }
+  m_outdatedFiles.clear();
+  return m_stats;
+}
+
+/**
+ * Add or subtract the contribution of a file.
+ * @param contribution contribution of file
+ * @param sign 1 to add, -1 to subtract
+ */
+void DirectoryNodeData::addContribution(
+    const DirectoryContribution& contribution, int sign)
+{
+  if (!contribution.hasTags)
+    return;
+
+  m_stats.numFilesWithTags += sign;
+  if (sign > 0) {
+    m_stats.duration += contribution.duration;
+  } else {
+    m_stats.duration -= contribution.duration;
+  }
+  auto addCount = [sign](QHash<QString, int>& counts, const QString& key) {
+    if (key.isEmpty())
+      return;
+    auto it = counts.find(key);
+    if (it == counts.end()) {
+      counts.insert(key, sign);
+    } else if ((*it += sign) <= 0) {
+      counts.erase(it);
+    }
+  };
+  addCount(m_artists, contribution.artist);
+  addCount(m_albums, contribution.album);
+  m_stats.numArtists = m_artists.size();
+  m_stats.numAlbums = m_albums.size();
+}
+
+}
+
 TaggedFileSystemModel::TaggedFileSystemModel(
     CoreTaggedFileIconProvider* iconProvider, QObject* parent)
-  : FileSystemModel(parent), m_iconProvider(iconProvider)
+  : FileSystemModel(parent), m_iconProvider(iconProvider),
+    m_tagMemoryTracker(new TagMemoryTracker(this))
 {
   setObjectName(QLatin1String("TaggedFileSystemModel"));
   connect(this, &QAbstractItemModel::rowsInserted,
@@ -67,8 +261,7 @@ QModelIndex TaggedFileSystemModel::sibling(int row, int column,
                                            const QModelIndex&idx) const
 {
   if (row == idx.row() &&
-      column >= NUM_FILESYSTEM_COLUMNS &&
-      column < NUM_FILESYSTEM_COLUMNS + m_tagFrameColumnTypes.size()) {
+      column >= NUM_FILESYSTEM_COLUMNS && column <= coverArtColumn()) {
     return createIndex(row, column, idx.internalPointer());
   } else {
     return FileSystemModel::sibling(row, column, idx);
@@ -77,8 +270,7 @@ QModelIndex TaggedFileSystemModel::sibling(int row, int column,
 
 int TaggedFileSystemModel::columnCount(const QModelIndex &parent) const
 {
-  return parent.column() > 0
-      ? 0 : NUM_FILESYSTEM_COLUMNS + m_tagFrameColumnTypes.size();
+  return parent.column() > 0 ? 0 : coverArtColumn() + 1;
 }
 
 /**
@@ -93,52 +285,56 @@ QVariant TaggedFileSystemModel::data(const QModelIndex& index, int role) const
     if (role == TaggedFileRole) {
       return retrieveTaggedFileVariant(index);
     } else if (role == Qt::DecorationRole && index.column() == 0) {
-      TaggedFile* taggedFile = m_taggedFiles.value(index, nullptr);
+      TaggedFile* taggedFile = taggedFileOfNode(index);
       if (taggedFile) {
         return m_iconProvider->iconForTaggedFile(taggedFile);
       }
     } else if (role == Qt::BackgroundRole && index.column() == 0) {
-      TaggedFile* taggedFile = m_taggedFiles.value(index, nullptr);
+      TaggedFile* taggedFile = taggedFileOfNode(index);
       if (taggedFile) {
         QVariant color = m_iconProvider->backgroundForTaggedFile(taggedFile);
         if (!color.isNull())
           return color;
       }
     } else if (role == IconIdRole && index.column() == 0) {
-      TaggedFile* taggedFile = m_taggedFiles.value(index, nullptr);
+      TaggedFile* taggedFile = taggedFileOfNode(index);
       return taggedFile
           ? m_iconProvider->iconIdForTaggedFile(taggedFile)
           : QByteArray("");
     } else if (role == TruncatedRole && index.column() == 0) {
-      TaggedFile* taggedFile = m_taggedFiles.value(index, nullptr);
+      TaggedFile* taggedFile = taggedFileOfNode(index);
       return taggedFile &&
           ((TagConfig::instance().markTruncations() &&
             taggedFile->getTruncationFlags(Frame::Tag_Id3v1) != 0) ||
            taggedFile->isMarked());
     } else if (role == IsDirRole && index.column() == 0) {
       return isDir(index);
+    } else if (role == Qt::DecorationRole &&
+               index.column() == coverArtColumn()) {
+      if (!isDir(index)) {
+        return m_iconProvider->coverArtForFile(filePath(index),
+                                               lastModified(index));
+      }
+      return QVariant();
     } else if ((role == Qt::DisplayRole || role == Qt::EditRole) &&
                index.column() >= NUM_FILESYSTEM_COLUMNS &&
                index.column() <
                NUM_FILESYSTEM_COLUMNS + m_tagFrameColumnTypes.size()) {
-      QPersistentModelIndex taggedFileIdx = index.sibling(index.row(), 0);
-      auto it = m_taggedFiles.constFind(taggedFileIdx);
-      if (it != m_taggedFiles.constEnd()) {
-        if (TaggedFile* taggedFile = *it) {
-          Frame frame;
-          Frame::Type type = m_tagFrameColumnTypes.at(index.column() -
-                                                      NUM_FILESYSTEM_COLUMNS);
-          if (taggedFile->getFrame(Frame::Tag_2, type, frame)) {
-            QString value = frame.getValue();
-            if (type == Frame::FT_Track) {
-              bool ok;
-              int intValue = value.toInt(&ok);
-              if (ok) {
-                return intValue;
-              }
+      // The columns of a row share the node of the first column.
+      if (TaggedFile* taggedFile = taggedFileOfNode(index)) {
+        Frame frame;
+        Frame::Type type = m_tagFrameColumnTypes.at(index.column() -
+                                                    NUM_FILESYSTEM_COLUMNS);
+        if (taggedFile->getFrame(Frame::Tag_2, type, frame)) {
+          QString value = frame.getValue();
+          if (type == Frame::FT_Track) {
+            bool ok;
+            int intValue = value.toInt(&ok);
+            if (ok) {
+              return intValue;
             }
-            return value;
           }
+          return value;
         }
       }
       return QVariant();
@@ -166,19 +362,16 @@ bool TaggedFileSystemModel::setData(const QModelIndex& index,
                index.column() >= NUM_FILESYSTEM_COLUMNS &&
                index.column() <
                NUM_FILESYSTEM_COLUMNS + m_tagFrameColumnTypes.size()) {
-      QPersistentModelIndex taggedFileIdx = index.sibling(index.row(), 0);
-      auto it = m_taggedFiles.constFind(taggedFileIdx);
-      if (it != m_taggedFiles.constEnd()) {
-        if (TaggedFile* taggedFile = *it) {
-          Frame frame;
-          if (taggedFile->getFrame(
-                Frame::Tag_2,
-                m_tagFrameColumnTypes.at(index.column() -
-                                         NUM_FILESYSTEM_COLUMNS),
-                frame)) {
-            frame.setValue(value.toString());
-            return taggedFile->setFrame(Frame::Tag_2, frame);
-          }
+      // The columns of a row share the node of the first column.
+      if (TaggedFile* taggedFile = taggedFileOfNode(index)) {
+        Frame frame;
+        if (taggedFile->getFrame(
+              Frame::Tag_2,
+              m_tagFrameColumnTypes.at(index.column() -
+                                       NUM_FILESYSTEM_COLUMNS),
+              frame)) {
+          frame.setValue(value.toString());
+          return taggedFile->setFrame(Frame::Tag_2, frame);
         }
       }
       return false;
@@ -206,6 +399,10 @@ QVariant TaggedFileSystemModel::headerData(
           m_tagFrameColumnTypes.at(section - NUM_FILESYSTEM_COLUMNS))
         .getTranslatedName();
   }
+  if (orientation == Qt::Horizontal && role == Qt::DisplayRole &&
+      section == coverArtColumn()) {
+    return Frame::ExtendedType(Frame::FT_Picture).getTranslatedName();
+  }
   return FileSystemModel::headerData(section, orientation, role);
 }
 
@@ -230,7 +427,9 @@ bool TaggedFileSystemModel::rename(const QModelIndex& index,
 void TaggedFileSystemModel::notifyModificationChanged(const QModelIndex& index,
                                                       bool modified)
 {
-  emit fileModificationChanged(index, modified);
+  if (index.isValid()) {
+    emit fileModificationChanged(index, modified);
+  }
 }
 
 /**
@@ -240,7 +439,99 @@ void TaggedFileSystemModel::notifyModificationChanged(const QModelIndex& index,
  */
 void TaggedFileSystemModel::notifyModelDataChanged(const QModelIndex& index)
 {
-  emit dataChanged(index, index);
+  if (index.isValid()) {
+    emit dataChanged(index, index);
+  }
+}
+
+/**
+ * Called when a cover art thumbnail is available to update the views.
+ * @param filePath path to file
+ */
+void TaggedFileSystemModel::notifyCoverArtChanged(const QString& filePath)
+{
+  QModelIndex idx = index(filePath, coverArtColumn());
+  if (idx.isValid()) {
+    emit dataChanged(idx, idx, {Qt::DecorationRole});
+  }
+}
+
+/**
+ * Get number of tagged files in a directory.
+ *
+ * @param dirHandle node handle of directory
+ *
+ * @return number of tagged files, -1 if @a dirHandle is invalid.
+ */
+int TaggedFileSystemModel::numberOfTaggedFilesInDirectory(
+    const void* dirHandle) const
+{
+  if (!dirHandle)
+    return -1;
+  auto dirData = static_cast<DirectoryNodeData*>(
+        nodeData(indexForNodeHandle(dirHandle)));
+  return dirData ? dirData->numFiles() : 0;
+}
+
+/**
+ * Get aggregated information about the tagged files in a directory.
+ * The values derived from tags only include the files whose tags have been
+ * read, use readTagsInDirectory() before to include all files. They are
+ * updated from the files whose tags were read, edited or cleared since the
+ * last call, the tags of the other files are not accessed.
+ *
+ * @param dirHandle node handle of directory
+ * @param stats the statistics are returned here
+ *
+ * @return true if @a dirHandle is valid.
+ */
+bool TaggedFileSystemModel::directoryStatistics(
+    const void* dirHandle, TaggedFile::DirectoryStatistics& stats) const
+{
+  if (!dirHandle)
+    return false;
+
+  auto dirData = static_cast<DirectoryNodeData*>(
+        nodeData(indexForNodeHandle(dirHandle)));
+  stats = dirData ? dirData->statistics() : TaggedFile::DirectoryStatistics();
+  return true;
+}
+
+/**
+ * Read the tags of all files in a directory which are not read yet.
+ * This has to be done before directoryStatistics() is used if its values
+ * shall not depend on which files have been loaded.
+ *
+ * @param dirIndex index of directory
+ */
+void TaggedFileSystemModel::readTagsInDirectory(const QModelIndex& dirIndex)
+{
+  TraceSpan span("readTagsInDirectory");
+  const int numRows = rowCount(dirIndex);
+  for (int row = 0; row < numRows; ++row) {
+    TaggedFile* taggedFile = taggedFileOfNode(index(row, 0, dirIndex));
+    if (taggedFile && !taggedFile->isTagInformationRead()) {
+      taggedFile->readTags(false);
+    }
+  }
+}
+
+/**
+ * Called from tagged file when its tags are read, edited or cleared.
+ * The contribution of the file to the statistics of its directory is
+ * calculated again when the statistics are requested.
+ * @param fileHandle node handle of file
+ */
+void TaggedFileSystemModel::markDirectoryStatisticsOutdated(
+    const void* fileHandle) const
+{
+  if (auto fileData = static_cast<TaggedNodeData*>(
+        nodeData(indexForNodeHandle(fileHandle)))) {
+    if (fileData->taggedFile()) {
+      static_cast<TaggedFileNodeData*>(fileData)
+          ->markDirectoryStatisticsOutdated();
+    }
+  }
 }
 
 /**
@@ -251,6 +542,7 @@ void TaggedFileSystemModel::notifyModelDataChanged(const QModelIndex& index)
  */
 void TaggedFileSystemModel::updateInsertedRows(const QModelIndex& parent,
                                                int start, int end) {
+  TraceSpan span("updateInsertedRows");
   const QAbstractItemModel* model = parent.model();
   if (!model)
     return;
@@ -270,15 +562,48 @@ void TaggedFileSystemModel::resetInternalData()
   clearTaggedFileStore();
 }
 
+/**
+ * Get tagged file stored with the node of an index.
+ * @param index model index
+ * @return tagged file, null if not found.
+ */
+TaggedFile* TaggedFileSystemModel::taggedFileOfNode(
+    const QModelIndex& index) const {
+  auto fileData = static_cast<TaggedNodeData*>(nodeData(index));
+  return fileData ? fileData->taggedFile() : nullptr;
+}
+
+/**
+ * Set maximum memory used by the tags of the files in the model.
+ * When accounting is enabled, the files whose tags are already read are
+ * added to the tag memory tracker.
+ * @param bytes maximum number of bytes, 0 to disable accounting
+ */
+void TaggedFileSystemModel::setTagMemoryBudget(qint64 bytes)
+{
+  const bool wasEnabled = m_tagMemoryTracker->isEnabled();
+  m_tagMemoryTracker->setBudget(bytes);
+  if (!wasEnabled && m_tagMemoryTracker->isEnabled()) {
+    const QList<NodeData*> allData = allNodeData();
+    for (NodeData* data : allData) {
+      TaggedFile* taggedFile = static_cast<TaggedNodeData*>(data)->taggedFile();
+      if (taggedFile && taggedFile->isTagInformationRead()) {
+        m_tagMemoryTracker->fileAccessed(taggedFile, true);
+      }
+    }
+  }
+}
+
 /**
  * Retrieve tagged file for an index.
  * @param index model index
  * @return QVariant with tagged file, invalid QVariant if not found.
  */
 QVariant TaggedFileSystemModel::retrieveTaggedFileVariant(
-    const QPersistentModelIndex& index) const {
-  if (m_taggedFiles.contains(index))
-    return QVariant::fromValue(m_taggedFiles.value(index));
+    const QModelIndex& index) const {
+  auto fileData = static_cast<TaggedNodeData*>(nodeData(index));
+  if (TaggedFile* taggedFile = fileData ? fileData->taggedFile() : nullptr)
+    return QVariant::fromValue(taggedFile);
   return QVariant();
 }
 
@@ -289,20 +614,29 @@ QVariant TaggedFileSystemModel::retrieveTaggedFileVariant(
  * @return true if index and value valid
  */
 bool TaggedFileSystemModel::storeTaggedFileVariant(
-    const QPersistentModelIndex& index, const QVariant& value) {
+    const QModelIndex& index, const QVariant& value) {
   if (index.isValid()) {
     if (value.isValid()) {
       if (value.canConvert<TaggedFile*>()) {
-        TaggedFile* oldItem = m_taggedFiles.value(index, nullptr);
-        delete oldItem;
-        m_taggedFiles.insert(index, value.value<TaggedFile*>());
+        TaggedFile* taggedFile = value.value<TaggedFile*>();
+        auto fileData = static_cast<TaggedFileNodeData*>(nodeData(index));
+        if (!fileData || fileData->taggedFile() != taggedFile) {
+          // An existing tagged file is deleted with its node data.
+          if (fileData) {
+            fileData->removeFromDirectory();
+          }
+          setNodeData(index, new TaggedFileNodeData(
+                        taggedFile, m_tagMemoryTracker,
+                        static_cast<DirectoryNodeData*>(
+                          directoryNodeData(index.parent()))));
+        }
         return true;
       }
     } else {
-      if (TaggedFile* oldFile = m_taggedFiles.value(index, nullptr)) {
-        m_taggedFiles.remove(index);
-        delete oldFile;
+      if (auto fileData = static_cast<TaggedFileNodeData*>(nodeData(index))) {
+        fileData->removeFromDirectory();
       }
+      setNodeData(index, nullptr);
     }
   }
   return false;
@@ -312,8 +646,25 @@ bool TaggedFileSystemModel::storeTaggedFileVariant(
  * Clear store with tagged files.
  */
 void TaggedFileSystemModel::clearTaggedFileStore() {
-  qDeleteAll(m_taggedFiles);
-  m_taggedFiles.clear();
+  clearNodeData();
+}
+
+/**
+ * Get the statistics data of a directory, create it if it does not exist.
+ * @param dirIndex index of directory
+ * @return statistics data of directory, null if @a dirIndex is invalid.
+ */
+FileSystemModel::NodeData* TaggedFileSystemModel::directoryNodeData(
+    const QModelIndex& dirIndex)
+{
+  if (!dirIndex.isValid())
+    return nullptr;
+  NodeData* dirData = nodeData(dirIndex);
+  if (!dirData) {
+    dirData = new DirectoryNodeData;
+    setNodeData(dirIndex, dirData);
+  }
+  return dirData;
 }
 
 /**
@@ -420,3 +771,26 @@ TaggedFile* TaggedFileSystemModel::createTaggedFile(
   }
   return nullptr;
 }
+
+/**
+ * Read the data of the embedded cover picture without reading the tags.
+ * Can be called from any thread.
+ *
+ * @param filePath path to file
+ *
+ * @return picture data, empty if no picture found.
+ */
+QByteArray TaggedFileSystemModel::readPictureData(const QString& filePath)
+{
+  const auto factories = s_taggedFileFactories;
+  for (ITaggedFileFactory* factory : factories) {
+    const auto keys = factory->taggedFileKeys();
+    for (const QString& key : keys) {
+      QByteArray data = factory->readPictureData(key, filePath);
+      if (!data.isEmpty()) {
+        return data;
+      }
+    }
+  }
+  return QByteArray();
+}
@@ -32,6 +32,7 @@
 
 class CoreTaggedFileIconProvider;
 class ITaggedFileFactory;
+class TagMemoryTracker;
 
 class KID3_CORE_EXPORT TaggedFileSystemModel : public FileSystemModel {
   Q_OBJECT
@@ -106,6 +107,61 @@ public:
    */
   CoreTaggedFileIconProvider* getIconProvider() const { return m_iconProvider; }
 
+  /**
+   * Get memory accounting for the tags of the files in the model.
+   * @return tag memory tracker.
+   */
+  TagMemoryTracker* tagMemoryTracker() const { return m_tagMemoryTracker; }
+
+  /**
+   * Set maximum memory used by the tags of the files in the model.
+   * When accounting is enabled, the files whose tags are already read are
+   * added to the tag memory tracker.
+   * @param bytes maximum number of bytes, 0 to disable accounting
+   */
+  void setTagMemoryBudget(qint64 bytes);
+
+  /**
+   * Get number of tagged files in a directory.
+   *
+   * @param dirHandle node handle of directory
+   *
+   * @return number of tagged files, -1 if @a dirHandle is invalid.
+   */
+  int numberOfTaggedFilesInDirectory(const void* dirHandle) const;
+
+  /**
+   * Get aggregated information about the tagged files in a directory.
+   * The values derived from tags only include the files whose tags have been
+   * read, use readTagsInDirectory() before to include all files. They are
+   * updated from the files whose tags were read, edited or cleared since the
+   * last call, the tags of the other files are not accessed.
+   *
+   * @param dirHandle node handle of directory
+   * @param stats the statistics are returned here
+   *
+   * @return true if @a dirHandle is valid.
+   */
+  bool directoryStatistics(const void* dirHandle,
+                           TaggedFile::DirectoryStatistics& stats) const;
+
+  /**
+   * Read the tags of all files in a directory which are not read yet.
+   * This has to be done before directoryStatistics() is used if its values
+   * shall not depend on which files have been loaded.
+   *
+   * @param dirIndex index of directory
+   */
+  void readTagsInDirectory(const QModelIndex& dirIndex);
+
+  /**
+   * Called from tagged file when its tags are read, edited or cleared.
+   * The contribution of the file to the statistics of its directory is
+   * calculated again when the statistics are requested.
+   * @param fileHandle node handle of file
+   */
+  void markDirectoryStatisticsOutdated(const void* fileHandle) const;
+
   /**
    * Called from tagged file to notify modification state changes.
    * @param index model index
@@ -120,6 +176,23 @@ public:
    */
   void notifyModelDataChanged(const QModelIndex& index);
 
+  /**
+   * Get column with cover art thumbnails.
+   * The thumbnails are provided by the icon provider with
+   * CoreTaggedFileIconProvider::coverArtForFile() when the decoration of
+   * a cell in this column is requested, i.e. only for visible rows.
+   * @return column index.
+   */
+  int coverArtColumn() const {
+    return NUM_FILESYSTEM_COLUMNS + m_tagFrameColumnTypes.size();
+  }
+
+  /**
+   * Called when a cover art thumbnail is available to update the views.
+   * @param filePath path to file
+   */
+  void notifyCoverArtChanged(const QString& filePath);
+
   /**
    * Access to tagged file factories.
    * @return reference to tagged file factories.
@@ -154,6 +227,16 @@ public:
       const QString& fileName,
       const QPersistentModelIndex& idx);
 
+  /**
+   * Read the data of the embedded cover picture without reading the tags.
+   * Can be called from any thread.
+   *
+   * @param filePath path to file
+   *
+   * @return picture data, empty if no picture found.
+   */
+  static QByteArray readPictureData(const QString& filePath);
+
   /**
    * Get tagged file data of model index.
    *
@@ -204,12 +287,26 @@ private slots:
   void updateInsertedRows(const QModelIndex& parent, int start, int end);
 
 private:
+  /**
+   * Get the statistics data of a directory, create it if it does not exist.
+   * @param dirIndex index of directory
+   * @return statistics data of directory, null if @a dirIndex is invalid.
+   */
+  NodeData* directoryNodeData(const QModelIndex& dirIndex);
+
+  /**
+   * Get tagged file stored with the node of an index.
+   * @param index model index
+   * @return tagged file, null if not found.
+   */
+  TaggedFile* taggedFileOfNode(const QModelIndex& index) const;
+
   /**
    * Retrieve tagged file for an index.
    * @param index model index
    * @return QVariant with tagged file, invalid QVariant if not found.
    */
-  QVariant retrieveTaggedFileVariant(const QPersistentModelIndex& index) const;
+  QVariant retrieveTaggedFileVariant(const QModelIndex& index) const;
 
   /**
    * Store tagged file from variant with index.
@@ -217,7 +314,7 @@ private:
    * @param value QVariant containing tagged file
    * @return true if index and value valid
    */
-  bool storeTaggedFileVariant(const QPersistentModelIndex& index,
+  bool storeTaggedFileVariant(const QModelIndex& index,
                               const QVariant& value);
 
   /**
@@ -231,9 +328,9 @@ private:
    */
   void initTaggedFileData(const QModelIndex& index);
 
-  QHash<QPersistentModelIndex, TaggedFile*> m_taggedFiles;
   QList<Frame::Type> m_tagFrameColumnTypes;
   CoreTaggedFileIconProvider* m_iconProvider;
+  TagMemoryTracker* m_tagMemoryTracker;
 
   static QList<ITaggedFileFactory*> s_taggedFileFactories;
 };
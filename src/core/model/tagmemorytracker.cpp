@@ -0,0 +1,335 @@
+/**
+ * \file tagmemorytracker.cpp
+ * Memory accounting for the tags of loaded files.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tagmemorytracker.h"
+#include <QVector>
+#include <QPair>
+#include <algorithm>
+#include "taggedfile.h"
+
+namespace {
+
+/** Approximate fixed memory used by a frame in a frame collection. */
+const qint64 FRAME_OVERHEAD = 128;
+/** Approximate fixed memory used by a field of a frame. */
+const qint64 FIELD_OVERHEAD = 32;
+/** Usage is reduced to this percentage of the budget when files are evicted */
+const int EVICTION_TARGET_PERCENT = 90;
+
+/**
+ * Estimate the memory used by a field value.
+ * @param value field value
+ * @return number of bytes.
+ */
+qint64 variantSize(const QVariant& value)
+{
+  switch (value.userType()) {
+  case QMetaType::QByteArray:
+    return value.toByteArray().size();
+  case QMetaType::QString:
+    return value.toString().size() * 2;
+  default:
+    return 0;
+  }
+}
+
+}
+
+/**
+ * Constructor.
+ * @param parent parent object
+ */
+TagMemoryTracker::TagMemoryTracker(QObject* parent) : QObject(parent),
+  m_budget(0), m_usage(0), m_accessCounter(0), m_updateScheduled(false)
+{
+  setObjectName(QLatin1String("TagMemoryTracker"));
+}
+
+/**
+ * Set maximum memory used by the tags of loaded files.
+ * @param bytes maximum number of bytes, 0 to disable accounting
+ */
+void TagMemoryTracker::setBudget(qint64 bytes)
+{
+  if (bytes < 0) {
+    bytes = 0;
+  }
+  if (m_budget != bytes) {
+    m_budget = bytes;
+    if (m_budget == 0) {
+      m_entries.clear();
+      m_modifiedFiles.clear();
+      m_usage = 0;
+    }
+    scheduleUpdate();
+  }
+}
+
+/**
+ * Update accounting after the tags of a file have been read or cleared.
+ *
+ * @param taggedFile tagged file
+ * @param priorIsTagInformationRead prior value returned by
+ * isTagInformationRead()
+ */
+void TagMemoryTracker::fileAccessed(TaggedFile* taggedFile,
+                                    bool priorIsTagInformationRead)
+{
+  if (!isEnabled())
+    return;
+
+  auto it = m_entries.find(taggedFile);
+  if (taggedFile->isTagInformationRead()) {
+    const qint64 bytes = estimateTagMemory(taggedFile);
+    m_modifiedFiles.remove(taggedFile);
+    if (it != m_entries.end()) {
+      m_usage += bytes - it->bytes;
+      it->bytes = bytes;
+      it->lastAccess = ++m_accessCounter;
+    } else {
+      m_usage += bytes;
+      m_entries.insert(taggedFile, {bytes, ++m_accessCounter});
+    }
+    scheduleUpdate();
+  } else if (it != m_entries.end()) {
+    m_usage -= it->bytes;
+    m_entries.erase(it);
+    m_modifiedFiles.remove(taggedFile);
+    scheduleUpdate();
+  } else if (priorIsTagInformationRead) {
+    scheduleUpdate();
+  }
+}
+
+/**
+ * Update accounting after the frames of a file have been changed.
+ * The memory used by the tags is estimated again in the next update.
+ * @param taggedFile tagged file
+ */
+void TagMemoryTracker::fileModified(TaggedFile* taggedFile)
+{
+  if (!isEnabled())
+    return;
+
+  auto it = m_entries.find(taggedFile);
+  if (it != m_entries.end()) {
+    // Estimating all frames on every changed frame would be too expensive
+    // when many frames are set, so this is deferred to update().
+    it->lastAccess = ++m_accessCounter;
+    m_modifiedFiles.insert(taggedFile);
+    scheduleUpdate();
+  }
+}
+
+/**
+ * Remove a file which is about to be deleted from the accounting.
+ * @param taggedFile tagged file
+ */
+void TagMemoryTracker::fileRemoved(TaggedFile* taggedFile)
+{
+  m_pinnedFiles.remove(taggedFile);
+  for (auto it = m_operationFiles.begin(); it != m_operationFiles.end(); ++it) {
+    it->remove(taggedFile);
+  }
+  m_modifiedFiles.remove(taggedFile);
+  auto it = m_entries.find(taggedFile);
+  if (it != m_entries.end()) {
+    m_usage -= it->bytes;
+    m_entries.erase(it);
+    scheduleUpdate();
+  }
+}
+
+/**
+ * Set files whose tags must not be cleared, e.g. the selected files.
+ * @param taggedFiles files to keep
+ */
+void TagMemoryTracker::setPinnedFiles(const QSet<TaggedFile*>& taggedFiles)
+{
+  m_pinnedFiles = taggedFiles;
+}
+
+/**
+ * Add files whose tags must not be cleared.
+ * @param taggedFiles files to keep in addition to the already pinned files
+ */
+void TagMemoryTracker::addPinnedFiles(const QSet<TaggedFile*>& taggedFiles)
+{
+  m_pinnedFiles.unite(taggedFiles);
+}
+
+/**
+ * Set files whose tags must not be cleared while an operation is running,
+ * e.g. the files of a batch import. The files are kept in addition to the
+ * pinned files and the files of other operations.
+ * @param owner operation using the files
+ * @param taggedFiles files to keep, replacing those set before by @a owner
+ */
+void TagMemoryTracker::setOperationFiles(const void* owner,
+                                         const QSet<TaggedFile*>& taggedFiles)
+{
+  if (taggedFiles.isEmpty()) {
+    m_operationFiles.remove(owner);
+  } else {
+    m_operationFiles.insert(owner, taggedFiles);
+  }
+}
+
+/**
+ * Add files whose tags must not be cleared while an operation is running.
+ * @param owner operation using the files
+ * @param taggedFiles files to keep in addition to those of @a owner
+ */
+void TagMemoryTracker::addOperationFiles(const void* owner,
+                                         const QSet<TaggedFile*>& taggedFiles)
+{
+  if (!taggedFiles.isEmpty()) {
+    m_operationFiles[owner].unite(taggedFiles);
+  }
+}
+
+/**
+ * Release the files of an operation when it is finished.
+ * @param owner operation which used the files
+ */
+void TagMemoryTracker::releaseOperationFiles(const void* owner)
+{
+  if (m_operationFiles.remove(owner)) {
+    // Files which were kept for the operation can now be evicted.
+    scheduleUpdate();
+  }
+}
+
+/**
+ * Remove all files from the accounting.
+ */
+void TagMemoryTracker::clear()
+{
+  m_entries.clear();
+  m_pinnedFiles.clear();
+  m_operationFiles.clear();
+  m_modifiedFiles.clear();
+  m_usage = 0;
+  scheduleUpdate();
+}
+
+/**
+ * Estimate the memory used by the tags of a file.
+ * @param taggedFile tagged file with read tags
+ * @return estimated number of bytes.
+ */
+qint64 TagMemoryTracker::estimateTagMemory(TaggedFile* taggedFile)
+{
+  qint64 bytes = 0;
+  FrameCollection frames;
+  FOR_ALL_TAGS(tagNr) {
+    if (!taggedFile->isTagSupported(tagNr))
+      continue;
+
+    taggedFile->getAllFrames(tagNr, frames);
+    for (auto it = frames.cbegin(); it != frames.cend(); ++it) {
+      bytes += FRAME_OVERHEAD +
+          (it->getValue().size() + it->getInternalName().size()) * 2;
+      const Frame::FieldList& fields = it->getFieldList();
+      for (auto fit = fields.constBegin(); fit != fields.constEnd(); ++fit) {
+        bytes += FIELD_OVERHEAD + variantSize(fit->m_value);
+      }
+    }
+  }
+  return bytes;
+}
+
+/**
+ * Schedule an update of the accounting in the event loop.
+ * Files are not evicted immediately because they may still be used by the
+ * operation which caused them to be read.
+ */
+void TagMemoryTracker::scheduleUpdate()
+{
+  if (!m_updateScheduled) {
+    m_updateScheduled = true;
+    QMetaObject::invokeMethod(this, "update", Qt::QueuedConnection);
+  }
+}
+
+/**
+ * Check if the tags of a file must not be cleared.
+ * @param taggedFile tagged file
+ * @return true if the file is pinned or used by a running operation.
+ */
+bool TagMemoryTracker::isPinned(TaggedFile* taggedFile) const
+{
+  if (m_pinnedFiles.contains(taggedFile))
+    return true;
+  for (auto it = m_operationFiles.constBegin();
+       it != m_operationFiles.constEnd();
+       ++it) {
+    if (it->contains(taggedFile))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * Estimate the memory of modified files again, evict the least recently
+ * used unmodified files if the budget is exceeded and report the usage.
+ * This is done automatically from the event loop, it can be called to
+ * get the current usage immediately.
+ */
+void TagMemoryTracker::update()
+{
+  // Evicted files must not schedule another update.
+  m_updateScheduled = true;
+  for (TaggedFile* taggedFile : qAsConst(m_modifiedFiles)) {
+    auto it = m_entries.find(taggedFile);
+    if (it != m_entries.end()) {
+      const qint64 bytes = estimateTagMemory(taggedFile);
+      m_usage += bytes - it->bytes;
+      it->bytes = bytes;
+    }
+  }
+  m_modifiedFiles.clear();
+  if (isEnabled() && m_usage > m_budget) {
+    QVector<QPair<quint64, TaggedFile*>> candidates;
+    candidates.reserve(m_entries.size());
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+      TaggedFile* taggedFile = it.key();
+      if (!taggedFile->isChanged() && !isPinned(taggedFile)) {
+        candidates.append(qMakePair(it->lastAccess, taggedFile));
+      }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    const qint64 target = m_budget * EVICTION_TARGET_PERCENT / 100;
+    for (auto it = candidates.constBegin();
+         it != candidates.constEnd() && m_usage > target;
+         ++it) {
+      // The file is removed from m_entries in fileAccessed().
+      it->second->clearTags(false);
+    }
+  }
+  m_updateScheduled = false;
+  emit usageChanged(m_usage, m_budget);
+}
@@ -0,0 +1,195 @@
+/**
+ * \file tagmemorytracker.h
+ * Memory accounting for the tags of loaded files.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include "kid3api.h"
+
+class TaggedFile;
+
+/**
+ * Keeps track of the memory used by the tags of loaded files.
+ *
+ * The memory used by the tags of a file is estimated from its frames when
+ * the tags are read, and estimated again when its frames are edited. If a
+ * budget is set and the tags of all loaded files
+ * exceed it, the tags of the least recently read unmodified files are
+ * cleared until the usage is below the budget again. Accounting is only
+ * active when a budget is set.
+ */
+class KID3_CORE_EXPORT TagMemoryTracker : public QObject {
+  Q_OBJECT
+public:
+  /**
+   * Constructor.
+   * @param parent parent object
+   */
+  explicit TagMemoryTracker(QObject* parent = nullptr);
+
+  /**
+   * Destructor.
+   */
+  virtual ~TagMemoryTracker() override = default;
+
+  /**
+   * Set maximum memory used by the tags of loaded files.
+   * @param bytes maximum number of bytes, 0 to disable accounting
+   */
+  void setBudget(qint64 bytes);
+
+  /**
+   * Get maximum memory used by the tags of loaded files.
+   * @return maximum number of bytes, 0 if unlimited.
+   */
+  qint64 budget() const { return m_budget; }
+
+  /**
+   * Check if memory accounting is active.
+   * @return true if a budget is set.
+   */
+  bool isEnabled() const { return m_budget > 0; }
+
+  /**
+   * Get estimated memory used by the tags of loaded files.
+   * @return number of bytes.
+   */
+  qint64 usage() const { return m_usage; }
+
+  /**
+   * Get number of files with loaded tags which are accounted.
+   * @return number of files.
+   */
+  int numLoadedFiles() const { return m_entries.size(); }
+
+  /**
+   * Update accounting after the tags of a file have been read or cleared.
+   *
+   * @param taggedFile tagged file
+   * @param priorIsTagInformationRead prior value returned by
+   * isTagInformationRead()
+   */
+  void fileAccessed(TaggedFile* taggedFile, bool priorIsTagInformationRead);
+
+  /**
+   * Update accounting after the frames of a file have been changed.
+   * The memory used by the tags is estimated again in the next update.
+   * @param taggedFile tagged file
+   */
+  void fileModified(TaggedFile* taggedFile);
+
+  /**
+   * Remove a file which is about to be deleted from the accounting.
+   * @param taggedFile tagged file
+   */
+  void fileRemoved(TaggedFile* taggedFile);
+
+  /**
+   * Set files whose tags must not be cleared, e.g. the selected files.
+   * @param taggedFiles files to keep
+   */
+  void setPinnedFiles(const QSet<TaggedFile*>& taggedFiles);
+
+  /**
+   * Add files whose tags must not be cleared.
+   * @param taggedFiles files to keep in addition to the already pinned files
+   */
+  void addPinnedFiles(const QSet<TaggedFile*>& taggedFiles);
+
+  /**
+   * Set files whose tags must not be cleared while an operation is running,
+   * e.g. the files of a batch import. The files are kept in addition to the
+   * pinned files and the files of other operations.
+   * @param owner operation using the files
+   * @param taggedFiles files to keep, replacing those set before by @a owner
+   */
+  void setOperationFiles(const void* owner,
+                         const QSet<TaggedFile*>& taggedFiles);
+
+  /**
+   * Add files whose tags must not be cleared while an operation is running.
+   * @param owner operation using the files
+   * @param taggedFiles files to keep in addition to those of @a owner
+   */
+  void addOperationFiles(const void* owner,
+                         const QSet<TaggedFile*>& taggedFiles);
+
+  /**
+   * Release the files of an operation when it is finished.
+   * @param owner operation which used the files
+   */
+  void releaseOperationFiles(const void* owner);
+
+  /**
+   * Remove all files from the accounting.
+   */
+  void clear();
+
+  /**
+   * Estimate the memory used by the tags of a file.
+   * @param taggedFile tagged file with read tags
+   * @return estimated number of bytes.
+   */
+  static qint64 estimateTagMemory(TaggedFile* taggedFile);
+
+public slots:
+  /**
+   * Estimate the memory of modified files again, evict the least recently
+   * used unmodified files if the budget is exceeded and report the usage.
+   * This is done automatically from the event loop, it can be called to
+   * get the current usage immediately.
+   */
+  void update();
+
+signals:
+  /**
+   * Emitted when the usage or the budget changed.
+   * @param usage estimated number of bytes used
+   * @param budget maximum number of bytes, 0 if unlimited
+   */
+  void usageChanged(qint64 usage, qint64 budget);
+
+private:
+  /** Accounting information of a file. */
+  struct Entry {
+    qint64 bytes;
+    quint64 lastAccess;
+  };
+
+  void scheduleUpdate();
+  bool isPinned(TaggedFile* taggedFile) const;
+
+  QHash<TaggedFile*, Entry> m_entries;
+  QSet<TaggedFile*> m_pinnedFiles;
+  QHash<const void*, QSet<TaggedFile*>> m_operationFiles;
+  QSet<TaggedFile*> m_modifiedFiles;
+  qint64 m_budget;
+  qint64 m_usage;
+  quint64 m_accessCounter;
+  bool m_updateScheduled;
+};
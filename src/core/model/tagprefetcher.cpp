@@ -0,0 +1,258 @@
+/**
+ * \file tagprefetcher.cpp
+ * Background prefetch of the tags of the next files.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tagprefetcher.h"
+#include <QFile>
+#include <QItemSelectionModel>
+#include "fileproxymodel.h"
+#include "taggedfile.h"
+#include "tagmemorytracker.h"
+#include "tracer.h"
+
+namespace {
+
+/** Number of bytes read from the start of a file */
+const qint64 HEAD_BYTES = 256 * 1024;
+/** Number of bytes read from the end of a file, e.g. for ID3v1 and APE */
+const qint64 TAIL_BYTES = 128 * 1024;
+/** Maximum number of bytes read for an ID3v2 tag with large pictures */
+const qint64 MAX_ID3V2_BYTES = 16 * 1024 * 1024;
+
+/**
+ * Get the size of an ID3v2 tag at the start of a file.
+ * @param head data from the start of the file
+ * @return size of tag including header, 0 if no ID3v2 tag found.
+ */
+qint64 id3v2TagSize(const QByteArray& head)
+{
+  if (head.size() < 10 || !head.startsWith("ID3"))
+    return 0;
+
+  // The size is a 28 bit synchsafe integer.
+  qint64 size = 0;
+  for (int i = 6; i < 10; ++i) {
+    size = (size << 7) | (static_cast<uchar>(head.at(i)) & 0x7f);
+  }
+  return size + 10;
+}
+
+}
+
+/**
+ * Job reading the parts of a file which contain its tags, so that they are
+ * cached by the operating system when the tags are read.
+ */
+class TagPrefetcher::LoadJob : public QRunnable {
+public:
+  LoadJob(TagPrefetcher* prefetcher, const QString& filePath)
+    : m_prefetcher(prefetcher), m_filePath(filePath) {
+  }
+
+  virtual void run() override;
+
+private:
+  TagPrefetcher* m_prefetcher;
+  const QString m_filePath;
+};
+
+void TagPrefetcher::LoadJob::run()
+{
+  TraceSpan span("prefetch load");
+  QFile file(m_filePath);
+  if (file.open(QIODevice::ReadOnly)) {
+    // The data is discarded, it is only read to have it in the cache.
+    const QByteArray head = file.read(HEAD_BYTES);
+    qint64 remaining = qMin(id3v2TagSize(head), MAX_ID3V2_BYTES) - head.size();
+    while (remaining > 0) {
+      const qint64 len = file.read(qMin(remaining, HEAD_BYTES)).size();
+      if (len <= 0)
+        break;
+      remaining -= len;
+    }
+    const qint64 tailPos = file.size() - TAIL_BYTES;
+    if (tailPos > file.pos() && file.seek(tailPos)) {
+      file.read(TAIL_BYTES);
+    }
+  }
+  QMetaObject::invokeMethod(m_prefetcher, "onFileLoaded",
+                            Qt::QueuedConnection,
+                            Q_ARG(QString, m_filePath));
+}
+
+
+/**
+ * Constructor.
+ * @param selectionModel selection model of file proxy model, selected
+ * files are not cleared
+ * @param tracker memory tracker which must not evict the files of the
+ * window, nullptr if not used
+ * @param parent parent object
+ */
+TagPrefetcher::TagPrefetcher(QItemSelectionModel* selectionModel,
+                             TagMemoryTracker* tracker, QObject* parent)
+  : QObject(parent), m_selectionModel(selectionModel), m_tracker(tracker),
+    m_count(0)
+{
+  setObjectName(QLatin1String("TagPrefetcher"));
+  m_threadPool.setMaxThreadCount(2);
+}
+
+/**
+ * Destructor.
+ * Waits until the running jobs are finished.
+ */
+TagPrefetcher::~TagPrefetcher()
+{
+  m_threadPool.clear();
+  m_threadPool.waitForDone();
+}
+
+/**
+ * Set number of files read in advance.
+ * @param count number of files, 0 to disable prefetching
+ */
+void TagPrefetcher::setCount(int count)
+{
+  if (count < 0) {
+    count = 0;
+  }
+  if (m_count != count) {
+    m_count = count;
+    if (m_count == 0) {
+      setWindow(QPersistentModelIndex(), {});
+    }
+  }
+}
+
+/**
+ * Set the files following the current file.
+ * Files which are not yet read are read in the background, files outside
+ * of the new window are cleared if the current file is not in the
+ * previous window.
+ *
+ * @param current index of current file in file proxy model
+ * @param nextIndexes indexes of the next count() tagged files in file
+ * proxy model order
+ */
+void TagPrefetcher::setWindow(const QPersistentModelIndex& current,
+                              const QList<QPersistentModelIndex>& nextIndexes)
+{
+  // Moving to the next file or one of the following files is not a jump,
+  // the files which were skipped are kept up to the limit.
+  const bool jumped = current != m_current && !m_window.contains(current);
+  m_current = current;
+  m_window = nextIndexes.mid(0, m_count);
+  // The visited file is now owned by the user and never cleared here.
+  m_prefetched.removeAll(current);
+
+  const int maxKept = 2 * m_count;
+  for (auto it = m_prefetched.begin(); it != m_prefetched.end();) {
+    if (!it->isValid()) {
+      it = m_prefetched.erase(it);
+    } else if (!m_window.contains(*it) &&
+               (jumped || m_prefetched.size() > maxKept)) {
+      evict(*it);
+      it = m_prefetched.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  // Jobs which have not yet started are no longer needed.
+  m_threadPool.clear();
+  m_loadingPaths.clear();
+  QSet<TaggedFile*> windowFiles;
+  for (const QPersistentModelIndex& index : qAsConst(m_window)) {
+    TaggedFile* taggedFile = FileProxyModel::getTaggedFileOfIndex(index);
+    if (taggedFile) {
+      windowFiles.insert(taggedFile);
+      if (!taggedFile->isTagInformationRead()) {
+        const QString filePath = taggedFile->currentFilePath();
+        m_loadingPaths.insert(filePath);
+        m_threadPool.start(new LoadJob(this, filePath));
+      }
+    }
+  }
+  // The files of the window are about to be visited, the memory tracker
+  // must not clear them before.
+  if (m_tracker) {
+    m_tracker->setOperationFiles(this, windowFiles);
+  }
+}
+
+/**
+ * Stop prefetching and forget prefetched files without clearing them.
+ * Used when the files are no longer valid, e.g. when another folder is
+ * opened.
+ */
+void TagPrefetcher::clear()
+{
+  m_threadPool.clear();
+  m_loadingPaths.clear();
+  m_current = QPersistentModelIndex();
+  m_window.clear();
+  m_prefetched.clear();
+  if (m_tracker) {
+    m_tracker->releaseOperationFiles(this);
+  }
+}
+
+/**
+ * Called in the main thread when the data of a file has been loaded.
+ * @param filePath path to file
+ */
+void TagPrefetcher::onFileLoaded(const QString& filePath)
+{
+  if (!m_loadingPaths.remove(filePath))
+    return;
+
+  for (const QPersistentModelIndex& index : qAsConst(m_window)) {
+    TaggedFile* taggedFile = FileProxyModel::getTaggedFileOfIndex(index);
+    if (taggedFile && taggedFile->currentFilePath() == filePath) {
+      if (!taggedFile->isTagInformationRead()) {
+        TraceSpan span("prefetch readTags");
+        FileProxyModel::readTagsFromTaggedFile(taggedFile);
+        if (!m_prefetched.contains(index)) {
+          m_prefetched.append(index);
+        }
+      }
+      break;
+    }
+  }
+}
+
+/**
+ * Clear the tags of a prefetched file if they are not used.
+ * @param index index of file in file proxy model
+ */
+void TagPrefetcher::evict(const QPersistentModelIndex& index)
+{
+  TaggedFile* taggedFile = FileProxyModel::getTaggedFileOfIndex(index);
+  if (taggedFile && !taggedFile->isChanged() &&
+      !(m_selectionModel && m_selectionModel->isSelected(index))) {
+    taggedFile->clearTags(false);
+  }
+}
@@ -0,0 +1,138 @@
+/**
+ * \file tagprefetcher.h
+ * Background prefetch of the tags of the next files.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QList>
+#include <QSet>
+#include <QPersistentModelIndex>
+#include <QThreadPool>
+#include "kid3api.h"
+
+class QItemSelectionModel;
+class TagMemoryTracker;
+
+/**
+ * Reads the tags of the files following the current file in advance.
+ *
+ * The file data containing the tags is read in a background thread, so
+ * that the slow part of accessing files on network storage does not block
+ * the user interface. Then the tags are read from the already cached data
+ * in the main thread, which is required because tagged files are not
+ * thread-safe. When the user selects one of these files, its tags are
+ * already available.
+ *
+ * The tags of prefetched files which were not visited are cleared again when
+ * the user jumps to another location, at most twice the number of files in
+ * the window are kept.
+ */
+class KID3_CORE_EXPORT TagPrefetcher : public QObject {
+  Q_OBJECT
+public:
+  /**
+   * Constructor.
+   * @param selectionModel selection model of file proxy model, selected
+   * files are not cleared
+   * @param tracker memory tracker which must not evict the files of the
+   * window, nullptr if not used
+   * @param parent parent object
+   */
+  explicit TagPrefetcher(QItemSelectionModel* selectionModel,
+                         TagMemoryTracker* tracker = nullptr,
+                         QObject* parent = nullptr);
+
+  /**
+   * Destructor.
+   * Waits until the running jobs are finished.
+   */
+  virtual ~TagPrefetcher() override;
+
+  /**
+   * Set number of files read in advance.
+   * @param count number of files, 0 to disable prefetching
+   */
+  void setCount(int count);
+
+  /**
+   * Get number of files read in advance.
+   * @return number of files, 0 if disabled.
+   */
+  int count() const { return m_count; }
+
+  /**
+   * Check if prefetching is active.
+   * @return true if count() is not 0.
+   */
+  bool isEnabled() const { return m_count > 0; }
+
+  /**
+   * Set the files following the current file.
+   * Files which are not yet read are read in the background, files outside
+   * of the new window are cleared if the current file is not in the
+   * previous window.
+   *
+   * @param current index of current file in file proxy model
+   * @param nextIndexes indexes of the next count() tagged files in file
+   * proxy model order
+   */
+  void setWindow(const QPersistentModelIndex& current,
+                 const QList<QPersistentModelIndex>& nextIndexes);
+
+  /**
+   * Stop prefetching and forget prefetched files without clearing them.
+   * Used when the files are no longer valid, e.g. when another folder is
+   * opened.
+   */
+  void clear();
+
+  /**
+   * Get number of files read by the prefetcher which have not been visited.
+   * @return number of files.
+   */
+  int numPrefetchedFiles() const { return m_prefetched.size(); }
+
+private slots:
+  void onFileLoaded(const QString& filePath);
+
+private:
+  class LoadJob;
+
+  void evict(const QPersistentModelIndex& index);
+
+  QItemSelectionModel* m_selectionModel;
+  TagMemoryTracker* m_tracker;
+  QThreadPool m_threadPool;
+  /** Current file */
+  QPersistentModelIndex m_current;
+  /** Files following the current file */
+  QList<QPersistentModelIndex> m_window;
+  /** Files read by prefetcher and not yet visited, oldest first */
+  QList<QPersistentModelIndex> m_prefetched;
+  /** Files being loaded in the thread pool */
+  QSet<QString> m_loadingPaths;
+  int m_count;
+};
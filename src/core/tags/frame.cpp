@@ -38,6 +38,7 @@
 #include <QTextCodec>
 #endif
 #include "pictureframe.h"
+#include "taggedfile.h"
 
 namespace {
 
@@ -367,12 +368,13 @@ Frame::FieldList reducedFieldList(const Frame::FieldList& fieldList)
 }
 
 Frame::ExtendedType::ExtendedType(const QString& name) :
-  m_type(getTypeFromName(name)), m_name(name)
+  m_type(getTypeFromName(name)), m_name(FrameStringPool::intern(name))
 {
 }
 
 Frame::ExtendedType::ExtendedType(Type type) :
-  m_type(type), m_name(QString::fromLatin1(getNameFromType(type)))
+  m_type(type),
+  m_name(FrameStringPool::intern(QString::fromLatin1(getNameFromType(type))))
 {
 }
 
@@ -411,7 +413,8 @@ Frame::Frame()
  */
 Frame::Frame(Type type, const QString& value,
              const QString& name, int index)
-  : m_extendedType(type, name), m_index(index), m_value(value),
+  : m_extendedType(type, name), m_index(index),
+    m_value(FrameStringPool::internValue(type, value)),
     m_marked(FrameNotice::None), m_valueChanged(false)
 {
 }
@@ -423,7 +426,8 @@ Frame::Frame(Type type, const QString& value,
  * @param index index inside tag, -1 if unknown
  */
 Frame::Frame(const ExtendedType& type, const QString& value, int index)
-  : m_extendedType(type), m_index(index), m_value(value),
+  : m_extendedType(type), m_index(index),
+    m_value(FrameStringPool::internValue(type.getType(), value)),
     m_marked(FrameNotice::None), m_valueChanged(false)
 {
 }
@@ -441,7 +445,8 @@ void Frame::setValueFromFieldList()
       if (id == ID_Text ||
           id == ID_Description ||
           id == ID_Url) {
-        m_value = (*fldIt).m_value.toString();
+        m_value = FrameStringPool::internValue(
+              m_extendedType.m_type, (*fldIt).m_value.toString());
         if (id == ID_Text) {
           // highest priority, will not be overwritten
           break;
@@ -998,6 +1003,8 @@ bool Frame::setNamesForCustomFrames(const QStringList& customNames)
     customFrameNames.swap(newCustomFrameNames);
     // Invalidate mapping used by getTypeFromName()
     customFrameNameMap.clear();
+    // Compiled filename formats contain types from getTypeFromName()
+    TaggedFile::clearFilenameFormatCache();
     return true;
   }
   return false;
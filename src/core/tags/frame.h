@@ -34,6 +34,7 @@
 #include <set>
 #include "formatreplacer.h"
 #include "framenotice.h"
+#include "framestringpool.h"
 #include "kid3api.h"
 
 /** Generalized frame. */
@@ -434,7 +435,8 @@ public:
      * @param type type
      * @param name internal name
      */
-    ExtendedType(Type type, const QString& name) : m_type(type), m_name(name) {}
+    ExtendedType(Type type, const QString& name)
+      : m_type(type), m_name(FrameStringPool::intern(name)) {}
 
     /**
      * Constructor.
@@ -602,7 +604,9 @@ public:
    * Set value as string.
    * @param value value as string
    */
-  void setValue(const QString& value) { m_value = value; }
+  void setValue(const QString& value) {
+    m_value = FrameStringPool::internValue(m_extendedType.m_type, value);
+  }
 
   /**
    * Get value as integer.
@@ -0,0 +1,162 @@
+/**
+ * \file framestringpool.cpp
+ * Shared storage of strings used by many frames.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "framestringpool.h"
+#include "frame.h"
+
+namespace {
+
+/** Maximum number of strings in the pool */
+const int MAX_STRINGS = 200000;
+/** Longer values are not interned, they are rarely repeated */
+const int MAX_VALUE_LENGTH = 128;
+
+/** Frame types whose values are interned */
+const quint64 INTERNED_VALUE_TYPES =
+    (1ULL << Frame::FT_Artist)         |
+    (1ULL << Frame::FT_Album)          |
+    (1ULL << Frame::FT_Date)           |
+    (1ULL << Frame::FT_Genre)          |
+    (1ULL << Frame::FT_AlbumArtist)    |
+    (1ULL << Frame::FT_Composer)       |
+    (1ULL << Frame::FT_Conductor)      |
+    (1ULL << Frame::FT_Copyright)      |
+    (1ULL << Frame::FT_EncodedBy)      |
+    (1ULL << Frame::FT_EncoderSettings) |
+    (1ULL << Frame::FT_Language)       |
+    (1ULL << Frame::FT_Publisher);
+
+}
+
+/**
+ * Constructor.
+ */
+FrameStringPool::FrameStringPool() : m_enabled(1)
+{
+}
+
+/**
+ * Get the pool used by the application.
+ * @return string pool.
+ */
+FrameStringPool& FrameStringPool::instance()
+{
+  static FrameStringPool pool;
+  return pool;
+}
+
+/**
+ * Get an interned copy of a frame value if the frame type has values
+ * which are typically repeated in many files.
+ * @param type frame type, Frame::Type
+ * @param str value
+ * @return string sharing its data with an equal string in the pool,
+ * @a str if values of @a type are not interned.
+ */
+QString FrameStringPool::internValue(int type, const QString& str)
+{
+  if (type < 0 || type >= 64 || !(INTERNED_VALUE_TYPES & (1ULL << type)) ||
+      str.isEmpty() || str.size() > MAX_VALUE_LENGTH)
+    return str;
+
+  return intern(str);
+}
+
+/**
+ * Enable or disable interning.
+ * Interning is enabled by default, strings already interned are kept.
+ * @param enabled true to enable
+ */
+void FrameStringPool::setEnabled(bool enabled)
+{
+  instance().m_enabled.storeRelaxed(enabled ? 1 : 0);
+}
+
+/**
+ * Get number of strings in the pool.
+ * @return number of strings.
+ */
+int FrameStringPool::size()
+{
+  FrameStringPool& pool = instance();
+  QMutexLocker locker(&pool.m_mutex);
+  return pool.m_strings.size();
+}
+
+/**
+ * Remove strings which are no longer used outside of the pool.
+ */
+void FrameStringPool::purge()
+{
+  FrameStringPool& pool = instance();
+  QMutexLocker locker(&pool.m_mutex);
+  pool.removeUnused();
+}
+
+/**
+ * Get the string from the pool, insert it if not yet contained.
+ * @param str string
+ * @return string from pool.
+ */
+QString FrameStringPool::insert(const QString& str)
+{
+  if (str.isEmpty())
+    return str;
+
+  QMutexLocker locker(&m_mutex);
+  auto it = m_strings.constFind(str);
+  if (it != m_strings.constEnd())
+    return *it;
+
+  if (m_strings.size() >= MAX_STRINGS) {
+    removeUnused();
+    // If most strings are still used, the new string is not interned to
+    // avoid purging again for every call.
+    if (m_strings.size() >= MAX_STRINGS * 3 / 4)
+      return str;
+  }
+  // A deep copy is stored, so that the pool does not keep extra capacity
+  // or raw data of the caller.
+  const QString copy(str.constData(), str.size());
+  m_strings.insert(copy);
+  return copy;
+}
+
+/**
+ * Remove strings which are only referenced by the pool.
+ * Must be called with the mutex locked.
+ */
+void FrameStringPool::removeUnused()
+{
+  for (auto it = m_strings.begin(); it != m_strings.end();) {
+    // Detached means that the data is not shared with another string.
+    if (it->isDetached()) {
+      it = m_strings.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
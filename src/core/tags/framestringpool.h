@@ -0,0 +1,107 @@
+/**
+ * \file framestringpool.h
+ * Shared storage of strings used by many frames.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QSet>
+#include <QMutex>
+#include <QAtomicInt>
+#include "kid3api.h"
+
+/**
+ * Pool of interned strings for frame names and common frame values.
+ *
+ * QString is implicitly shared, but strings created separately for each
+ * file, e.g. the name "ALBUMARTIST" or the album name of each track, have
+ * their own copy of the data. Interning returns a copy of an equal string
+ * already in the pool, so that all frames refer to the same data and the
+ * duplicate is freed. Only values of frame types which are typically
+ * repeated in many files (artist, album, genre, ...) are interned, unique
+ * values such as titles are kept as they are.
+ *
+ * The pool is thread-safe. It is bounded, strings which are no longer used
+ * outside of the pool are removed when it gets full.
+ */
+class KID3_CORE_EXPORT FrameStringPool {
+public:
+  /**
+   * Get an interned copy of a frame name.
+   * @param str string
+   * @return string sharing its data with an equal string in the pool,
+   * @a str if interning is disabled or the pool is full.
+   */
+  static QString intern(const QString& str) {
+    return instance().m_enabled.loadRelaxed() ? instance().insert(str) : str;
+  }
+
+  /**
+   * Get an interned copy of a frame value if the frame type has values
+   * which are typically repeated in many files.
+   * @param type frame type, Frame::Type
+   * @param str value
+   * @return string sharing its data with an equal string in the pool,
+   * @a str if values of @a type are not interned.
+   */
+  static QString internValue(int type, const QString& str);
+
+  /**
+   * Enable or disable interning.
+   * Interning is enabled by default, strings already interned are kept.
+   * @param enabled true to enable
+   */
+  static void setEnabled(bool enabled);
+
+  /**
+   * Check if interning is enabled.
+   * @return true if enabled.
+   */
+  static bool isEnabled() { return instance().m_enabled.loadRelaxed() != 0; }
+
+  /**
+   * Get number of strings in the pool.
+   * @return number of strings.
+   */
+  static int size();
+
+  /**
+   * Remove strings which are no longer used outside of the pool.
+   */
+  static void purge();
+
+private:
+  FrameStringPool();
+
+  static FrameStringPool& instance();
+  QString insert(const QString& str);
+  void removeUnused();
+
+  QMutex m_mutex;
+  QSet<QString> m_strings;
+  QAtomicInt m_enabled;
+
+  Q_DISABLE_COPY(FrameStringPool)
+};
@@ -28,7 +28,9 @@
 #include "frame.h"
 #include <QString>
 #include <QVector>
-#include <QMap>
+#include <QHash>
+#include <QMutex>
+#include <algorithm>
 
 /**
  * Alphabetic list of genres, starts with unknown (empty) entry.
@@ -447,6 +449,16 @@ const char* Genres::getName(int num)
   return s_genre[getIndex(num)];
 }
 
+namespace {
+
+/** Genre name with its number. */
+struct GenreEntry {
+  const char* name;
+  unsigned char number;
+};
+
+}
+
 /**
  * Get the index in the alphabetically sorted list from the genre number.
  *
@@ -456,17 +468,21 @@ const char* Genres::getName(int num)
  */
 int Genres::getIndex(int num)
 {
-  int i;
-  for (i = 0; i < Genres::count + 1; i++) {
-    if (s_genreNum[i] == num) {
-      return i;
+  // Inverse of s_genreNum, built on first use.
+  static const QVector<unsigned char> indexOfNumber = [] {
+    QVector<unsigned char> indexes(256, 0);
+    // Iterate backwards, so that the first index is used for a number.
+    for (int i = Genres::count; i >= 0; --i) {
+      indexes[s_genreNum[i]] = static_cast<unsigned char>(i);
     }
-  }
-  return 0; // 0 for unknown entry
+    return indexes;
+  }();
+  return num >= 0 && num < 256 ? indexOfNumber.at(num) : 0;
 }
 
 /**
  * Get the genre number from a string containing a genre text.
+ * The genre text is compared case insensitively.
  *
  * @param str string with genre
  *
@@ -474,32 +490,75 @@ int Genres::getIndex(int num)
  */
 int Genres::getNumber(const QString& str)
 {
-  static QMap<QString, int> strNumMap;
-  if (strNumMap.empty()) {
-    // first time initialization
-    for (int i = 0; i < Genres::count + 1; i++) {
-      strNumMap.insert(QString::fromLatin1(s_genre[i]), s_genreNum[i]);
+  if (str.isEmpty())
+    return 255;
+
+  // Genre names sorted case insensitively with their numbers, built on
+  // first use and searched with a binary search.
+  static const QVector<GenreEntry> entries = [] {
+    QVector<GenreEntry> genres;
+    genres.reserve(Genres::count);
+    for (int i = 1; i < Genres::count + 1; i++) {
+      genres.append({s_genre[i], s_genreNum[i]});
     }
-  }
-  auto it = strNumMap.constFind(str);
-  if (it != strNumMap.constEnd()) {
-    return *it;
+    std::sort(genres.begin(), genres.end(),
+              [](const GenreEntry& lhs, const GenreEntry& rhs) {
+      return QString::fromLatin1(lhs.name).compare(
+            QLatin1String(rhs.name), Qt::CaseInsensitive) < 0;
+    });
+    return genres;
+  }();
+  auto it = std::lower_bound(entries.constBegin(), entries.constEnd(), str,
+                             [](const GenreEntry& entry, const QString& s) {
+    return s.compare(QLatin1String(entry.name), Qt::CaseInsensitive) > 0;
+  });
+  if (it != entries.constEnd() &&
+      str.compare(QLatin1String(it->name), Qt::CaseInsensitive) == 0) {
+    return it->number;
   }
   return 255; // 255 for unknown
 }
 
+namespace {
+
+/** Maximum number of strings kept in a GenreStringCache */
+const int MAX_CACHED_GENRE_STRINGS = 1024;
+
 /**
- * Get a name string from a string with a number or a name.
- * ID3v2 genres can be stored as "9", "(9)", "(9)Metal" or "Metal".
- *
- * @param str genre string, it can also reference multiple ID3v1 genres
- * and have a refinement such as "(9)(138)Viking Metal".
- * Multiple genres can be separated by Frame::stringListSeparator().
- *
- * @return genre name or multiple genre names separated by
- * Frame::stringListSeparator().
+ * Cache for converted genre strings.
+ * The genres of many files are the same, so they only have to be parsed
+ * once. The cache is cleared when it is full.
  */
-QString Genres::getNameString(const QString& str)
+class GenreStringCache {
+public:
+  bool find(const QString& str, QString& result) const {
+    QMutexLocker locker(&m_mutex);
+    auto it = m_results.constFind(str);
+    if (it == m_results.constEnd())
+      return false;
+    result = *it;
+    return true;
+  }
+
+  void insert(const QString& str, const QString& result) {
+    QMutexLocker locker(&m_mutex);
+    if (m_results.size() >= MAX_CACHED_GENRE_STRINGS) {
+      m_results.clear();
+    }
+    m_results.insert(str, result);
+  }
+
+private:
+  mutable QMutex m_mutex;
+  QHash<QString, QString> m_results;
+};
+
+/**
+ * Convert a genre string to names, see Genres::getNameString().
+ * @param str genre string
+ * @return genre names.
+ */
+QString parseNameString(const QString& str)
 {
   if (!str.isEmpty()) {
     QStringList genres;
@@ -527,7 +586,7 @@ QString Genres::getNameString(const QString& str)
           genres.append(genreCode.toString());
 #endif
         } else if (ok && n >= 0 && n <= 0xff) {
-          QString genreText = QString::fromLatin1(getName(n));
+          QString genreText = QString::fromLatin1(Genres::getName(n));
           if (!genreText.isEmpty()) {
             genres.append(genreText);
           }
@@ -539,7 +598,7 @@ QString Genres::getNameString(const QString& str)
         bool ok;
         int n = s.toInt(&ok);
         if (ok && n >= 0 && n <= 0xff) {
-          QString genreText = QString::fromLatin1(getName(n));
+          QString genreText = QString::fromLatin1(Genres::getName(n));
           if (!genreText.isEmpty()) {
             genres.append(genreText);
           }
@@ -559,20 +618,12 @@ QString Genres::getNameString(const QString& str)
 }
 
 /**
- * Get a number representation of a genre name if possible.
- *
- * @param str string with genre name, can also contain multiple genres
- * separated by Frame::stringListSeparator()
- * @param parentheses true to put the numbers in parentheses, this will
- * result in an ID3v2.3.0 genre string, which can containing multiple
- * references to ID3v1 genres and optionally a refinement as a genre text
- *
- * @return genre string using numbers where possible. If @a parentheses
- * is true, an ID3v2.3.0 genre string such as "(9)(138)Viking Metal" is
- * returned, else if @a str contains multiple genres, they are returned
- * as numbers (where possible) separated by Frame::stringListSeparator().
+ * Convert a genre string to numbers, see Genres::getNumberString().
+ * @param str genre names
+ * @param parentheses true to create an ID3v2.3.0 genre string
+ * @return genre string using numbers where possible.
  */
-QString Genres::getNumberString(const QString& str, bool parentheses)
+QString parseNumberString(const QString& str, bool parentheses)
 {
   QStringList genres;
   QString genreText;
@@ -585,7 +636,7 @@ QString Genres::getNumberString(const QString& str, bool parentheses)
     if (s == QLatin1String("RX") || s == QLatin1String("CR")) {
       genres.append(s);
     } else if ((ok && n >= 0 && n <= 255) ||
-               (n = getNumber(s)) < 0xff) {
+               (n = Genres::getNumber(s)) < 0xff) {
       genres.append(QString::number(n));
     } else if (!parentheses) {
       genres.append(s);
@@ -604,3 +655,55 @@ QString Genres::getNumberString(const QString& str, bool parentheses)
     return genreText;
   }
 }
+
+}
+
+/**
+ * Get a name string from a string with a number or a name.
+ * ID3v2 genres can be stored as "9", "(9)", "(9)Metal" or "Metal".
+ *
+ * @param str genre string, it can also reference multiple ID3v1 genres
+ * and have a refinement such as "(9)(138)Viking Metal".
+ * Multiple genres can be separated by Frame::stringListSeparator().
+ *
+ * @return genre name or multiple genre names separated by
+ * Frame::stringListSeparator().
+ */
+QString Genres::getNameString(const QString& str)
+{
+  if (str.isEmpty())
+    return str;
+
+  static GenreStringCache cache;
+  QString result;
+  if (!cache.find(str, result)) {
+    result = parseNameString(str);
+    cache.insert(str, result);
+  }
+  return result;
+}
+
+/**
+ * Get a number representation of a genre name if possible.
+ *
+ * @param str string with genre name, can also contain multiple genres
+ * separated by Frame::stringListSeparator()
+ * @param parentheses true to put the numbers in parentheses, this will
+ * result in an ID3v2.3.0 genre string, which can containing multiple
+ * references to ID3v1 genres and optionally a refinement as a genre text
+ *
+ * @return genre string using numbers where possible. If @a parentheses
+ * is true, an ID3v2.3.0 genre string such as "(9)(138)Viking Metal" is
+ * returned, else if @a str contains multiple genres, they are returned
+ * as numbers (where possible) separated by Frame::stringListSeparator().
+ */
+QString Genres::getNumberString(const QString& str, bool parentheses)
+{
+  static GenreStringCache cache[2];
+  QString result;
+  if (!cache[parentheses].find(str, result)) {
+    result = parseNumberString(str, parentheses);
+    cache[parentheses].insert(str, result);
+  }
+  return result;
+}
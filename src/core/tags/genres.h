@@ -54,6 +54,7 @@ public:
 
   /**
    * Get the genre number from a string containing a genre text.
+   * The genre text is compared case insensitively.
    *
    * @param str string with genre
    *
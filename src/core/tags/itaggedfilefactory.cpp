@@ -35,3 +35,24 @@ ITaggedFileFactory::~ITaggedFileFactory()
   // will lead to unresolved symbols when building with shared libraries on
   // Windows and a class from another library inherits from this class.
 }
+
+/**
+ * Read the data of the embedded cover picture without reading the tags.
+ * This is used to display thumbnails for many files and can be called
+ * from any thread, so it must not use tagged file objects or other
+ * state which is not thread-safe.
+ *
+ * The default implementation returns an empty byte array.
+ *
+ * @param key tagged file key
+ * @param fileName path to file
+ *
+ * @return picture data, empty if not supported or no picture found.
+ */
+QByteArray ITaggedFileFactory::readPictureData(const QString& key,
+                                               const QString& fileName)
+{
+  Q_UNUSED(key)
+  Q_UNUSED(fileName)
+  return QByteArray();
+}
@@ -28,6 +28,7 @@
 
 #include <QtPlugin>
 #include <QStringList>
+#include <QByteArray>
 #include "kid3api.h"
 
 class QPersistentModelIndex;
@@ -105,7 +106,25 @@ public:
    * @param key tagged file key
    */
   virtual void notifyConfigurationChange(const QString& key) = 0;
+
+  /**
+   * Read the data of the embedded cover picture without reading the tags.
+   * This is used to display thumbnails for many files and can be called
+   * from any thread, so it must not use tagged file objects or other
+   * state which is not thread-safe.
+   *
+   * The default implementation returns an empty byte array.
+   *
+   * @param key tagged file key
+   * @param fileName path to file
+   *
+   * @return picture data, empty if not supported or no picture found.
+   */
+  virtual QByteArray readPictureData(const QString& key,
+                                     const QString& fileName);
 };
 
+// The interface ID has to be changed when virtual methods are added, so that
+// plugins built for an older version are not loaded.
 Q_DECLARE_INTERFACE(ITaggedFileFactory,
-                    "org.kde.kid3.ITaggedFileFactory")
+                    "org.kde.kid3.ITaggedFileFactory/2")
@@ -28,6 +28,10 @@
 #include <QDir>
 #include <QString>
 #include <QRegularExpression>
+#include <QSharedPointer>
+#include <QMutex>
+#include <QHash>
+#include <QVector>
 #ifdef Q_OS_WIN32
 #include <sys/types.h>
 #include <sys/utime.h>
@@ -41,6 +45,9 @@
 #include "modeliterator.h"
 #include "saferename.h"
 #include "taggedfilesystemmodel.h"
+#include "tagmemorytracker.h"
+#include "tracer.h"
+#include "pictureframe.h"
 
 /**
  * Constructor.
@@ -48,15 +55,17 @@
  * @param idx index in tagged file system model
  */
 TaggedFile::TaggedFile(const QPersistentModelIndex& idx)
-  : m_index(idx), m_truncation(0), m_modified(false), m_marked(false)
+  : m_model(static_cast<const TaggedFileSystemModel*>(idx.model())),
+    m_nodeHandle(FileSystemModel::nodeHandle(idx)),
+    m_truncation(0), m_modified(false), m_marked(false)
 {
   FOR_ALL_TAGS(tagNr) {
     m_changedFrames[tagNr] = 0;
     m_changed[tagNr] = false;
   }
-  Q_ASSERT(m_index.model()->metaObject() == &TaggedFileSystemModel::staticMetaObject);
-  if (const TaggedFileSystemModel* model = getTaggedFileSystemModel()) {
-    m_newFilename = model->fileName(m_index);
+  Q_ASSERT(idx.model()->metaObject() == &TaggedFileSystemModel::staticMetaObject);
+  if (m_model) {
+    m_newFilename = m_model->fileName(idx);
     m_filename = m_newFilename;
   }
 }
@@ -68,7 +77,18 @@ TaggedFile::TaggedFile(const QPersistentModelIndex& idx)
 const TaggedFileSystemModel* TaggedFile::getTaggedFileSystemModel() const
 {
   // The validity of this cast is checked in the constructor.
-  return static_cast<const TaggedFileSystemModel*>(m_index.model());
+  return m_model;
+}
+
+/**
+ * Get index of tagged file in model.
+ * The index is looked up using the model node of the file, so that no
+ * persistent index has to be kept for every file.
+ * @return index, invalid if not in model.
+ */
+QModelIndex TaggedFile::getIndex() const
+{
+  return m_model ? m_model->indexForNodeHandle(m_nodeHandle) : QModelIndex();
 }
 
 /**
@@ -78,8 +98,9 @@ const TaggedFileSystemModel* TaggedFile::getTaggedFileSystemModel() const
  */
 QString TaggedFile::getDirname() const
 {
-  if (const TaggedFileSystemModel* model = getTaggedFileSystemModel()) {
-    return model->filePath(m_index.parent());
+  if (m_model) {
+    return m_model->filePathForNodeHandle(
+          m_model->parentNodeHandle(m_nodeHandle));
   }
   return QString();
 }
@@ -114,8 +135,8 @@ void TaggedFile::setFilenameFormattedIfEnabled(QString fn)
  */
 void TaggedFile::updateCurrentFilename()
 {
-  if (const TaggedFileSystemModel* model = getTaggedFileSystemModel()) {
-    const QString newName = model->fileName(m_index);
+  if (m_model) {
+    const QString newName = m_model->fileNameForNodeHandle(m_nodeHandle);
     if (!newName.isEmpty() && m_filename != newName) {
       if (m_newFilename == m_filename) {
         m_newFilename = newName;
@@ -126,18 +147,51 @@ void TaggedFile::updateCurrentFilename()
   }
 }
 
+/**
+ * Called by the model when the node of the file has been removed.
+ * The file is deleted later, until then it has no index in the model.
+ */
+void TaggedFile::detachFromModelNode()
+{
+  m_nodeHandle = nullptr;
+}
+
 /**
  * Get current path to file.
  * @return absolute path.
  */
 QString TaggedFile::currentFilePath() const
 {
-  if (const TaggedFileSystemModel* model = getTaggedFileSystemModel()) {
-    return model->filePath(m_index);
+  if (m_model) {
+    return m_model->filePathForNodeHandle(m_nodeHandle);
   }
   return QString();
 }
 
+/**
+ * Get the data of the embedded cover picture.
+ * If the tags have already been read, the picture is taken from the
+ * frames, otherwise only the picture is extracted from the file using
+ * TaggedFileSystemModel::readPictureData() without reading the tags.
+ *
+ * @return picture data, empty if no picture found.
+ */
+QByteArray TaggedFile::readPictureData()
+{
+  if (!isTagInformationRead()) {
+    return TaggedFileSystemModel::readPictureData(currentFilePath());
+  }
+  QByteArray data;
+  FrameCollection frames;
+  getAllFrames(Frame::Tag_Picture, frames);
+  auto it = frames.find(
+        Frame(Frame::FT_Picture, QLatin1String(""), QLatin1String(""), -1));
+  if (it != frames.cend()) {
+    PictureFrame::getData(*it, data);
+  }
+  return data;
+}
+
 /**
  * Get features supported.
  * @return bit mask with Feature flags set.
@@ -281,6 +335,10 @@ void TaggedFile::markTagChanged(Frame::TagNumber tagNr,
     }
   }
   updateModifiedState();
+  markDirectoryStatisticsOutdated();
+  if (const TaggedFileSystemModel* model = getTaggedFileSystemModel()) {
+    model->tagMemoryTracker()->fileModified(this);
+  }
 }
 
 /**
@@ -288,11 +346,15 @@ void TaggedFile::markTagChanged(Frame::TagNumber tagNr,
  * @param tagNr tag number
  */
 void TaggedFile::markTagUnchanged(Frame::TagNumber tagNr) {
+  const bool wasChanged = m_changed[tagNr];
   m_changed[tagNr] = false;
   m_changedFrames[tagNr] = 0;
   m_changedOtherFrameNames[tagNr].clear();
   clearTrunctionFlags(tagNr);
   updateModifiedState();
+  if (wasChanged) {
+    markDirectoryStatisticsOutdated();
+  }
 }
 
 /**
@@ -369,7 +431,7 @@ void TaggedFile::updateModifiedState()
     m_modified = modified;
     if (const TaggedFileSystemModel* model = getTaggedFileSystemModel()) {
       const_cast<TaggedFileSystemModel*>(model)->notifyModificationChanged(
-            m_index, m_modified);
+            getIndex(), m_modified);
     }
   }
 }
@@ -386,9 +448,12 @@ void TaggedFile::updateModifiedState()
  */
 void TaggedFile::notifyModelDataChanged(bool priorIsTagInformationRead) const
 {
-  if (isTagInformationRead() != priorIsTagInformationRead) {
-    if (const TaggedFileSystemModel* model = getTaggedFileSystemModel()) {
-      const_cast<TaggedFileSystemModel*>(model)->notifyModelDataChanged(m_index);
+  if (const TaggedFileSystemModel* model = getTaggedFileSystemModel()) {
+    model->tagMemoryTracker()->fileAccessed(const_cast<TaggedFile*>(this),
+                                            priorIsTagInformationRead);
+    markDirectoryStatisticsOutdated();
+    if (isTagInformationRead() != priorIsTagInformationRead) {
+      const_cast<TaggedFileSystemModel*>(model)->notifyModelDataChanged(getIndex());
     }
   }
 }
@@ -405,7 +470,7 @@ void TaggedFile::notifyTruncationChanged(bool priorTruncation) const
   bool currentTruncation = m_truncation != 0;
   if (currentTruncation != priorTruncation) {
     if (const TaggedFileSystemModel* model = getTaggedFileSystemModel()) {
-      const_cast<TaggedFileSystemModel*>(model)->notifyModelDataChanged(m_index);
+      const_cast<TaggedFileSystemModel*>(model)->notifyModelDataChanged(getIndex());
     }
   }
 }
@@ -432,42 +497,102 @@ QString removeArtist(const QString& album)
   return str;
 }
 
+/** Maximum number of compiled formats kept by FilenameFormatParser. */
+const int MAX_CACHED_FILENAME_FORMATS = 16;
+
+/**
+ * Create a regular expression which is compiled and optimized immediately.
+ * @param pattern regular expression pattern
+ * @return regular expression.
+ */
+QRegularExpression compiledRegExp(const char* pattern)
+{
+  QRegularExpression re(QString::fromLatin1(pattern));
+  re.optimize();
+  return re;
 }
 
 /**
- * Get tags from filename.
- * Supported formats:
- * album/track - artist - song
- * artist - album/track song
- * /artist - album - track - song
- * album/artist - track - song
- * artist/album/track song
- * album/artist - song
- *
- * @param frames frames to put result
- * @param fmt format string containing the following codes:
- *            %s title (song)
- *            %l album
- *            %a artist
- *            %c comment
- *            %y year
- *            %t track
+ * Parser for tags from file names, compiled from a format string.
+ * Building the regular expression from the format is expensive compared to
+ * matching a file name, so compiled parsers are cached by format.
  */
-void TaggedFile::getTagsFromFilename(FrameCollection& frames, const QString& fmt)
+class FilenameFormatParser {
+public:
+  /**
+   * Get parser for a format, it is compiled on first use.
+   * Can be called from any thread.
+   * @param fmt format string
+   * @return parser.
+   */
+  static QSharedPointer<const FilenameFormatParser> forFormat(
+      const QString& fmt);
+
+  /**
+   * Remove all compiled parsers from the cache.
+   * Can be called from any thread.
+   */
+  static void clearCache();
+
+  /**
+   * Get tags from a file name.
+   * @param filePath path of file
+   * @param frames frames to put result
+   * @return true if the file name matches the format.
+   */
+  bool parse(const QString& filePath, FrameCollection& frames) const;
+
+private:
+  /** Frame set from a capture group. */
+  struct Capture {
+    Frame::ExtendedType type;
+    int group;
+    bool isTrackNumber;
+  };
+
+  explicit FilenameFormatParser(const QString& fmt);
+
+  static QMutex s_mutex;
+  static QHash<QString, QSharedPointer<const FilenameFormatParser>> s_cache;
+
+  QRegularExpression m_re;
+  QVector<Capture> m_captures;
+  bool m_replaceUnderscores;
+};
+
+QMutex FilenameFormatParser::s_mutex;
+QHash<QString, QSharedPointer<const FilenameFormatParser>>
+FilenameFormatParser::s_cache;
+
+QSharedPointer<const FilenameFormatParser> FilenameFormatParser::forFormat(
+    const QString& fmt)
 {
-  QRegularExpression re;
-  QRegularExpressionMatch match;
-  QString fn(getAbsFilename());
+  QMutexLocker locker(&s_mutex);
+  auto it = s_cache.constFind(fmt);
+  if (it != s_cache.constEnd()) {
+    return *it;
+  }
+  if (s_cache.size() >= MAX_CACHED_FILENAME_FORMATS) {
+    s_cache.clear();
+  }
+  QSharedPointer<const FilenameFormatParser> parser(
+        new FilenameFormatParser(fmt));
+  s_cache.insert(fmt, parser);
+  return parser;
+}
 
-  // construct regular expression from format string
+void FilenameFormatParser::clearCache()
+{
+  QMutexLocker locker(&s_mutex);
+  s_cache.clear();
+}
 
+FilenameFormatParser::FilenameFormatParser(const QString& fmt)
   // if the format does not contain a '_', they are replaced by spaces
   // in the filename.
-  QString fileName(fn);
-  if (!fmt.contains(QLatin1Char('_'))) {
-    fileName.replace(QLatin1Char('_'), QLatin1Char(' '));
-  }
-
+  : m_replaceUnderscores(!fmt.contains(QLatin1Char('_')))
+{
+  // construct regular expression from format string
   QString pattern;
   QMap<QString, int> codePos;
   bool useCustomCaptures = fmt.contains(QLatin1String("}("));
@@ -552,29 +677,82 @@ void TaggedFile::getTagsFromFilename(FrameCollection& frames, const QString& fmt
   // and finally a dot followed by 2 to 4 characters for the extension
   pattern += QLatin1String("\\..{2,4}$");
 
-  re.setPattern(pattern);
-  if ((match = re.match(fileName)).hasMatch()) {
-    for (auto it = codePos.begin(); it != codePos.end(); ++it) {
-      const QString& name = it.key();
-      QString str = match.captured(*it);
-      if (!str.isEmpty()) {
-        if (!useCustomCaptures && name == QLatin1String("track number") &&
-            str.length() == 2 && str[0] == QLatin1Char('0')) {
-          // remove leading zero
-          str = str.mid(1);
-        }
-        if (name != QLatin1String("ignore"))
-          frames.setValue(Frame::ExtendedType(name), str);
+  m_re.setPattern(pattern);
+  m_re.optimize();
+
+  for (auto it = codePos.constBegin(); it != codePos.constEnd(); ++it) {
+    const QString& name = it.key();
+    if (name != QLatin1String("ignore")) {
+      m_captures.append({Frame::ExtendedType(name), *it,
+                         !useCustomCaptures &&
+                         name == QLatin1String("track number")});
+    }
+  }
+}
+
+bool FilenameFormatParser::parse(const QString& filePath,
+                                 FrameCollection& frames) const
+{
+  QString fileName(filePath);
+  if (m_replaceUnderscores) {
+    fileName.replace(QLatin1Char('_'), QLatin1Char(' '));
+  }
+  QRegularExpressionMatch match = m_re.match(fileName);
+  if (!match.hasMatch()) {
+    return false;
+  }
+
+  for (const Capture& capture : m_captures) {
+    QString str = match.captured(capture.group);
+    if (!str.isEmpty()) {
+      if (capture.isTrackNumber &&
+          str.length() == 2 && str[0] == QLatin1Char('0')) {
+        // remove leading zero
+        str = str.mid(1);
       }
+      frames.setValue(capture.type, str);
     }
+  }
+  return true;
+}
+
+}
+
+/**
+ * Get tags from filename.
+ * Supported formats:
+ * album/track - artist - song
+ * artist - album/track song
+ * /artist - album - track - song
+ * album/artist - track - song
+ * artist/album/track song
+ * album/artist - song
+ *
+ * @param frames frames to put result
+ * @param fmt format string containing the following codes:
+ *            %s title (song)
+ *            %l album
+ *            %a artist
+ *            %c comment
+ *            %y year
+ *            %t track
+ */
+void TaggedFile::getTagsFromFilename(FrameCollection& frames, const QString& fmt)
+{
+  QRegularExpressionMatch match;
+  QString fn(getAbsFilename());
+
+  const QSharedPointer<const FilenameFormatParser> parser =
+      FilenameFormatParser::forFormat(fmt);
+  if (parser->parse(fn, frames)) {
     return;
   }
 
   // album/track - artist - song
-  re.setPattern(QLatin1String(
+  static const QRegularExpression albumTrackArtistSongRe = compiledRegExp(
     R"(([^/]+)/(\d{1,3})[-_\. ]+([^-_\./ ][^/]+)[_ ]-[_ ])"
-    R"(([^-_\./ ][^/]+)\..{2,4}$)"));
-  if ((match = re.match(fn)).hasMatch()) {
+    R"(([^-_\./ ][^/]+)\..{2,4}$)");
+  if ((match = albumTrackArtistSongRe.match(fn)).hasMatch()) {
     frames.setAlbum(removeArtist(match.captured(1)));
     frames.setTrack(match.captured(2).toInt());
     frames.setArtist(match.captured(3));
@@ -583,10 +761,10 @@ void TaggedFile::getTagsFromFilename(FrameCollection& frames, const QString& fmt
   }
 
   // artist - album (year)/track song
-  re.setPattern(QLatin1String(
+  static const QRegularExpression artistAlbumYearTrackSongRe = compiledRegExp(
     R"(([^/]+)[_ ]-[_ ]([^/]+)[_ ]\((\d{4})\)/(\d{1,3})[-_\. ]+)"
-    R"(([^-_\./ ][^/]+)\..{2,4}$)"));
-  if ((match = re.match(fn)).hasMatch()) {
+    R"(([^-_\./ ][^/]+)\..{2,4}$)");
+  if ((match = artistAlbumYearTrackSongRe.match(fn)).hasMatch()) {
     frames.setArtist(match.captured(1));
     frames.setAlbum(match.captured(2));
     frames.setYear(match.captured(3).toInt());
@@ -596,9 +774,9 @@ void TaggedFile::getTagsFromFilename(FrameCollection& frames, const QString& fmt
   }
 
   // artist - album/track song
-  re.setPattern(QLatin1String(
-    R"(([^/]+)[_ ]-[_ ]([^/]+)/(\d{1,3})[-_\. ]+([^-_\./ ][^/]+)\..{2,4}$)"));
-  if ((match = re.match(fn)).hasMatch()) {
+  static const QRegularExpression artistAlbumTrackSongRe = compiledRegExp(
+    R"(([^/]+)[_ ]-[_ ]([^/]+)/(\d{1,3})[-_\. ]+([^-_\./ ][^/]+)\..{2,4}$)");
+  if ((match = artistAlbumTrackSongRe.match(fn)).hasMatch()) {
     frames.setArtist(match.captured(1));
     frames.setAlbum(match.captured(2));
     frames.setTrack(match.captured(3).toInt());
@@ -606,10 +784,10 @@ void TaggedFile::getTagsFromFilename(FrameCollection& frames, const QString& fmt
     return;
   }
   // /artist - album - track - song
-  re.setPattern(QLatin1String(
+  static const QRegularExpression artistAlbumTrackSongFlatRe = compiledRegExp(
     R"(/([^/]+[^-_/ ])[_ ]-[_ ]([^-_/ ][^/]+[^-_/ ])[-_\. ]+)"
-    R"((\d{1,3})[-_\. ]+([^-_\./ ][^/]+)\..{2,4}$)"));
-  if ((match = re.match(fn)).hasMatch()) {
+    R"((\d{1,3})[-_\. ]+([^-_\./ ][^/]+)\..{2,4}$)");
+  if ((match = artistAlbumTrackSongFlatRe.match(fn)).hasMatch()) {
     frames.setArtist(match.captured(1));
     frames.setAlbum(match.captured(2));
     frames.setTrack(match.captured(3).toInt());
@@ -617,10 +795,10 @@ void TaggedFile::getTagsFromFilename(FrameCollection& frames, const QString& fmt
     return;
   }
   // album/artist - track - song
-  re.setPattern(QLatin1String(
+  static const QRegularExpression albumArtistTrackSongRe = compiledRegExp(
     R"(([^/]+)/([^/]+[^-_\./ ])[-_\. ]+(\d{1,3})[-_\. ]+)"
-    R"(([^-_\./ ][^/]+)\..{2,4}$)"));
-  if ((match = re.match(fn)).hasMatch()) {
+    R"(([^-_\./ ][^/]+)\..{2,4}$)");
+  if ((match = albumArtistTrackSongRe.match(fn)).hasMatch()) {
     frames.setAlbum(removeArtist(match.captured(1)));
     frames.setArtist(match.captured(2));
     frames.setTrack(match.captured(3).toInt());
@@ -628,9 +806,9 @@ void TaggedFile::getTagsFromFilename(FrameCollection& frames, const QString& fmt
     return;
   }
   // artist/album/track song
-  re.setPattern(QLatin1String(
-    R"(([^/]+)/([^/]+)/(\d{1,3})[-_\. ]+([^-_\./ ][^/]+)\..{2,4}$)"));
-  if ((match = re.match(fn)).hasMatch()) {
+  static const QRegularExpression artistAlbumTrackSongDirsRe = compiledRegExp(
+    R"(([^/]+)/([^/]+)/(\d{1,3})[-_\. ]+([^-_\./ ][^/]+)\..{2,4}$)");
+  if ((match = artistAlbumTrackSongDirsRe.match(fn)).hasMatch()) {
     frames.setArtist(match.captured(1));
     frames.setAlbum(match.captured(2));
     frames.setTrack(match.captured(3).toInt());
@@ -638,9 +816,9 @@ void TaggedFile::getTagsFromFilename(FrameCollection& frames, const QString& fmt
     return;
   }
   // album/artist - song
-  re.setPattern(QLatin1String(
-    "([^/]+)/([^/]+[^-_/ ])[_ ]-[_ ]([^-_/ ][^/]+)\\..{2,4}$"));
-  if ((match = re.match(fn)).hasMatch()) {
+  static const QRegularExpression albumArtistSongRe = compiledRegExp(
+    "([^/]+)/([^/]+[^-_/ ])[_ ]-[_ ]([^-_/ ][^/]+)\\..{2,4}$");
+  if ((match = albumArtistSongRe.match(fn)).hasMatch()) {
     frames.setAlbum(removeArtist(match.captured(1)));
     frames.setArtist(match.captured(2));
     frames.setTitle(match.captured(3));
@@ -648,6 +826,15 @@ void TaggedFile::getTagsFromFilename(FrameCollection& frames, const QString& fmt
   }
 }
 
+/**
+ * Clear the formats compiled by getTagsFromFilename().
+ * This method shall be called when the frame types of names change.
+ */
+void TaggedFile::clearFilenameFormatCache()
+{
+  FilenameFormatParser::clearCache();
+}
+
 /**
  * Format a time string "h:mm:ss".
  * If the time is less than an hour, the hour is not put into the
@@ -683,6 +870,7 @@ QString TaggedFile::formatTime(unsigned seconds)
  */
 bool TaggedFile::renameFile() const
 {
+  TraceSpan span("renameFile");
   const QString dirname = getDirname();
   const QString fnOld = currentFilename();
   const QString fnNew = getFilename();
@@ -713,13 +901,13 @@ bool TaggedFile::renameFile() const
     // insensitive filesystems (e.g. Windows).
     QString temp_filename(fnNew);
     temp_filename.append(QLatin1String("_CASE"));
-    if (!((model && model->rename(m_index, temp_filename)) ||
+    if (!((model && model->rename(getIndex(), temp_filename)) ||
           Utils::safeRename(dirname, fnOld, temp_filename))) {
       qDebug("rename(%s, %s) failed", fnOld.toLatin1().data(),
              temp_filename.toLatin1().data());
       return false;
     }
-    if (!((model && model->rename(m_index, fnNew)) ||
+    if (!((model && model->rename(getIndex(), fnNew)) ||
           Utils::safeRename(dirname, temp_filename, fnNew))) {
       qDebug("rename(%s, %s) failed", temp_filename.toLatin1().data(),
              fnNew.toLatin1().data());
@@ -729,7 +917,7 @@ bool TaggedFile::renameFile() const
     qDebug("rename(%s, %s): %s already exists", fnOld.toLatin1().data(),
            fnNew.toLatin1().data(), fnNew.toLatin1().data());
     return false;
-  } else if (!((model && model->rename(m_index, fnNew)) ||
+  } else if (!((model && model->rename(getIndex(), fnNew)) ||
                Utils::safeRename(dirname, fnOld, fnNew))) {
     qDebug("rename(%s, %s) failed", fnOld.toLatin1().data(),
            fnNew.toLatin1().data());
@@ -842,17 +1030,37 @@ QString TaggedFile::fixUpTagKey(const QString& key, TagType tagType)
  * @return total number of tracks, -1 if unavailable.
  */
 int TaggedFile::getTotalNumberOfTracksInDir() const {
-  int numTracks = -1;
-  QModelIndex parentIdx = m_index.parent();
-  if (parentIdx.isValid()) {
-    numTracks = 0;
-    TaggedFileOfDirectoryIterator it(parentIdx);
-    while (it.hasNext()) {
-      it.next();
-      ++numTracks;
-    }
+  return m_model ? m_model->numberOfTaggedFilesInDirectory(
+                     m_model->parentNodeHandle(m_nodeHandle))
+                 : -1;
+}
+
+/**
+ * Get aggregated information about the files in the directory.
+ * The values derived from tags only include the files whose tags have been
+ * read, see TaggedFileSystemModel::readTagsInDirectory().
+ *
+ * @param stats the statistics are returned here
+ *
+ * @return true if available.
+ */
+bool TaggedFile::getDirectoryStatistics(DirectoryStatistics& stats) const
+{
+  return m_model && m_model->directoryStatistics(
+        m_model->parentNodeHandle(m_nodeHandle), stats);
+}
+
+/**
+ * Update the contribution of the file to the statistics of its directory
+ * when they are requested next.
+ * This method shall be called when tags are read, edited, reverted or
+ * cleared.
+ */
+void TaggedFile::markDirectoryStatisticsOutdated() const
+{
+  if (m_model) {
+    m_model->markDirectoryStatisticsOutdated(m_nodeHandle);
   }
-  return numTracks;
 }
 
 /**
@@ -1253,6 +1461,14 @@ bool TaggedFile::setFileTimeStamps(const QString& path,
 }
 
 
+/**
+ * Constructor.
+ */
+TaggedFile::DirectoryStatistics::DirectoryStatistics()
+  : numFiles(0), numFilesWithTags(0), duration(0), numArtists(0), numAlbums(0)
+{
+}
+
 /**
  * Constructor.
  */
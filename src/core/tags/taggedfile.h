@@ -88,6 +88,18 @@ public:
     QString toString() const;
   };
 
+  /** Aggregated information about the files in a directory. */
+  struct KID3_CORE_EXPORT DirectoryStatistics {
+    /** Constructor. */
+    DirectoryStatistics();
+
+    int numFiles;           /**< number of tagged files */
+    int numFilesWithTags;   /**< number of files with read tags */
+    unsigned long duration; /**< duration in seconds of files with read tags */
+    int numArtists;         /**< number of different artists */
+    int numAlbums;          /**< number of different albums */
+  };
+
   /**
    * Constructor.
    *
@@ -221,6 +233,16 @@ public:
    */
   virtual bool isTagInformationRead() const = 0;
 
+  /**
+   * Get the data of the embedded cover picture.
+   * If the tags have already been read, the picture is taken from the
+   * frames, otherwise only the picture is extracted from the file using
+   * TaggedFileSystemModel::readPictureData() without reading the tags.
+   *
+   * @return picture data, empty if no picture found.
+   */
+  QByteArray readPictureData();
+
   /**
    * Get technical detail information.
    *
@@ -358,6 +380,12 @@ public:
    */
   void getTagsFromFilename(FrameCollection& frames, const QString& fmt);
 
+  /**
+   * Clear the formats compiled by getTagsFromFilename().
+   * This method shall be called when the frame types of names change.
+   */
+  static void clearFilenameFormatCache();
+
   /**
    * Check if file is changed.
    *
@@ -393,6 +421,12 @@ public:
    */
   void updateCurrentFilename();
 
+  /**
+   * Called by the model when the node of the file has been removed.
+   * The file is deleted later, until then it has no index in the model.
+   */
+  void detachFromModelNode();
+
   /**
    * Check if tag was changed.
    * @param tagNr tag number
@@ -468,11 +502,24 @@ public:
    */
   int getTotalNumberOfTracksInDir() const;
 
+  /**
+   * Get aggregated information about the files in the directory.
+   * The values derived from tags only include the files whose tags have been
+   * read, see TaggedFileSystemModel::readTagsInDirectory().
+   *
+   * @param stats the statistics are returned here
+   *
+   * @return true if available.
+   */
+  bool getDirectoryStatistics(DirectoryStatistics& stats) const;
+
   /**
    * Get index of tagged file in model.
-   * @return index
+   * The index is looked up using the model node of the file, so that no
+   * persistent index has to be kept for every file.
+   * @return index, invalid if not in model.
    */
-  const QPersistentModelIndex& getIndex() const { return m_index; }
+  QModelIndex getIndex() const;
 
   /**
    * Check if the file is marked.
@@ -666,9 +713,12 @@ private:
   TaggedFile& operator=(const TaggedFile&);
 
   void updateModifiedState();
+  void markDirectoryStatisticsOutdated() const;
 
-  /** Index of file in model */
-  QPersistentModelIndex m_index;
+  /** Model containing the file */
+  const TaggedFileSystemModel* m_model;
+  /** Handle of the file's node in m_model */
+  const void* m_nodeHandle;
   /** File name */
   QString m_filename;
   /** New file name */
@@ -52,6 +52,10 @@ TrackDataFormatReplacer::TrackDataFormatReplacer(
  * %d duration in minutes:seconds
  * %D duration in seconds
  * %n number of tracks
+ * %{dirduration} duration of files in directory in minutes:seconds
+ * %{dirseconds} duration of files in directory in seconds
+ * %{dirartists} number of artists in directory
+ * %{diralbums} number of albums in directory
  *
  * @param code format code
  *
@@ -141,6 +145,23 @@ QString TrackDataFormatReplacer::getReplacement(const QString& code) const
         result = QString::number(m_trackData.getFileDuration());
       } else if (name == QLatin1String("tracks")) {
         result = QString::number(m_trackData.getTotalNumberOfTracksInDir());
+      } else if (name == QLatin1String("dirduration") ||
+                 name == QLatin1String("dirseconds") ||
+                 name == QLatin1String("dirartists") ||
+                 name == QLatin1String("diralbums")) {
+        TaggedFile::DirectoryStatistics stats;
+        TaggedFile* taggedFile = m_trackData.getTaggedFile();
+        if (taggedFile && taggedFile->getDirectoryStatistics(stats)) {
+          if (name == QLatin1String("dirduration")) {
+            result = TaggedFile::formatTime(static_cast<unsigned>(stats.duration));
+          } else if (name == QLatin1String("dirseconds")) {
+            result = QString::number(stats.duration);
+          } else if (name == QLatin1String("dirartists")) {
+            result = QString::number(stats.numArtists);
+          } else {
+            result = QString::number(stats.numAlbums);
+          }
+        }
       } else if (name == QLatin1String("extension")) {
         result = m_trackData.getFileExtension();
       } else if (name.startsWith(QLatin1String("tag")) && name.length() == 4) {
@@ -181,6 +202,23 @@ QString TrackDataFormatReplacer::getReplacement(const QString& code) const
   return result;
 }
 
+/**
+ * Check if a format uses the statistics of the directory, e.g.
+ * %{dirartists}. The tags of the other files in the directory should
+ * then be read before the format is applied.
+ *
+ * @param format format string
+ *
+ * @return true if @a format contains a directory statistics code.
+ */
+bool TrackDataFormatReplacer::usesDirectoryStatistics(const QString& format)
+{
+  return format.contains(QLatin1String("%{dirduration}")) ||
+         format.contains(QLatin1String("%{dirseconds}")) ||
+         format.contains(QLatin1String("%{dirartists}")) ||
+         format.contains(QLatin1String("%{diralbums}"));
+}
+
 /**
  * Get help text for supported format codes.
  *
@@ -242,6 +280,28 @@ QString TrackDataFormatReplacer::getToolTip(bool onlyRows)
   str += QCoreApplication::translate("@default", numberOfTracksStr);
   str += QLatin1String("</td></tr>\n");
 
+  str += QLatin1String("<tr><td></td><td>%{dirduration}</td><td>");
+  const char* const directoryLengthStr =
+      QT_TRANSLATE_NOOP("@default", "Length of directory");
+  str += QCoreApplication::translate("@default", directoryLengthStr);
+  str += QLatin1String(" &quot;M:S&quot;</td></tr>\n");
+
+  str += QLatin1String("<tr><td></td><td>%{dirseconds}</td><td>");
+  str += QCoreApplication::translate("@default", directoryLengthStr);
+  str += QLatin1String(" &quot;S&quot;</td></tr>\n");
+
+  str += QLatin1String("<tr><td></td><td>%{dirartists}</td><td>");
+  const char* const numberOfArtistsStr =
+      QT_TRANSLATE_NOOP("@default", "Number of artists in directory");
+  str += QCoreApplication::translate("@default", numberOfArtistsStr);
+  str += QLatin1String("</td></tr>\n");
+
+  str += QLatin1String("<tr><td></td><td>%{diralbums}</td><td>");
+  const char* const numberOfAlbumsStr =
+      QT_TRANSLATE_NOOP("@default", "Number of albums in directory");
+  str += QCoreApplication::translate("@default", numberOfAlbumsStr);
+  str += QLatin1String("</td></tr>\n");
+
   str += QLatin1String("<tr><td>%e</td><td>%{extension}</td><td>");
   const char* const extensionStr = QT_TRANSLATE_NOOP("@default", "Extension");
   str += QCoreApplication::translate("@default", extensionStr);
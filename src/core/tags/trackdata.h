@@ -348,6 +348,17 @@ public:
    */
   static QString getToolTip(bool onlyRows = false);
 
+  /**
+   * Check if a format uses the statistics of the directory, e.g.
+   * %{dirartists}. The tags of the other files in the directory should
+   * then be read before the format is applied.
+   *
+   * @param format format string
+   *
+   * @return true if @a format contains a directory statistics code.
+   */
+  static bool usesDirectoryStatistics(const QString& format);
+
 protected:
   /**
    * Replace a format code (one character %c or multiple characters %{chars}).
@@ -26,6 +26,7 @@
 
 #include "icoreplatformtools.h"
 #include <QString>
+#include <QByteArray>
 
 /**
  * Destructor.
@@ -105,6 +106,40 @@ bool ICorePlatformTools::hasGui() const
   return false;
 }
 
+/**
+ * Check if pictures can be converted with convertPicture().
+ * @return true if convertPicture() is supported.
+ */
+bool ICorePlatformTools::canConvertPicture() const
+{
+  return false;
+}
+
+/**
+ * Resize and recompress a picture.
+ * This method is called from worker threads.
+ * This default implementation does not convert pictures, it is only
+ * supported when QtGui is available.
+ * @param data picture data
+ * @param maxDimension maximum width and height in pixels, 0 for no limit
+ * @param maxBytes maximum size of picture data in bytes, 0 for no limit
+ * @param format image format of converted picture, e.g. "JPG" or "PNG"
+ * @param quality quality of converted picture, 0..100
+ * @return converted picture data, empty if the picture does not exceed
+ *         the limits or cannot be converted.
+ */
+QByteArray ICorePlatformTools::convertPicture(
+    const QByteArray& data, int maxDimension, int maxBytes,
+    const QString& format, int quality) const
+{
+  Q_UNUSED(data)
+  Q_UNUSED(maxDimension)
+  Q_UNUSED(maxBytes)
+  Q_UNUSED(format)
+  Q_UNUSED(quality)
+  return QByteArray();
+}
+
 /**
  * Construct a name filter string suitable for file dialogs.
  * This function can be used to implement fileDialogNameFilter()
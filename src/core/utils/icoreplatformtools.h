@@ -31,6 +31,7 @@
 #include "kid3api.h"
 
 class QObject;
+class QByteArray;
 class QString;
 class QWidget;
 class ISettings;
@@ -154,6 +155,29 @@ public:
    */
   virtual bool hasGui() const;
 
+  /**
+   * Check if pictures can be converted with convertPicture().
+   * @return true if convertPicture() is supported.
+   */
+  virtual bool canConvertPicture() const;
+
+  /**
+   * Resize and recompress a picture.
+   * This method is called from worker threads.
+   * This default implementation does not convert pictures, it is only
+   * supported when QtGui is available.
+   * @param data picture data
+   * @param maxDimension maximum width and height in pixels, 0 for no limit
+   * @param maxBytes maximum size of picture data in bytes, 0 for no limit
+   * @param format image format of converted picture, e.g. "JPG" or "PNG"
+   * @param quality quality of converted picture, 0..100
+   * @return converted picture data, empty if the picture does not exceed
+   *         the limits or cannot be converted.
+   */
+  virtual QByteArray convertPicture(const QByteArray& data, int maxDimension,
+                                    int maxBytes, const QString& format,
+                                    int quality) const;
+
 protected:
   /**
    * Construct a name filter string suitable for file dialogs.
@@ -0,0 +1,215 @@
+/**
+ * \file tracer.cpp
+ * Lightweight tracing of time spent in hot paths.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tracer.h"
+#include <QFile>
+#include <QThread>
+#include <QCoreApplication>
+#include <QStringList>
+#include <QPair>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+/**
+ * Maximum number of events kept, further spans are only counted.
+ * An event takes 32 bytes, so the events of a trace use at most 64 MiB.
+ */
+const int MAX_EVENTS = 2 * 1024 * 1024;
+
+}
+
+/**
+ * Get the tracer used by the application.
+ * @return tracer.
+ */
+Tracer& Tracer::instance()
+{
+  static Tracer tracer;
+  return tracer;
+}
+
+/**
+ * Constructor.
+ */
+Tracer::Tracer() : m_droppedEvents(0), m_active(0)
+{
+}
+
+/**
+ * Start tracing.
+ * Events recorded by a previous trace are discarded.
+ * @param filePath path to file where the trace is written by stop()
+ */
+void Tracer::start(const QString& filePath)
+{
+  QMutexLocker locker(&m_mutex);
+  m_filePath = filePath;
+  m_events.clear();
+  m_counters.clear();
+  m_threadIds.clear();
+  m_droppedEvents = 0;
+  m_timer.start();
+  m_active.storeRelease(1);
+}
+
+/**
+ * Stop tracing, write the trace file and log the summary.
+ * @return false if the trace file could not be written.
+ */
+bool Tracer::stop()
+{
+  if (!isActive())
+    return true;
+
+  m_active.storeRelease(0);
+  bool ok = writeChromeTrace(m_filePath);
+  if (!ok) {
+    qWarning("Could not write trace to %s", qPrintable(m_filePath));
+  }
+  qInfo().noquote() << summary();
+  return ok;
+}
+
+/**
+ * Record a completed span.
+ * Can be called from any thread.
+ *
+ * @param name name of span, must be a string literal
+ * @param startNs start time as returned by nsecsElapsed()
+ * @param endNs end time as returned by nsecsElapsed()
+ */
+void Tracer::addEvent(const char* name, qint64 startNs, qint64 endNs)
+{
+  const qint64 durationNs = endNs - startNs;
+  const Qt::HANDLE thread = QThread::currentThreadId();
+  QMutexLocker locker(&m_mutex);
+  if (!isActive())
+    return;
+
+  // Raw data is used to avoid an allocation, the name is a string literal.
+  Counter& counter = m_counters[QByteArray::fromRawData(name, qstrlen(name))];
+  ++counter.count;
+  counter.totalNs += durationNs;
+  counter.maxNs = qMax(counter.maxNs, durationNs);
+  if (m_events.size() < MAX_EVENTS) {
+    auto it = m_threadIds.constFind(thread);
+    if (it == m_threadIds.constEnd()) {
+      it = m_threadIds.insert(thread, m_threadIds.size());
+    }
+    m_events.append({name, startNs, durationNs, *it});
+  } else {
+    ++m_droppedEvents;
+  }
+}
+
+/**
+ * Write the recorded events in the Chrome trace event format.
+ * @param filePath path to JSON file
+ * @return true if ok.
+ */
+bool Tracer::writeChromeTrace(const QString& filePath) const
+{
+  QFile file(filePath);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return false;
+
+  QMutexLocker locker(&m_mutex);
+  const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+  // Written directly instead of using QJsonDocument to keep the memory
+  // needed for large traces low.
+  file.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  for (auto it = m_threadIds.constBegin(); it != m_threadIds.constEnd(); ++it) {
+    file.write("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid +
+               ",\"tid\":" + QByteArray::number(it.value()) +
+               ",\"args\":{\"name\":\"" +
+               (it.value() == 0 ? QByteArray("main")
+                                : "worker " + QByteArray::number(it.value())) +
+               "\"}},\n");
+  }
+  for (const Event& event : m_events) {
+    QByteArray line("{\"name\":\"");
+    line += event.name;
+    line += "\",\"cat\":\"kid3\",\"ph\":\"X\",\"ts\":";
+    line += QByteArray::number(static_cast<double>(event.startNs) / 1000.0,
+                               'f', 3);
+    line += ",\"dur\":";
+    line += QByteArray::number(static_cast<double>(event.durationNs) / 1000.0,
+                               'f', 3);
+    line += ",\"pid\":";
+    line += pid;
+    line += ",\"tid\":";
+    line += QByteArray::number(event.threadId);
+    line += "},\n";
+    file.write(line);
+  }
+  // Trailing metadata event, so that the previous lines can all end in ",".
+  file.write("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" + pid +
+             ",\"args\":{\"name\":\"kid3\"}}\n]}\n");
+  return file.error() == QFileDevice::NoError;
+}
+
+/**
+ * Get a table with the number of calls and the time spent per span name.
+ * @return summary with one line per span name, sorted by total time.
+ */
+QString Tracer::summary() const
+{
+  QMutexLocker locker(&m_mutex);
+  QVector<QPair<QByteArray, Counter>> counters;
+  counters.reserve(m_counters.size());
+  for (auto it = m_counters.constBegin(); it != m_counters.constEnd(); ++it) {
+    counters.append(qMakePair(it.key(), it.value()));
+  }
+  std::sort(counters.begin(), counters.end(),
+            [](const QPair<QByteArray, Counter>& lhs,
+               const QPair<QByteArray, Counter>& rhs) {
+    return lhs.second.totalNs > rhs.second.totalNs;
+  });
+
+  QStringList lines;
+  lines.append(QString(QLatin1String("%1 %2 %3 %4 %5"))
+               .arg(QLatin1String("Span"), -32)
+               .arg(QLatin1String("Count"), 10)
+               .arg(QLatin1String("Total ms"), 12)
+               .arg(QLatin1String("Mean ms"), 10)
+               .arg(QLatin1String("Max ms"), 10));
+  for (const auto& nameCounter : counters) {
+    const Counter& counter = nameCounter.second;
+    lines.append(QString(QLatin1String("%1 %2 %3 %4 %5"))
+                 .arg(QString::fromLatin1(nameCounter.first), -32)
+                 .arg(counter.count, 10)
+                 .arg(counter.totalNs / 1e6, 12, 'f', 3)
+                 .arg(counter.totalNs / 1e6 / counter.count, 10, 'f', 3)
+                 .arg(counter.maxNs / 1e6, 10, 'f', 3));
+  }
+  if (m_droppedEvents > 0) {
+    lines.append(QString(QLatin1String("%1 events not written to trace"))
+                 .arg(m_droppedEvents));
+  }
+  return lines.join(QLatin1Char('\n'));
+}
@@ -0,0 +1,171 @@
+/**
+ * \file tracer.h
+ * Lightweight tracing of time spent in hot paths.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include "kid3api.h"
+
+/**
+ * Collects the time spent in instrumented code sections.
+ *
+ * The sections are marked using TraceSpan objects. While tracing is active,
+ * each span is recorded as an event, which can be written in the Chrome
+ * trace event format to be inspected with chrome://tracing or Perfetto.
+ * Additionally, the number of calls and the time spent are summed up per
+ * span name. When tracing is not active, a span only costs a check of an
+ * atomic flag.
+ */
+class KID3_CORE_EXPORT Tracer {
+public:
+  /**
+   * Get the tracer used by the application.
+   * @return tracer.
+   */
+  static Tracer& instance();
+
+  /**
+   * Check if tracing is active.
+   * @return true if spans are recorded.
+   */
+  bool isActive() const { return m_active.loadAcquire() != 0; }
+
+  /**
+   * Start tracing.
+   * Events recorded by a previous trace are discarded.
+   * @param filePath path to file where the trace is written by stop()
+   */
+  void start(const QString& filePath);
+
+  /**
+   * Stop tracing, write the trace file and log the summary.
+   * @return false if the trace file could not be written.
+   */
+  bool stop();
+
+  /**
+   * Get path of trace file.
+   * @return path passed to start().
+   */
+  QString filePath() const { return m_filePath; }
+
+  /**
+   * Get time elapsed since tracing was started.
+   * @return elapsed time in nanoseconds.
+   */
+  qint64 nsecsElapsed() const { return m_timer.nsecsElapsed(); }
+
+  /**
+   * Record a completed span.
+   * Can be called from any thread.
+   *
+   * @param name name of span, must be a string literal
+   * @param startNs start time as returned by nsecsElapsed()
+   * @param endNs end time as returned by nsecsElapsed()
+   */
+  void addEvent(const char* name, qint64 startNs, qint64 endNs);
+
+  /**
+   * Write the recorded events in the Chrome trace event format.
+   * @param filePath path to JSON file
+   * @return true if ok.
+   */
+  bool writeChromeTrace(const QString& filePath) const;
+
+  /**
+   * Get a table with the number of calls and the time spent per span name.
+   * @return summary with one line per span name, sorted by total time.
+   */
+  QString summary() const;
+
+private:
+  /** Recorded span. */
+  struct Event {
+    const char* name;
+    qint64 startNs;
+    qint64 durationNs;
+    int threadId;
+  };
+
+  /** Accumulated time per span name. */
+  struct Counter {
+    qint64 count;
+    qint64 totalNs;
+    qint64 maxNs;
+  };
+
+  Tracer();
+
+  QString m_filePath;
+  QElapsedTimer m_timer;
+  mutable QMutex m_mutex;
+  QVector<Event> m_events;
+  QHash<QByteArray, Counter> m_counters;
+  QHash<Qt::HANDLE, int> m_threadIds;
+  qint64 m_droppedEvents;
+  QAtomicInt m_active;
+
+  Q_DISABLE_COPY(Tracer)
+};
+
+/**
+ * Records the time from its construction to its destruction with the
+ * application tracer.
+ *
+ * Usage: TraceSpan span("readTags TagLib");
+ */
+class TraceSpan {
+public:
+  /**
+   * Constructor.
+   * @param name name of span, must be a string literal
+   */
+  explicit TraceSpan(const char* name)
+    : m_name(Tracer::instance().isActive() ? name : nullptr),
+      m_startNs(m_name ? Tracer::instance().nsecsElapsed() : 0) {
+  }
+
+  /**
+   * Destructor.
+   */
+  ~TraceSpan() {
+    if (m_name) {
+      Tracer& tracer = Tracer::instance();
+      tracer.addEvent(m_name, m_startNs, tracer.nsecsElapsed());
+    }
+  }
+
+private:
+  Q_DISABLE_COPY(TraceSpan)
+
+  const char* const m_name;
+  const qint64 m_startNs;
+};
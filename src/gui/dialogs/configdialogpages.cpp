@@ -131,7 +131,9 @@ QStringList folderPatternListFromString(const QString& patterns,
 ConfigDialogPages::ConfigDialogPages(IPlatformTools* platformTools,
                                      QObject* parent) : QObject(parent),
   m_platformTools(platformTools),
-  m_loadLastOpenedFileCheckBox(nullptr), m_preserveTimeCheckBox(nullptr),
+  m_loadLastOpenedFileCheckBox(nullptr), m_tagMemoryBudgetSpinBox(nullptr),
+  m_tagPrefetchCountSpinBox(nullptr),
+  m_preserveTimeCheckBox(nullptr),
   m_markChangesCheckBox(nullptr), m_coverFileNameLineEdit(nullptr),
   m_nameFilterComboBox(nullptr), m_includeFoldersLineEdit(nullptr),
   m_excludeFoldersLineEdit(nullptr), m_showHiddenFilesCheckBox(nullptr),
@@ -139,7 +141,11 @@ ConfigDialogPages::ConfigDialogPages(IPlatformTools* platformTools,
   m_markTruncationsCheckBox(nullptr), m_textEncodingV1ComboBox(nullptr),
   m_totalNumTracksCheckBox(nullptr), m_commentNameComboBox(nullptr),
   m_pictureNameComboBox(nullptr), m_markOversizedPicturesCheckBox(nullptr),
-  m_maximumPictureSizeSpinBox(nullptr), m_genreNotNumericCheckBox(nullptr),
+  m_maximumPictureSizeSpinBox(nullptr), m_normalizePicturesCheckBox(nullptr),
+  m_maximumNormalizedPictureSizeSpinBox(nullptr),
+  m_maximumPictureDimensionSpinBox(nullptr),
+  m_pictureFormatComboBox(nullptr), m_pictureQualitySpinBox(nullptr),
+  m_genreNotNumericCheckBox(nullptr),
   m_lowercaseId3ChunkCheckBox(nullptr),
   m_markStandardViolationsCheckBox(nullptr), m_textEncodingComboBox(nullptr),
   m_id3v2VersionComboBox(nullptr), m_trackNumberDigitsSpinBox(nullptr),
@@ -267,13 +273,44 @@ QWidget* ConfigDialogPages::createTagsPage()
     vorbisGroupBox->hide();
   }
   QGroupBox* pictureGroupBox = new QGroupBox(tr("Picture"), tag2Page);
-  auto pictureGroupBoxLayout = new QHBoxLayout(pictureGroupBox);
+  auto pictureGroupBoxLayout = new QGridLayout(pictureGroupBox);
   m_markOversizedPicturesCheckBox =
       new QCheckBox(tr("Mark if &larger than (bytes):"));
   m_maximumPictureSizeSpinBox = new QSpinBox;
   m_maximumPictureSizeSpinBox->setRange(0, INT_MAX);
-  pictureGroupBoxLayout->addWidget(m_markOversizedPicturesCheckBox);
-  pictureGroupBoxLayout->addWidget(m_maximumPictureSizeSpinBox);
+  m_normalizePicturesCheckBox =
+      new QCheckBox(tr("&Resize and recompress when saving"));
+  QLabel* maximumNormalizedPictureSizeLabel =
+      new QLabel(tr("Maximum size (bytes):"));
+  m_maximumNormalizedPictureSizeSpinBox = new QSpinBox;
+  m_maximumNormalizedPictureSizeSpinBox->setRange(0, INT_MAX);
+  maximumNormalizedPictureSizeLabel->setBuddy(
+        m_maximumNormalizedPictureSizeSpinBox);
+  QLabel* maximumPictureDimensionLabel =
+      new QLabel(tr("Maximum width and height (pixels):"));
+  m_maximumPictureDimensionSpinBox = new QSpinBox;
+  m_maximumPictureDimensionSpinBox->setRange(0, 65535);
+  maximumPictureDimensionLabel->setBuddy(m_maximumPictureDimensionSpinBox);
+  QLabel* pictureFormatLabel = new QLabel(tr("Format:"));
+  m_pictureFormatComboBox = new QComboBox;
+  m_pictureFormatComboBox->addItems({QLatin1String("JPG"),
+                                     QLatin1String("PNG")});
+  pictureFormatLabel->setBuddy(m_pictureFormatComboBox);
+  QLabel* pictureQualityLabel = new QLabel(tr("Quality:"));
+  m_pictureQualitySpinBox = new QSpinBox;
+  m_pictureQualitySpinBox->setRange(0, 100);
+  pictureQualityLabel->setBuddy(m_pictureQualitySpinBox);
+  pictureGroupBoxLayout->addWidget(m_markOversizedPicturesCheckBox, 0, 0);
+  pictureGroupBoxLayout->addWidget(m_maximumPictureSizeSpinBox, 0, 1);
+  pictureGroupBoxLayout->addWidget(m_normalizePicturesCheckBox, 1, 0, 1, 2);
+  pictureGroupBoxLayout->addWidget(maximumNormalizedPictureSizeLabel, 2, 0);
+  pictureGroupBoxLayout->addWidget(m_maximumNormalizedPictureSizeSpinBox, 2, 1);
+  pictureGroupBoxLayout->addWidget(maximumPictureDimensionLabel, 3, 0);
+  pictureGroupBoxLayout->addWidget(m_maximumPictureDimensionSpinBox, 3, 1);
+  pictureGroupBoxLayout->addWidget(pictureFormatLabel, 4, 0);
+  pictureGroupBoxLayout->addWidget(m_pictureFormatComboBox, 4, 1);
+  pictureGroupBoxLayout->addWidget(pictureQualityLabel, 5, 0);
+  pictureGroupBoxLayout->addWidget(m_pictureQualitySpinBox, 5, 1);
   tag2LeftLayout->addWidget(pictureGroupBox);
   tag2LeftLayout->addStretch();
   tag2Layout->addLayout(tag2LeftLayout);
@@ -384,6 +421,20 @@ QWidget* ConfigDialogPages::createFilesPage()
                                                startupGroupBox);
   auto startupLayout = new QVBoxLayout;
   startupLayout->addWidget(m_loadLastOpenedFileCheckBox);
+  m_tagMemoryBudgetSpinBox = new QSpinBox(startupGroupBox);
+  m_tagMemoryBudgetSpinBox->setRange(0, 65536);
+  m_tagMemoryBudgetSpinBox->setSingleStep(64);
+  m_tagMemoryBudgetSpinBox->setSuffix(QLatin1String(" MiB"));
+  m_tagMemoryBudgetSpinBox->setSpecialValueText(tr("Unlimited"));
+  auto tagMemoryLayout = new QFormLayout;
+  tagMemoryLayout->addRow(tr("Maximum memory for &tags:"),
+                          m_tagMemoryBudgetSpinBox);
+  m_tagPrefetchCountSpinBox = new QSpinBox(startupGroupBox);
+  m_tagPrefetchCountSpinBox->setRange(0, 32);
+  m_tagPrefetchCountSpinBox->setSpecialValueText(tr("Off"));
+  tagMemoryLayout->addRow(tr("&Read tags of next files in advance:"),
+                          m_tagPrefetchCountSpinBox);
+  startupLayout->addLayout(tagMemoryLayout);
   startupGroupBox->setLayout(startupLayout);
   leftLayout->addWidget(startupGroupBox);
   QGroupBox* saveGroupBox = new QGroupBox(tr("Save"), filesPage);
@@ -690,6 +741,8 @@ void ConfigDialogPages::setConfigs(
   m_markTruncationsCheckBox->setChecked(tagCfg.markTruncations());
   m_totalNumTracksCheckBox->setChecked(tagCfg.enableTotalNumberOfTracks());
   m_loadLastOpenedFileCheckBox->setChecked(fileCfg.loadLastOpenedFile());
+  m_tagMemoryBudgetSpinBox->setValue(fileCfg.tagMemoryBudget());
+  m_tagPrefetchCountSpinBox->setValue(fileCfg.tagPrefetchCount());
   m_preserveTimeCheckBox->setChecked(fileCfg.preserveTime());
   m_markChangesCheckBox->setChecked(fileCfg.markChanges());
   m_coverFileNameLineEdit->setText(fileCfg.defaultCoverFileName());
@@ -729,6 +782,14 @@ void ConfigDialogPages::setConfigs(
   m_trackNumberDigitsSpinBox->setValue(tagCfg.trackNumberDigits());
   m_markOversizedPicturesCheckBox->setChecked(tagCfg.markOversizedPictures());
   m_maximumPictureSizeSpinBox->setValue(tagCfg.maximumPictureSize());
+  m_normalizePicturesCheckBox->setChecked(tagCfg.normalizePictures());
+  m_maximumNormalizedPictureSizeSpinBox->setValue(
+        tagCfg.maximumNormalizedPictureSize());
+  m_maximumPictureDimensionSpinBox->setValue(
+        tagCfg.maximumPictureDimension());
+  m_pictureFormatComboBox->setCurrentIndex(
+        qMax(m_pictureFormatComboBox->findText(tagCfg.pictureFormat()), 0));
+  m_pictureQualitySpinBox->setValue(tagCfg.pictureQuality());
   idx = m_trackNameComboBox->findText(tagCfg.riffTrackName());
   if (idx >= 0) {
     m_trackNameComboBox->setCurrentIndex(idx);
@@ -814,6 +875,8 @@ void ConfigDialogPages::getConfig() const
   tagCfg.setMarkTruncations(m_markTruncationsCheckBox->isChecked());
   tagCfg.setEnableTotalNumberOfTracks(m_totalNumTracksCheckBox->isChecked());
   fileCfg.setLoadLastOpenedFile(m_loadLastOpenedFileCheckBox->isChecked());
+  fileCfg.setTagMemoryBudget(m_tagMemoryBudgetSpinBox->value());
+  fileCfg.setTagPrefetchCount(m_tagPrefetchCountSpinBox->value());
   fileCfg.setPreserveTime(m_preserveTimeCheckBox->isChecked());
   fileCfg.setMarkChanges(m_markChangesCheckBox->isChecked());
   fileCfg.setDefaultCoverFileName(m_coverFileNameLineEdit->text());
@@ -850,6 +913,12 @@ void ConfigDialogPages::getConfig() const
   tagCfg.setTrackNumberDigits(m_trackNumberDigitsSpinBox->value());
   tagCfg.setMarkOversizedPictures(m_markOversizedPicturesCheckBox->isChecked());
   tagCfg.setMaximumPictureSize(m_maximumPictureSizeSpinBox->value());
+  tagCfg.setNormalizePictures(m_normalizePicturesCheckBox->isChecked());
+  tagCfg.setMaximumNormalizedPictureSize(
+        m_maximumNormalizedPictureSizeSpinBox->value());
+  tagCfg.setMaximumPictureDimension(m_maximumPictureDimensionSpinBox->value());
+  tagCfg.setPictureFormat(m_pictureFormatComboBox->currentText());
+  tagCfg.setPictureQuality(m_pictureQualitySpinBox->value());
   tagCfg.setRiffTrackName(m_trackNameComboBox->currentText());
   networkCfg.setBrowser(m_browserLineEdit->text());
   guiCfg.setPlayOnDoubleClick(m_playOnDoubleClickCheckBox->isChecked());
@@ -139,6 +139,10 @@ private:
   IPlatformTools* m_platformTools;
   /** Load last-opened files checkbox */
   QCheckBox* m_loadLastOpenedFileCheckBox;
+  /** Maximum memory for tags spinbox */
+  QSpinBox* m_tagMemoryBudgetSpinBox;
+  /** Number of files to read in advance spinbox */
+  QSpinBox* m_tagPrefetchCountSpinBox;
   /** Preserve timestamp checkbox */
   QCheckBox* m_preserveTimeCheckBox;
   /** Mark changes checkbox */
@@ -169,6 +173,16 @@ private:
   QCheckBox* m_markOversizedPicturesCheckBox;
   /** Maximum picture size spin box */
   QSpinBox* m_maximumPictureSizeSpinBox;
+  /** Normalize pictures check box */
+  QCheckBox* m_normalizePicturesCheckBox;
+  /** Maximum size of normalized pictures spin box */
+  QSpinBox* m_maximumNormalizedPictureSizeSpinBox;
+  /** Maximum picture width and height spin box */
+  QSpinBox* m_maximumPictureDimensionSpinBox;
+  /** Picture format combo box */
+  QComboBox* m_pictureFormatComboBox;
+  /** Picture quality spin box */
+  QSpinBox* m_pictureQualitySpinBox;
   /** Genre as text instead of numeric string checkbox */
   QCheckBox* m_genreNotNumericCheckBox;
   /** WAV files with lowercase id3 chunk checkbox */
@@ -86,6 +86,7 @@
 #include "serverimporter.h"
 #include "batchimporter.h"
 #include "dirrenamer.h"
+#include "tagmemorytracker.h"
 #include "iplatformtools.h"
 #include "saferename.h"
 #include "config.h"
@@ -117,6 +118,7 @@ BaseMainWindowImpl::BaseMainWindowImpl(QMainWindow* mainWin,
     m_editFrameTagNr(Frame::Tag_2),
     m_progressTerminationHandler(nullptr),
     m_folderCount(0), m_fileCount(0), m_selectionCount(0),
+    m_tagMemoryUsage(0), m_tagMemoryBudget(0),
     m_progressDisconnected(false),
     m_findReplaceActive(false), m_expandNotificationNeeded(false)
 {
@@ -170,6 +172,9 @@ BaseMainWindowImpl::BaseMainWindowImpl(QMainWindow* mainWin,
           this, &BaseMainWindowImpl::showOperationProgress);
   connect(m_app, &Kid3Application::aboutToPlayAudio,
           this, &BaseMainWindowImpl::showPlayToolBar);
+  connect(m_app->getFileSystemModel()->tagMemoryTracker(),
+          &TagMemoryTracker::usageChanged,
+          this, &BaseMainWindowImpl::onTagMemoryUsageChanged);
 }
 
 /**
@@ -706,6 +711,12 @@ void BaseMainWindowImpl::updateStatusLabel()
       //~ plural %n selected
       counts.append(tr("%n selected", "", m_selectionCount));
     }
+    if (m_tagMemoryBudget > 0) {
+      counts.append(tr("Tags: %1 of %2 MiB")
+                    .arg(static_cast<double>(m_tagMemoryUsage) / 1048576.0,
+                         0, 'f', 1)
+                    .arg(m_tagMemoryBudget / 1048576));
+    }
     if (counts.isEmpty()) {
       m_statusLabel->setText((tr("Ready.")));
     } else {
@@ -714,6 +725,18 @@ void BaseMainWindowImpl::updateStatusLabel()
   }
 }
 
+/**
+ * Called when the memory used by the tags of loaded files changed.
+ * @param usage estimated number of bytes used
+ * @param budget maximum number of bytes, 0 if unlimited
+ */
+void BaseMainWindowImpl::onTagMemoryUsageChanged(qint64 usage, qint64 budget)
+{
+  m_tagMemoryUsage = usage;
+  m_tagMemoryBudget = budget;
+  updateStatusLabel();
+}
+
 /**
  * Change status message.
  *
@@ -473,6 +473,13 @@ private slots:
    */
   void onSelectionCountChanged();
 
+  /**
+   * Called when the memory used by the tags of loaded files changed.
+   * @param usage estimated number of bytes used
+   * @param budget maximum number of bytes, 0 if unlimited
+   */
+  void onTagMemoryUsageChanged(qint64 usage, qint64 budget);
+
 private:
   /**
    * Free allocated resources.
@@ -645,6 +652,8 @@ private:
   int m_folderCount;
   int m_fileCount;
   int m_selectionCount;
+  qint64 m_tagMemoryUsage;
+  qint64 m_tagMemoryBudget;
   bool m_progressDisconnected;
   bool m_findReplaceActive;
   bool m_expandNotificationNeeded;
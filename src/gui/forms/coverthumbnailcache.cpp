@@ -0,0 +1,481 @@
+/**
+ * \file coverthumbnailcache.cpp
+ * Cache for downscaled cover art images.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "coverthumbnailcache.h"
+#include <QByteArray>
+#include <QBuffer>
+#include <QImageReader>
+#include <QRunnable>
+#include <QHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include "taggedfilesystemmodel.h"
+
+namespace {
+
+/** Default maximum memory used by the cached thumbnails. */
+const int DEFAULT_MAX_COST = 32 * 1024 * 1024;
+
+/** Default maximum memory used by the cached thumbnails of files. */
+const int DEFAULT_MAX_FILE_COST = 16 * 1024 * 1024;
+
+/** Maximum size of the thumbnails in the disk cache. */
+const qint64 MAX_DISK_CACHE_SIZE = 50 * 1024 * 1024;
+
+/** Number of thumbnails written to disk after which the cache is pruned. */
+const int PRUNE_INTERVAL = 256;
+
+/** Key of text in cached thumbnail with modification time of file. */
+const QLatin1String MTIME_KEY("Kid3::MTime");
+
+/** Key of text in cached thumbnail set if file has no picture. */
+const QLatin1String NO_PICTURE_KEY("Kid3::NoPicture");
+
+/**
+ * Decode picture data with the resolution needed for a thumbnail.
+ *
+ * @param data picture data
+ * @param size maximum size of thumbnail, invalid for original size
+ * @param originalSize the size of the original image is returned here
+ *
+ * @return thumbnail, null if @a data cannot be decoded.
+ */
+QImage decodeThumbnail(const QByteArray& data, const QSize& size,
+                       QSize* originalSize)
+{
+  QBuffer buffer;
+  buffer.setData(data);
+  buffer.open(QIODevice::ReadOnly);
+  QImageReader reader(&buffer);
+  reader.setAutoTransform(true);
+  // The size is available from the header without decoding the image.
+  QSize imageSize = reader.size();
+  *originalSize = imageSize;
+  if (size.isValid() && imageSize.isValid() &&
+      (imageSize.width() > size.width() ||
+       imageSize.height() > size.height())) {
+    reader.setScaledSize(imageSize.scaled(size, Qt::KeepAspectRatio));
+  }
+  QImage image = reader.read();
+  if (!originalSize->isValid()) {
+    *originalSize = image.size();
+  }
+  if (!image.isNull() && size.isValid() &&
+      (image.width() > size.width() || image.height() > size.height())) {
+    // The reader could not provide the scaled size.
+    image = image.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+  }
+  return image;
+}
+
+/**
+ * Job decoding a thumbnail in a thread pool.
+ */
+class DecodeJob : public QRunnable {
+public:
+  /**
+   * Constructor.
+   * @param cache cache to be notified with the decoded image
+   * @param key key of picture data
+   * @param data picture data
+   * @param size maximum size of thumbnail
+   */
+  DecodeJob(CoverThumbnailCache* cache, quint64 key, const QByteArray& data,
+            const QSize& size)
+    : m_cache(cache), m_key(key), m_data(data), m_size(size) {}
+
+  virtual void run() override;
+
+private:
+  CoverThumbnailCache* m_cache;
+  quint64 m_key;
+  QByteArray m_data;
+  QSize m_size;
+};
+
+void DecodeJob::run()
+{
+  QSize originalSize;
+  QImage image = decodeThumbnail(m_data, m_size, &originalSize);
+  QMetaObject::invokeMethod(m_cache, "onDecoded", Qt::QueuedConnection,
+                            Q_ARG(quint64, m_key), Q_ARG(QSize, m_size),
+                            Q_ARG(QImage, image), Q_ARG(QSize, originalSize));
+}
+
+/**
+ * Job getting the thumbnail of the cover art of a file in a thread pool.
+ * The thumbnail is taken from the disk cache if it is up to date, else
+ * the picture is extracted from the file and stored in the disk cache.
+ */
+class FileThumbnailJob : public QRunnable {
+public:
+  /**
+   * Constructor.
+   * @param cache cache to be notified with the thumbnail
+   * @param filePath path to file
+   * @param lastModified modification time of file in ms since the epoch
+   * @param size maximum size of thumbnail
+   * @param diskCacheDir directory for cached thumbnails, empty if not used
+   */
+  FileThumbnailJob(CoverThumbnailCache* cache, const QString& filePath,
+                   qint64 lastModified, const QSize& size,
+                   const QString& diskCacheDir)
+    : m_cache(cache), m_filePath(filePath), m_lastModified(lastModified),
+      m_size(size), m_diskCacheDir(diskCacheDir) {}
+
+  virtual void run() override;
+
+private:
+  CoverThumbnailCache* m_cache;
+  QString m_filePath;
+  qint64 m_lastModified;
+  QSize m_size;
+  QString m_diskCacheDir;
+};
+
+void FileThumbnailJob::run()
+{
+  QImage image;
+  bool found = false;
+  QString cachePath;
+  const QString mtime = QString::number(m_lastModified);
+  if (!m_diskCacheDir.isEmpty()) {
+    cachePath = m_diskCacheDir + QLatin1Char('/') + QString::fromLatin1(
+          QCryptographicHash::hash(
+            (m_filePath + QLatin1Char('\n') +
+             QString::number(m_size.width()) + QLatin1Char('x') +
+             QString::number(m_size.height())).toUtf8(),
+            QCryptographicHash::Sha1).toHex()) + QLatin1String(".png");
+    QImageReader reader(cachePath);
+    // The texts are read from the header without decoding the image.
+    if (reader.canRead() && reader.text(MTIME_KEY) == mtime) {
+      found = true;
+      if (reader.text(NO_PICTURE_KEY).isEmpty()) {
+        image = reader.read();
+      }
+    }
+  }
+  if (!found) {
+    const QByteArray data = TaggedFileSystemModel::readPictureData(m_filePath);
+    if (!data.isEmpty()) {
+      QSize originalSize;
+      image = decodeThumbnail(data, m_size, &originalSize);
+    }
+    if (!cachePath.isEmpty()) {
+      QImage cacheImage = image;
+      if (cacheImage.isNull()) {
+        // Remember that there is no picture to avoid reading the file again.
+        cacheImage = QImage(1, 1, QImage::Format_ARGB32);
+        cacheImage.fill(Qt::transparent);
+        cacheImage.setText(NO_PICTURE_KEY, QLatin1String("1"));
+      }
+      cacheImage.setText(MTIME_KEY, mtime);
+      cacheImage.save(cachePath, "PNG");
+    }
+  }
+  QMetaObject::invokeMethod(m_cache, "onFileDecoded", Qt::QueuedConnection,
+                            Q_ARG(QString, m_filePath),
+                            Q_ARG(qint64, m_lastModified),
+                            Q_ARG(QSize, m_size), Q_ARG(QImage, image));
+}
+
+}
+
+/**
+ * Job removing the oldest thumbnails if the disk cache is larger than its
+ * maximum size.
+ */
+class PruneJob : public QRunnable {
+public:
+  /**
+   * Constructor.
+   * @param diskCacheDir directory for cached thumbnails
+   */
+  explicit PruneJob(const QString& diskCacheDir)
+    : m_diskCacheDir(diskCacheDir) {}
+
+  virtual void run() override;
+
+private:
+  QString m_diskCacheDir;
+};
+
+void PruneJob::run()
+{
+  QFileInfoList files = QDir(m_diskCacheDir).entryInfoList(
+        {QLatin1String("*.png")}, QDir::Files, QDir::Time);
+  qint64 size = 0;
+  for (const QFileInfo& fi : qAsConst(files)) {
+    size += fi.size();
+  }
+  // The files are sorted by time, newest first.
+  while (size > MAX_DISK_CACHE_SIZE && !files.isEmpty()) {
+    const QFileInfo fi = files.takeLast();
+    if (QFile::remove(fi.filePath())) {
+      size -= fi.size();
+    }
+  }
+}
+
+}
+
+/**
+ * Constructor.
+ * @param parent parent object
+ */
+CoverThumbnailCache::CoverThumbnailCache(QObject* parent) : QObject(parent),
+  m_cache(DEFAULT_MAX_COST), m_fileCache(DEFAULT_MAX_FILE_COST),
+  m_numFileJobs(0)
+{
+  setObjectName(QLatin1String("CoverThumbnailCache"));
+  const QString cacheLocation =
+      QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  if (!cacheLocation.isEmpty()) {
+    // The thumbnails have their own folder, so that they are not mixed up
+    // with other cached cover art and can be pruned separately.
+    m_diskCacheDir = cacheLocation + QLatin1String("/coverart/thumbnails");
+    if (!QDir().mkpath(m_diskCacheDir)) {
+      m_diskCacheDir.clear();
+    }
+  }
+  // Decoding is memory intensive, do not use all cores.
+  m_threadPool.setMaxThreadCount(2);
+  if (!m_diskCacheDir.isEmpty()) {
+    m_threadPool.start(new PruneJob(m_diskCacheDir));
+  }
+}
+
+/**
+ * Destructor.
+ * Waits until all pending decoding jobs are finished.
+ */
+CoverThumbnailCache::~CoverThumbnailCache()
+{
+  m_threadPool.waitForDone();
+}
+
+/**
+ * Get the cache shared by all users.
+ * @return cover thumbnail cache.
+ */
+CoverThumbnailCache* CoverThumbnailCache::instance()
+{
+  static CoverThumbnailCache cache;
+  return &cache;
+}
+
+/**
+ * Get key for picture data.
+ * @param data picture data
+ * @return key identifying @a data.
+ */
+CoverThumbnailCache::Key CoverThumbnailCache::keyForData(
+    const QByteArray& data)
+{
+  return (static_cast<Key>(data.size()) << 32) |
+      static_cast<uint>(qHash(data));
+}
+
+/**
+ * Look up a thumbnail in the cache.
+ *
+ * @param key key of picture data, see keyForData()
+ * @param size maximum size of thumbnail, invalid for original size
+ * @param originalSize if not null, the size of the original image is
+ *                     returned here
+ *
+ * @return thumbnail, null if not in cache.
+ */
+QImage CoverThumbnailCache::find(Key key, const QSize& size,
+                                 QSize* originalSize)
+{
+  if (const Entry* entry = m_cache.object(entryKey(key, size))) {
+    if (originalSize) {
+      *originalSize = entry->originalSize;
+    }
+    return entry->image;
+  }
+  return QImage();
+}
+
+/**
+ * Get a thumbnail, decode it synchronously if it is not in the cache.
+ *
+ * @param data picture data
+ * @param size maximum size of thumbnail, invalid for original size
+ * @param originalSize if not null, the size of the original image is
+ *                     returned here
+ *
+ * @return thumbnail, null if @a data cannot be decoded.
+ */
+QImage CoverThumbnailCache::thumbnail(const QByteArray& data,
+                                      const QSize& size, QSize* originalSize)
+{
+  const Key key = keyForData(data);
+  QSize imageSize;
+  QImage image = find(key, size, &imageSize);
+  if (image.isNull()) {
+    image = decodeThumbnail(data, size, &imageSize);
+    insert(key, size, image, imageSize);
+  }
+  if (originalSize) {
+    *originalSize = imageSize;
+  }
+  return image;
+}
+
+/**
+ * Decode a thumbnail in a background thread.
+ * thumbnailReady() is emitted when the thumbnail is available with find().
+ * Nothing is done if the same thumbnail is already being decoded.
+ *
+ * @param data picture data
+ * @param size maximum size of thumbnail, invalid for original size
+ *
+ * @return key identifying @a data.
+ */
+CoverThumbnailCache::Key CoverThumbnailCache::requestThumbnail(
+    const QByteArray& data, const QSize& size)
+{
+  const Key key = keyForData(data);
+  const EntryKey ek = entryKey(key, size);
+  if (!m_pending.contains(ek)) {
+    m_pending.insert(ek);
+    m_threadPool.start(new DecodeJob(this, key, data, size));
+  }
+  return key;
+}
+
+/**
+ * Get a thumbnail of the cover art embedded in a file.
+ * If the thumbnail is not in the memory cache or outdated, it is loaded
+ * from the disk cache or extracted from the file in a background thread
+ * and fileThumbnailReady() is emitted when it is available.
+ *
+ * @param filePath path to file
+ * @param lastModified modification time of file
+ * @param size maximum size of thumbnail
+ *
+ * @return thumbnail, null if not available or if the file does not
+ *         contain a picture.
+ */
+QImage CoverThumbnailCache::fileThumbnail(const QString& filePath,
+                                          const QDateTime& lastModified,
+                                          const QSize& size)
+{
+  const qint64 mtime = lastModified.toMSecsSinceEpoch();
+  if (const FileEntry* entry = m_fileCache.object(filePath)) {
+    if (entry->lastModified == mtime && entry->size == size) {
+      return entry->image;
+    }
+  }
+  if (!m_pendingFiles.contains(filePath)) {
+    m_pendingFiles.insert(filePath);
+    m_threadPool.start(new FileThumbnailJob(this, filePath, mtime, size,
+                                            m_diskCacheDir));
+    // Every job can add a thumbnail to the disk cache.
+    if (!m_diskCacheDir.isEmpty() && ++m_numFileJobs >= PRUNE_INTERVAL) {
+      m_numFileJobs = 0;
+      m_threadPool.start(new PruneJob(m_diskCacheDir));
+    }
+  }
+  return QImage();
+}
+
+/**
+ * Set maximum memory used by the cached thumbnails.
+ * @param bytes maximum number of bytes
+ */
+void CoverThumbnailCache::setMaxCost(int bytes)
+{
+  m_cache.setMaxCost(bytes);
+}
+
+/**
+ * Called in the GUI thread when a thumbnail has been decoded.
+ *
+ * @param key key of picture data
+ * @param size requested size
+ * @param image decoded image
+ * @param originalSize size of original image
+ */
+void CoverThumbnailCache::onDecoded(quint64 key, const QSize& size,
+                                    const QImage& image,
+                                    const QSize& originalSize)
+{
+  m_pending.remove(entryKey(key, size));
+  insert(key, size, image, originalSize);
+  emit thumbnailReady(key, size);
+}
+
+/**
+ * Called in the GUI thread when the thumbnail of a file is available.
+ *
+ * @param filePath path to file
+ * @param lastModified modification time of file in ms since the epoch
+ * @param size requested size
+ * @param image thumbnail, null if file has no picture
+ */
+void CoverThumbnailCache::onFileDecoded(const QString& filePath,
+                                        qint64 lastModified,
+                                        const QSize& size, const QImage& image)
+{
+  m_pendingFiles.remove(filePath);
+#if QT_VERSION >= 0x050a00
+  const auto cost = static_cast<int>(image.sizeInBytes());
+#else
+  const int cost = image.byteCount();
+#endif
+  m_fileCache.insert(filePath, new FileEntry{image, size, lastModified},
+                     qMax(cost, 1));
+  emit fileThumbnailReady(filePath);
+}
+
+CoverThumbnailCache::EntryKey CoverThumbnailCache::entryKey(
+    Key key, const QSize& size)
+{
+  return qMakePair(key, qMakePair(size.width(), size.height()));
+}
+
+void CoverThumbnailCache::insert(Key key, const QSize& size,
+                                 const QImage& image,
+                                 const QSize& originalSize)
+{
+  if (image.isNull()) {
+    return;
+  }
+#if QT_VERSION >= 0x050a00
+  const auto cost = static_cast<int>(image.sizeInBytes());
+#else
+  const int cost = image.byteCount();
+#endif
+  m_cache.insert(entryKey(key, size), new Entry{image, originalSize},
+                 qMax(cost, 1));
+}
@@ -0,0 +1,193 @@
+/**
+ * \file coverthumbnailcache.h
+ * Cache for downscaled cover art images.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QCache>
+#include <QPair>
+#include <QSet>
+#include <QImage>
+#include <QThreadPool>
+#include "kid3api.h"
+
+class QByteArray;
+class QDateTime;
+
+/**
+ * Cache for downscaled cover art images.
+ *
+ * The images are decoded with QImageReader using a scaled size, so that
+ * decoders supporting it (e.g. JPEG) only decode the needed resolution.
+ * The thumbnails are kept in a least recently used cache keyed by a hash of
+ * the picture data and the requested size, which is shared by all views
+ * displaying cover art.
+ *
+ * Thumbnails of the cover art embedded in files can be requested by file
+ * path. They are extracted in the background without reading the tags and
+ * are additionally cached on disk, so that they are only extracted again
+ * when the file is modified. The oldest thumbnails are removed from the
+ * disk cache when it exceeds its maximum size.
+ */
+class KID3_GUI_EXPORT CoverThumbnailCache : public QObject {
+  Q_OBJECT
+public:
+  /** Key identifying picture data. */
+  typedef quint64 Key;
+
+  /**
+   * Get the cache shared by all users.
+   * @return cover thumbnail cache.
+   */
+  static CoverThumbnailCache* instance();
+
+  /**
+   * Destructor.
+   * Waits until all pending decoding jobs are finished.
+   */
+  virtual ~CoverThumbnailCache() override;
+
+  /**
+   * Get key for picture data.
+   * @param data picture data
+   * @return key identifying @a data.
+   */
+  static Key keyForData(const QByteArray& data);
+
+  /**
+   * Look up a thumbnail in the cache.
+   *
+   * @param key key of picture data, see keyForData()
+   * @param size maximum size of thumbnail, invalid for original size
+   * @param originalSize if not null, the size of the original image is
+   *                     returned here
+   *
+   * @return thumbnail, null if not in cache.
+   */
+  QImage find(Key key, const QSize& size, QSize* originalSize = nullptr);
+
+  /**
+   * Get a thumbnail, decode it synchronously if it is not in the cache.
+   *
+   * @param data picture data
+   * @param size maximum size of thumbnail, invalid for original size
+   * @param originalSize if not null, the size of the original image is
+   *                     returned here
+   *
+   * @return thumbnail, null if @a data cannot be decoded.
+   */
+  QImage thumbnail(const QByteArray& data, const QSize& size,
+                   QSize* originalSize = nullptr);
+
+  /**
+   * Decode a thumbnail in a background thread.
+   * thumbnailReady() is emitted when the thumbnail is available with find().
+   * Nothing is done if the same thumbnail is already being decoded.
+   *
+   * @param data picture data
+   * @param size maximum size of thumbnail, invalid for original size
+   *
+   * @return key identifying @a data.
+   */
+  Key requestThumbnail(const QByteArray& data, const QSize& size);
+
+  /**
+   * Get a thumbnail of the cover art embedded in a file.
+   * If the thumbnail is not in the memory cache or outdated, it is loaded
+   * from the disk cache or extracted from the file in a background thread
+   * and fileThumbnailReady() is emitted when it is available.
+   *
+   * @param filePath path to file
+   * @param lastModified modification time of file
+   * @param size maximum size of thumbnail
+   *
+   * @return thumbnail, null if not available or if the file does not
+   *         contain a picture.
+   */
+  QImage fileThumbnail(const QString& filePath, const QDateTime& lastModified,
+                       const QSize& size);
+
+  /**
+   * Set maximum memory used by the cached thumbnails.
+   * @param bytes maximum number of bytes
+   */
+  void setMaxCost(int bytes);
+
+signals:
+  /**
+   * Emitted when a thumbnail requested with requestThumbnail() is
+   * available.
+   *
+   * @param key key of picture data
+   * @param size size which was requested
+   */
+  void thumbnailReady(quint64 key, const QSize& size);
+
+  /**
+   * Emitted when a thumbnail requested with fileThumbnail() is available.
+   *
+   * @param filePath path to file
+   */
+  void fileThumbnailReady(const QString& filePath);
+
+private slots:
+  void onDecoded(quint64 key, const QSize& size, const QImage& image,
+                 const QSize& originalSize);
+  void onFileDecoded(const QString& filePath, qint64 lastModified,
+                     const QSize& size, const QImage& image);
+
+private:
+  /** Cached thumbnail. */
+  struct Entry {
+    QImage image;
+    QSize originalSize;
+  };
+
+  /** Cached thumbnail of a file. */
+  struct FileEntry {
+    QImage image;
+    QSize size;
+    qint64 lastModified;
+  };
+
+  /** Key of cache entry consisting of data key and size. */
+  typedef QPair<Key, QPair<int, int>> EntryKey;
+
+  explicit CoverThumbnailCache(QObject* parent = nullptr);
+
+  static EntryKey entryKey(Key key, const QSize& size);
+  void insert(Key key, const QSize& size, const QImage& image,
+              const QSize& originalSize);
+
+  QCache<EntryKey, Entry> m_cache;
+  QSet<EntryKey> m_pending;
+  QCache<QString, FileEntry> m_fileCache;
+  QSet<QString> m_pendingFiles;
+  QString m_diskCacheDir;
+  QThreadPool m_threadPool;
+  /** Number of file thumbnail jobs since the disk cache was pruned */
+  int m_numFileJobs;
+};
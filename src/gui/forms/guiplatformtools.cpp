@@ -27,6 +27,9 @@
 #include "guiplatformtools.h"
 #include <QGuiApplication>
 #include <QClipboard>
+#include <QBuffer>
+#include <QImage>
+#include <QImageReader>
 #include "taggedfileiconprovider.h"
 #include "config.h"
 #ifdef HAVE_QTMULTIMEDIA
@@ -106,3 +109,71 @@ QObject* GuiPlatformTools::createAudioPlayer(Kid3Application* app,
   return nullptr;
 #endif
 }
+
+/**
+ * Check if pictures can be converted with convertPicture().
+ * @return true if convertPicture() is supported.
+ */
+bool GuiPlatformTools::canConvertPicture() const
+{
+  return true;
+}
+
+/**
+ * Resize and recompress a picture.
+ * This method is called from worker threads.
+ * @param data picture data
+ * @param maxDimension maximum width and height in pixels, 0 for no limit
+ * @param maxBytes maximum size of picture data in bytes, 0 for no limit
+ * @param format image format of converted picture, e.g. "JPG" or "PNG"
+ * @param quality quality of converted picture, 0..100
+ * @return converted picture data, empty if the picture does not exceed
+ *         the limits or cannot be converted.
+ */
+QByteArray GuiPlatformTools::convertPicture(
+    const QByteArray& data, int maxDimension, int maxBytes,
+    const QString& format, int quality) const
+{
+  QByteArray source(data);
+  QBuffer sourceBuffer(&source);
+  sourceBuffer.open(QIODevice::ReadOnly);
+  QImageReader reader(&sourceBuffer);
+  const QSize size = reader.size();
+  const bool tooLarge = maxDimension > 0 && size.isValid() &&
+      (size.width() > maxDimension || size.height() > maxDimension);
+  const bool tooBig = maxBytes > 0 && data.size() > maxBytes;
+  if (!size.isValid() || (!tooLarge && !tooBig)) {
+    return QByteArray();
+  }
+  if (tooLarge) {
+    // Decoders supporting it (e.g. JPEG) only decode the needed resolution.
+    reader.setScaledSize(size.scaled(maxDimension, maxDimension,
+                                     Qt::KeepAspectRatio));
+  }
+  const QImage image = reader.read();
+  if (image.isNull()) {
+    return QByteArray();
+  }
+
+  const QByteArray fmt = format.toLatin1();
+  // Quality has no effect on the size of lossless formats.
+  const bool lossless = format.compare(QLatin1String("PNG"),
+                                       Qt::CaseInsensitive) == 0;
+  QByteArray result;
+  for (int q = quality; ; q -= 10) {
+    result.clear();
+    QBuffer buffer(&result);
+    buffer.open(QIODevice::WriteOnly);
+    if (!image.save(&buffer, fmt.constData(), q)) {
+      return QByteArray();
+    }
+    if (lossless || maxBytes <= 0 || result.size() <= maxBytes || q <= 10) {
+      break;
+    }
+  }
+  if (!tooLarge && result.size() >= data.size()) {
+    // Recompression did not make the picture smaller.
+    return QByteArray();
+  }
+  return result;
+}
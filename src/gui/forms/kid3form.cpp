@@ -71,6 +71,8 @@
 #include "icoreplatformtools.h"
 #include "kid3application.h"
 #include "sectionactions.h"
+#include "coverthumbnailcache.h"
+#include "taggedfilesystemmodel.h"
 #ifdef Q_OS_MAC
 #include <CoreFoundation/CFURL.h>
 #endif
@@ -293,6 +295,10 @@ Kid3Form::Kid3Form(Kid3Application* app, BaseMainWindowImpl* mainWin,
         QApplication::style()->standardIcon(QStyle::SP_DriveFDIcon));
   int iconHeight = (((fontMetrics().height() - 1) / 16) + 1) * 16;
   tagIconProvider->setRequestedSize(QSize(iconHeight, iconHeight));
+  connect(CoverThumbnailCache::instance(),
+          &CoverThumbnailCache::fileThumbnailReady,
+          m_app->getFileSystemModel(),
+          &TaggedFileSystemModel::notifyCoverArtChanged);
   m_fileListBox->setModel(fileProxyModel);
   m_fileListBox->setSelectionModel(m_app->getFileSelectionModel());
   m_dirListBox = new ConfigurableTreeView(m_vSplitter);
@@ -28,6 +28,7 @@
 #include <QHash>
 #include <QVariant>
 #include "coretaggedfileiconprovider.h"
+#include "coverthumbnailcache.h"
 
 /**
  * Constructor.
@@ -68,18 +69,16 @@ QPixmap PixmapProvider::getPixmap(const QString& id, QSize* size,
     QByteArray data = getImageData();
     if (!data.isEmpty()) {
       uint hash = qHash(data);
-      if (m_dataPixmap.isNull() || hash != m_pixmapHash) {
-        if (m_dataPixmap.loadFromData(data)) {
-          if (size) {
-            *size = m_dataPixmap.size();
-          }
-          if (requestedSize.isValid()) {
-            m_dataPixmap = m_dataPixmap.scaled(requestedSize,
-                                               Qt::KeepAspectRatio);
-          }
-          if (!m_dataPixmap.isNull()) {
-            m_pixmapHash = hash;
-          }
+      if (m_dataPixmap.isNull() || hash != m_pixmapHash ||
+          requestedSize != m_pixmapRequestedSize) {
+        // Only decode the requested resolution, the thumbnail cache is
+        // shared with the other views displaying cover art.
+        const QImage image = CoverThumbnailCache::instance()->thumbnail(
+              data, requestedSize, size);
+        m_dataPixmap = QPixmap::fromImage(image);
+        if (!m_dataPixmap.isNull()) {
+          m_pixmapHash = hash;
+          m_pixmapRequestedSize = requestedSize;
         }
       }
       if (!m_dataPixmap.isNull()) {
@@ -65,5 +65,6 @@ public:
 private:
   CoreTaggedFileIconProvider* m_fileIconProvider;
   QPixmap m_dataPixmap;
+  QSize m_pixmapRequestedSize;
   uint m_pixmapHash;
 };
@@ -33,6 +33,7 @@
 #include <QPainter>
 #include "taggedfile.h"
 #include "tagconfig.h"
+#include "coverthumbnailcache.h"
 
 /**
  * Constructor.
@@ -245,6 +246,26 @@ QVariant TaggedFileIconProvider::backgroundForTaggedFile(
   return QVariant();
 }
 
+/**
+ * Get a thumbnail of the cover art embedded in a file.
+ * The thumbnail is created asynchronously by CoverThumbnailCache if it is
+ * not yet available.
+ *
+ * @param filePath path to file
+ * @param lastModified modification time of file, used to detect
+ *                     outdated thumbnails
+ *
+ * @return thumbnail pixmap, null if not available.
+ */
+QVariant TaggedFileIconProvider::coverArtForFile(const QString& filePath,
+                                                 const QDateTime& lastModified)
+{
+  // Thumbnails are twice as high as the icons to be recognizable.
+  QImage image = CoverThumbnailCache::instance()->fileThumbnail(
+        filePath, lastModified, m_requestedSize * 2);
+  return image.isNull() ? QVariant() : QVariant(QPixmap::fromImage(image));
+}
+
 /**
  * Get brush with color for a context.
  * @param context color context
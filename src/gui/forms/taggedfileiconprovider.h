@@ -88,6 +88,20 @@ public:
    */
   virtual QVariant backgroundForTaggedFile(const TaggedFile* taggedFile) override;
 
+  /**
+   * Get a thumbnail of the cover art embedded in a file.
+   * The thumbnail is created asynchronously by CoverThumbnailCache if it is
+   * not yet available.
+   *
+   * @param filePath path to file
+   * @param lastModified modification time of file, used to detect
+   *                     outdated thumbnails
+   *
+   * @return thumbnail pixmap, null if not available.
+   */
+  virtual QVariant coverArtForFile(const QString& filePath,
+                                   const QDateTime& lastModified) override;
+
   /**
    * Get brush with color for a context.
    * @param context color context
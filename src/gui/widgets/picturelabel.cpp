@@ -27,7 +27,6 @@
 #include "picturelabel.h"
 #include <QLabel>
 #include <QVBoxLayout>
-#include <QHash>
 #include <QByteArray>
 #include <QPixmap>
 #include <QCoreApplication>
@@ -63,7 +62,7 @@ int PictureLabelIntern::heightForWidth(int w) const
  * @param parent parent widget
  */
 PictureLabel::PictureLabel(QWidget* parent)
-  : QWidget(parent), m_pixmapHash(0)
+  : QWidget(parent), m_pixmapKey(0), m_pendingKey(0)
 {
   setObjectName(QLatin1String("PictureLabel"));
   auto layout = new QVBoxLayout(this);
@@ -74,6 +73,8 @@ PictureLabel::PictureLabel(QWidget* parent)
   m_sizeLabel->setAlignment(Qt::AlignHCenter | Qt::AlignVCenter);
   layout->addWidget(m_sizeLabel);
   clearPicture();
+  connect(CoverThumbnailCache::instance(), &CoverThumbnailCache::thumbnailReady,
+          this, &PictureLabel::onThumbnailReady);
 }
 
 /**
@@ -92,6 +93,48 @@ void PictureLabel::clearPicture()
   const char* const msg = QT_TRANSLATE_NOOP("@default", "Drag album\nartwork\nhere");
   m_pictureLabel->setText(QCoreApplication::translate("@default", msg));
   m_sizeLabel->clear();
+  m_pixmapKey = 0;
+  m_pendingKey = 0;
+}
+
+/**
+ * Display a thumbnail.
+ *
+ * @param image thumbnail
+ * @param originalSize size of original picture
+ */
+void PictureLabel::setThumbnail(const QImage& image, const QSize& originalSize)
+{
+  m_pictureLabel->setContentsMargins(0, 0, 0, 0);
+  m_pictureLabel->setPixmap(QPixmap::fromImage(image));
+  m_sizeLabel->setText(QString::number(originalSize.width()) +
+                       QLatin1Char('x') +
+                       QString::number(originalSize.height()));
+}
+
+/**
+ * Called when a requested thumbnail has been decoded.
+ *
+ * @param key key of picture data
+ * @param size requested size
+ */
+void PictureLabel::onThumbnailReady(CoverThumbnailCache::Key key,
+                                    const QSize& size)
+{
+  if (key != m_pendingKey || size != m_pendingSize) {
+    // Not the picture of the current file.
+    return;
+  }
+  QSize originalSize;
+  QImage image = CoverThumbnailCache::instance()->find(key, size,
+                                                       &originalSize);
+  if (image.isNull()) {
+    clearPicture();
+    return;
+  }
+  setThumbnail(image, originalSize);
+  m_pixmapKey = key;
+  m_pendingKey = 0;
 }
 
 /**
@@ -102,28 +145,31 @@ void PictureLabel::clearPicture()
 void PictureLabel::setData(const QByteArray& data)
 {
   if (!data.isEmpty()) {
-    uint hash = qHash(data);
+    CoverThumbnailCache::Key key = CoverThumbnailCache::keyForData(data);
 #if QT_VERSION >= 0x050f00
-    if (!m_pictureLabel->pixmap(Qt::ReturnByValue).isNull() && hash == m_pixmapHash)
+    if (!m_pictureLabel->pixmap(Qt::ReturnByValue).isNull() && key == m_pixmapKey)
 #else
-    if (m_pictureLabel->pixmap() && hash == m_pixmapHash)
+    if (m_pictureLabel->pixmap() && key == m_pixmapKey)
 #endif
       return; // keep existing pixmap
 
-    // creating new pixmap
-    QPixmap pm;
-    if (pm.loadFromData(data)) {
-      int dimension = m_pictureLabel->width();
-      QPixmap scaledPm = pm.scaled(dimension, dimension, Qt::KeepAspectRatio);
-      if (!scaledPm.isNull()) {
-        m_pixmapHash = hash;
-        m_pictureLabel->setContentsMargins(0, 0, 0, 0);
-        m_pictureLabel->setPixmap(scaledPm);
-        m_sizeLabel->setText(QString::number(pm.width()) + QLatin1Char('x') +
-                             QString::number(pm.height()));
-        return;
-      }
+    const int dimension = m_pictureLabel->width();
+    const QSize size(dimension, dimension);
+    CoverThumbnailCache* cache = CoverThumbnailCache::instance();
+    QSize originalSize;
+    QImage image = cache->find(key, size, &originalSize);
+    if (!image.isNull()) {
+      setThumbnail(image, originalSize);
+      m_pixmapKey = key;
+      m_pendingKey = 0;
+      return;
     }
+
+    // Decode in the background, the old picture is displayed until the
+    // new one is ready to avoid flicker when scrolling through files.
+    m_pendingKey = cache->requestThumbnail(data, size);
+    m_pendingSize = size;
+    return;
   }
 
   clearPicture();
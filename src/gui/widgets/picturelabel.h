@@ -27,6 +27,7 @@
 #pragma once
 
 #include <QWidget>
+#include "coverthumbnailcache.h"
 
 class QByteArray;
 class QLabel;
@@ -61,7 +62,25 @@ private:
    */
   void clearPicture();
 
+  /**
+   * Display a thumbnail.
+   *
+   * @param image thumbnail
+   * @param originalSize size of original picture
+   */
+  void setThumbnail(const QImage& image, const QSize& originalSize);
+
+  /**
+   * Called when a requested thumbnail has been decoded.
+   *
+   * @param key key of picture data
+   * @param size requested size
+   */
+  void onThumbnailReady(CoverThumbnailCache::Key key, const QSize& size);
+
   QLabel* m_pictureLabel;
   QLabel* m_sizeLabel;
-  uint m_pixmapHash;
+  CoverThumbnailCache::Key m_pixmapKey;
+  CoverThumbnailCache::Key m_pendingKey;
+  QSize m_pendingSize;
 };
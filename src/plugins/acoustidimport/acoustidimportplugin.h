@@ -35,7 +35,8 @@
 class KID3_PLUGIN_EXPORT AcoustidImportPlugin
     : public QObject, public IServerTrackImporterFactory {
   Q_OBJECT
-  Q_PLUGIN_METADATA(IID "org.kde.kid3.IServerTrackImporterFactory")
+  Q_PLUGIN_METADATA(IID "org.kde.kid3.IServerTrackImporterFactory"
+                    FILE "acoustidimportplugin.json")
   Q_INTERFACES(IServerTrackImporterFactory)
 public:
   /*!
@@ -58,7 +58,7 @@ QStringList parseAcoustidIds(const QByteArray& bytes)
       startPos += 15;
       int endPos = bytes.indexOf(']', startPos);
       if (endPos > startPos) {
-        QRegularExpression idRe(QLatin1String("\"id\":\\s*\"([^\"]+)\""));
+        static const QRegularExpression idRe(QLatin1String("\"id\":\\s*\"([^\"]+)\""));
         QString recordings(QString::fromLatin1(bytes.mid(startPos,
                                                          endPos - startPos)));
         auto it = idRe.globalMatch(recordings);
@@ -148,7 +148,7 @@ void parseMusicBrainzMetadata(const QByteArray& bytes,
         QString date(releaseNode.namedItem(QLatin1String("date")).toElement()
                      .text());
         if (!date.isEmpty()) {
-          QRegularExpression dateRe(QLatin1String(R"(^(\d{4})(?:-\d{2})?(?:-\d{2})?$)"));
+          static const QRegularExpression dateRe(QLatin1String(R"(^(\d{4})(?:-\d{2})?(?:-\d{2})?$)"));
           auto match = dateRe.match(date);
           int year = 0;
           if (match.hasMatch()) {
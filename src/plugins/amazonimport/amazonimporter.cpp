@@ -108,7 +108,7 @@ void AmazonImporter::parseFindResults(const QByteArray& searchStr)
 (..)>by </span>(..)<a class="a-link-normal a-text-normal" href="/Amon-Amarth/e/B000APIBHO/ref=sr_ntt_srch_lnk_1?qid=1426338609&sr=1-1">Amon Amarth</a>
    */
   QString str = QString::fromUtf8(searchStr);
-  QRegularExpression catIdTitleRe(
+  static const QRegularExpression catIdTitleRe(
         QLatin1String(R"(href="[^"]+/(dp|ASIN|images|product|-)/([A-Z0-9]+))"
             R"([^"]+">.*<span[^>]*>([^<]+)</span>)"
             R"((?:[\s\n]*(?:</a>|</h2>|<div[^>]*>|<span[^>]*>))*by </span>)"
@@ -196,11 +196,11 @@ void AmazonImporter::parseAlbumResults(const QByteArray& albumStr)
   QString albumArtist;
   start = str.indexOf(QLatin1String(">Product details<"));
   if (start >= 0) {
-    QRegularExpression yearRe(
+    static const QRegularExpression yearRe(
           QLatin1String(R"(>Date First Available.*?)"
                         R"(<span>[^<]*(\d{4})[^<]*</span>)"),
           QRegularExpression::DotMatchesEverythingOption);
-    QRegularExpression labelRe(
+    static const QRegularExpression labelRe(
           QLatin1String(R"(>Manufacturer.*?<span>([^<]+)</span>)"),
           QRegularExpression::DotMatchesEverythingOption);
     QRegularExpressionMatch match;
@@ -219,7 +219,7 @@ void AmazonImporter::parseAlbumResults(const QByteArray& albumStr)
   ImportTrackDataVector trackDataVector(m_trackDataModel->getTrackData());
   trackDataVector.setCoverArtUrl(QUrl());
   if (getCoverArt()) {
-    QRegularExpression imgSrcRe(
+    static const QRegularExpression imgSrcRe(
           QLatin1String("id=\"imgTagWrapperId\"[^>]*>\\s*"
                         "<img[^>]*src=\"([^\"]+)\""),
           QRegularExpression::DotMatchesEverythingOption);
@@ -231,7 +231,7 @@ void AmazonImporter::parseAlbumResults(const QByteArray& albumStr)
 
   start = str.indexOf(QLatin1String("<h2>Track Listings</h2>"));
   if (start >= 0) {
-    QRegularExpression trackNumberTitleRe(
+    static const QRegularExpression trackNumberTitleRe(
           QLatin1String(R"(<td>(\d+)</td>\s*<td>([^<]+?)(?:\s*\[?(\d+):(\d+)\]?\s*)?</td>)"));
     FrameCollection frames(framesHdr);
     auto it = trackDataVector.begin();
@@ -47,17 +47,32 @@ namespace {
  */
 QString fixUpArtist(QString str)
 {
-  str.replace(QRegularExpression(QLatin1String(",(\\S)")), QLatin1String(", \\1"));
-  str.replace(QLatin1String("* / "), QLatin1String(" / "));
-  str.replace(QLatin1String("* - "), QLatin1String(" - "));
-  str.replace(QLatin1String("*,"), QLatin1String(","));
-  str.remove(QRegularExpression(QLatin1String("\\*$")));
-  str.remove(QRegularExpression(QLatin1String(R"([*\s]*\(\d+\)\(tracks:[^)]+\))")));
-  str.replace(QRegularExpression(
-    QLatin1String("[*\\s]*\\((?:\\d+|tracks:[^)]+)\\)(\\s*/\\s*,|\\s*&amp;|"
-                  "\\s*And|\\s*and)")),
-    QLatin1String("\\1"));
-  str.remove(QRegularExpression(QLatin1String(R"([*\s]*\((?:\d+|tracks:[^)]+)\)$)")));
+  static const QRegularExpression commaRe(QLatin1String(",(\\S)"));
+  static const QRegularExpression numberTracksRe(
+        QLatin1String(R"([*\s]*\(\d+\)\(tracks:[^)]+\))"));
+  static const QRegularExpression numberSeparatorRe(
+        QLatin1String("[*\\s]*\\((?:\\d+|tracks:[^)]+)\\)(\\s*/\\s*,|\\s*&amp;|"
+                      "\\s*And|\\s*and)"));
+  static const QRegularExpression numberEndRe(
+        QLatin1String(R"([*\s]*\((?:\d+|tracks:[^)]+)\)$)"));
+  // This is called for every artist and label, most of them do not contain
+  // the characters needed by the expressions, so these are checked first.
+  if (str.contains(QLatin1Char(','))) {
+    str.replace(commaRe, QLatin1String(", \\1"));
+  }
+  if (str.contains(QLatin1Char('*'))) {
+    str.replace(QLatin1String("* / "), QLatin1String(" / "));
+    str.replace(QLatin1String("* - "), QLatin1String(" - "));
+    str.replace(QLatin1String("*,"), QLatin1String(","));
+    if (str.endsWith(QLatin1Char('*'))) {
+      str.chop(1);
+    }
+  }
+  if (str.contains(QLatin1Char('('))) {
+    str.remove(numberTracksRe);
+    str.replace(numberSeparatorRe, QLatin1String("\\1"));
+    str.remove(numberEndRe);
+  }
   return ServerImporter::removeHtml(str);
 }
 
@@ -251,7 +266,7 @@ void addCredit(FrameCollection& frames, Frame::Type type, const QString& name)
  * @return image URL if present, else null.
  */
 QString extractUrlFromImageValue(const QJsonValue& imageValue) {
-  QRegularExpression sourceUrlRe(
+  static const QRegularExpression sourceUrlRe(
         QLatin1String("\"sourceUrl\"\\s*:\\s*\"([^\"]+)\""));
   QString ref = imageValue.toObject()
       .value(QLatin1String("fullsize")).toObject()
@@ -378,7 +393,7 @@ private:
 TrackInfo::TrackInfo(const QJsonObject& track)
   : m_pos(0), m_duration(0)
 {
-  QRegularExpression discTrackPosRe(QLatin1String("^(\\d+)-(\\d+)$"));
+  static const QRegularExpression discTrackPosRe(QLatin1String("^(\\d+)-(\\d+)$"));
   m_position = track.value(QLatin1String("position")).toString();
   bool ok;
   m_pos = m_position.toInt(&ok);
@@ -460,8 +475,8 @@ bool parseJsonAlbumResults(const QJsonObject& map,
   //   "released": "2003",
   //   "formats": [{"name": "CD"}]
   // }
-  QRegularExpression discTrackPosRe(QLatin1String("^(\\d+)-(\\d+)$"));
-  QRegularExpression yearRe(QLatin1String("^\\d{4}-\\d{2}"));
+  static const QRegularExpression discTrackPosRe(QLatin1String("^(\\d+)-(\\d+)$"));
+  static const QRegularExpression yearRe(QLatin1String("^\\d{4}-\\d{2}"));
   QList<ExtraArtist> trackExtraArtists;
   ImportTrackDataVector trackDataVector(trackDataModel->getTrackData());
   FrameCollection framesHdr;
@@ -783,14 +798,14 @@ void DiscogsImporter::HtmlImpl::parseFindResults(const QByteArray& searchStr)
   // <a href="/artist/256076-Amon-Amarth">Amon Amarth</a>         </span> -
   // <a class="search_result_title " href="/Amon-Amarth-The-Avenger/release/761529-Amon-Amarth-The-Avenger" data-followable="true">The Avenger</a>
   QString str = QString::fromUtf8(searchStr);
-  QRegularExpression idTitleRe(QLatin1String(
+  static const QRegularExpression idTitleRe(QLatin1String(
       "href=\"/artist/[^>]+?>([^<]+?)</a>[^-]*?-"
       "\\s*?<a class=\"search_result_title[ \"]+?href=\"/([^/]*?/?release)/"
       "([0-9]+-[^\"]+?)\"[^>]*?>([^<]+?)</a>(.*?card_actions)"),
        QRegularExpression::DotMatchesEverythingOption);
 
-  QRegularExpression yearRe(QLatin1String("<span class=\"card_release_year\">([^<]+)</span>"));
-  QRegularExpression formatRe(QLatin1String("<span class=\"card_release_format\">([^<]+)</span>"));
+  static const QRegularExpression yearRe(QLatin1String("<span class=\"card_release_year\">([^<]+)</span>"));
+  static const QRegularExpression formatRe(QLatin1String("<span class=\"card_release_format\">([^<]+)</span>"));
 
   albumListModel()->clear();
   auto it = idTitleRe.globalMatch(str);
@@ -828,8 +843,11 @@ void DiscogsImporter::HtmlImpl::parseAlbumResults(const QByteArray& albumStr)
     int jsonEnd = albumStr.indexOf("</script>", jsonStart);
     if (jsonEnd > jsonStart) {
       // We have JSON data inside the HTML output, if it is usable, we do not
-      // have to parse the HTML output.
-      auto doc = QJsonDocument::fromJson(albumStr.mid(jsonStart, jsonEnd - jsonStart));
+      // have to parse the HTML output. The JSON data can be several megabytes
+      // for large releases, so it is parsed in place instead of copying it.
+      auto doc = QJsonDocument::fromJson(
+            QByteArray::fromRawData(albumStr.constData() + jsonStart,
+                                    jsonEnd - jsonStart));
       if (!doc.isNull() && doc.isObject()) {
         const auto dataValue = doc.object().value(QLatin1String("data"));
         if (dataValue.isObject()) {
@@ -902,8 +920,8 @@ void DiscogsImporter::HtmlImpl::parseAlbumResults(const QByteArray& albumStr)
     }
   }
 
-  QRegularExpression nlSpaceRe(QLatin1String("[\r\n]+\\s*"));
-  QRegularExpression atDiscogsRe(QLatin1String("\\s*\\([^)]+\\) (?:at|-|\\|) Discogs\n?$"));
+  static const QRegularExpression nlSpaceRe(QLatin1String("[\r\n]+\\s*"));
+  static const QRegularExpression atDiscogsRe(QLatin1String("\\s*\\([^)]+\\) (?:at|-|\\|) Discogs\n?$"));
   QString str = QString::fromUtf8(albumStr);
   str.remove(QLatin1String(" data-rh=\"\"")).remove(QLatin1String("<!-- -->"))
      .replace(QLatin1Char(' ') + QChar(0x2013) + QLatin1Char(' '),
@@ -949,7 +967,7 @@ void DiscogsImporter::HtmlImpl::parseAlbumResults(const QByteArray& albumStr)
         yearStr.replace(nlSpaceRe, QLatin1String(""));
         yearStr = removeHtml(yearStr); // strip HTML tags and entities
         // this should skip day and month numbers
-        QRegularExpression yearRe(QLatin1String("(\\d{4})"));
+        static const QRegularExpression yearRe(QLatin1String("(\\d{4})"));
         auto match = yearRe.match(yearStr);
         if (match.hasMatch()) {
           framesHdr.setYear(match.captured(1).toInt());
@@ -969,6 +987,7 @@ void DiscogsImporter::HtmlImpl::parseAlbumResults(const QByteArray& albumStr)
      */
     // All genres found are checked for an ID3v1 number, starting with those
     // in the Style field.
+    static const QRegularExpression commaSpaceRe(QLatin1String(",\\s*"));
     QStringList genreList;
     static const char* const fields[] = { "Style:", "Genre:" };
     for (auto field : fields) {
@@ -984,7 +1003,7 @@ void DiscogsImporter::HtmlImpl::parseAlbumResults(const QByteArray& albumStr)
           genreStr.remove(QLatin1String("RockStyle:"));
           genreStr.remove(QLatin1String("PopStyle:"));
           if (genreStr.indexOf(QLatin1Char(',')) >= 0) {
-            genreList += genreStr.split(QRegularExpression(QLatin1String(",\\s*")));
+            genreList += genreStr.split(commaSpaceRe);
           } else {
             if (!genreStr.isEmpty()) {
               genreList += genreStr;
@@ -1028,7 +1047,7 @@ void DiscogsImporter::HtmlImpl::parseAlbumResults(const QByteArray& albumStr)
         // strip new lines and space after them
         labelStr.replace(nlSpaceRe, QLatin1String(""));
         labelStr = fixUpArtist(labelStr);
-        QRegularExpression catNoRe(QLatin1String(" \\s*(?:&lrm;)?- +(\\S[^,]*[^, ])"));
+        static const QRegularExpression catNoRe(QLatin1String(" \\s*(?:&lrm;)?- +(\\S[^,]*[^, ])"));
         auto match = catNoRe.match(labelStr);
         if (match.hasMatch()) {
           int catNoPos = match.capturedStart();
@@ -1154,20 +1173,20 @@ void DiscogsImporter::HtmlImpl::parseAlbumResults(const QByteArray& albumStr)
       str.replace(nlSpaceRe, QLatin1String(""));
 
       FrameCollection frames(framesHdr);
-      QRegularExpression posRe(QLatin1String(
+      static const QRegularExpression posRe(QLatin1String(
         R"(<td [^>]*class="trackPos[^"]*">(\d+)</td>)"));
-      QRegularExpression artistsRe(QLatin1String(
+      static const QRegularExpression artistsRe(QLatin1String(
         "class=\"trackArtist[^\"]*\">(?:<span[^>]*>)?"
         "<a href=\"/artist/[^>]+>([^<]+)</a>"));
-      QRegularExpression moreArtistsRe(QLatin1String(
+      static const QRegularExpression moreArtistsRe(QLatin1String(
         "^([^<>]+)<a href=\"/artist/[^>]+>([^<]+)</a>"));
-      QRegularExpression titleRe(QLatin1String(
+      static const QRegularExpression titleRe(QLatin1String(
         "<span class=\"trackTitle[^\"]*\"[^>]*>([^<]+)<"));
-      QRegularExpression durationRe(QLatin1String(
+      static const QRegularExpression durationRe(QLatin1String(
         "<td [^>]*class=\"duration[^\"]*\"[^>]*>(?:<meta[^>]*>)?"
         "(?:<span>)?(\\d+):(\\d+)</"));
-      QRegularExpression indexRe(QLatin1String("<td class=\"track_index\">([^<]+)$"));
-      QRegularExpression rowEndRe(QLatin1String(R"(</td>[\s\r\n]*</tr>)"));
+      static const QRegularExpression indexRe(QLatin1String("<td class=\"track_index\">([^<]+)$"));
+      static const QRegularExpression rowEndRe(QLatin1String(R"(</td>[\s\r\n]*</tr>)"));
       auto it = trackDataVector.begin();
       bool atTrackDataListEnd = (it == trackDataVector.end());
       int trackNr = 1;
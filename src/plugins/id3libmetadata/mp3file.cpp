@@ -45,6 +45,7 @@
 #include "id3libconfig.h"
 #include "genres.h"
 #include "attributedata.h"
+#include "tracer.h"
 
 #ifdef Q_OS_WIN32
 /**
@@ -128,6 +129,7 @@ int Mp3File::taggedFileFeatures() const
  */
 void Mp3File::readTags(bool force)
 {
+  TraceSpan span("readTags id3lib");
   bool priorIsTagInformationRead = isTagInformationRead();
   QByteArray fn = QFile::encodeName(currentFilePath());
 
@@ -173,6 +175,7 @@ void Mp3File::readTags(bool force)
  */
 bool Mp3File::writeTags(bool force, bool* renamed, bool preserve)
 {
+  TraceSpan span("writeTags id3lib");
   QString fnStr(currentFilePath());
   if (isChanged() && !QFileInfo(fnStr).isWritable()) {
     revertChangedFilename();
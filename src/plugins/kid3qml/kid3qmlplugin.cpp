@@ -48,6 +48,7 @@
 #include "dirrenamer.h"
 #include "filefilter.h"
 #include "batchimporter.h"
+#include "coverartexporter.h"
 #include "downloadclient.h"
 #include "config.h"
 #ifdef HAVE_QTMULTIMEDIA
@@ -75,6 +76,7 @@ Q_DECLARE_METATYPE(CheckableListModel*)
 Q_DECLARE_METATYPE(QItemSelectionModel*)
 Q_DECLARE_METATYPE(DirRenamer*)
 Q_DECLARE_METATYPE(BatchImporter*)
+Q_DECLARE_METATYPE(CoverArtExporter*)
 Q_DECLARE_METATYPE(DownloadClient*)
 Q_DECLARE_METATYPE(Kid3ApplicationTagContext*)
 #ifdef HAVE_QTMULTIMEDIA
@@ -200,6 +202,8 @@ void Kid3QmlPlugin::registerTypes(const char *uri)
           uri, 1, 0, "FileFilter", QLatin1String("Only enum container"));
     qmlRegisterUncreatableType<BatchImporter>(uri, 1, 0, "BatchImporter",
         QLatin1String("Retrieve it using app.batchImporter"));
+    qmlRegisterUncreatableType<CoverArtExporter>(uri, 1, 0, "CoverArtExporter",
+        QLatin1String("Retrieve it using app.coverArtExporter"));
     qmlRegisterUncreatableType<DownloadClient>(uri, 1, 0, "DownloadClient",
         QLatin1String("Retrieve it using app.downloadClient"));
     qmlRegisterUncreatableType<Kid3ApplicationTagContext>(uri, 1, 0,
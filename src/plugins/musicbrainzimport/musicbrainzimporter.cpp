@@ -25,7 +25,7 @@
  */
 
 #include "musicbrainzimporter.h"
-#include <QDomDocument>
+#include <QXmlStreamReader>
 #include <QUrl>
 #include <QRegularExpression>
 #include "serverimporterconfig.h"
@@ -79,60 +79,49 @@ ServerImporterConfig* MusicBrainzImporter::config() const {
 /** additional tags option, false if not used */
 bool MusicBrainzImporter::additionalTags() const { return true; }
 
+namespace {
+
 /**
- * Process finished findCddbAlbum request.
+ * Check the name of the current element of an XML stream.
  *
- * @param searchStr search data received
+ * @param xml XML stream reader
+ * @param name element name
+ *
+ * @return true if the current element has @a name.
  */
-void MusicBrainzImporter::parseFindResults(const QByteArray& searchStr)
+bool isElement(const QXmlStreamReader& xml, const char* name)
 {
-  /* simplified XML result:
-<metadata>
-  <release-list offset="0" count="3">
-    <release ext:score="100" id="978c7ed1-a854-4ef2-bd4e-e7c1317be854">
-      <title>Odin</title>
-      <artist-credit>
-        <name-credit>
-          <artist id="d1075cad-33e3-496b-91b0-d4670aabf4f8">
-            <name>Wizard</name>
-            <sort-name>Wizard</sort-name>
-          </artist>
-        </name-credit>
-      </artist-credit>
-    </release>
-  */
-  int start = searchStr.indexOf("<?xml");
-  int end = searchStr.indexOf("</metadata>");
-  QByteArray xmlStr = searchStr;
-  if (start >= 0 && end > start) {
-    xmlStr = xmlStr.mid(start, end + 11 - start);
-  }
-  QDomDocument doc;
-  if (doc.setContent(xmlStr, false)) {
-    m_albumListModel->clear();
-    QDomElement releaseList =
-      doc.namedItem(QLatin1String("metadata")).toElement()
-         .namedItem(QLatin1String("release-list")).toElement();
-    for (QDomNode releaseNode = releaseList.namedItem(QLatin1String("release"));
-         !releaseNode.isNull();
-         releaseNode = releaseNode.nextSibling()) {
-      QDomElement release = releaseNode.toElement();
-      QString id = release.attribute(QLatin1String("id"));
-      QString title = release.namedItem(QLatin1String("title")).toElement()
-          .text();
-      QDomElement artist = release.namedItem(QLatin1String("artist-credit"))
-          .toElement().namedItem(QLatin1String("name-credit")).toElement()
-          .namedItem(QLatin1String("artist")).toElement();
-      QString name = artist.namedItem(QLatin1String("name")).toElement().text();
-      m_albumListModel->appendItem(
-        name + QLatin1String(" - ") + title,
-        QLatin1String("release"),
-        id);
-    }
-  }
+  return xml.name() == QLatin1String(name);
 }
 
-namespace {
+/**
+ * Read the text of the current element including the text of its children.
+ *
+ * @param xml XML stream reader positioned at a start element
+ *
+ * @return text of element.
+ */
+QString readText(QXmlStreamReader& xml)
+{
+  return xml.readElementText(QXmlStreamReader::IncludeChildElements);
+}
+
+/**
+ * Get the XML document from a server response.
+ * The returned data references @a str and is only valid as long as @a str.
+ *
+ * @param str response received from server
+ *
+ * @return data from "<?xml" to "</metadata>", @a str if not found.
+ */
+QByteArray metadataXml(const QByteArray& str)
+{
+  int start = str.indexOf("<?xml");
+  int end = str.indexOf("</metadata>");
+  return start >= 0 && end > start
+      ? QByteArray::fromRawData(str.constData() + start, end + 11 - start)
+      : str;
+}
 
 /**
  * Uppercase the first characters of each word in a string.
@@ -182,61 +171,131 @@ void addInvolvedPeople(
 }
 
 /**
- * Set tags from an XML node with a relation list.
- *
- * @param relationList relation-list with target-type Artist
- * @param frames       tags will be added to these frames
+ * Credit from a relation-list with target-type artist.
+ */
+struct Credit {
+  Credit() : hasAttributeList(false) {}
+
+  QString type;          /**< relation type, e.g. "composer" */
+  QString attribute;     /**< first entry in attribute-list, e.g. instrument */
+  QString artist;        /**< name of artist */
+  bool hasAttributeList; /**< true if relation has an attribute-list */
+};
+
+/**
+ * Read credits from a relation-list.
  *
- * @return true if credits found.
+ * @param xml XML stream reader positioned at a relation-list with
+ * target-type artist
+ * @param credits the credits with an artist are appended to this list
  */
-bool parseCredits(const QDomElement& relationList, FrameCollection& frames)
+void readCredits(QXmlStreamReader& xml, QList<Credit>& credits)
 {
-  bool result = false;
-  QDomNode relation(relationList.firstChild());
-  while (!relation.isNull()) {
-    QString artist(relation.toElement().namedItem(QLatin1String("artist"))
-                           .toElement().namedItem(QLatin1String("name"))
-                           .toElement().text());
-    if (!artist.isEmpty()) {
-      QString type(relation.toElement().attribute(QLatin1String("type")));
-      if (type == QLatin1String("instrument")) {
-        QDomNode attributeList(relation.toElement()
-                               .namedItem(QLatin1String("attribute-list")));
-        if (!attributeList.isNull()) {
-          addInvolvedPeople(frames, Frame::FT_Performer,
-            attributeList.firstChild().toElement().text(), artist);
+  while (xml.readNextStartElement()) {
+    Credit credit;
+    credit.type = xml.attributes().value(QLatin1String("type")).toString();
+    while (xml.readNextStartElement()) {
+      if (isElement(xml, "artist")) {
+        while (xml.readNextStartElement()) {
+          if (isElement(xml, "name") && credit.artist.isNull()) {
+            credit.artist = readText(xml);
+          } else {
+            xml.skipCurrentElement();
+          }
+        }
+      } else if (isElement(xml, "attribute-list") &&
+                 !credit.hasAttributeList) {
+        credit.hasAttributeList = true;
+        if (xml.readNextStartElement()) {
+          credit.attribute = readText(xml);
+          xml.skipCurrentElement();
         }
-      } else if (type == QLatin1String("vocal")) {
-        addInvolvedPeople(frames, Frame::FT_Performer, type, artist);
       } else {
-        static const struct {
-          const char* credit;
-          Frame::Type type;
-        } creditToType[] = {
-          { "composer", Frame::FT_Composer },
-          { "conductor", Frame::FT_Conductor },
-          { "performing orchestra", Frame::FT_AlbumArtist },
-          { "lyricist", Frame::FT_Lyricist },
-          { "publisher", Frame::FT_Publisher },
-          { "remixer", Frame::FT_Remixer }
-        };
-        bool found = false;
-        for (const auto& c2t : creditToType) {
-          if (type == QString::fromLatin1(c2t.credit)) {
-            frames.setValue(c2t.type, artist);
-            found = true;
-            break;
+        xml.skipCurrentElement();
+      }
+    }
+    if (!credit.artist.isEmpty()) {
+      credits.append(credit);
+    }
+  }
+}
+
+/**
+ * Read credits from the first work of a relation-list.
+ *
+ * @param xml XML stream reader positioned at a relation-list with
+ * target-type work
+ * @param credits the credits of the work are appended to this list
+ */
+void readWorkCredits(QXmlStreamReader& xml, QList<Credit>& credits)
+{
+  bool relationRead = false;
+  while (xml.readNextStartElement()) {
+    if (isElement(xml, "relation") && !relationRead) {
+      relationRead = true;
+      while (xml.readNextStartElement()) {
+        if (isElement(xml, "work")) {
+          bool relationListRead = false;
+          while (xml.readNextStartElement()) {
+            if (isElement(xml, "relation-list") && !relationListRead) {
+              relationListRead = true;
+              readCredits(xml, credits);
+            } else {
+              xml.skipCurrentElement();
+            }
           }
+        } else {
+          xml.skipCurrentElement();
         }
-        if (!found && type != QLatin1String("tribute")) {
-          addInvolvedPeople(frames, Frame::FT_Arranger, type, artist);
+      }
+    } else {
+      xml.skipCurrentElement();
+    }
+  }
+}
+
+/**
+ * Set tags from credits.
+ *
+ * @param credits credits read with readCredits()
+ * @param frames  tags will be added to these frames
+ */
+void setCredits(const QList<Credit>& credits, FrameCollection& frames)
+{
+  for (const Credit& credit : credits) {
+    const QString& type = credit.type;
+    if (type == QLatin1String("instrument")) {
+      if (credit.hasAttributeList) {
+        addInvolvedPeople(frames, Frame::FT_Performer,
+                          credit.attribute, credit.artist);
+      }
+    } else if (type == QLatin1String("vocal")) {
+      addInvolvedPeople(frames, Frame::FT_Performer, type, credit.artist);
+    } else {
+      static const struct {
+        const char* credit;
+        Frame::Type type;
+      } creditToType[] = {
+        { "composer", Frame::FT_Composer },
+        { "conductor", Frame::FT_Conductor },
+        { "performing orchestra", Frame::FT_AlbumArtist },
+        { "lyricist", Frame::FT_Lyricist },
+        { "publisher", Frame::FT_Publisher },
+        { "remixer", Frame::FT_Remixer }
+      };
+      bool found = false;
+      for (const auto& c2t : creditToType) {
+        if (type == QString::fromLatin1(c2t.credit)) {
+          frames.setValue(c2t.type, credit.artist);
+          found = true;
+          break;
         }
       }
+      if (!found && type != QLatin1String("tribute")) {
+        addInvolvedPeople(frames, Frame::FT_Arranger, type, credit.artist);
+      }
     }
-    result = true;
-    relation = relation.nextSibling();
   }
-  return result;
 }
 
 /**
@@ -266,40 +325,374 @@ QString fixUpGenre(QString genre)
 }
 
 /**
- * Get genres from an XML node with a genre-list.
- * @param element XML node which could have a genre-list
- * @return genres separated by frame string list separator, null if not found.
+ * Read genres from a genre-list.
+ * @param xml XML stream reader positioned at a genre-list
+ * @return genres separated by frame string list separator.
  */
-QString parseGenres(const QDomElement& element)
+QString readGenres(QXmlStreamReader& xml)
 {
-  QDomNode genreList =
-      element.namedItem(QLatin1String("genre-list"));
-  if (!genreList.isNull()) {
-    QStringList genres, customGenres;
-    for (QDomNode genreNode = genreList.namedItem(QLatin1String("genre"));
-         !genreNode.isNull();
-         genreNode = genreNode.nextSibling()) {
-      if (!genreNode.isNull()) {
-        QString genre = fixUpGenre(genreNode.toElement()
-            .namedItem(QLatin1String("name")).toElement().text());
-        if (!genre.isEmpty()) {
-          int genreNum = Genres::getNumber(genre);
-          if (genreNum != 255) {
-            genres.append(QString::fromLatin1(Genres::getName(genreNum)));
+  QStringList genres, customGenres;
+  while (xml.readNextStartElement()) {
+    QString name;
+    while (xml.readNextStartElement()) {
+      if (isElement(xml, "name") && name.isNull()) {
+        name = readText(xml);
+      } else {
+        xml.skipCurrentElement();
+      }
+    }
+    QString genre = fixUpGenre(name);
+    if (!genre.isEmpty()) {
+      int genreNum = Genres::getNumber(genre);
+      if (genreNum != 255) {
+        genres.append(QString::fromLatin1(Genres::getName(genreNum)));
+      } else {
+        customGenres.append(genre);
+      }
+    }
+  }
+  genres.append(customGenres);
+  return genres.join(Frame::stringListSeparator());
+}
+
+/**
+ * Artist of the first name-credit in an artist-credit.
+ */
+struct ArtistCredit {
+  QString name;  /**< artist name */
+  QString genre; /**< genres of artist, null if not found */
+};
+
+/**
+ * Read the first artist from an artist-credit.
+ * @param xml XML stream reader positioned at an artist-credit
+ * @return artist.
+ */
+ArtistCredit readArtistCredit(QXmlStreamReader& xml)
+{
+  ArtistCredit credit;
+  bool nameCreditRead = false;
+  while (xml.readNextStartElement()) {
+    if (isElement(xml, "name-credit") && !nameCreditRead) {
+      nameCreditRead = true;
+      while (xml.readNextStartElement()) {
+        if (isElement(xml, "artist")) {
+          while (xml.readNextStartElement()) {
+            if (isElement(xml, "name")) {
+              credit.name = readText(xml);
+            } else if (isElement(xml, "genre-list")) {
+              credit.genre = readGenres(xml);
+            } else {
+              xml.skipCurrentElement();
+            }
+          }
+        } else {
+          xml.skipCurrentElement();
+        }
+      }
+    } else {
+      xml.skipCurrentElement();
+    }
+  }
+  return credit;
+}
+
+/**
+ * Read the cover art URL from a relation-list.
+ *
+ * @param xml XML stream reader positioned at a relation-list with
+ * target-type url
+ * @param coverArtUrl set to URL of last cover art relation if found
+ */
+void readCoverArtUrl(QXmlStreamReader& xml, QString& coverArtUrl)
+{
+  static const QRegularExpression amazonProductRe(
+        QLatin1String("https://www\\.amazon\\.[^/]+/gp/product/"));
+  while (xml.readNextStartElement()) {
+    if (isElement(xml, "relation")) {
+      const QString type =
+          xml.attributes().value(QLatin1String("type")).toString();
+      if (type == QLatin1String("cover art link") ||
+          type == QLatin1String("amazon asin")) {
+        QString url;
+        while (xml.readNextStartElement()) {
+          if (isElement(xml, "target") && url.isNull()) {
+            url = readText(xml);
           } else {
-            customGenres.append(genre);
+            xml.skipCurrentElement();
+          }
+        }
+        // https://www.amazon.de/gp/product/ does not work, fix such links.
+        url.replace(amazonProductRe,
+                    QLatin1String("http://images.amazon.com/images/P/"));
+        if (!url.endsWith(QLatin1String(".jpg"))) {
+          url += QLatin1String(".jpg");
+        }
+        coverArtUrl = url;
+        continue;
+      }
+    }
+    xml.skipCurrentElement();
+  }
+}
+
+/**
+ * Track read from the track-list of a medium.
+ */
+struct TrackRecord {
+  TrackRecord()
+    : discNr(0), trackNr(0), length(0), recordingLength(0),
+      hasRecording(false), hasRecordingLength(false) {}
+
+  QString title;           /**< title of recording */
+  QString artist;          /**< artist of recording */
+  QString artistGenre;     /**< genres of artist of recording */
+  QString genre;           /**< genres of recording */
+  QList<Credit> credits;   /**< credits of recording and its work */
+  int discNr;              /**< disc number */
+  int trackNr;             /**< track number */
+  int length;              /**< length of track in milliseconds */
+  int recordingLength;     /**< length of recording in milliseconds */
+  bool hasRecording;       /**< true if track has a recording */
+  bool hasRecordingLength; /**< true if recording has a valid length */
+};
+
+/**
+ * Read a recording.
+ * @param xml XML stream reader positioned at a recording
+ * @param track recording information is stored here
+ */
+void readRecording(QXmlStreamReader& xml, TrackRecord& track)
+{
+  track.hasRecording = true;
+  while (xml.readNextStartElement()) {
+    if (isElement(xml, "title")) {
+      track.title = readText(xml);
+    } else if (isElement(xml, "length")) {
+      track.recordingLength = readText(xml).toInt(&track.hasRecordingLength);
+    } else if (isElement(xml, "artist-credit")) {
+      ArtistCredit artist = readArtistCredit(xml);
+      track.artist = artist.name;
+      track.artistGenre = artist.genre;
+    } else if (isElement(xml, "genre-list")) {
+      track.genre = readGenres(xml);
+    } else if (isElement(xml, "relation-list")) {
+      const QString targetType =
+          xml.attributes().value(QLatin1String("target-type")).toString();
+      if (targetType == QLatin1String("artist")) {
+        readCredits(xml, track.credits);
+      } else if (targetType == QLatin1String("work")) {
+        readWorkCredits(xml, track.credits);
+      } else {
+        xml.skipCurrentElement();
+      }
+    } else {
+      xml.skipCurrentElement();
+    }
+  }
+}
+
+/**
+ * Release read from a MusicBrainz response.
+ * Only the data needed to set the tags is kept, so that large releases
+ * do not need the memory of a complete document tree.
+ */
+struct ReleaseRecord {
+  ReleaseRecord() : mediumCount(0) {}
+
+  QString title;               /**< title of release */
+  ArtistCredit artist;         /**< artist of release */
+  QString date;                /**< release date */
+  QString asin;                /**< Amazon Standard Identification Number */
+  QString label;               /**< name of first label */
+  QString catalogNumber;       /**< catalog number of first label */
+  QString country;             /**< release country */
+  QString coverArtUrl;         /**< URL from cover art relation */
+  QList<Credit> credits;       /**< credits of release */
+  QVector<TrackRecord> tracks; /**< tracks of all media */
+  int mediumCount;             /**< count attribute of medium-list */
+};
+
+/**
+ * Read the first label-info from a label-info-list.
+ * @param xml XML stream reader positioned at a label-info-list
+ * @param release label and catalog number are stored here
+ */
+void readLabelInfo(QXmlStreamReader& xml, ReleaseRecord& release)
+{
+  bool labelInfoRead = false;
+  while (xml.readNextStartElement()) {
+    if (isElement(xml, "label-info") && !labelInfoRead) {
+      labelInfoRead = true;
+      while (xml.readNextStartElement()) {
+        if (isElement(xml, "label")) {
+          while (xml.readNextStartElement()) {
+            if (isElement(xml, "name")) {
+              release.label = readText(xml);
+            } else {
+              xml.skipCurrentElement();
+            }
           }
+        } else if (isElement(xml, "catalog-number")) {
+          release.catalogNumber = readText(xml);
+        } else {
+          xml.skipCurrentElement();
         }
       }
+    } else {
+      xml.skipCurrentElement();
+    }
+  }
+}
+
+/**
+ * Read the tracks of all media in a medium-list.
+ * @param xml XML stream reader positioned at a medium-list
+ * @param release tracks are appended to this release
+ */
+void readMediumList(QXmlStreamReader& xml, ReleaseRecord& release)
+{
+  release.mediumCount =
+      xml.attributes().value(QLatin1String("count")).toString().toInt();
+  int discNr = 1, trackNr = 1;
+  while (xml.readNextStartElement()) {
+    const int firstTrackIndex = release.tracks.size();
+    while (xml.readNextStartElement()) {
+      if (isElement(xml, "position")) {
+        bool ok;
+        int position = readText(xml).toInt(&ok);
+        if (ok) {
+          discNr = position;
+        }
+      } else if (isElement(xml, "track-list")) {
+        while (xml.readNextStartElement()) {
+          TrackRecord track;
+          bool hasPosition = false;
+          int position = 0;
+          while (xml.readNextStartElement()) {
+            if (isElement(xml, "position")) {
+              position = readText(xml).toInt(&hasPosition);
+            } else if (isElement(xml, "length")) {
+              track.length = readText(xml).toInt();
+            } else if (isElement(xml, "recording") && !track.hasRecording) {
+              readRecording(xml, track);
+            } else {
+              xml.skipCurrentElement();
+            }
+          }
+          if (hasPosition) {
+            trackNr = position;
+          }
+          track.trackNr = trackNr++;
+          release.tracks.append(track);
+        }
+      } else {
+        xml.skipCurrentElement();
+      }
+    }
+    // The position of the medium is set when all its tracks are known.
+    for (int i = firstTrackIndex; i < release.tracks.size(); ++i) {
+      release.tracks[i].discNr = discNr;
+    }
+    ++discNr;
+  }
+}
+
+/**
+ * Read a release.
+ * @param xml XML stream reader positioned at a release
+ * @param release release data is stored here
+ */
+void readRelease(QXmlStreamReader& xml, ReleaseRecord& release)
+{
+  while (xml.readNextStartElement()) {
+    if (isElement(xml, "title")) {
+      release.title = readText(xml);
+    } else if (isElement(xml, "artist-credit")) {
+      release.artist = readArtistCredit(xml);
+    } else if (isElement(xml, "date")) {
+      release.date = readText(xml);
+    } else if (isElement(xml, "asin")) {
+      release.asin = readText(xml);
+    } else if (isElement(xml, "country")) {
+      release.country = readText(xml);
+    } else if (isElement(xml, "label-info-list")) {
+      readLabelInfo(xml, release);
+    } else if (isElement(xml, "medium-list")) {
+      readMediumList(xml, release);
+    } else if (isElement(xml, "relation-list")) {
+      const QString targetType =
+          xml.attributes().value(QLatin1String("target-type")).toString();
+      if (targetType == QLatin1String("artist")) {
+        readCredits(xml, release.credits);
+      } else if (targetType == QLatin1String("url")) {
+        readCoverArtUrl(xml, release.coverArtUrl);
+      } else {
+        xml.skipCurrentElement();
+      }
+    } else {
+      xml.skipCurrentElement();
     }
-    genres.append(customGenres);
-    return genres.join(Frame::stringListSeparator());
   }
-  return QString();
 }
 
 }
 
+/**
+ * Process finished findCddbAlbum request.
+ *
+ * @param searchStr search data received
+ */
+void MusicBrainzImporter::parseFindResults(const QByteArray& searchStr)
+{
+  /* simplified XML result:
+<metadata>
+  <release-list offset="0" count="3">
+    <release ext:score="100" id="978c7ed1-a854-4ef2-bd4e-e7c1317be854">
+      <title>Odin</title>
+      <artist-credit>
+        <name-credit>
+          <artist id="d1075cad-33e3-496b-91b0-d4670aabf4f8">
+            <name>Wizard</name>
+            <sort-name>Wizard</sort-name>
+          </artist>
+        </name-credit>
+      </artist-credit>
+    </release>
+  */
+  QStringList texts, ids;
+  QXmlStreamReader xml(metadataXml(searchStr));
+  if (xml.readNextStartElement() && isElement(xml, "metadata")) {
+    while (xml.readNextStartElement()) {
+      if (isElement(xml, "release-list")) {
+        while (xml.readNextStartElement()) {
+          ids.append(xml.attributes().value(QLatin1String("id")).toString());
+          QString title, name;
+          while (xml.readNextStartElement()) {
+            if (isElement(xml, "title")) {
+              title = readText(xml);
+            } else if (isElement(xml, "artist-credit")) {
+              name = readArtistCredit(xml).name;
+            } else {
+              xml.skipCurrentElement();
+            }
+          }
+          texts.append(name + QLatin1String(" - ") + title);
+        }
+      } else {
+        xml.skipCurrentElement();
+      }
+    }
+  }
+  if (!xml.hasError()) {
+    m_albumListModel->clear();
+    for (int i = 0; i < texts.size(); ++i) {
+      m_albumListModel->appendItem(texts.at(i), QLatin1String("release"),
+                                   ids.at(i));
+    }
+  }
+}
+
 /**
  * Parse result of album request and populate m_trackDataModel with results.
  *
@@ -332,274 +725,153 @@ void MusicBrainzImporter::parseAlbumResults(const QByteArray& albumStr)
               <length>319173</length>
             </recording>
   */
-  int start = albumStr.indexOf("<?xml");
-  int end = albumStr.indexOf("</metadata>");
-  QByteArray xmlStr = start >= 0 && end > start ?
-    albumStr.mid(start, end + 11 - start) : albumStr;
-  QDomDocument doc;
-  if (doc.setContent(xmlStr, false)) {
-    QDomElement release =
-      doc.namedItem(QLatin1String("metadata")).toElement()
-         .namedItem(QLatin1String("release")).toElement();
-    FrameCollection framesHdr;
-    const bool standardTags = getStandardTags();
-    if (standardTags) {
-      framesHdr.setAlbum(release.namedItem(QLatin1String("title")).toElement()
-                         .text());
-      QDomElement artist = release.namedItem(QLatin1String("artist-credit"))
-          .toElement().namedItem(QLatin1String("name-credit"))
-          .toElement().namedItem(QLatin1String("artist"))
-          .toElement();
-      framesHdr.setArtist(artist.namedItem(QLatin1String("name"))
-                          .toElement().text());
-      QString genre = parseGenres(artist);
-      if (!genre.isEmpty()) {
-        framesHdr.setGenre(genre);
-      }
-      QString date(release.namedItem(QLatin1String("date")).toElement().text());
-      if (!date.isEmpty()) {
-        QRegularExpression dateRe(QLatin1String(R"(^(\d{4})(?:-\d{2})?(?:-\d{2})?$)"));
-        int year = 0;
-        auto match = dateRe.match(date);
-        if (match.hasMatch()) {
-          year = match.captured(1).toInt();
-        } else {
-          year = date.toInt();
-        }
-        if (year != 0) {
-          framesHdr.setYear(year);
-        }
+  // The response is read with a stream reader into a compact release
+  // record instead of building a DOM tree, which needs several times the
+  // size of the response for releases with hundreds of tracks. The tags are
+  // set after reading because release relations follow the medium-list.
+  ReleaseRecord release;
+  QXmlStreamReader xml(metadataXml(albumStr));
+  if (xml.readNextStartElement() && isElement(xml, "metadata")) {
+    bool releaseRead = false;
+    while (xml.readNextStartElement()) {
+      if (isElement(xml, "release") && !releaseRead) {
+        releaseRead = true;
+        readRelease(xml, release);
+      } else {
+        xml.skipCurrentElement();
       }
     }
+  }
+  if (xml.hasError()) {
+    return;
+  }
 
-    ImportTrackDataVector trackDataVector(m_trackDataModel->getTrackData());
-    trackDataVector.setCoverArtUrl(QUrl());
-    const bool coverArt = getCoverArt();
-    if (coverArt) {
-      QString asin(release.namedItem(QLatin1String("asin")).toElement().text());
-      if (!asin.isEmpty()) {
-        trackDataVector.setCoverArtUrl(
-          QUrl(QLatin1String("http://www.amazon.com/dp/") + asin));
-      }
+  FrameCollection framesHdr;
+  const bool standardTags = getStandardTags();
+  if (standardTags) {
+    framesHdr.setAlbum(release.title);
+    framesHdr.setArtist(release.artist.name);
+    if (!release.artist.genre.isEmpty()) {
+      framesHdr.setGenre(release.artist.genre);
     }
-
-    const bool additionalTags = getAdditionalTags();
-    if (additionalTags) {
-      // label can be found in the label-info-list
-      QDomElement labelInfoList(
-            release.namedItem(QLatin1String("label-info-list")).toElement());
-      if (!labelInfoList.isNull()) {
-        QDomElement labelInfo(
-              labelInfoList.namedItem(QLatin1String("label-info")).toElement());
-        if (!labelInfo.isNull()) {
-          QString label(labelInfo.namedItem(QLatin1String("label"))
-                        .namedItem(QLatin1String("name")).toElement().text());
-          if (!label.isEmpty()) {
-            framesHdr.setValue(Frame::FT_Publisher, label);
-          }
-          QString catNo(labelInfo.namedItem(QLatin1String("catalog-number"))
-                        .toElement().text());
-          if (!catNo.isEmpty()) {
-            framesHdr.setValue(Frame::FT_CatalogNumber, catNo);
-          }
-        }
+    if (!release.date.isEmpty()) {
+      static const QRegularExpression dateRe(
+            QLatin1String(R"(^(\d{4})(?:-\d{2})?(?:-\d{2})?$)"));
+      int year = 0;
+      auto match = dateRe.match(release.date);
+      if (match.hasMatch()) {
+        year = match.captured(1).toInt();
+      } else {
+        year = release.date.toInt();
       }
-      // Release country can be found in "country"
-      QString country(release.namedItem(QLatin1String("country")).toElement()
-                      .text());
-      if (!country.isEmpty()) {
-        framesHdr.setValue(Frame::FT_ReleaseCountry, country);
+      if (year != 0) {
+        framesHdr.setYear(year);
       }
     }
+  }
 
-    if (additionalTags || coverArt) {
-      QDomNode relationListNode(release.firstChild());
-      while (!relationListNode.isNull()) {
-        if (relationListNode.nodeName() == QLatin1String("relation-list")) {
-          QDomElement relationList(relationListNode.toElement());
-          if (!relationList.isNull()) {
-            QString targetType(relationList.attribute(QLatin1String("target-type")));
-            if (targetType == QLatin1String("artist")) {
-              if (additionalTags) {
-                parseCredits(relationList, framesHdr);
-              }
-            } else if (targetType == QLatin1String("url")) {
-              if (coverArt) {
-                QDomNode relationNode(relationList.firstChild());
-                while (!relationNode.isNull()) {
-                  if (relationNode.nodeName() == QLatin1String("relation")) {
-                    QDomElement relation(relationNode.toElement());
-                    if (!relation.isNull()) {
-                      QString type(relation.attribute(QLatin1String("type")));
-                      if (type == QLatin1String("cover art link") ||
-                          type == QLatin1String("amazon asin")) {
-                        QString coverArtUrl =
-                            relation.namedItem(QLatin1String("target"))
-                            .toElement().text();
-                        // https://www.amazon.de/gp/product/ does not work,
-                        // fix such links.
-                        coverArtUrl.replace(
-                            QRegularExpression(QLatin1String(
-                                  "https://www\\.amazon\\.[^/]+/gp/product/")),
-                            QLatin1String("http://images.amazon.com/images/P/"));
-                        if (!coverArtUrl.endsWith(QLatin1String(".jpg"))) {
-                          coverArtUrl += QLatin1String(".jpg");
-                        }
-                        trackDataVector.setCoverArtUrl(
-                          QUrl(coverArtUrl));
-                      }
-                    }
-                  }
-                  relationNode = relationNode.nextSibling();
-                }
-              }
-            }
-          }
-        }
-        relationListNode = relationListNode.nextSibling();
-      }
+  ImportTrackDataVector trackDataVector(m_trackDataModel->getTrackData());
+  trackDataVector.setCoverArtUrl(QUrl());
+  const bool coverArt = getCoverArt();
+  if (coverArt) {
+    if (!release.asin.isEmpty()) {
+      trackDataVector.setCoverArtUrl(
+        QUrl(QLatin1String("http://www.amazon.com/dp/") + release.asin));
+    }
+    if (!release.coverArtUrl.isEmpty()) {
+      trackDataVector.setCoverArtUrl(QUrl(release.coverArtUrl));
     }
+  }
 
-    auto it = trackDataVector.begin();
-    bool atTrackDataListEnd = (it == trackDataVector.end());
-    int discNr = 1, trackNr = 1;
-    bool ok;
-    FrameCollection frames(framesHdr);
-    QDomElement mediumList = release.namedItem(QLatin1String("medium-list"))
-        .toElement();
-    int mediumCount = mediumList.attribute(QLatin1String("count")).toInt();
-    for (QDomNode mediumNode = mediumList.namedItem(QLatin1String("medium"));
-         !mediumNode.isNull();
-         mediumNode = mediumNode.nextSibling()) {
-      int position = mediumNode.namedItem(QLatin1String("position"))
-          .toElement().text().toInt(&ok);
-      if (ok) {
-        discNr = position;
+  const bool additionalTags = getAdditionalTags();
+  if (additionalTags) {
+    if (!release.label.isEmpty()) {
+      framesHdr.setValue(Frame::FT_Publisher, release.label);
+    }
+    if (!release.catalogNumber.isEmpty()) {
+      framesHdr.setValue(Frame::FT_CatalogNumber, release.catalogNumber);
+    }
+    if (!release.country.isEmpty()) {
+      framesHdr.setValue(Frame::FT_ReleaseCountry, release.country);
+    }
+    setCredits(release.credits, framesHdr);
+  }
+
+  auto it = trackDataVector.begin();
+  bool atTrackDataListEnd = (it == trackDataVector.end());
+  FrameCollection frames(framesHdr);
+  for (const TrackRecord& track : qAsConst(release.tracks)) {
+    if (release.mediumCount > 1 && additionalTags) {
+      frames.setValue(Frame::FT_Disc, QString::number(track.discNr));
+    }
+    if (standardTags) {
+      frames.setTrack(track.trackNr);
+    }
+    int duration = track.length;
+    if (track.hasRecording) {
+      if (standardTags) {
+        frames.setTitle(track.title);
       }
-      QDomElement trackList = mediumNode.namedItem(QLatin1String("track-list"))
-          .toElement();
-      for (QDomNode trackNode = trackList.namedItem(QLatin1String("track"));
-           !trackNode.isNull();
-           trackNode = trackNode.nextSibling()) {
-        if (mediumCount > 1 && additionalTags) {
-          frames.setValue(Frame::FT_Disc, QString::number(discNr));
-        }
-        QDomElement track = trackNode.toElement();
-        position = track.namedItem(QLatin1String("position")).toElement()
-            .text().toInt(&ok);
-        if (ok) {
-          trackNr = position;
-        }
+      if (track.hasRecordingLength) {
+        duration = track.recordingLength;
+      }
+      if (!track.artist.isEmpty()) {
+        // use the artist in the header as the album artist
+        // and the artist in the track as the artist
         if (standardTags) {
-          frames.setTrack(trackNr);
-        }
-        int duration = track.namedItem(QLatin1String("length")).toElement()
-            .text().toInt();
-        QDomElement recording = track.namedItem(QLatin1String("recording"))
-            .toElement();
-        if (!recording.isNull()) {
-          if (standardTags) {
-            frames.setTitle(recording.namedItem(QLatin1String("title"))
-                            .toElement().text());
-          }
-          int length = recording.namedItem(QLatin1String("length"))
-              .toElement().text().toInt(&ok);
-          if (ok) {
-            duration = length;
-          }
-          QDomNode artistNode =
-              recording.namedItem(QLatin1String("artist-credit"));
-          if (!artistNode.isNull()) {
-            QDomElement artistElement = artistNode.toElement()
-                .namedItem(QLatin1String("name-credit")).toElement()
-                .namedItem(QLatin1String("artist")).toElement();
-            QString artist = artistElement
-                .namedItem(QLatin1String("name")).toElement().text();
-            if (!artist.isEmpty()) {
-              // use the artist in the header as the album artist
-              // and the artist in the track as the artist
-              if (standardTags) {
-                frames.setArtist(artist);
-              }
-              if (additionalTags) {
-                frames.setValue(Frame::FT_AlbumArtist, framesHdr.getArtist());
-              }
-            }
-            QString genre = parseGenres(artistElement);
-            if (!genre.isEmpty()) {
-              frames.setGenre(genre);
-            }
-          }
-          QString genre = parseGenres(recording);
-          if (!genre.isEmpty()) {
-            frames.setGenre(genre);
-          }
-          if (additionalTags) {
-            QDomNode relationListNode(recording.firstChild());
-            while (!relationListNode.isNull()) {
-              if (relationListNode.nodeName() == QLatin1String("relation-list")) {
-                QDomElement relationList(relationListNode.toElement());
-                if (!relationList.isNull()) {
-                  QString targetType(
-                        relationList.attribute(QLatin1String("target-type")));
-                  if (targetType == QLatin1String("artist")) {
-                    parseCredits(relationList, frames);
-                  } else if (targetType == QLatin1String("work")) {
-                    QDomNode workRelationListNode(relationList
-                          .namedItem(QLatin1String("relation"))
-                          .namedItem(QLatin1String("work"))
-                          .namedItem(QLatin1String("relation-list")));
-                    if (!workRelationListNode.isNull()) {
-                      parseCredits(workRelationListNode.toElement(), frames);
-                    }
-                  }
-                }
-              }
-              relationListNode = relationListNode.nextSibling();
-            }
-          }
+          frames.setArtist(track.artist);
         }
-        duration /= 1000;
-        if (atTrackDataListEnd) {
-          ImportTrackData trackData;
-          trackData.setFrameCollection(frames);
-          trackData.setImportDuration(duration);
-          trackDataVector.push_back(trackData);
-        } else {
-          while (!atTrackDataListEnd && !it->isEnabled()) {
-            ++it;
-            atTrackDataListEnd = (it == trackDataVector.end());
-          }
-          if (!atTrackDataListEnd) {
-            (*it).setFrameCollection(frames);
-            (*it).setImportDuration(duration);
-            ++it;
-            atTrackDataListEnd = (it == trackDataVector.end());
-          }
+        if (additionalTags) {
+          frames.setValue(Frame::FT_AlbumArtist, framesHdr.getArtist());
         }
-        ++trackNr;
-        frames = framesHdr;
       }
-      ++discNr;
-    }
-    // handle redundant tracks
-    frames.clear();
-    while (!atTrackDataListEnd) {
-      if (it->isEnabled()) {
-        if ((*it).getFileDuration() == 0) {
-          it = trackDataVector.erase(it);
-        } else {
-          (*it).setFrameCollection(frames);
-          (*it).setImportDuration(0);
-          ++it;
-        }
+      if (!track.artistGenre.isEmpty()) {
+        frames.setGenre(track.artistGenre);
+      }
+      if (!track.genre.isEmpty()) {
+        frames.setGenre(track.genre);
+      }
+      if (additionalTags) {
+        setCredits(track.credits, frames);
+      }
+    }
+    duration /= 1000;
+    if (atTrackDataListEnd) {
+      ImportTrackData trackData;
+      trackData.setFrameCollection(frames);
+      trackData.setImportDuration(duration);
+      trackDataVector.push_back(trackData);
+    } else {
+      while (!atTrackDataListEnd && !it->isEnabled()) {
+        ++it;
+        atTrackDataListEnd = (it == trackDataVector.end());
+      }
+      if (!atTrackDataListEnd) {
+        (*it).setFrameCollection(frames);
+        (*it).setImportDuration(duration);
+        ++it;
+        atTrackDataListEnd = (it == trackDataVector.end());
+      }
+    }
+    frames = framesHdr;
+  }
+  // handle redundant tracks
+  frames.clear();
+  while (!atTrackDataListEnd) {
+    if (it->isEnabled()) {
+      if ((*it).getFileDuration() == 0) {
+        it = trackDataVector.erase(it);
       } else {
+        (*it).setFrameCollection(frames);
+        (*it).setImportDuration(0);
         ++it;
       }
-      atTrackDataListEnd = (it == trackDataVector.end());
+    } else {
+      ++it;
     }
-    m_trackDataModel->setTrackData(trackDataVector);
+    atTrackDataListEnd = (it == trackDataVector.end());
   }
+  m_trackDataModel->setTrackData(trackDataVector);
 }
 
 /**
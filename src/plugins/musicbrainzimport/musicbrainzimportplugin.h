@@ -35,7 +35,8 @@
 class KID3_PLUGIN_EXPORT MusicBrainzImportPlugin
     : public QObject, public IServerImporterFactory {
   Q_OBJECT
-  Q_PLUGIN_METADATA(IID "org.kde.kid3.IServerImporterFactory")
+  Q_PLUGIN_METADATA(IID "org.kde.kid3.IServerImporterFactory"
+                    FILE "musicbrainzimportplugin.json")
   Q_INTERFACES(IServerImporterFactory)
 public:
   /*!
@@ -0,0 +1,42 @@
+/**
+ * \file offlinemirrorconfig.cpp
+ * Offline mirror configuration.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "offlinemirrorconfig.h"
+
+int OfflineMirrorConfig::s_index = -1;
+
+/**
+ * Constructor.
+ * Set default configuration.
+ *
+ * @param grp configuration group
+ */
+OfflineMirrorConfig::OfflineMirrorConfig(const QString& grp)
+  : StoredConfig<OfflineMirrorConfig, ServerImporterConfig>(grp)
+{
+  setCgiPathUsed(false);
+  setAdditionalTagsUsed(true);
+}
@@ -0,0 +1,58 @@
+/**
+ * \file offlinemirrorconfig.h
+ * Offline mirror configuration.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "serverimporterconfig.h"
+
+/**
+ * Offline mirror configuration.
+ * The server is the path to the folder containing the dump files.
+ */
+class OfflineMirrorConfig
+    : public StoredConfig<OfflineMirrorConfig, ServerImporterConfig> {
+public:
+  /**
+   * Constructor.
+   * Set default configuration.
+   *
+   * @param grp configuration group
+   */
+  explicit OfflineMirrorConfig(
+      const QString& grp = QLatin1String("OfflineMirror"));
+
+  /**
+   * Destructor.
+   */
+  virtual ~OfflineMirrorConfig() override = default;
+
+private:
+  friend OfflineMirrorConfig&
+  StoredConfig<OfflineMirrorConfig, ServerImporterConfig>::instance();
+
+  /** Index in configuration storage */
+  static int s_index;
+};
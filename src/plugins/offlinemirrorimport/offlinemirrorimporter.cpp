@@ -0,0 +1,340 @@
+/**
+ * \file offlinemirrorimporter.cpp
+ * Importer using a local mirror of metadata dumps.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "offlinemirrorimporter.h"
+#include <QRunnable>
+#include <QDataStream>
+#include "trackdatamodel.h"
+#include "offlinemirrorconfig.h"
+
+namespace {
+
+/** Maximum number of albums returned by a find query. */
+const int MAX_FIND_RESULTS = 200;
+
+}
+
+/**
+ * Job checking if the index is up to date and rebuilding it if necessary.
+ */
+class OfflineMirrorImporter::IndexUpdateJob : public QRunnable {
+public:
+  IndexUpdateJob(OfflineMirrorImporter* importer, const QString& dirPath)
+    : m_importer(importer), m_dirPath(dirPath) {
+  }
+
+  virtual void run() override {
+    QByteArray signature;
+    const QStringList dumpFiles =
+        OfflineMirrorIndex::findDumpFiles(m_dirPath, &signature);
+    const QString indexPath =
+        OfflineMirrorIndex::indexPathForDirectory(m_dirPath);
+    bool ok = !dumpFiles.isEmpty() &&
+        (OfflineMirrorIndex::readSignature(indexPath) == signature ||
+         OfflineMirrorIndex::build(dumpFiles, signature, indexPath));
+    QMetaObject::invokeMethod(m_importer, "onIndexUpdated",
+                              Qt::QueuedConnection,
+                              Q_ARG(QString, m_dirPath), Q_ARG(bool, ok));
+  }
+
+private:
+  OfflineMirrorImporter* const m_importer;
+  const QString m_dirPath;
+};
+
+/**
+ * Constructor.
+ *
+ * @param netMgr network access manager
+ * @param trackDataModel track data to be filled with imported values
+ */
+OfflineMirrorImporter::OfflineMirrorImporter(QNetworkAccessManager* netMgr,
+                                             TrackDataModel* trackDataModel)
+  : ServerImporter(netMgr, trackDataModel), m_findRequested(false)
+{
+  setObjectName(QLatin1String("OfflineMirrorImporter"));
+  // Jobs are serialized, so that the index is only built once.
+  m_threadPool.setMaxThreadCount(1);
+}
+
+/**
+ * Destructor.
+ * Waits until the index is built.
+ */
+OfflineMirrorImporter::~OfflineMirrorImporter()
+{
+  m_threadPool.waitForDone();
+}
+
+/**
+ * Name of import source.
+ * @return name.
+ */
+const char* OfflineMirrorImporter::name() const {
+  return QT_TRANSLATE_NOOP("@default", "Offline Mirror");
+}
+
+/** default server, 0 to disable */
+const char* OfflineMirrorImporter::defaultServer() const { return ""; }
+
+/** anchor to online help, 0 to disable */
+const char* OfflineMirrorImporter::helpAnchor() const {
+  return "import-offline-mirror";
+}
+
+/** configuration, 0 if not used */
+ServerImporterConfig* OfflineMirrorImporter::config() const {
+  return &OfflineMirrorConfig::instance();
+}
+
+/** additional tags option, false if not used */
+bool OfflineMirrorImporter::additionalTags() const { return true; }
+
+/**
+ * Parse result of find request and populate m_albumListModel with results.
+ *
+ * @param searchStr search data received
+ */
+void OfflineMirrorImporter::parseFindResults(const QByteArray& searchStr)
+{
+  m_albumListModel->clear();
+  QDataStream stream(searchStr);
+  quint32 numResults = 0;
+  stream >> numResults;
+  for (quint32 i = 0; i < numResults && stream.status() == QDataStream::Ok;
+       ++i) {
+    QString text, category, id;
+    stream >> text >> category >> id;
+    m_albumListModel->appendItem(text, category, id);
+  }
+}
+
+/**
+ * Parse result of album request and populate m_trackDataModel with results.
+ *
+ * @param albumStr album data received
+ */
+void OfflineMirrorImporter::parseAlbumResults(const QByteArray& albumStr)
+{
+  OfflineMirrorIndex::Release release;
+  if (!OfflineMirrorIndex::parseReleaseData(albumStr, release))
+    return;
+
+  const bool standardTags = getStandardTags();
+  const bool additionalTags = getAdditionalTags();
+  FrameCollection framesHdr;
+  if (standardTags) {
+    framesHdr.setArtist(release.artist);
+    framesHdr.setAlbum(release.album);
+    framesHdr.setYear(release.date.left(4).toInt());
+    if (!release.genre.isEmpty()) {
+      framesHdr.setGenre(release.genre);
+    }
+  }
+  if (additionalTags) {
+    if (!release.label.isEmpty()) {
+      framesHdr.setValue(Frame::FT_Publisher, release.label);
+    }
+    if (!release.catalogNumber.isEmpty()) {
+      framesHdr.setValue(Frame::FT_CatalogNumber, release.catalogNumber);
+    }
+  }
+  const bool multipleMedia = !release.tracks.isEmpty() &&
+      release.tracks.first().medium != release.tracks.last().medium;
+
+  ImportTrackDataVector trackDataVector(m_trackDataModel->getTrackData());
+  trackDataVector.setCoverArtUrl(QUrl());
+  auto it = trackDataVector.begin();
+  bool atTrackDataListEnd = (it == trackDataVector.end());
+  FrameCollection frames(framesHdr);
+  for (const OfflineMirrorIndex::Track& track : qAsConst(release.tracks)) {
+    if (standardTags) {
+      frames.setTrack(track.position);
+      frames.setTitle(track.title);
+      if (!track.artist.isEmpty()) {
+        frames.setArtist(track.artist);
+      }
+    }
+    if (additionalTags) {
+      if (!track.artist.isEmpty()) {
+        frames.setValue(Frame::FT_AlbumArtist, release.artist);
+      }
+      if (multipleMedia) {
+        frames.setValue(Frame::FT_Disc, QString::number(track.medium));
+      }
+      if (!track.isrcs.isEmpty()) {
+        frames.setValue(Frame::FT_Isrc, track.isrcs.first());
+      }
+    }
+    const int duration = static_cast<int>(track.duration);
+    if (atTrackDataListEnd) {
+      ImportTrackData trackData;
+      trackData.setFrameCollection(frames);
+      trackData.setImportDuration(duration);
+      trackDataVector.push_back(trackData);
+    } else {
+      while (!atTrackDataListEnd && !it->isEnabled()) {
+        ++it;
+        atTrackDataListEnd = (it == trackDataVector.end());
+      }
+      if (!atTrackDataListEnd) {
+        (*it).setFrameCollection(frames);
+        (*it).setImportDuration(duration);
+        ++it;
+        atTrackDataListEnd = (it == trackDataVector.end());
+      }
+    }
+    frames = framesHdr;
+  }
+  // handle redundant tracks
+  frames.clear();
+  while (!atTrackDataListEnd) {
+    if (it->isEnabled()) {
+      if ((*it).getFileDuration() == 0) {
+        it = trackDataVector.erase(it);
+      } else {
+        (*it).setFrameCollection(frames);
+        (*it).setImportDuration(0);
+        ++it;
+      }
+    } else {
+      ++it;
+    }
+    atTrackDataListEnd = (it == trackDataVector.end());
+  }
+  m_trackDataModel->setTrackData(trackDataVector);
+}
+
+/**
+ * Send a query command to search in the index.
+ *
+ * @param cfg      import source configuration
+ * @param artist   artist to search
+ * @param album    album to search
+ */
+void OfflineMirrorImporter::sendFindQuery(
+  const ServerImporterConfig* cfg,
+  const QString& artist, const QString& album)
+{
+  m_findRequested = true;
+  m_requestArtist = artist;
+  m_requestAlbum = album;
+  updateIndex(cfg);
+}
+
+/**
+ * Send a query command to fetch the track list from the index.
+ *
+ * @param cfg      import source configuration
+ * @param cat      category
+ * @param id       ID
+ */
+void OfflineMirrorImporter::sendTrackListQuery(
+  const ServerImporterConfig* cfg, const QString& cat, const QString& id)
+{
+  m_findRequested = false;
+  m_requestCategory = cat;
+  m_requestId = id;
+  if (m_index.isLoaded() && cfg && cfg->server() == m_dirPath) {
+    // The result is delivered like a network reply after this method
+    // has returned.
+    QMetaObject::invokeMethod(this, "answerRequest", Qt::QueuedConnection);
+  } else {
+    updateIndex(cfg);
+  }
+}
+
+/**
+ * Start a job to check and rebuild the index of the dump folder.
+ * The pending request is answered when the job has finished.
+ * @param cfg import source configuration
+ */
+void OfflineMirrorImporter::updateIndex(const ServerImporterConfig* cfg)
+{
+  m_dirPath = cfg ? cfg->server() : QString();
+  if (m_dirPath.isEmpty()) {
+    QMetaObject::invokeMethod(this, "onIndexUpdated", Qt::QueuedConnection,
+                              Q_ARG(QString, m_dirPath), Q_ARG(bool, false));
+    return;
+  }
+  emit progress(tr("Indexing %1...").arg(m_dirPath), 0, 0);
+  m_threadPool.start(new IndexUpdateJob(this, m_dirPath));
+}
+
+/**
+ * Called when the index has been checked and rebuilt.
+ * @param dirPath folder with dump files
+ * @param ok true if the index is available
+ */
+void OfflineMirrorImporter::onIndexUpdated(const QString& dirPath, bool ok)
+{
+  if (dirPath != m_dirPath) {
+    // Result of a previous request for another folder.
+    return;
+  }
+  if (ok) {
+    const QString indexPath =
+        OfflineMirrorIndex::indexPathForDirectory(dirPath);
+    if (!m_index.isLoaded() ||
+        m_index.signature() != OfflineMirrorIndex::readSignature(indexPath)) {
+      ok = m_index.load(indexPath);
+    }
+  }
+  if (!ok) {
+    m_index = OfflineMirrorIndex();
+    emit progress(tr("No dump files found in %1").arg(dirPath), -1, -1);
+  } else {
+    emit progress(tr("Ready."), 1, 1);
+  }
+  answerRequest();
+}
+
+/**
+ * Answer the pending request from the index.
+ * The result is emitted in the same way as data received from a server.
+ */
+void OfflineMirrorImporter::answerRequest()
+{
+  QByteArray data;
+  if (m_findRequested) {
+    const QVector<OfflineMirrorIndex::Entry> entries = m_index.isLoaded()
+        ? m_index.find(m_requestArtist, m_requestAlbum, MAX_FIND_RESULTS)
+        : QVector<OfflineMirrorIndex::Entry>();
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << static_cast<quint32>(entries.size());
+    for (const OfflineMirrorIndex::Entry& entry : entries) {
+      QString text = entry.artist + QLatin1String(" - ") + entry.album;
+      if (entry.year > 0) {
+        text += QString(QLatin1String(" (%1)")).arg(entry.year);
+      }
+      stream << text << entry.category << entry.id;
+    }
+  } else {
+    data = m_index.readReleaseData(
+          m_index.indexOf(m_requestCategory, m_requestId));
+  }
+  emit bytesReceived(data);
+}
@@ -0,0 +1,129 @@
+/**
+ * \file offlinemirrorimporter.h
+ * Importer using a local mirror of metadata dumps.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QThreadPool>
+#include "serverimporter.h"
+#include "offlinemirrorindex.h"
+
+/**
+ * Importer using a local mirror of MusicBrainz and gnudb metadata dumps.
+ *
+ * The folder with the dump files is configured as the server. An index of
+ * the dumps is built in a background thread when a query is made and the
+ * dump files have changed since the index was built. Find and album queries
+ * are answered from the index without network access.
+ */
+class OfflineMirrorImporter : public ServerImporter {
+  Q_OBJECT
+public:
+  /**
+   * Constructor.
+   *
+   * @param netMgr network access manager
+   * @param trackDataModel track data to be filled with imported values
+   */
+  OfflineMirrorImporter(QNetworkAccessManager* netMgr,
+                        TrackDataModel* trackDataModel);
+
+  /**
+   * Destructor.
+   * Waits until the index is built.
+   */
+  virtual ~OfflineMirrorImporter() override;
+
+  /**
+   * Name of import source.
+   * @return name.
+   */
+  virtual const char* name() const override;
+
+  /** default server, 0 to disable */
+  virtual const char* defaultServer() const override;
+
+  /** anchor to online help, 0 to disable */
+  virtual const char* helpAnchor() const override;
+
+  /** configuration, 0 if not used */
+  virtual ServerImporterConfig* config() const override;
+
+  /** additional tags option, false if not used */
+  virtual bool additionalTags() const override;
+
+  /**
+   * Parse result of find request and populate m_albumListModel with results.
+   *
+   * @param searchStr search data received
+   */
+  virtual void parseFindResults(const QByteArray& searchStr) override;
+
+  /**
+   * Parse result of album request and populate m_trackDataModel with results.
+   *
+   * @param albumStr album data received
+   */
+  virtual void parseAlbumResults(const QByteArray& albumStr) override;
+
+  /**
+   * Send a query command to search in the index.
+   *
+   * @param cfg      import source configuration
+   * @param artist   artist to search
+   * @param album    album to search
+   */
+  virtual void sendFindQuery(
+    const ServerImporterConfig* cfg,
+    const QString& artist, const QString& album) override;
+
+  /**
+   * Send a query command to fetch the track list from the index.
+   *
+   * @param cfg      import source configuration
+   * @param cat      category
+   * @param id       ID
+   */
+  virtual void sendTrackListQuery(
+    const ServerImporterConfig* cfg, const QString& cat, const QString& id) override;
+
+private slots:
+  void onIndexUpdated(const QString& dirPath, bool ok);
+  void answerRequest();
+
+private:
+  class IndexUpdateJob;
+
+  void updateIndex(const ServerImporterConfig* cfg);
+
+  QThreadPool m_threadPool;
+  OfflineMirrorIndex m_index;
+  QString m_dirPath;
+  QString m_requestArtist;
+  QString m_requestAlbum;
+  QString m_requestCategory;
+  QString m_requestId;
+  bool m_findRequested;
+};
@@ -0,0 +1,70 @@
+/**
+ * \file offlinemirrorimportplugin.cpp
+ * Offline mirror import plugin.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "offlinemirrorimportplugin.h"
+#include "offlinemirrorimporter.h"
+
+namespace {
+
+const QLatin1String OFFLINE_MIRROR_IMPORTER_NAME("OfflineMirrorImport");
+
+}
+
+/*!
+ * Constructor.
+ * @param parent parent object
+ */
+OfflineMirrorImportPlugin::OfflineMirrorImportPlugin(QObject* parent) : QObject(parent)
+{
+  setObjectName(QLatin1String("OfflineMirrorImport"));
+}
+
+/**
+ * Get keys of available server importers.
+ * @return list of keys.
+ */
+QStringList OfflineMirrorImportPlugin::serverImporterKeys() const
+{
+  return {OFFLINE_MIRROR_IMPORTER_NAME};
+}
+
+/**
+ * Create server importer.
+ * @param key server importer key
+ * @param netMgr network access manager
+ * @param trackDataModel track data to be filled with imported values
+ * @return server importer instance, 0 if key unknown.
+ * @remarks The caller takes ownership of the returned instance.
+ */
+ServerImporter* OfflineMirrorImportPlugin::createServerImporter(
+    const QString& key,
+    QNetworkAccessManager* netMgr, TrackDataModel* trackDataModel)
+{
+  if (key == OFFLINE_MIRROR_IMPORTER_NAME) {
+    return new OfflineMirrorImporter(netMgr, trackDataModel);
+  }
+  return nullptr;
+}
@@ -0,0 +1,1123 @@
+/**
+ * \file offlinemirrorindex.cpp
+ * On-disk index of MusicBrainz and gnudb metadata dumps.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "offlinemirrorindex.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDirIterator>
+#include <QDataStream>
+#include <QBuffer>
+#include <QHash>
+#include <QSet>
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <QRegularExpression>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDateTime>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+namespace {
+
+/** Magic number at the start of an index file, "K3MI". */
+const quint32 INDEX_MAGIC = 0x4b334d49;
+/** Version of index file format. */
+const quint32 INDEX_VERSION = 2;
+/** Version of QDataStream used to serialize the index. */
+const int STREAM_VERSION = QDataStream::Qt_5_6;
+
+/** Size of entry table record: offset and size of summary. */
+const quint64 ENTRY_RECORD_SIZE = 12;
+/** Size of key table record: hash of key and index of entry. */
+const quint64 KEY_RECORD_SIZE = 12;
+/** Size of word table record: offset and size of word, offset and number
+ *  of entry indexes. */
+const quint64 WORD_RECORD_SIZE = 24;
+/**
+ * Maximum number of words starting with a search word which are used to
+ * restrict the entries to check. Search words matching more words, e.g. a
+ * single letter, are only checked in the summaries of the entries found
+ * with the other search words.
+ */
+const quint32 MAX_PREFIX_WORDS = 1024;
+
+/** Categories of gnudb, used as folder names for xmcd files. */
+const char* const gnudbCategories[] = {
+  "blues", "classical", "country", "data", "folk", "jazz", "misc", "newage",
+  "reggae", "rock", "soundtrack"
+};
+
+/**
+ * Check if a folder name is a gnudb category.
+ * @param name folder name
+ * @return true if category.
+ */
+bool isGnudbCategory(const QString& name)
+{
+  for (const char* category : gnudbCategories) {
+    if (name == QLatin1String(category)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Check if a file is a dump file which can be indexed.
+ * @param fileInfo file information
+ * @return true if MusicBrainz JSON or gnudb xmcd file.
+ */
+bool isDumpFile(const QFileInfo& fileInfo)
+{
+  const QString suffix = fileInfo.suffix().toLower();
+  return suffix == QLatin1String("json") ||
+      suffix == QLatin1String("jsonl") ||
+      suffix == QLatin1String("ndjson") ||
+      fileInfo.fileName() == QLatin1String("release") ||
+      isGnudbCategory(fileInfo.dir().dirName());
+}
+
+/**
+ * Decode text which is UTF-8 or, as in older freedb files, Latin-1.
+ * @param data encoded text
+ * @return decoded text.
+ */
+QString decodeText(const QByteArray& data)
+{
+  QString text = QString::fromUtf8(data);
+  if (text.contains(QChar::ReplacementCharacter)) {
+    text = QString::fromLatin1(data);
+  }
+  return text;
+}
+
+/**
+ * Get the year of a release date.
+ * @param date date starting with the year
+ * @return year, 0 if unknown.
+ */
+quint16 yearOfDate(const QString& date)
+{
+  return static_cast<quint16>(date.left(4).toUInt());
+}
+
+void writeRelease(QDataStream& stream,
+                  const OfflineMirrorIndex::Release& release)
+{
+  stream << release.category << release.id << release.artist << release.album
+         << release.date << release.genre << release.label
+         << release.catalogNumber << release.barcode << release.discIds
+         << static_cast<quint32>(release.tracks.size());
+  for (const OfflineMirrorIndex::Track& track : release.tracks) {
+    stream << track.title << track.artist << track.isrcs << track.duration
+           << track.medium << track.position;
+  }
+}
+
+void writeSummary(QDataStream& stream,
+                  const OfflineMirrorIndex::Entry& entry)
+{
+  stream << entry.category << entry.id << entry.artist << entry.album
+         << entry.offset << entry.size << entry.year << entry.numTracks;
+}
+
+void readSummary(QDataStream& stream, OfflineMirrorIndex::Entry& entry)
+{
+  stream >> entry.category >> entry.id >> entry.artist >> entry.album
+         >> entry.offset >> entry.size >> entry.year >> entry.numTracks;
+}
+
+/**
+ * Get hash of a key stored in the index.
+ * A 64-bit FNV-1a hash is used because it must not change between runs
+ * like qHash().
+ * @param key key
+ * @return hash.
+ */
+quint64 keyHash(const QString& key)
+{
+  quint64 hash = Q_UINT64_C(14695981039346656037);
+  const QByteArray utf8 = key.toUtf8();
+  for (char ch : utf8) {
+    hash ^= static_cast<quint8>(ch);
+    hash *= Q_UINT64_C(1099511628211);
+  }
+  return hash;
+}
+
+/**
+ * Get key for category and ID of a release.
+ * @param category category
+ * @param id ID
+ * @return key.
+ */
+QString categoryIdKey(const QString& category, const QString& id)
+{
+  return category + QLatin1Char('/') + id;
+}
+
+/**
+ * Normalize text for searching.
+ * @param str text
+ * @return text in lower case without diacritics.
+ */
+QString normalizeText(const QString& str)
+{
+  const QString decomposed =
+      str.normalized(QString::NormalizationForm_KD).toLower();
+  QString normalized;
+  normalized.reserve(decomposed.size());
+  for (const QChar ch : decomposed) {
+    if (ch.category() != QChar::Mark_NonSpacing) {
+      normalized.append(ch);
+    }
+  }
+  return normalized;
+}
+
+/**
+ * Split normalized text into words.
+ * @param normalized text returned by normalizeText()
+ * @return words consisting of letters and digits.
+ */
+QStringList wordsOfText(const QString& normalized)
+{
+  QStringList words;
+  QString word;
+  for (const QChar ch : normalized) {
+    if (ch.isLetterOrNumber()) {
+      word.append(ch);
+    } else if (!word.isEmpty()) {
+      words.append(word);
+      word.clear();
+    }
+  }
+  if (!word.isEmpty()) {
+    words.append(word);
+  }
+  return words;
+}
+
+/**
+ * Get the exact keys of a release.
+ * @param release release
+ * @return barcode, ID, disc IDs and ISRCs in lower case.
+ */
+QSet<QString> keysOfRelease(const OfflineMirrorIndex::Release& release)
+{
+  QSet<QString> keys;
+  keys.insert(release.barcode.toLower());
+  keys.insert(release.id.toLower());
+  for (const QString& discId : release.discIds) {
+    keys.insert(discId.toLower());
+  }
+  for (const OfflineMirrorIndex::Track& track : release.tracks) {
+    for (const QString& isrc : track.isrcs) {
+      keys.insert(isrc.toLower());
+    }
+  }
+  keys.remove(QString());
+  return keys;
+}
+
+/**
+ * Reader for the tables of an index file.
+ */
+class IndexFileReader {
+public:
+  /**
+   * Constructor.
+   * @param indexPath path to index file
+   */
+  explicit IndexFileReader(const QString& indexPath)
+    : m_file(indexPath), m_stream(&m_file) {
+    m_stream.setVersion(STREAM_VERSION);
+  }
+
+  /**
+   * Open index file.
+   * @return true if ok.
+   */
+  bool open() { return m_file.open(QIODevice::ReadOnly); }
+
+  /**
+   * Read data from index file.
+   * @param offset position in file
+   * @param size number of bytes
+   * @return data, empty if not found.
+   */
+  QByteArray readData(quint64 offset, quint32 size) {
+    return m_file.seek(static_cast<qint64>(offset))
+        ? m_file.read(size) : QByteArray();
+  }
+
+  /**
+   * Read summary of a release.
+   * @param table entry table
+   * @param idx index of entry
+   * @param entry the entry is returned here
+   * @return true if ok.
+   */
+  bool readEntry(const OfflineMirrorIndex::TableLocation& table, quint32 idx,
+                 OfflineMirrorIndex::Entry& entry) {
+    if (idx >= table.count || !seek(table, ENTRY_RECORD_SIZE, idx))
+      return false;
+
+    quint64 offset;
+    quint32 size;
+    m_stream >> offset >> size;
+    if (m_stream.status() != QDataStream::Ok)
+      return false;
+
+    QDataStream stream(readData(offset, size));
+    stream.setVersion(STREAM_VERSION);
+    readSummary(stream, entry);
+    return stream.status() == QDataStream::Ok;
+  }
+
+  /**
+   * Find key in a key table.
+   * @param table key table sorted by hash
+   * @param hash hash of key
+   * @return indexes of entries with @a hash in ascending order.
+   */
+  QVector<quint32> findKey(const OfflineMirrorIndex::TableLocation& table,
+                           quint64 hash) {
+    QVector<quint32> indexes;
+    quint32 lower = 0, upper = table.count;
+    while (lower < upper) {
+      const quint32 middle = lower + (upper - lower) / 2;
+      quint64 middleHash;
+      quint32 idx;
+      if (!readKey(table, middle, middleHash, idx))
+        return indexes;
+      if (middleHash < hash) {
+        lower = middle + 1;
+      } else {
+        upper = middle;
+      }
+    }
+    for (quint32 i = lower; i < table.count; ++i) {
+      quint64 keyHash;
+      quint32 idx;
+      if (!readKey(table, i, keyHash, idx) || keyHash != hash)
+        break;
+      indexes.append(idx);
+    }
+    return indexes;
+  }
+
+  /**
+   * Find the entries containing words starting with a prefix.
+   * @param table word table sorted by word
+   * @param prefix start of word
+   * @param indexes the sorted indexes of the entries are returned here
+   * @return false if more than MAX_PREFIX_WORDS words start with @a prefix.
+   */
+  bool findWordPrefix(const OfflineMirrorIndex::TableLocation& table,
+                      const QString& prefix, QVector<quint32>& indexes) {
+    indexes.clear();
+    quint32 lower = 0, upper = table.count;
+    while (lower < upper) {
+      const quint32 middle = lower + (upper - lower) / 2;
+      WordRecord record;
+      if (!readWord(table, middle, record))
+        return true;
+      if (record.word < prefix) {
+        lower = middle + 1;
+      } else {
+        upper = middle;
+      }
+    }
+    QVector<WordRecord> records;
+    for (quint32 i = lower; i < table.count; ++i) {
+      WordRecord record;
+      if (!readWord(table, i, record) || !record.word.startsWith(prefix))
+        break;
+      if (static_cast<quint32>(records.size()) >= MAX_PREFIX_WORDS)
+        return false;
+      records.append(record);
+    }
+    for (const WordRecord& record : qAsConst(records)) {
+      if (!m_file.seek(static_cast<qint64>(record.entriesOffset)))
+        break;
+      for (quint32 i = 0; i < record.numEntries; ++i) {
+        quint32 idx;
+        m_stream >> idx;
+        indexes.append(idx);
+      }
+    }
+    if (records.size() > 1) {
+      std::sort(indexes.begin(), indexes.end());
+      indexes.erase(std::unique(indexes.begin(), indexes.end()),
+                    indexes.end());
+    }
+    return true;
+  }
+
+private:
+  /** Record of word table. */
+  struct WordRecord {
+    QString word;
+    quint64 entriesOffset;
+    quint32 numEntries;
+  };
+
+  bool seek(const OfflineMirrorIndex::TableLocation& table,
+            quint64 recordSize, quint32 idx) {
+    return m_file.seek(static_cast<qint64>(table.offset + recordSize * idx));
+  }
+
+  bool readKey(const OfflineMirrorIndex::TableLocation& table, quint32 i,
+               quint64& hash, quint32& idx) {
+    if (!seek(table, KEY_RECORD_SIZE, i))
+      return false;
+    m_stream >> hash >> idx;
+    return m_stream.status() == QDataStream::Ok;
+  }
+
+  bool readWord(const OfflineMirrorIndex::TableLocation& table, quint32 i,
+                WordRecord& record) {
+    if (!seek(table, WORD_RECORD_SIZE, i))
+      return false;
+    quint64 wordOffset;
+    quint32 wordSize;
+    m_stream >> wordOffset >> wordSize >> record.entriesOffset
+             >> record.numEntries;
+    if (m_stream.status() != QDataStream::Ok)
+      return false;
+    record.word = QString::fromUtf8(readData(wordOffset, wordSize));
+    return true;
+  }
+
+  QFile m_file;
+  QDataStream m_stream;
+};
+
+/**
+ * Get the artist name from a MusicBrainz artist credit.
+ * @param credits JSON array with name credits
+ * @return artist names joined with their join phrases.
+ */
+QString artistCreditName(const QJsonArray& credits)
+{
+  QString artist;
+  for (const auto& creditValue : credits) {
+    const QJsonObject credit = creditValue.toObject();
+    QString name = credit.value(QLatin1String("name")).toString();
+    if (name.isEmpty()) {
+      name = credit.value(QLatin1String("artist")).toObject()
+          .value(QLatin1String("name")).toString();
+    }
+    artist += name;
+    artist += credit.value(QLatin1String("joinphrase")).toString();
+  }
+  return artist;
+}
+
+/**
+ * Get the strings of a JSON array.
+ * @param array JSON array with strings
+ * @return strings.
+ */
+QStringList stringsOfArray(const QJsonArray& array)
+{
+  QStringList strs;
+  for (const auto& value : array) {
+    strs.append(value.toString());
+  }
+  return strs;
+}
+
+/**
+ * Parse a release in the format of the MusicBrainz JSON web service and
+ * data dumps.
+ * @param obj JSON object of release
+ * @param release the release is returned here
+ * @return true if the object is a release with tracks.
+ */
+bool parseMusicBrainzRelease(const QJsonObject& obj,
+                             OfflineMirrorIndex::Release& release)
+{
+  const QJsonArray media = obj.value(QLatin1String("media")).toArray();
+  release.category = QLatin1String("release");
+  release.id = obj.value(QLatin1String("id")).toString();
+  release.album = obj.value(QLatin1String("title")).toString();
+  release.artist = artistCreditName(
+        obj.value(QLatin1String("artist-credit")).toArray());
+  release.date = obj.value(QLatin1String("date")).toString();
+  release.barcode = obj.value(QLatin1String("barcode")).toString();
+  const QJsonArray genres = obj.value(QLatin1String("genres")).toArray();
+  if (!genres.isEmpty()) {
+    release.genre = genres.first().toObject()
+        .value(QLatin1String("name")).toString();
+  }
+  const QJsonArray labelInfos =
+      obj.value(QLatin1String("label-info")).toArray();
+  if (!labelInfos.isEmpty()) {
+    const QJsonObject labelInfo = labelInfos.first().toObject();
+    release.label = labelInfo.value(QLatin1String("label")).toObject()
+        .value(QLatin1String("name")).toString();
+    release.catalogNumber =
+        labelInfo.value(QLatin1String("catalog-number")).toString();
+  }
+  for (const auto& mediumValue : media) {
+    const QJsonObject medium = mediumValue.toObject();
+    const quint16 mediumPos = static_cast<quint16>(
+          medium.value(QLatin1String("position")).toInt(1));
+    const QJsonArray discs = medium.value(QLatin1String("discs")).toArray();
+    for (const auto& discValue : discs) {
+      release.discIds.append(discValue.toObject()
+                             .value(QLatin1String("id")).toString());
+    }
+    const QJsonArray tracks = medium.value(QLatin1String("tracks")).toArray();
+    for (const auto& trackValue : tracks) {
+      const QJsonObject trackObj = trackValue.toObject();
+      const QJsonObject recording =
+          trackObj.value(QLatin1String("recording")).toObject();
+      OfflineMirrorIndex::Track track;
+      track.title = trackObj.value(QLatin1String("title")).toString();
+      if (track.title.isEmpty()) {
+        track.title = recording.value(QLatin1String("title")).toString();
+      }
+      track.artist = artistCreditName(
+            trackObj.value(QLatin1String("artist-credit")).toArray());
+      if (track.artist == release.artist) {
+        track.artist.clear();
+      }
+      track.isrcs = stringsOfArray(
+            recording.value(QLatin1String("isrcs")).toArray());
+      double length = trackObj.value(QLatin1String("length")).toDouble();
+      if (length <= 0.0) {
+        length = recording.value(QLatin1String("length")).toDouble();
+      }
+      track.duration = static_cast<quint32>(length / 1000.0 + 0.5);
+      track.medium = mediumPos;
+      track.position = static_cast<quint16>(
+            trackObj.value(QLatin1String("position"))
+            .toInt(release.tracks.size() + 1));
+      release.tracks.append(track);
+    }
+  }
+  return !release.id.isEmpty() && !release.tracks.isEmpty();
+}
+
+/**
+ * Parse a MusicBrainz JSON file.
+ * The file can contain a release object per line as in the JSON data dumps
+ * or a single release or release search result from the web service.
+ *
+ * @param filePath path to file
+ * @param addRelease function called for every release
+ */
+void parseMusicBrainzFile(
+    const QString& filePath,
+    const std::function<void (const OfflineMirrorIndex::Release&)>& addRelease)
+{
+  QFile file(filePath);
+  if (!file.open(QIODevice::ReadOnly))
+    return;
+
+  bool firstLine = true;
+  while (!file.atEnd()) {
+    const QByteArray line = file.readLine().trimmed();
+    if (line.isEmpty())
+      continue;
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(line, &error);
+    if (error.error != QJsonParseError::NoError) {
+      if (firstLine) {
+        // Not one object per line, parse the whole file.
+        file.seek(0);
+        const QJsonObject obj = QJsonDocument::fromJson(file.readAll()).object();
+        const QJsonArray releases =
+            obj.value(QLatin1String("releases")).toArray();
+        if (releases.isEmpty()) {
+          OfflineMirrorIndex::Release release;
+          if (parseMusicBrainzRelease(obj, release)) {
+            addRelease(release);
+          }
+        } else {
+          for (const auto& releaseValue : releases) {
+            OfflineMirrorIndex::Release release;
+            if (parseMusicBrainzRelease(releaseValue.toObject(), release)) {
+              addRelease(release);
+            }
+          }
+        }
+        return;
+      }
+      continue;
+    }
+    firstLine = false;
+    OfflineMirrorIndex::Release release;
+    if (parseMusicBrainzRelease(doc.object(), release)) {
+      addRelease(release);
+    }
+  }
+}
+
+/**
+ * Parse a gnudb xmcd file.
+ *
+ * @param data contents of xmcd file
+ * @param category gnudb category
+ * @param release the release is returned here
+ *
+ * @return true if the file contains a disc with tracks.
+ */
+bool parseXmcd(const QByteArray& data, const QString& category,
+               OfflineMirrorIndex::Release& release)
+{
+  const QStringList lines = decodeText(data).split(QLatin1Char('\n'));
+  QHash<QString, QString> values;
+  QList<int> frameOffsets;
+  int discLength = 0;
+  bool inOffsets = false;
+  for (QString line : lines) {
+    if (line.endsWith(QLatin1Char('\r'))) {
+      line.chop(1);
+    }
+    if (line.startsWith(QLatin1Char('#'))) {
+      const QString comment = line.mid(1).trimmed();
+      if (comment.startsWith(QLatin1String("Track frame offsets"))) {
+        inOffsets = true;
+      } else if (comment.startsWith(QLatin1String("Disc length:"))) {
+        discLength = comment.mid(12).trimmed().section(QLatin1Char(' '), 0, 0)
+            .toInt();
+        inOffsets = false;
+      } else if (inOffsets) {
+        bool ok;
+        int offset = comment.toInt(&ok);
+        if (ok) {
+          frameOffsets.append(offset);
+        } else {
+          inOffsets = false;
+        }
+      }
+      continue;
+    }
+    const int eqPos = line.indexOf(QLatin1Char('='));
+    if (eqPos > 0) {
+      // Values can be split over multiple lines with the same key.
+      values[line.left(eqPos)] += line.mid(eqPos + 1);
+    }
+  }
+
+  const QStringList discIds =
+      values.value(QLatin1String("DISCID")).split(QLatin1Char(','));
+  const QString discTitle = values.value(QLatin1String("DTITLE"));
+  const int slashPos = discTitle.indexOf(QLatin1String(" / "));
+  release.category = category;
+  release.id = discIds.first().trimmed();
+  for (const QString& discId : discIds) {
+    release.discIds.append(discId.trimmed());
+  }
+  if (slashPos >= 0) {
+    release.artist = discTitle.left(slashPos).trimmed();
+    release.album = discTitle.mid(slashPos + 3).trimmed();
+  } else {
+    release.artist = discTitle.trimmed();
+    release.album = release.artist;
+  }
+  release.date = values.value(QLatin1String("DYEAR")).trimmed();
+  release.genre = values.value(QLatin1String("DGENRE")).trimmed();
+  const bool variousArtists =
+      release.artist.startsWith(QLatin1String("Various"), Qt::CaseInsensitive);
+  for (quint16 trackNr = 0;; ++trackNr) {
+    auto it = values.constFind(QLatin1String("TTITLE") +
+                               QString::number(trackNr));
+    if (it == values.constEnd())
+      break;
+
+    OfflineMirrorIndex::Track track;
+    track.title = it->trimmed();
+    if (variousArtists) {
+      const int pos = track.title.indexOf(QLatin1String(" / "));
+      if (pos > 0) {
+        track.artist = track.title.left(pos).trimmed();
+        track.title = track.title.mid(pos + 3).trimmed();
+      }
+    }
+    track.duration = 0;
+    if (trackNr < frameOffsets.size()) {
+      const int endOffset = trackNr + 1 < frameOffsets.size()
+          ? frameOffsets.at(trackNr + 1) : discLength * 75;
+      if (endOffset > frameOffsets.at(trackNr)) {
+        track.duration = static_cast<quint32>(
+              (endOffset - frameOffsets.at(trackNr)) / 75);
+      }
+    }
+    track.medium = 1;
+    track.position = trackNr + 1;
+    release.tracks.append(track);
+  }
+  return !release.id.isEmpty() && !release.tracks.isEmpty();
+}
+
+}
+
+/**
+ * Constructor.
+ */
+OfflineMirrorIndex::OfflineMirrorIndex()
+  : m_entryTable{0, 0}, m_keyTable{0, 0}, m_idTable{0, 0}, m_wordTable{0, 0}
+{
+}
+
+/**
+ * Get path of index file for a folder with dump files.
+ * The index is stored in the cache folder, so that the dump folder can
+ * be read-only.
+ * @param dirPath folder with dump files
+ * @return path to index file.
+ */
+QString OfflineMirrorIndex::indexPathForDirectory(const QString& dirPath)
+{
+  const QByteArray hash = QCryptographicHash::hash(
+        QDir(dirPath).absolutePath().toUtf8(), QCryptographicHash::Sha1);
+  return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+      QLatin1String("/offlinemirror/") + QString::fromLatin1(hash.toHex()) +
+      QLatin1String(".idx");
+}
+
+/**
+ * Find the dump files in a folder.
+ * @param dirPath folder with dump files
+ * @param signature if not null, a signature of the names, sizes and
+ * modification times of the dump files is returned here
+ * @return paths of dump files.
+ */
+QStringList OfflineMirrorIndex::findDumpFiles(const QString& dirPath,
+                                              QByteArray* signature)
+{
+  QStringList dumpFiles;
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  QDirIterator it(dirPath, QDir::Files, QDirIterator::Subdirectories);
+  while (it.hasNext()) {
+    it.next();
+    const QFileInfo fileInfo = it.fileInfo();
+    if (isDumpFile(fileInfo)) {
+      dumpFiles.append(fileInfo.filePath());
+    }
+  }
+  dumpFiles.sort();
+  if (signature) {
+    for (const QString& filePath : qAsConst(dumpFiles)) {
+      const QFileInfo fileInfo(filePath);
+      hash.addData(filePath.toUtf8());
+      hash.addData(QByteArray::number(fileInfo.size()));
+      hash.addData(QByteArray::number(
+                     fileInfo.lastModified().toMSecsSinceEpoch()));
+    }
+    *signature = hash.result();
+  }
+  return dumpFiles;
+}
+
+/**
+ * Build index from dump files.
+ * Can be called from any thread.
+ *
+ * @param dumpFiles paths of dump files
+ * @param signature signature stored in the index
+ * @param indexPath path to index file to write
+ *
+ * @return true if ok.
+ */
+bool OfflineMirrorIndex::build(const QStringList& dumpFiles,
+                               const QByteArray& signature,
+                               const QString& indexPath)
+{
+  QDir().mkpath(QFileInfo(indexPath).absolutePath());
+  QSaveFile file(indexPath);
+  if (!file.open(QIODevice::WriteOnly))
+    return false;
+
+  QDataStream stream(&file);
+  stream.setVersion(STREAM_VERSION);
+  stream << INDEX_MAGIC << INDEX_VERSION << signature;
+  const qint64 tablesOffsetPos = file.pos();
+  stream << quint64(0);
+
+  // Offsets and sizes of the summaries, hashed keys with entry indexes and
+  // the entry indexes for each word.
+  QVector<QPair<quint64, quint32>> summaries;
+  QVector<QPair<quint64, quint32>> keys;
+  QVector<QPair<quint64, quint32>> ids;
+  QHash<QString, QVector<quint32>> entriesForWord;
+  QByteArray recordData;
+  auto writeRecord = [&file, &recordData](
+      const std::function<void (QDataStream&)>& write) {
+    recordData.clear();
+    QBuffer buffer(&recordData);
+    buffer.open(QIODevice::WriteOnly);
+    QDataStream recordStream(&buffer);
+    recordStream.setVersion(STREAM_VERSION);
+    write(recordStream);
+    buffer.close();
+    const quint64 offset = static_cast<quint64>(file.pos());
+    file.write(recordData);
+    return qMakePair(offset, static_cast<quint32>(recordData.size()));
+  };
+  auto addRelease = [&](const Release& release) {
+    Entry entry;
+    const QPair<quint64, quint32> record =
+        writeRecord([&release](QDataStream& s) { writeRelease(s, release); });
+    entry.category = release.category;
+    entry.id = release.id;
+    entry.artist = release.artist;
+    entry.album = release.album;
+    entry.offset = record.first;
+    entry.size = record.second;
+    entry.year = yearOfDate(release.date);
+    entry.numTracks = static_cast<quint16>(
+          qMin(release.tracks.size(), 0xffff));
+    const quint32 idx = static_cast<quint32>(summaries.size());
+    summaries.append(
+          writeRecord([&entry](QDataStream& s) { writeSummary(s, entry); }));
+    ids.append(qMakePair(keyHash(categoryIdKey(entry.category, entry.id)),
+                         idx));
+    const QSet<QString> releaseKeys = keysOfRelease(release);
+    for (const QString& key : releaseKeys) {
+      keys.append(qMakePair(keyHash(key), idx));
+    }
+    const QStringList releaseWords =
+        wordsOfText(normalizeText(release.artist)) +
+        wordsOfText(normalizeText(release.album));
+    for (const QString& word : releaseWords) {
+      QVector<quint32>& indexes = entriesForWord[word];
+      if (indexes.isEmpty() || indexes.last() != idx) {
+        indexes.append(idx);
+      }
+    }
+  };
+
+  for (const QString& filePath : dumpFiles) {
+    const QFileInfo fileInfo(filePath);
+    const QString dirName = fileInfo.dir().dirName();
+    if (isGnudbCategory(dirName) && fileInfo.suffix().isEmpty()) {
+      QFile xmcdFile(filePath);
+      if (xmcdFile.open(QIODevice::ReadOnly)) {
+        Release release;
+        if (parseXmcd(xmcdFile.readAll(), dirName, release)) {
+          addRelease(release);
+        }
+      }
+    } else {
+      parseMusicBrainzFile(filePath, addRelease);
+    }
+  }
+
+  // Words and their entry indexes, the index entries of a word are in
+  // ascending order because the entries are added in this order.
+  QStringList words = entriesForWord.keys();
+  std::sort(words.begin(), words.end());
+  QVector<QPair<quint64, quint32>> wordLocations;
+  QVector<QPair<quint64, quint32>> wordEntries;
+  wordLocations.reserve(words.size());
+  wordEntries.reserve(words.size());
+  for (const QString& word : qAsConst(words)) {
+    const QByteArray utf8 = word.toUtf8();
+    wordLocations.append(qMakePair(static_cast<quint64>(file.pos()),
+                                   static_cast<quint32>(utf8.size())));
+    file.write(utf8);
+    const QVector<quint32> indexes = entriesForWord.take(word);
+    wordEntries.append(qMakePair(static_cast<quint64>(file.pos()),
+                                 static_cast<quint32>(indexes.size())));
+    for (quint32 idx : indexes) {
+      stream << idx;
+    }
+  }
+  std::sort(keys.begin(), keys.end());
+  std::sort(ids.begin(), ids.end());
+
+  // Tables with fixed size records, see ENTRY_RECORD_SIZE, KEY_RECORD_SIZE,
+  // WORD_RECORD_SIZE.
+  TableLocation entryTable, keyTable, idTable, wordTable;
+  entryTable.offset = static_cast<quint64>(file.pos());
+  entryTable.count = static_cast<quint32>(summaries.size());
+  for (const auto& summary : qAsConst(summaries)) {
+    stream << summary.first << summary.second;
+  }
+  keyTable.offset = static_cast<quint64>(file.pos());
+  keyTable.count = static_cast<quint32>(keys.size());
+  for (const auto& key : qAsConst(keys)) {
+    stream << key.first << key.second;
+  }
+  idTable.offset = static_cast<quint64>(file.pos());
+  idTable.count = static_cast<quint32>(ids.size());
+  for (const auto& id : qAsConst(ids)) {
+    stream << id.first << id.second;
+  }
+  wordTable.offset = static_cast<quint64>(file.pos());
+  wordTable.count = static_cast<quint32>(words.size());
+  for (int i = 0; i < words.size(); ++i) {
+    stream << wordLocations.at(i).first << wordLocations.at(i).second
+           << wordEntries.at(i).first << wordEntries.at(i).second;
+  }
+
+  const quint64 tablesOffset = static_cast<quint64>(file.pos());
+  for (const TableLocation& table : {entryTable, keyTable, idTable,
+                                     wordTable}) {
+    stream << table.offset << table.count;
+  }
+  file.seek(tablesOffsetPos);
+  stream << tablesOffset;
+  return stream.status() == QDataStream::Ok && file.commit();
+}
+
+/**
+ * Read the signature stored in an index file.
+ * @param indexPath path to index file
+ * @return signature, empty if index not valid.
+ */
+QByteArray OfflineMirrorIndex::readSignature(const QString& indexPath)
+{
+  QFile file(indexPath);
+  if (!file.open(QIODevice::ReadOnly))
+    return QByteArray();
+
+  QDataStream stream(&file);
+  stream.setVersion(STREAM_VERSION);
+  quint32 magic, version;
+  QByteArray signature;
+  stream >> magic >> version;
+  if (magic != INDEX_MAGIC || version != INDEX_VERSION)
+    return QByteArray();
+
+  stream >> signature;
+  return stream.status() == QDataStream::Ok ? signature : QByteArray();
+}
+
+/**
+ * Load the locations of the tables of an index file.
+ * @param indexPath path to index file
+ * @return true if ok.
+ */
+bool OfflineMirrorIndex::load(const QString& indexPath)
+{
+  m_indexPath.clear();
+  m_signature.clear();
+
+  QFile file(indexPath);
+  if (!file.open(QIODevice::ReadOnly))
+    return false;
+
+  QDataStream stream(&file);
+  stream.setVersion(STREAM_VERSION);
+  quint32 magic, version;
+  quint64 tablesOffset;
+  stream >> magic >> version;
+  if (magic != INDEX_MAGIC || version != INDEX_VERSION)
+    return false;
+
+  stream >> m_signature >> tablesOffset;
+  if (stream.status() != QDataStream::Ok ||
+      !file.seek(static_cast<qint64>(tablesOffset)))
+    return false;
+
+  for (TableLocation* table : {&m_entryTable, &m_keyTable, &m_idTable,
+                               &m_wordTable}) {
+    stream >> table->offset >> table->count;
+  }
+  if (stream.status() != QDataStream::Ok) {
+    m_signature.clear();
+    return false;
+  }
+  m_indexPath = indexPath;
+  return true;
+}
+
+/**
+ * Find releases.
+ * If only @a artist is given and it has the form of a barcode, disc ID,
+ * ISRC or MusicBrainz ID, releases with this key are searched. Otherwise
+ * releases whose artist and title contain @a artist and @a album are
+ * searched, ignoring case and diacritics. The words of @a artist and
+ * @a album must be found at the start of words in the release.
+ *
+ * @param artist artist or key to search
+ * @param album album to search
+ * @param maxResults maximum number of results
+ *
+ * @return entries found.
+ */
+QVector<OfflineMirrorIndex::Entry> OfflineMirrorIndex::find(
+    const QString& artist, const QString& album, int maxResults) const
+{
+  static const QRegularExpression keyRe(QLatin1String(
+      "^(?:\\d{8,14}"                                  // barcode
+      "|[0-9a-fA-F]{8}"                                // gnudb disc ID
+      "|[A-Za-z0-9._]{27}-"                            // MusicBrainz disc ID
+      "|[A-Za-z]{2}[A-Za-z0-9]{3}\\d{7}"               // ISRC
+      "|[0-9a-f]{8}(?:-[0-9a-f]{4}){3}-[0-9a-f]{12}"   // MusicBrainz ID
+      ")$"));
+  QVector<Entry> result;
+  const QString artistStr = artist.trimmed();
+  const QString albumStr = album.trimmed();
+  if (artistStr.isEmpty() && albumStr.isEmpty())
+    return result;
+
+  IndexFileReader reader(m_indexPath);
+  if (!reader.open())
+    return result;
+
+  if (albumStr.isEmpty() && keyRe.match(artistStr).hasMatch()) {
+    // Different keys can have the same hash, so the key is checked in the
+    // release record.
+    const QString key = artistStr.toLower();
+    const QVector<quint32> indexes = reader.findKey(m_keyTable, keyHash(key));
+    for (quint32 idx : indexes) {
+      if (result.size() >= maxResults)
+        break;
+      Entry entry;
+      Release release;
+      if (reader.readEntry(m_entryTable, idx, entry) &&
+          parseReleaseData(reader.readData(entry.offset, entry.size),
+                           release) &&
+          keysOfRelease(release).contains(key)) {
+        result.append(entry);
+      }
+    }
+    if (!result.isEmpty())
+      return result;
+  }
+
+  // The entries are restricted to those containing words starting with the
+  // search words, their summaries are then checked for the complete strings.
+  const QString artistNorm = normalizeText(artistStr);
+  const QString albumNorm = normalizeText(albumStr);
+  QStringList searchWords = wordsOfText(artistNorm) + wordsOfText(albumNorm);
+  searchWords.removeDuplicates();
+  QVector<quint32> candidates;
+  bool restricted = false;
+  for (const QString& word : qAsConst(searchWords)) {
+    QVector<quint32> indexes;
+    if (!reader.findWordPrefix(m_wordTable, word, indexes))
+      continue;
+    if (restricted) {
+      QVector<quint32> intersection;
+      std::set_intersection(candidates.constBegin(), candidates.constEnd(),
+                            indexes.constBegin(), indexes.constEnd(),
+                            std::back_inserter(intersection));
+      candidates.swap(intersection);
+    } else {
+      candidates.swap(indexes);
+      restricted = true;
+    }
+    if (candidates.isEmpty())
+      return result;
+  }
+
+  // Without restricting words, all entries are checked.
+  const quint32 numCandidates = restricted
+      ? static_cast<quint32>(candidates.size()) : m_entryTable.count;
+  for (quint32 i = 0; i < numCandidates && result.size() < maxResults; ++i) {
+    Entry entry;
+    if (reader.readEntry(m_entryTable, restricted ? candidates.at(i) : i,
+                         entry) &&
+        normalizeText(entry.artist).contains(artistNorm) &&
+        normalizeText(entry.album).contains(albumNorm)) {
+      result.append(entry);
+    }
+  }
+  return result;
+}
+
+/**
+ * Get index of entry with a category and ID.
+ * @param category category
+ * @param id ID
+ * @return index of entry, -1 if not found.
+ */
+int OfflineMirrorIndex::indexOf(const QString& category,
+                                const QString& id) const
+{
+  IndexFileReader reader(m_indexPath);
+  if (!reader.open())
+    return -1;
+
+  const QVector<quint32> indexes =
+      reader.findKey(m_idTable, keyHash(categoryIdKey(category, id)));
+  for (quint32 idx : indexes) {
+    Entry entry;
+    if (reader.readEntry(m_entryTable, idx, entry) &&
+        entry.category == category && entry.id == id) {
+      return static_cast<int>(idx);
+    }
+  }
+  return -1;
+}
+
+/**
+ * Read release record from index file.
+ * @param idx index of entry
+ * @return serialized release, empty if not found.
+ */
+QByteArray OfflineMirrorIndex::readReleaseData(int idx) const
+{
+  IndexFileReader reader(m_indexPath);
+  Entry entry;
+  if (idx < 0 || !reader.open() ||
+      !reader.readEntry(m_entryTable, static_cast<quint32>(idx), entry))
+    return QByteArray();
+
+  return reader.readData(entry.offset, entry.size);
+}
+
+/**
+ * Deserialize a release record.
+ * @param data data returned by readReleaseData()
+ * @param release the release is returned here
+ * @return true if ok.
+ */
+bool OfflineMirrorIndex::parseReleaseData(const QByteArray& data,
+                                          Release& release)
+{
+  QDataStream stream(data);
+  stream.setVersion(STREAM_VERSION);
+  quint32 numTracks;
+  stream >> release.category >> release.id >> release.artist >> release.album
+         >> release.date >> release.genre >> release.label
+         >> release.catalogNumber >> release.barcode >> release.discIds
+         >> numTracks;
+  if (stream.status() != QDataStream::Ok || numTracks > 0xffff)
+    return false;
+
+  release.tracks.resize(static_cast<int>(numTracks));
+  for (Track& track : release.tracks) {
+    stream >> track.title >> track.artist >> track.isrcs >> track.duration
+           >> track.medium >> track.position;
+  }
+  return stream.status() == QDataStream::Ok;
+}
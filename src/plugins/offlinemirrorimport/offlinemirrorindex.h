@@ -0,0 +1,208 @@
+/**
+ * \file offlinemirrorindex.h
+ * On-disk index of MusicBrainz and gnudb metadata dumps.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+
+/**
+ * Compact on-disk index of metadata dumps.
+ *
+ * The index is built from the files in a folder containing
+ * - MusicBrainz JSON dumps (one release object per line, as in mbdump/release
+ *   of the JSON data dumps) or responses of the MusicBrainz JSON web service,
+ * - gnudb/freedb xmcd files, stored in folders named after their category.
+ *
+ * The index file contains a record and a summary for each release followed
+ * by tables with fixed size records, which are searched on disk:
+ * - the locations of the summaries,
+ * - hashes of exact keys (barcode, disc IDs, ISRCs, MusicBrainz ID) sorted
+ *   by hash,
+ * - hashes of category and ID sorted by hash,
+ * - the normalized words of artists and titles in sorted order with the
+ *   releases containing them.
+ * Only the locations of these tables are kept in memory, a lookup reads only
+ * the table records and summaries it needs.
+ */
+class OfflineMirrorIndex {
+public:
+  /** Track of a release. */
+  struct Track {
+    QString title;      /**< title */
+    QString artist;     /**< artist, empty if same as release artist */
+    QStringList isrcs;  /**< ISRCs of recording */
+    quint32 duration;   /**< duration in seconds, 0 if unknown */
+    quint16 medium;     /**< position of medium, starting with 1 */
+    quint16 position;   /**< position of track on medium, starting with 1 */
+  };
+
+  /** Release with its tracks. */
+  struct Release {
+    QString category;      /**< "release" for MusicBrainz, else gnudb category */
+    QString id;            /**< MusicBrainz ID or gnudb disc ID */
+    QString artist;        /**< release artist */
+    QString album;         /**< release title */
+    QString date;          /**< release date or year */
+    QString genre;         /**< genre */
+    QString label;         /**< label */
+    QString catalogNumber; /**< catalog number */
+    QString barcode;       /**< barcode */
+    QStringList discIds;   /**< MusicBrainz or gnudb disc IDs */
+    QVector<Track> tracks; /**< tracks */
+  };
+
+  /** Summary of a release, as displayed in the search results. */
+  struct Entry {
+    QString category;    /**< category, see Release */
+    QString id;          /**< ID, see Release */
+    QString artist;      /**< release artist */
+    QString album;       /**< release title */
+    quint64 offset;      /**< position of release record in index file */
+    quint32 size;        /**< size of release record in bytes */
+    quint16 year;        /**< release year, 0 if unknown */
+    quint16 numTracks;   /**< number of tracks */
+  };
+
+  /** Location of a table in the index file. */
+  struct TableLocation {
+    quint64 offset;      /**< position of first record */
+    quint32 count;       /**< number of records */
+  };
+
+  /**
+   * Constructor.
+   */
+  OfflineMirrorIndex();
+
+  /**
+   * Get path of index file for a folder with dump files.
+   * The index is stored in the cache folder, so that the dump folder can
+   * be read-only.
+   * @param dirPath folder with dump files
+   * @return path to index file.
+   */
+  static QString indexPathForDirectory(const QString& dirPath);
+
+  /**
+   * Find the dump files in a folder.
+   * @param dirPath folder with dump files
+   * @param signature if not null, a signature of the names, sizes and
+   * modification times of the dump files is returned here
+   * @return paths of dump files.
+   */
+  static QStringList findDumpFiles(const QString& dirPath,
+                                   QByteArray* signature = nullptr);
+
+  /**
+   * Build index from dump files.
+   * Can be called from any thread.
+   *
+   * @param dumpFiles paths of dump files
+   * @param signature signature stored in the index
+   * @param indexPath path to index file to write
+   *
+   * @return true if ok.
+   */
+  static bool build(const QStringList& dumpFiles, const QByteArray& signature,
+                    const QString& indexPath);
+
+  /**
+   * Read the signature stored in an index file.
+   * @param indexPath path to index file
+   * @return signature, empty if index not valid.
+   */
+  static QByteArray readSignature(const QString& indexPath);
+
+  /**
+   * Load the locations of the tables of an index file.
+   * @param indexPath path to index file
+   * @return true if ok.
+   */
+  bool load(const QString& indexPath);
+
+  /**
+   * Check if an index is loaded.
+   * @return true if loaded.
+   */
+  bool isLoaded() const { return !m_indexPath.isEmpty(); }
+
+  /**
+   * Get signature of loaded index.
+   * @return signature of dump files.
+   */
+  QByteArray signature() const { return m_signature; }
+
+  /**
+   * Find releases.
+   * If only @a artist is given and it has the form of a barcode, disc ID,
+   * ISRC or MusicBrainz ID, releases with this key are searched. Otherwise
+   * releases whose artist and title contain @a artist and @a album are
+   * searched, ignoring case and diacritics. The words of @a artist and
+   * @a album must be found at the start of words in the release.
+   *
+   * @param artist artist or key to search
+   * @param album album to search
+   * @param maxResults maximum number of results
+   *
+   * @return entries found.
+   */
+  QVector<Entry> find(const QString& artist, const QString& album,
+                      int maxResults) const;
+
+  /**
+   * Get index of entry with a category and ID.
+   * @param category category
+   * @param id ID
+   * @return index of entry, -1 if not found.
+   */
+  int indexOf(const QString& category, const QString& id) const;
+
+  /**
+   * Read release record from index file.
+   * @param idx index of entry
+   * @return serialized release, empty if not found.
+   */
+  QByteArray readReleaseData(int idx) const;
+
+  /**
+   * Deserialize a release record.
+   * @param data data returned by readReleaseData()
+   * @param release the release is returned here
+   * @return true if ok.
+   */
+  static bool parseReleaseData(const QByteArray& data, Release& release);
+
+private:
+  QString m_indexPath;
+  QByteArray m_signature;
+  TableLocation m_entryTable;
+  TableLocation m_keyTable;
+  TableLocation m_idTable;
+  TableLocation m_wordTable;
+};
@@ -28,6 +28,7 @@
 
 #include "genres.h"
 #include "pictureframe.h"
+#include "tracer.h"
 #include <FLAC++/metadata.h>
 #include <QFile>
 #include <QDir>
@@ -144,6 +145,7 @@ QString FlacFile::taggedFileKey() const
  */
 void FlacFile::readTags(bool force)
 {
+  TraceSpan span("readTags FLAC");
   bool priorIsTagInformationRead = isTagInformationRead();
   if (force || !m_fileRead) {
     m_comments.clear();
@@ -245,6 +247,7 @@ void FlacFile::readTags(bool force)
  */
 bool FlacFile::writeTags(bool force, bool* renamed, bool preserve)
 {
+  TraceSpan span("writeTags FLAC");
   if (isChanged() &&
     !QFileInfo(currentFilePath()).isWritable()) {
     revertChangedFilename();
@@ -38,6 +38,7 @@
 #include "pictureframe.h"
 #include "tagconfig.h"
 #include "taggedfilesystemmodel.h"
+#include "tracer.h"
 
 namespace {
 
@@ -173,6 +174,7 @@ int OggFile::taggedFileFeatures() const
  */
 void OggFile::readTags(bool force)
 {
+  TraceSpan span("readTags Ogg");
   bool priorIsTagInformationRead = isTagInformationRead();
   if (force || !m_fileRead) {
     m_comments.clear();
@@ -232,6 +234,7 @@ void OggFile::readTags(bool force)
  */
 bool OggFile::writeTags(bool force, bool* renamed, bool preserve)
 {
+  TraceSpan span("writeTags Ogg");
   QString dirname = getDirname();
   if (isChanged() &&
     !QFileInfo(currentFilePath()).isWritable()) {
@@ -205,7 +205,7 @@ protected:
     /** Constructor. */
     CommentField(const QString& name = QString(),
                  const QString& value = QString())
-      : m_name(name), m_value(value) {}
+      : m_name(FrameStringPool::intern(name)), m_value(value) {}
     /**
      * Get name.
      * @return name.
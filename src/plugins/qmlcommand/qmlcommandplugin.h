@@ -40,7 +40,8 @@ class QQmlEngine;
 class KID3_PLUGIN_EXPORT QmlCommandPlugin
     : public QObject, public IUserCommandProcessor {
   Q_OBJECT
-  Q_PLUGIN_METADATA(IID "org.kde.kid3.IUserCommandProcessor")
+  Q_PLUGIN_METADATA(IID "org.kde.kid3.IUserCommandProcessor"
+                    FILE "qmlcommandplugin.json")
   Q_INTERFACES(IUserCommandProcessor)
 public:
   /**
@@ -39,6 +39,7 @@
 #include "genres.h"
 #include "attributedata.h"
 #include "pictureframe.h"
+#include "tracer.h"
 
 // Just using include <oggfile.h>, include <flacfile.h> as recommended in the
 // TagLib documentation does not work, as there are files with these names
@@ -926,6 +927,7 @@ void TagLibFile::clearTags(bool force)
  */
 void TagLibFile::readTags(bool force)
 {
+  TraceSpan span("readTags TagLib");
   bool priorIsTagInformationRead = isTagInformationRead();
   QString fileName = currentFilePath();
 
@@ -1197,7 +1199,8 @@ void TagLibFile::readTags(bool force)
   m_tagInformationRead = true;
   FOR_TAGLIB_TAGS(tagNr) {
     m_hasTag[tagNr] = m_tag[tagNr] && !m_tag[tagNr]->isEmpty();
-    m_tagFormat[tagNr] = getTagFormat(m_tag[tagNr], m_tagType[tagNr]);
+    m_tagFormat[tagNr] = FrameStringPool::intern(
+          getTagFormat(m_tag[tagNr], m_tagType[tagNr]));
   }
   readAudioProperties();
 
@@ -1289,6 +1292,7 @@ bool TagLibFile::writeTags(bool force, bool* renamed, bool preserve)
 bool TagLibFile::writeTags(bool force, bool* renamed, bool preserve,
                            int id3v2Version)
 {
+  TraceSpan span("writeTags TagLib");
   QString fnStr(currentFilePath());
   if (isChanged() && !QFileInfo(fnStr).isWritable()) {
     closeFile(false);
@@ -7069,3 +7073,234 @@ void TagLibFile::staticInit()
 {
   tagLibInitializer.init();
 }
+
+namespace {
+
+/**
+ * Get the data of the front cover, or the first picture if there is no
+ * front cover, in an ID3v2 tag.
+ * @param tag ID3v2 tag
+ * @return picture data, empty if not found.
+ */
+QByteArray pictureDataFromId3v2Tag(const TagLib::ID3v2::Tag* tag)
+{
+  const TagLib::ID3v2::FrameList& frames = tag->frameListMap()["APIC"];
+  const TagLib::ID3v2::AttachedPictureFrame* picture = nullptr;
+  for (auto it = frames.begin(); it != frames.end(); ++it) {
+    if (auto apic =
+        dynamic_cast<const TagLib::ID3v2::AttachedPictureFrame*>(*it)) {
+      if (!picture ||
+          apic->type() == TagLib::ID3v2::AttachedPictureFrame::FrontCover) {
+        picture = apic;
+        if (apic->type() == TagLib::ID3v2::AttachedPictureFrame::FrontCover) {
+          break;
+        }
+      }
+    }
+  }
+  if (picture) {
+    const TagLib::ByteVector data = picture->picture();
+    return QByteArray(data.data(), static_cast<int>(data.size()));
+  }
+  return QByteArray();
+}
+
+/**
+ * Get the data of the front cover, or the first picture if there is no
+ * front cover, in a list of FLAC pictures.
+ * @param pictures FLAC pictures
+ * @return picture data, empty if not found.
+ */
+QByteArray pictureDataFromFlacPictures(
+    const TagLib::List<TagLib::FLAC::Picture*>& pictures)
+{
+  const TagLib::FLAC::Picture* picture = nullptr;
+  for (auto it = pictures.begin(); it != pictures.end(); ++it) {
+    if (!picture || (*it)->type() == TagLib::FLAC::Picture::FrontCover) {
+      picture = *it;
+      if (picture->type() == TagLib::FLAC::Picture::FrontCover) {
+        break;
+      }
+    }
+  }
+  if (picture) {
+    const TagLib::ByteVector data = picture->data();
+    return QByteArray(data.data(), static_cast<int>(data.size()));
+  }
+  return QByteArray();
+}
+
+/**
+ * Get the data of the first picture in a Xiph comment.
+ * @param tag Xiph comment
+ * @return picture data, empty if not found.
+ */
+QByteArray pictureDataFromXiphComment(TagLib::Ogg::XiphComment* tag)
+{
+#if TAGLIB_VERSION >= 0x010b00
+  return pictureDataFromFlacPictures(tag->pictureList());
+#else
+  const TagLib::StringList values =
+      tag->fieldListMap()["METADATA_BLOCK_PICTURE"];
+  for (auto it = values.begin(); it != values.end(); ++it) {
+    const QByteArray block = QByteArray::fromBase64(it->toCString());
+    TagLib::FLAC::Picture picture;
+    if (picture.parse(TagLib::ByteVector(block.constData(),
+                                         static_cast<uint>(block.size())))) {
+      const TagLib::ByteVector data = picture.data();
+      return QByteArray(data.data(), static_cast<int>(data.size()));
+    }
+  }
+  return QByteArray();
+#endif
+}
+
+/**
+ * Get the data of the first cover art item in an MP4 tag.
+ * @param tag MP4 tag
+ * @return picture data, empty if not found.
+ */
+QByteArray pictureDataFromMp4Tag(TagLib::MP4::Tag* tag)
+{
+#if TAGLIB_VERSION >= 0x010a00
+  const auto& itemMap = tag->itemMap();
+  auto it = itemMap.find("covr");
+  const TagLib::MP4::CoverArtList pics = it != itemMap.end()
+      ? it->second.toCoverArtList() : TagLib::MP4::CoverArtList();
+#else
+  const TagLib::MP4::CoverArtList pics(
+        tag->itemListMap()["covr"].toCoverArtList());
+#endif
+  if (!pics.isEmpty()) {
+    const TagLib::ByteVector data = pics.front().data();
+    return QByteArray(data.data(), static_cast<int>(data.size()));
+  }
+  return QByteArray();
+}
+
+/**
+ * Get the data of the front cover, or the first picture if there is no
+ * front cover, in an ASF tag.
+ * @param tag ASF tag
+ * @return picture data, empty if not found.
+ */
+QByteArray pictureDataFromAsfTag(TagLib::ASF::Tag* tag)
+{
+  TagLib::ASF::AttributeListMap& attrListMap = tag->attributeListMap();
+  if (!attrListMap.contains("WM/Picture")) {
+    return QByteArray();
+  }
+  const TagLib::ASF::AttributeList& attrList = attrListMap["WM/Picture"];
+  TagLib::ASF::Picture picture;
+  for (auto it = attrList.begin(); it != attrList.end(); ++it) {
+    TagLib::ASF::Picture pic = it->toPicture();
+    if (pic.isValid() && (!picture.isValid() ||
+                          pic.type() == TagLib::ASF::Picture::FrontCover)) {
+      picture = pic;
+      if (pic.type() == TagLib::ASF::Picture::FrontCover) {
+        break;
+      }
+    }
+  }
+  if (picture.isValid()) {
+    const TagLib::ByteVector data = picture.picture();
+    return QByteArray(data.data(), static_cast<int>(data.size()));
+  }
+  return QByteArray();
+}
+
+/**
+ * Get the data of the embedded cover picture from an opened stream.
+ * The files are created without reading the audio properties.
+ * @param stream stream
+ * @param ext uppercase extension of file
+ * @return picture data, empty if not supported or not found.
+ */
+QByteArray pictureDataFromStream(TagLib::IOStream* stream, const QString& ext)
+{
+  if (ext == QLatin1String("MP3") || ext == QLatin1String("MP2") ||
+      ext == QLatin1String("AAC")) {
+    TagLib::MPEG::File file(stream, TagLib::ID3v2::FrameFactory::instance(),
+                            false);
+    if (const TagLib::ID3v2::Tag* tag = file.ID3v2Tag()) {
+      return pictureDataFromId3v2Tag(tag);
+    }
+  } else if (ext == QLatin1String("FLAC")) {
+    TagLib::FLAC::File file(stream, TagLib::ID3v2::FrameFactory::instance(),
+                            false);
+    QByteArray data = pictureDataFromFlacPictures(file.pictureList());
+    if (data.isEmpty()) {
+      if (const TagLib::ID3v2::Tag* tag = file.ID3v2Tag()) {
+        data = pictureDataFromId3v2Tag(tag);
+      }
+    }
+    return data;
+  } else if (ext == QLatin1String("OGG") || ext == QLatin1String("OGA")) {
+    TagLib::Vorbis::File file(stream, false);
+    if (file.isValid()) {
+      if (TagLib::Ogg::XiphComment* tag = file.tag()) {
+        return pictureDataFromXiphComment(tag);
+      }
+    } else {
+      TagLib::Ogg::FLAC::File flacFile(stream, false);
+      if (TagLib::Ogg::XiphComment* tag = flacFile.tag()) {
+        return pictureDataFromXiphComment(tag);
+      }
+    }
+  } else if (ext == QLatin1String("OPUS")) {
+    TagLib::Ogg::Opus::File file(stream, false);
+    if (TagLib::Ogg::XiphComment* tag = file.tag()) {
+      return pictureDataFromXiphComment(tag);
+    }
+  } else if (ext == QLatin1String("SPX")) {
+    TagLib::Ogg::Speex::File file(stream, false);
+    if (TagLib::Ogg::XiphComment* tag = file.tag()) {
+      return pictureDataFromXiphComment(tag);
+    }
+  } else if (ext == QLatin1String("M4A") || ext == QLatin1String("M4B") ||
+             ext == QLatin1String("M4P") || ext == QLatin1String("M4R") ||
+             ext == QLatin1String("MP4") || ext == QLatin1String("M4V") ||
+             ext == QLatin1String("MP4V")) {
+    TagLib::MP4::File file(stream, false);
+    if (TagLib::MP4::Tag* tag = file.tag()) {
+      return pictureDataFromMp4Tag(tag);
+    }
+  } else if (ext == QLatin1String("WMA") || ext == QLatin1String("ASF") ||
+             ext == QLatin1String("WMV")) {
+    TagLib::ASF::File file(stream, false);
+    if (TagLib::ASF::Tag* tag = file.tag()) {
+      return pictureDataFromAsfTag(tag);
+    }
+  }
+  return QByteArray();
+}
+
+}
+
+/**
+ * Read the data of the embedded cover picture without reading the tags.
+ * Only the tag containing the picture is parsed, the audio properties are
+ * not read and no frames are created. Can be called from any thread.
+ *
+ * @param fileName path to file
+ *
+ * @return picture data, empty if not supported or no picture found.
+ */
+QByteArray TagLibFile::readPictureData(const QString& fileName)
+{
+  const QString ext =
+      fileName.mid(fileName.lastIndexOf(QLatin1Char('.')) + 1).toUpper();
+  // A plain file stream is used because FileIOStream keeps track of the
+  // open files, which is not thread-safe.
+#ifdef Q_OS_WIN32
+  const std::wstring fn = fileName.toStdWString();
+  TagLib::FileStream stream(TagLib::FileName(fn.c_str()), true);
+#else
+  const QByteArray fn = QFile::encodeName(fileName);
+  TagLib::FileStream stream(TagLib::FileName(fn.constData()), true);
+#endif
+  if (!stream.isOpen()) {
+    return QByteArray();
+  }
+  return pictureDataFromStream(&stream, ext);
+}
@@ -298,6 +298,17 @@ public:
    */
   static void notifyConfigurationChange();
 
+  /**
+   * Read the data of the embedded cover picture without reading the tags.
+   * Only the tag containing the picture is parsed, the audio properties are
+   * not read and no frames are created. Can be called from any thread.
+   *
+   * @param fileName path to file
+   *
+   * @return picture data, empty if not supported or no picture found.
+   */
+  static QByteArray readPictureData(const QString& fileName);
+
 private:
   friend void TagLibFileInternal::fixUpTagLibFrameValue(
       const TagLibFile* self, Frame::Type frameType, QString& value);
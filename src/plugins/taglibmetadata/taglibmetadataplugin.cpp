@@ -179,3 +179,20 @@ void TaglibMetadataPlugin::notifyConfigurationChange(const QString& key)
     TagLibFile::notifyConfigurationChange();
   }
 }
+
+/**
+ * Read the data of the embedded cover picture without reading the tags.
+ *
+ * @param key tagged file key
+ * @param fileName path to file
+ *
+ * @return picture data, empty if not supported or no picture found.
+ */
+QByteArray TaglibMetadataPlugin::readPictureData(const QString& key,
+                                                 const QString& fileName)
+{
+  if (key == TAGGEDFILE_KEY) {
+    return TagLibFile::readPictureData(fileName);
+  }
+  return QByteArray();
+}
@@ -35,7 +35,7 @@
 class KID3_PLUGIN_EXPORT TaglibMetadataPlugin
     : public QObject, public ITaggedFileFactory {
   Q_OBJECT
-  Q_PLUGIN_METADATA(IID "org.kde.kid3.ITaggedFileFactory")
+  Q_PLUGIN_METADATA(IID "org.kde.kid3.ITaggedFileFactory/2")
   Q_INTERFACES(ITaggedFileFactory)
 public:
   /*!
@@ -108,4 +108,15 @@ public:
    * @param key tagged file key
    */
   virtual void notifyConfigurationChange(const QString& key) override;
+
+  /**
+   * Read the data of the embedded cover picture without reading the tags.
+   *
+   * @param key tagged file key
+   * @param fileName path to file
+   *
+   * @return picture data, empty if not supported or no picture found.
+   */
+  virtual QByteArray readPictureData(const QString& key,
+                                     const QString& fileName) override;
 };
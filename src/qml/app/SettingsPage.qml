@@ -123,6 +123,40 @@ AbstractSettingsPage {
           onActivated: function() { value = tagCfg.maximumPictureSize; }
           onDeactivated: function() { tagCfg.maximumPictureSize = value; }
         },
+        SettingsElement {
+          name: qsTr("Resize and recompress pictures when saving")
+          onActivated: function() { value = tagCfg.normalizePictures; }
+          onDeactivated: function() { tagCfg.normalizePictures = value; }
+        },
+        SettingsElement {
+          name: qsTr("Picture maximum size (bytes)")
+          onActivated: function() {
+            value = tagCfg.maximumNormalizedPictureSize;
+          }
+          onDeactivated: function() {
+            tagCfg.maximumNormalizedPictureSize = value;
+          }
+        },
+        SettingsElement {
+          name: qsTr("Picture maximum width and height (pixels)")
+          onActivated: function() { value = tagCfg.maximumPictureDimension; }
+          onDeactivated: function() { tagCfg.maximumPictureDimension = value; }
+        },
+        SettingsElement {
+          name: qsTr("Picture format")
+          dropDownModel: ["JPG", "PNG"]
+          onActivated: function() {
+            value = Math.max(dropDownModel.indexOf(tagCfg.pictureFormat), 0)
+          }
+          onDeactivated: function() {
+            tagCfg.pictureFormat = dropDownModel[value]
+          }
+        },
+        SettingsElement {
+          name: qsTr("Picture quality")
+          onActivated: function() { value = tagCfg.pictureQuality; }
+          onDeactivated: function() { tagCfg.pictureQuality = value; }
+        },
         SettingsElement {
           name: qsTr("Show only custom genres")
           onActivated: function() { value = tagCfg.onlyCustomGenres; }
@@ -209,6 +243,16 @@ AbstractSettingsPage {
           onActivated: function() { value = fileCfg.loadLastOpenedFile; }
           onDeactivated: function() { fileCfg.loadLastOpenedFile = value; }
         },
+        SettingsElement {
+          name: qsTr("Maximum memory for tags (MiB, 0 for unlimited)")
+          onActivated: function() { value = fileCfg.tagMemoryBudget; }
+          onDeactivated: function() { fileCfg.tagMemoryBudget = value; }
+        },
+        SettingsElement {
+          name: qsTr("Read tags of next files in advance (0 for off)")
+          onActivated: function() { value = fileCfg.tagPrefetchCount; }
+          onDeactivated: function() { fileCfg.tagPrefetchCount = value; }
+        },
         SettingsElement {
           name: qsTr("Preserve file timestamp")
           onActivated: function() { value = fileCfg.preserveTime; }
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""Benchmarks for kid3-cli.
+
+Run from the build directory, e.g.
+python3 ../src/test/benchmark_cli.py [benchmark...] [-n RUNS]
+"""
+import argparse
+import os
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+from kid3testsupport import kid3_cli_path, create_test_file
+
+
+def run_kid3_cli(args):
+    if sys.platform == 'win32':
+        args = ['--portable'] + args
+    subprocess.check_call([kid3_cli_path()] + args,
+                          stdout=subprocess.DEVNULL)
+
+
+def measure(func, runs):
+    times = []
+    for _ in range(runs):
+        start = time.perf_counter()
+        func()
+        times.append(time.perf_counter() - start)
+    return times
+
+
+def report(name, times):
+    print('{:<24} runs {:4d}  median {:8.2f} ms  min {:8.2f} ms'.format(
+        name, len(times), statistics.median(times) * 1000,
+        min(times) * 1000))
+
+
+def report_max_rss(name):
+    """Print the peak resident set size of the kid3-cli processes."""
+    try:
+        import resource
+    except ImportError:
+        return
+    max_rss = resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss
+    if sys.platform != 'darwin':
+        max_rss *= 1024
+    print('{:<24} max RSS {:8.1f} MiB'.format(name, max_rss / 1048576))
+
+
+def create_test_tree(root, num_dirs, files_per_dir):
+    """Create a folder tree with copies of a small MP3 file."""
+    template = os.path.join(root, 'template.mp3')
+    create_test_file(template)
+    for dir_nr in range(num_dirs):
+        dirpath = os.path.join(root, 'tree', 'album%04d' % dir_nr)
+        os.makedirs(dirpath)
+        for file_nr in range(files_per_dir):
+            shutil.copyfile(template,
+                            os.path.join(dirpath, 'track%03d.mp3' % file_nr))
+    os.remove(template)
+    return os.path.join(root, 'tree')
+
+
+def benchmark_startup(runs):
+    """Start kid3-cli and exit immediately."""
+    report('startup', measure(lambda: run_kid3_cli(['-c', 'exit']), runs))
+
+
+def benchmark_get_title(runs):
+    """One-shot get command on a single file."""
+    with tempfile.TemporaryDirectory() as tmpdir:
+        mp3path = os.path.join(tmpdir, 'test.mp3')
+        create_test_file(mp3path)
+        report('get title', measure(
+            lambda: run_kid3_cli(['-c', 'get title', mp3path]), runs))
+
+
+def benchmark_tree(runs):
+    """Open a synthetic tree of 20000 files and query all file names.
+    This measures the cost of populating and updating the file system model
+    with a tagged file for every file.
+    """
+    with tempfile.TemporaryDirectory() as tmpdir:
+        treepath = create_test_tree(tmpdir, 200, 100)
+        report('tree 20000 files', measure(
+            lambda: run_kid3_cli(['-c', 'query file', treepath]), runs))
+        report_max_rss('tree 20000 files')
+
+
+def benchmark_flat(runs):
+    """Open a single folder with 20000 files and query their titles.
+    Reading the tags looks up the row of every file in the model, which
+    must not depend on the number of files in the folder.
+    """
+    with tempfile.TemporaryDirectory() as tmpdir:
+        dirpath = os.path.join(create_test_tree(tmpdir, 1, 20000),
+                               'album0000')
+        report('flat 20000 files', measure(
+            lambda: run_kid3_cli(['-c', 'query file,title', dirpath]), runs))
+        report_max_rss('flat 20000 files')
+
+
+def benchmark_totag(runs):
+    """Set the tags of 20000 files in a folder from their file names.
+    This measures the cost of parsing file names with a format, which is
+    compiled once and used for all files.
+    """
+    with tempfile.TemporaryDirectory() as tmpdir:
+        dirpath = os.path.join(create_test_tree(tmpdir, 1, 20000),
+                               'album0000')
+        report('totag 20000 files', measure(
+            lambda: run_kid3_cli(['-c', 'select all',
+                                  '-c', 'totag "%{album}/track%{track}" 2',
+                                  dirpath]), runs))
+
+
+BENCHMARKS = {
+    'startup': benchmark_startup,
+    'get_title': benchmark_get_title,
+    'tree': benchmark_tree,
+    'flat': benchmark_flat,
+    'totag': benchmark_totag,
+}
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark kid3-cli.')
+    parser.add_argument('benchmarks', nargs='*',
+                        help='benchmarks to run, all if not given: ' +
+                        ', '.join(BENCHMARKS))
+    parser.add_argument('-n', '--runs', type=int, default=20,
+                        help='number of runs per benchmark')
+    args = parser.parse_args()
+    for name in args.benchmarks:
+        if name not in BENCHMARKS:
+            parser.error('unknown benchmark ' + name)
+    # Use an invalid config file to use a default configuration.
+    os.environ['KID3_CONFIG_FILE'] = ''
+    for name in args.benchmarks or BENCHMARKS:
+        BENCHMARKS[name](args.runs)
+
+
+if __name__ == '__main__':
+    main()
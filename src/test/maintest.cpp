@@ -32,7 +32,13 @@
 #include "testmusicbrainzreleaseimportparser.h"
 #include "testmusicbrainzreleaseimporter.h"
 #include "testdiscogsimporter.h"
+#include "testdiscogsimportparser.h"
 #include "testamazonimporter.h"
+#include "testofflinemirrorimporter.h"
+#include "testhttprequestscheduler.h"
+#include "testcoverartfetcher.h"
+#include "testframestringpool.h"
+#include "testgenres.h"
 
 /**
  * Main routine for test runner.
@@ -51,7 +57,13 @@ int main(int argc, char *argv[])
     new TestMusicBrainzReleaseImportParser,
     new TestMusicBrainzReleaseImporter,
     new TestDiscogsImporter,
+    new TestDiscogsImportParser,
     new TestAmazonImporter,
+    new TestOfflineMirrorImporter,
+    new TestHttpRequestScheduler,
+    new TestCoverArtFetcher,
+    new TestFrameStringPool,
+    new TestGenres,
     nullptr
   };
 
@@ -7,6 +7,8 @@ import subprocess
 import tempfile
 import platform
 import json
+import socket
+import time
 from kid3testsupport import kid3_cli_path, call_kid3_cli, create_test_file
 
 
@@ -52,6 +54,57 @@ class CliFunctionsTestCase(unittest.TestCase):
             'Timeout: default\n'
             'Timeout: default\n')
 
+    def test_memory(self):
+        self.assertEqual(call_kid3_cli(
+            ['-c', 'memory', '-c', 'memory 64', '-c', 'memory off']),
+            'Tag memory: off\n'
+            'Tag memory: 0.0 of 64 MiB, 0 files\n'
+            'Tag memory: off\n')
+
+    def test_memory_eviction(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            musicdir = os.path.join(tmpdir, 'music')
+            os.mkdir(musicdir)
+            jpgpath = os.path.join(tmpdir, 'test.jpg')
+            create_test_file(jpgpath)
+            # Pad the picture, so that the tags of two files exceed 1 MiB.
+            with open(jpgpath, 'ab') as jpgfh:
+                jpgfh.write(b'\x00' * 600000)
+            for nr in (1, 2, 3):
+                mp3path = os.path.join(musicdir, 'test%d.mp3' % nr)
+                create_test_file(mp3path)
+                call_kid3_cli(['-c', 'set album "Album %d" 2' % nr,
+                               '-c', 'set picture:"%s" "" 2' % jpgpath,
+                               mp3path])
+            lines = call_kid3_cli(
+                ['-c', 'memory 1',
+                 '-c', 'select first', '-c', 'get album',
+                 '-c', 'select next', '-c', 'get album',
+                 '-c', 'select next', '-c', 'get album',
+                 '-c', 'memory',
+                 '-c', 'select first', '-c', 'get album',
+                 '-c', 'memory', musicdir]).splitlines()
+            self.assertEqual(len(lines), 7)
+            self.assertEqual(lines[1:4], ['Album 1', 'Album 2', 'Album 3'])
+            # Only the tags of the selected file are kept.
+            self.assertRegex(lines[4], r'^Tag memory: 0\.\d of 1 MiB, 1 files$')
+            # The evicted tags are read again when the file is selected.
+            self.assertEqual(lines[5], 'Album 1')
+            self.assertRegex(lines[6], r'^Tag memory: 0\.\d of 1 MiB, 1 files$')
+
+    def test_trace(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            create_test_file(os.path.join(tmpdir, 'test.mp3'))
+            tracepath = os.path.join(tmpdir, 'trace.json')
+            call_kid3_cli(['--trace', tracepath, '-c', 'get title',
+                           os.path.join(tmpdir, 'test.mp3')])
+            with open(tracepath) as tracefh:
+                trace = json.load(tracefh)
+            names = {event['name'] for event in trace['traceEvents']
+                     if event['ph'] == 'X'}
+            self.assertIn('openDirectory', names)
+            self.assertIn('selectFiles', names)
+
     def test_exit(self):
         self.assertEqual(call_kid3_cli(['-c', 'exit']), '')
 
@@ -777,9 +830,37 @@ class CliFunctionsTestCase(unittest.TestCase):
                  '- 03 Heart Of Steel.spx', '+ 05 The Crown And The Ring (Lament Of The Kings).mp3',
                  '- 06 Kingdom Come.ape', '+ 08 Hail And Kill.wav', '- 09 The Warriors Prayer.opus',
                  '- 10 Blood Of The Kings.aif', 'Finished'])
-            call_kid3_cli(['-c', 'renamedir "%{artist} - [%{year}] %{album}" "create"', tmpdir])
+            self.assertEqual(call_kid3_cli(
+                ['-c', 'query file,title,track where "%{tag2} equals ID3v2.3.0"',
+                 tmpdir]),
+                'file\ttitle\ttrack\n'
+                '05 The Crown And The Ring (Lament Of The Kings).mp3\t'
+                'The Crown And The Ring (Lament Of The Kings)\t05\n'
+                '08 Hail And Kill.wav\tHail And Kill\t08\n')
+            # The JSON response with all rows is written on a single line.
+            self.assertEqual(call_kid3_cli(
+                ['-c', '{"jsonrpc":"2.0","id":"q","method":"query",'
+                       '"params":["file,title,track",'
+                       '"where","%{tag2} equals ID3v2.3.0"]}',
+                 tmpdir]),
+                '{"id":"q","jsonrpc":"2.0",'
+                '"result":{"columns":["file","title","track"],"rows":['
+                  '["05 The Crown And The Ring (Lament Of The Kings).mp3",'
+                  '"The Crown And The Ring (Lament Of The Kings)","05"],'
+                  '["08 Hail And Kill.wav","Hail And Kill","08"]'
+                ']}}\n')
             new_dirname = 'Manowar - [1988] Kings Of Metal'
             new_dirpath = os.path.join(tmpdir, new_dirname)
+            diff = call_kid3_cli(
+                ['-c', 'renamedir "%{artist} - [%{year}] %{album}" create diff',
+                 tmpdir]).splitlines()
+            self.assertEqual(len(diff), 16)
+            self.assertEqual(
+                diff[:2],
+                ['- ' + os.path.join(tmpdir, '01 Wheels Of Fire.m4a'),
+                 '+ ' + os.path.join(new_dirpath, '01 Wheels Of Fire.m4a')])
+            self.assertFalse(os.path.exists(new_dirpath))
+            call_kid3_cli(['-c', 'renamedir "%{artist} - [%{year}] %{album}" "create"', tmpdir])
             self.assertEqual(os.listdir(tmpdir)[0], new_dirname)
             call_kid3_cli(['-c', 'playlist', new_dirpath])
             with open(os.path.join(new_dirpath, new_dirname + '.m3u')) as m3ufh:
@@ -795,6 +876,103 @@ class CliFunctionsTestCase(unittest.TestCase):
                 '09 The Warriors Prayer.opus\n'
                 '10 Blood Of The Kings.aif\n')
 
+    def test_export_covers(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            musicdir = os.path.join(tmpdir, 'music')
+            outdir = os.path.join(tmpdir, 'covers')
+            os.mkdir(musicdir)
+            jpgpath = os.path.join(tmpdir, 'test.jpg')
+            create_test_file(jpgpath)
+            with open(jpgpath, 'rb') as jpgfh:
+                jpg_bytes = jpgfh.read()
+            for name in ('a.mp3', 'b.mp3', 'c.mp3'):
+                mp3path = os.path.join(musicdir, name)
+                create_test_file(mp3path)
+                args = ['-c', 'set artist "An Artist" 2',
+                        '-c', 'set album "An Album" 2']
+                if name != 'c.mp3':
+                    args += ['-c', 'set picture:"%s" "" 2' % jpgpath]
+                call_kid3_cli(args + [mp3path])
+            lines = call_kid3_cli(
+                ['-c', 'exportcovers "%s"' % outdir, musicdir]).splitlines()
+            self.assertEqual(lines[0], 'Started')
+            self.assertEqual(lines[-1], 'Finished: 1 exported, 1 duplicates')
+            self.assertIn('No picture  ' + os.path.join(musicdir, 'c.mp3'),
+                          lines)
+            covers = os.listdir(outdir)
+            self.assertEqual(len(covers), 1)
+            self.assertTrue(covers[0].startswith('An Artist - An Album.'))
+            with open(os.path.join(outdir, covers[0]), 'rb') as coverfh:
+                self.assertEqual(coverfh.read(), jpg_bytes)
+
+    def test_export_covers_formats(self):
+        # The pictures are extracted without reading the tags, which is
+        # implemented separately for every tag format.
+        with tempfile.TemporaryDirectory() as tmpdir:
+            jpgpath = os.path.join(tmpdir, 'test.jpg')
+            create_test_file(jpgpath)
+            with open(jpgpath, 'rb') as jpgfh:
+                jpg_bytes = jpgfh.read()
+            # ID3v2 APIC, FLAC picture, Xiph comment in Speex and Opus,
+            # MP4 covr
+            for ext in ('mp3', 'flac', 'spx', 'opus', 'm4a'):
+                musicdir = os.path.join(tmpdir, 'music_' + ext)
+                outdir = os.path.join(tmpdir, 'covers_' + ext)
+                os.mkdir(musicdir)
+                filepath = os.path.join(musicdir, 'test.' + ext)
+                create_test_file(filepath)
+                call_kid3_cli(['-c', 'set album "An Album" 2',
+                               '-c', 'set picture:"%s" "" 2' % jpgpath,
+                               filepath])
+                lines = call_kid3_cli(
+                    ['-c', 'exportcovers "%s" "%%{album}"' % outdir,
+                     musicdir]).splitlines()
+                self.assertEqual(lines[-1],
+                                 'Finished: 1 exported, 0 duplicates', ext)
+                covers = os.listdir(outdir)
+                self.assertEqual(len(covers), 1, ext)
+                self.assertTrue(covers[0].startswith('An Album.'), ext)
+                with open(os.path.join(outdir, covers[0]), 'rb') as coverfh:
+                    self.assertEqual(coverfh.read(), jpg_bytes, ext)
+
+    def test_query_in_folder(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            subdir = os.path.join(tmpdir, 'sub')
+            os.mkdir(subdir)
+            for path, title in ((os.path.join(tmpdir, 'a.mp3'), 'A'),
+                                (os.path.join(subdir, 'b.mp3'), 'B')):
+                create_test_file(path)
+                call_kid3_cli(['-c', 'set title "%s" 2' % title, path])
+            # The current folder and selection are kept after the query.
+            self.assertEqual(call_kid3_cli(
+                ['-c', 'query file,title in "%s" 2' % subdir,
+                 '-c', 'pwd',
+                 '-c', 'get title 2', os.path.join(tmpdir, 'a.mp3')]),
+                'file\ttitle\n'
+                'b.mp3\tB\n' +
+                tmpdir + '\n'
+                'A\n')
+
+    def test_directory_format_codes(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            for name, artist in (('a.mp3', 'Artist A'), ('b.mp3', 'Artist A'),
+                                 ('c.mp3', 'Artist B')):
+                mp3path = os.path.join(tmpdir, name)
+                create_test_file(mp3path)
+                call_kid3_cli(['-c', 'set artist "%s" 2' % artist,
+                               '-c', 'set album "An Album" 2', mp3path])
+            # The tags of the other files in the folder are read to get the
+            # values, and they are updated when tags are edited.
+            lines = call_kid3_cli(
+                ['-c', 'select first',
+                 '-c', 'fromtag "%{dirartists} artists %{diralbums} albums" 2',
+                 '-c', 'get',
+                 '-c', 'set artist "Artist C" 2',
+                 '-c', 'fromtag "%{dirartists} artists %{diralbums} albums" 2',
+                 '-c', 'get', tmpdir]).splitlines()
+            self.assertIn('* Name: 2 artists 1 albums.mp3', lines)
+            self.assertIn('* Name: 3 artists 1 albums.mp3', lines)
+
     def test_filename_tag_format(self):
         with tempfile.TemporaryDirectory() as tmpdir:
             albumdir = os.path.join(tmpdir, 'An Artist - 2016 - An Album')
@@ -958,6 +1136,115 @@ class CliFunctionsJsonTestCase(unittest.TestCase):
                 '{"result":{"files":[{"changed":true,"fileName":"test.mp3",'
                   '"selected":true,"tags":[2]}]}}\n')
 
+    def test_json_batch(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            mp3path = os.path.join(tmpdir, 'test.mp3')
+            create_test_file(mp3path)
+            self.assertEqual(call_kid3_cli(
+                ['-c', '[{"method":"set","params":["title","A Title"]},'
+                       '{"jsonrpc":"2.0","method":"set",'
+                       '"params":["artist","An Artist"]},'
+                       '{"jsonrpc":"2.0","id":"2","method":"get",'
+                       '"params":["title"]},'
+                       '{"method":"unknown"},'
+                       '{"method":"get","params":["artist"],'
+                       '"files":["test.mp3"]}]',
+                 '-c', '[{"jsonrpc":"2.0","method":"select",'
+                       '"params":["none"]}]',
+                 '-c', '{"method":"get","params":["title"]}',
+                 mp3path]),
+                '[{"result":null}'
+                ',{"id":"2","jsonrpc":"2.0","result":"A Title"}'
+                ',{"error":{"code":-32601,'
+                  '"message":"Unknown command \'unknown\'"}}'
+                ',{"result":"An Artist"}'
+                ']\n'
+                '{"result":null}\n')
+
+    def test_json_batch_restores_selection(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            create_test_file(os.path.join(tmpdir, 'a.mp3'))
+            create_test_file(os.path.join(tmpdir, 'b.mp3'))
+            self.assertEqual(call_kid3_cli(
+                ['-c', '{"method":"select","params":["b.mp3"]}',
+                 '-c', '{"method":"set","params":["title","B"]}',
+                 '-c', '{"method":"select","params":["none"]}',
+                 '-c', '{"method":"select","params":["a.mp3"]}',
+                 '-c', '{"method":"set","params":["title","A"]}',
+                 '-c', '[{"method":"get","params":["title"],'
+                       '"files":["b.mp3"]},'
+                       '{"method":"get","params":["title"],'
+                       '"files":["missing.mp3"]}]',
+                 '-c', '{"method":"get","params":["title"]}',
+                 tmpdir]),
+                '{"result":null}\n'
+                '{"result":null}\n'
+                '{"result":null}\n'
+                '{"result":null}\n'
+                '{"result":null}\n'
+                '[{"result":"B"}'
+                ',{"error":{"code":-32602,'
+                  '"message":"missing.mp3 not found"}}'
+                ']\n'
+                '{"result":"A"}\n')
+
+    @unittest.skipIf(sys.platform == 'win32', 'requires Unix domain sockets')
+    def test_server(self):
+        with tempfile.TemporaryDirectory() as tmpdir, \
+                tempfile.TemporaryDirectory() as sockdir:
+            mp3path = os.path.join(tmpdir, 'test.mp3')
+            create_test_file(mp3path)
+            sockpath = os.path.join(sockdir, 'kid3-cli.sock')
+            tracepath = os.path.join(sockdir, 'trace.json')
+            # The leading options are accepted in any order.
+            server = subprocess.Popen(
+                [kid3_cli_path(), '--trace', tracepath, '--server', sockpath,
+                 tmpdir],
+                stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+            try:
+                for _ in range(100):
+                    if os.path.exists(sockpath):
+                        break
+                    time.sleep(0.1)
+
+                def request(lines):
+                    with socket.socket(socket.AF_UNIX,
+                                       socket.SOCK_STREAM) as sock:
+                        sock.connect(sockpath)
+                        fh = sock.makefile('rw', encoding='utf-8')
+                        responses = []
+                        for line in lines:
+                            fh.write(line + '\n')
+                            fh.flush()
+                            responses.append(json.loads(fh.readline()))
+                        return responses
+
+                self.assertEqual(request(
+                    ['{"method":"select","params":["test.mp3"]}',
+                     '{"method":"set","params":["title","A Title"]}',
+                     '{"jsonrpc":"2.0","id":"1","method":"get",'
+                     '"params":["title"]}']),
+                    [{'result': None},
+                     {'result': None},
+                     {'id': '1', 'jsonrpc': '2.0', 'result': 'A Title'}])
+                # The state is kept for the next client.
+                self.assertEqual(request(
+                    ['{"method":"get","params":["title"]}',
+                     '{"method":"save"}']),
+                    [{'result': 'A Title'},
+                     {'result': None}])
+                with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+                    sock.connect(sockpath)
+                    sock.sendall(b'{"method":"exit"}\n')
+                    server.wait(10)
+            finally:
+                if server.poll() is None:
+                    server.kill()
+            self.assertEqual(server.returncode, 0)
+            self.assertTrue(os.path.exists(tracepath))
+            self.assertEqual(call_kid3_cli(['-c', 'get title', mp3path]),
+                             'A Title\n')
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,217 @@
+/**
+ * \file testcoverartfetcher.cpp
+ * Test concurrent download and caching of cover art.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testcoverartfetcher.h"
+#include <QTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QNetworkAccessManager>
+#include "dummysettings.h"
+#include "configstore.h"
+#include "httprequestscheduler.h"
+#include "coverartfetcher.h"
+
+namespace {
+
+/**
+ * HTTP/1.1 server which answers requests for "/cover..." with a JPEG image
+ * and all other requests with a picture which is too small to be valid.
+ */
+class ImageStubServer : public QTcpServer {
+public:
+  explicit ImageStubServer(QObject* parent = nullptr) : QTcpServer(parent) {
+    connect(this, &QTcpServer::newConnection, this, [this]() {
+      while (QTcpSocket* socket = nextPendingConnection()) {
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+          readRequests(socket);
+        });
+        connect(socket, &QTcpSocket::disconnected,
+                socket, &QObject::deleteLater);
+      }
+    });
+  }
+
+  QUrl url(const QString& path) const {
+    return QUrl(QString(QLatin1String("http://127.0.0.1:%1%2"))
+                .arg(serverPort()).arg(path));
+  }
+
+  static QByteArray imageData(const QByteArray& path) {
+    return path.startsWith("/cover") ? path.repeated(2048 / path.size() + 1)
+                                     : QByteArray("GIF89a");
+  }
+
+  QStringList paths() const { return m_paths; }
+
+private:
+  void readRequests(QTcpSocket* socket) {
+    QByteArray& buffer = m_buffers[socket];
+    buffer += socket->readAll();
+    int headerEnd;
+    while ((headerEnd = buffer.indexOf("\r\n\r\n")) >= 0) {
+      const QByteArray requestLine = buffer.left(buffer.indexOf("\r\n"));
+      buffer.remove(0, headerEnd + 4);
+      const QByteArray path = requestLine.split(' ').value(1);
+      m_paths.append(QString::fromLatin1(path));
+      const QByteArray body = imageData(path);
+      socket->write("HTTP/1.1 200 OK\r\n"
+                    "Content-Type: " +
+                    QByteArray(path.startsWith("/cover") ? "image/jpeg"
+                                                         : "image/gif") +
+                    "\r\nContent-Length: " + QByteArray::number(body.size()) +
+                    "\r\nConnection: keep-alive\r\n\r\n" + body);
+    }
+  }
+
+  QHash<QTcpSocket*, QByteArray> m_buffers;
+  QStringList m_paths;
+};
+
+}
+
+TestCoverArtFetcher::TestCoverArtFetcher(QObject* parent)
+  : QObject(parent), m_settings(nullptr), m_configStore(nullptr)
+{
+  if (!ConfigStore::instance()) {
+    m_settings = new DummySettings;
+    m_configStore = new ConfigStore(m_settings);
+  }
+}
+
+TestCoverArtFetcher::~TestCoverArtFetcher()
+{
+  delete m_configStore;
+  delete m_settings;
+}
+
+void TestCoverArtFetcher::testDeduplication()
+{
+  QTemporaryDir cacheDir;
+  QVERIFY(cacheDir.isValid());
+  QNetworkAccessManager netMgr;
+  ImageStubServer server;
+  QVERIFY(server.listen(QHostAddress::LocalHost));
+  HttpRequestScheduler::instance(&netMgr)->setMinimumRequestInterval(
+        QLatin1String("127.0.0.1"), 0);
+  CoverArtFetcher fetcher(&netMgr);
+  QVERIFY(fetcher.cacheDirectory().endsWith(
+            QLatin1String("/coverart/downloads")));
+  fetcher.setCacheDirectory(cacheDir.path());
+  QList<QUrl> fetchedUrls;
+  connect(&fetcher, &CoverArtFetcher::imageFetched,
+          this, [&fetchedUrls](const QUrl& url, const QByteArray& data,
+                               const QString& mimeType) {
+    QCOMPARE(data, ImageStubServer::imageData(url.path().toLatin1()));
+    QCOMPARE(CoverArtFetcher::isValidImage(data, mimeType),
+             url.path().startsWith(QLatin1String("/cover")));
+    fetchedUrls.append(url);
+  });
+
+  const QUrl cover1 = server.url(QLatin1String("/cover1.jpg"));
+  const QUrl cover2 = server.url(QLatin1String("/cover2.jpg"));
+  const QUrl invalid = server.url(QLatin1String("/invalid.gif"));
+  fetcher.fetch(cover1);
+  fetcher.fetch(cover2);
+  fetcher.fetch(cover1);
+  fetcher.fetch(invalid);
+  QCOMPARE(fetcher.pendingCount(), 3);
+  QTRY_COMPARE_WITH_TIMEOUT(fetchedUrls.size(), 3, 5000);
+  QCOMPARE(fetcher.pendingCount(), 0);
+  QCOMPARE(server.paths().size(), 3);
+
+  // Already fetched images are delivered from memory.
+  fetcher.fetch(cover2);
+  QCOMPARE(fetchedUrls.size(), 3);
+  QTRY_COMPARE_WITH_TIMEOUT(fetchedUrls.size(), 4, 5000);
+  QCOMPARE(fetchedUrls.last(), cover2);
+  QCOMPARE(server.paths().size(), 3);
+}
+
+void TestCoverArtFetcher::testDiskCache()
+{
+  QTemporaryDir cacheDir;
+  QVERIFY(cacheDir.isValid());
+  QNetworkAccessManager netMgr;
+  ImageStubServer server;
+  QVERIFY(server.listen(QHostAddress::LocalHost));
+  HttpRequestScheduler::instance(&netMgr)->setMinimumRequestInterval(
+        QLatin1String("127.0.0.1"), 0);
+  const QUrl cover = server.url(QLatin1String("/cover.jpg"));
+  const QUrl invalid = server.url(QLatin1String("/invalid.gif"));
+
+  int numFetched = 0;
+  {
+    CoverArtFetcher fetcher(&netMgr);
+    fetcher.setCacheDirectory(cacheDir.path());
+    connect(&fetcher, &CoverArtFetcher::imageFetched, this, [&numFetched]() {
+      ++numFetched;
+    });
+    fetcher.fetch(cover);
+    fetcher.fetch(invalid);
+    QTRY_COMPARE_WITH_TIMEOUT(numFetched, 2, 5000);
+  }
+  QCOMPARE(server.paths().size(), 2);
+
+  // A new fetcher finds the valid image in the disk cache, the invalid image
+  // is not cached.
+  CoverArtFetcher fetcher(&netMgr);
+  fetcher.setCacheDirectory(cacheDir.path());
+  QByteArray cachedData;
+  QString cachedMimeType;
+  numFetched = 0;
+  connect(&fetcher, &CoverArtFetcher::imageFetched,
+          this, [&](const QUrl& url, const QByteArray& data,
+                    const QString& mimeType) {
+    if (url == cover) {
+      cachedData = data;
+      cachedMimeType = mimeType;
+    }
+    ++numFetched;
+  });
+  fetcher.fetch(cover);
+  fetcher.fetch(invalid);
+  QTRY_COMPARE_WITH_TIMEOUT(numFetched, 2, 5000);
+  QCOMPARE(cachedData, ImageStubServer::imageData("/cover.jpg"));
+  QCOMPARE(cachedMimeType, QString(QLatin1String("image/jpeg")));
+  QCOMPARE(server.paths(),
+           QStringList({QLatin1String("/cover.jpg"),
+                        QLatin1String("/invalid.gif"),
+                        QLatin1String("/invalid.gif")}));
+
+  // Invalid images are not kept, but they are not fetched again.
+  QByteArray invalidData("not fetched");
+  disconnect(&fetcher, &CoverArtFetcher::imageFetched, this, nullptr);
+  connect(&fetcher, &CoverArtFetcher::imageFetched,
+          this, [&](const QUrl& url, const QByteArray& data) {
+    if (url == invalid) {
+      invalidData = data;
+    }
+  });
+  fetcher.fetch(invalid);
+  QTRY_VERIFY_WITH_TIMEOUT(invalidData.isEmpty(), 5000);
+  QCOMPARE(server.paths().size(), 3);
+}
@@ -0,0 +1,145 @@
+/**
+ * \file testdiscogsimportparser.cpp
+ * Test parsing of import data from Discogs server.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testdiscogsimportparser.h"
+#include <QTest>
+#include "serverimporter.h"
+#include "trackdatamodel.h"
+
+namespace {
+
+/** Search results page for "Wizard" "Odin" */
+const char searchStr[] =
+  "<div class=\"card_body\"><h4><span>"
+  "<a href=\"/artist/256076-Wizard-2\">Wizard (2)</a>         </span> -\n"
+  "<a class=\"search_result_title \" "
+  "href=\"/Wizard-Odin/release/2487778-Wizard-Odin\" "
+  "data-followable=\"true\">Odin</a></h4>\n"
+  "<span class=\"card_release_year\">2003</span>\n"
+  "<span class=\"card_release_format\">CD, Album</span>\n"
+  "<div class=\"card_actions\"></div></div>\n"
+  "<div class=\"card_body\"><h4><span>"
+  "<a href=\"/artist/194-Various\">Various*</a>  </span> -\n"
+  "<a class=\"search_result_title \" "
+  "href=\"/Various-Odin-Tribute/release/1234567-Various-Odin-Tribute\" "
+  "data-followable=\"true\">Odin Tribute</a></h4>\n"
+  "<span class=\"card_release_year\">2010</span>\n"
+  "<span class=\"card_release_format\">CD, Comp</span>\n"
+  "<div class=\"card_actions\"></div></div>\n";
+
+/** Release page of "Odin" by "Wizard" without embedded JSON data */
+const char albumStr[] =
+  "<html><head>\n<title>Wizard (2) - Odin (CD, Album) at Discogs</title>\n"
+  "</head><body>\n"
+  "<div class=\"head\">Genre:</div><div class=\"content\">\n"
+  "      Rock\n</div>\n"
+  "<div class=\"head\">Style:</div><div class=\"content\">\n"
+  "    Heavy Metal,\n    Power Metal\n</div>\n"
+  "<div class=\"head\">Released:</div><div class=\"content\">"
+  "19 Aug 2003</div>\n"
+  "<table class=\"tracklist\" id=\"release-tracklist\"><tbody>\n"
+  "<tr data-track-position=\"1\"><td class=\"trackPos_n\">1</td>\n"
+  "  <td class=\"trackTitle_n\"><span class=\"trackTitle_t\">"
+  "The Prophecy</span></td>\n"
+  "  <td class=\"duration_n\"><span>5:19</span></td>\n</tr>\n"
+  "<tr data-track-position=\"2\"><td class=\"trackPos_n\">2</td>\n"
+  "  <td class=\"trackTitle_n\"><span class=\"trackTitle_t\">"
+  "Betrayer</span></td>\n"
+  "  <td class=\"duration_n\"><span>4:53</span></td>\n</tr>\n"
+  "<tr data-track-position=\"3\"><td class=\"trackPos_n\">3</td>\n"
+  "  <td class=\"trackTitle_n\"><span class=\"trackTitle_t\">"
+  "Dead Hope</span></td>\n"
+  "  <td class=\"duration_n\"><span>6:02</span></td>\n</tr>\n"
+  "</tbody></table>\n</body></html>\n";
+
+}
+
+void TestDiscogsImportParser::initTestCase()
+{
+  setServerImporter(QLatin1String("DiscogsImport"));
+}
+
+void TestDiscogsImportParser::testParseAlbums()
+{
+  onFindFinished(searchStr);
+  AlbumListModel* albumModel = m_importer->getAlbumListModel();
+  QCOMPARE(albumModel->rowCount(), 2);
+  QString text, category, id;
+  albumModel->getItem(0, text, category, id);
+  QCOMPARE(text, QString(QLatin1String("Wizard - Odin (2003) [CD, Album]")));
+  QCOMPARE(category, QString(QLatin1String("Wizard-Odin/release")));
+  QCOMPARE(id, QString(QLatin1String("2487778-Wizard-Odin")));
+  albumModel->getItem(1, text, category, id);
+  QCOMPARE(text,
+           QString(QLatin1String("Various - Odin Tribute (2010) [CD, Comp]")));
+}
+
+void TestDiscogsImportParser::testParseTracks()
+{
+  onAlbumFinished(albumStr);
+
+  QStringList titles;
+  titles << QLatin1String("The Prophecy") << QLatin1String("Betrayer")
+         << QLatin1String("Dead Hope");
+  QStringList lengths;
+  lengths << QLatin1String("5:19") << QLatin1String("4:53")
+          << QLatin1String("6:02");
+  QCOMPARE(m_trackDataModel->rowCount(), 3);
+  for (int row = 0; row < 3; ++row) {
+    QCOMPARE(m_trackDataModel->index(row, 0).data().toString(), lengths.at(row));
+    QCOMPARE(m_trackDataModel->index(row, 3).data().toInt(), row + 1);
+    QCOMPARE(m_trackDataModel->index(row, 4).data().toString(), titles.at(row));
+    QCOMPARE(m_trackDataModel->index(row, 5).data().toString(),
+             QString(QLatin1String("Wizard")));
+    QCOMPARE(m_trackDataModel->index(row, 6).data().toString(),
+             QString(QLatin1String("Odin")));
+    QCOMPARE(m_trackDataModel->index(row, 7).data().toInt(), 2003);
+    QVERIFY(m_trackDataModel->index(row, 8).data().toString()
+            .startsWith(QLatin1String("Heavy Metal")));
+  }
+}
+
+void TestDiscogsImportParser::benchmarkParseAlbums()
+{
+  // Repeat the results to get the size of a typical search results page.
+  QByteArray searchBytes;
+  for (int i = 0; i < 25; ++i) {
+    searchBytes += searchStr;
+  }
+  QBENCHMARK {
+    onFindFinished(searchBytes);
+  }
+  QCOMPARE(m_importer->getAlbumListModel()->rowCount(), 50);
+}
+
+void TestDiscogsImportParser::benchmarkParseTracks()
+{
+  const QByteArray albumBytes(albumStr);
+  QBENCHMARK {
+    onAlbumFinished(albumBytes);
+  }
+  QCOMPARE(m_trackDataModel->rowCount(), 3);
+}
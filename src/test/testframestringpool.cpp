@@ -0,0 +1,173 @@
+/**
+ * \file testframestringpool.cpp
+ * Test interning of frame strings.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testframestringpool.h"
+#include <QTest>
+#include <QVector>
+#include "frame.h"
+#include "framestringpool.h"
+
+namespace {
+
+/** Number of albums in synthetic library */
+const int NUM_ALBUMS = 500;
+/** Number of tracks per album */
+const int NUM_TRACKS = 12;
+
+/**
+ * Create a string with its own data like a string read from a file.
+ * @param str string
+ * @return deep copy of @a str.
+ */
+QString readFromFile(const QString& str)
+{
+  return QString::fromUtf8(str.toUtf8());
+}
+
+/**
+ * Create the frames of a synthetic library with repeated album metadata.
+ * @return frame collections of all tracks.
+ */
+QVector<FrameCollection> createLibrary()
+{
+  QVector<FrameCollection> library;
+  library.reserve(NUM_ALBUMS * NUM_TRACKS);
+  for (int albumNr = 0; albumNr < NUM_ALBUMS; ++albumNr) {
+    const QString artist = QString(QLatin1String("Artist %1")).arg(albumNr / 4);
+    const QString album = QString(QLatin1String("Album %1")).arg(albumNr);
+    const QString genre = QString(QLatin1String("Genre %1")).arg(albumNr % 20);
+    const QString year = QString::number(1970 + albumNr % 50);
+    for (int trackNr = 1; trackNr <= NUM_TRACKS; ++trackNr) {
+      FrameCollection frames;
+      frames.insert(Frame(Frame::FT_Artist, readFromFile(artist),
+                          readFromFile(QLatin1String("ARTIST")), -1));
+      frames.insert(Frame(Frame::FT_AlbumArtist, readFromFile(artist),
+                          readFromFile(QLatin1String("ALBUMARTIST")), -1));
+      frames.insert(Frame(Frame::FT_Album, readFromFile(album),
+                          readFromFile(QLatin1String("ALBUM")), -1));
+      frames.insert(Frame(Frame::FT_Genre, readFromFile(genre),
+                          readFromFile(QLatin1String("GENRE")), -1));
+      frames.insert(Frame(Frame::FT_Date, readFromFile(year),
+                          readFromFile(QLatin1String("DATE")), -1));
+      frames.insert(Frame(Frame::FT_EncodedBy,
+                          readFromFile(QLatin1String("LAME 3.100")),
+                          readFromFile(QLatin1String("ENCODEDBY")), -1));
+      frames.insert(Frame(Frame::FT_Title,
+                          QString(QLatin1String("Title %1 of %2"))
+                          .arg(trackNr).arg(album),
+                          readFromFile(QLatin1String("TITLE")), -1));
+      frames.insert(Frame(Frame::FT_Track, QString::number(trackNr),
+                          readFromFile(QLatin1String("TRACKNUMBER")), -1));
+      library.append(frames);
+    }
+  }
+  return library;
+}
+
+/**
+ * Estimate the heap memory used by the string data of frames.
+ * Data shared by several strings is only counted once.
+ * @param library frame collections
+ * @return number of bytes.
+ */
+qint64 stringMemory(const QVector<FrameCollection>& library)
+{
+  // Size of the header of an allocated QString data block
+  const qint64 headerSize = 2 * sizeof(void*) + 8;
+  QSet<const void*> seen;
+  qint64 bytes = 0;
+  auto addString = [&seen, &bytes, headerSize](const QString& str) {
+    if (!str.isEmpty() && !seen.contains(str.constData())) {
+      seen.insert(str.constData());
+      bytes += headerSize + (str.capacity() + 1) * 2;
+    }
+  };
+  for (const FrameCollection& frames : library) {
+    for (auto it = frames.cbegin(); it != frames.cend(); ++it) {
+      addString(it->getInternalName());
+      addString(it->getValue());
+    }
+  }
+  return bytes;
+}
+
+}
+
+void TestFrameStringPool::testIntern()
+{
+  const QString name = readFromFile(QLatin1String("MUSICBRAINZ_ALBUMID"));
+  const QString interned = FrameStringPool::intern(name);
+  QCOMPARE(interned, name);
+  QCOMPARE(FrameStringPool::intern(readFromFile(name)).constData(),
+           interned.constData());
+
+  // Values are only interned for types which are repeated in many files.
+  const QString album = readFromFile(QLatin1String("Common Album"));
+  QCOMPARE(FrameStringPool::internValue(Frame::FT_Album, album).constData(),
+           FrameStringPool::internValue(Frame::FT_Album,
+                                        readFromFile(album)).constData());
+  const QString title = readFromFile(QLatin1String("Unique Title"));
+  QCOMPARE(FrameStringPool::internValue(Frame::FT_Title, title).constData(),
+           title.constData());
+
+  Frame frame1(Frame::FT_Genre, readFromFile(QLatin1String("Viking Metal")),
+               readFromFile(QLatin1String("GENRE")), -1);
+  Frame frame2(Frame::FT_Genre, QString(), QLatin1String("GENRE"), -1);
+  frame2.setValue(readFromFile(QLatin1String("Viking Metal")));
+  QCOMPARE(frame2.getValue(), frame1.getValue());
+  QCOMPARE(frame2.getValue().constData(), frame1.getValue().constData());
+  QCOMPARE(frame2.getInternalName().constData(),
+           frame1.getInternalName().constData());
+}
+
+void TestFrameStringPool::testPurge()
+{
+  FrameStringPool::purge();
+  const int sizeBefore = FrameStringPool::size();
+  {
+    const QVector<FrameCollection> library = createLibrary();
+    QVERIFY(FrameStringPool::size() > sizeBefore);
+    FrameStringPool::purge();
+    QVERIFY(FrameStringPool::size() > sizeBefore);
+  }
+  // The strings which are only referenced by the pool are removed.
+  FrameStringPool::purge();
+  QVERIFY(FrameStringPool::size() <= sizeBefore);
+}
+
+void TestFrameStringPool::testMemorySavings()
+{
+  FrameStringPool::setEnabled(false);
+  const qint64 bytesWithoutPool = stringMemory(createLibrary());
+  FrameStringPool::setEnabled(true);
+  const qint64 bytesWithPool = stringMemory(createLibrary());
+  qInfo("String data of %d tracks: %lld bytes without pool, "
+        "%lld bytes with pool (%lld%%)",
+        NUM_ALBUMS * NUM_TRACKS, bytesWithoutPool, bytesWithPool,
+        bytesWithPool * 100 / bytesWithoutPool);
+  // All strings except for the titles and track numbers are shared.
+  QVERIFY(bytesWithPool * 3 < bytesWithoutPool);
+}
@@ -0,0 +1,132 @@
+/**
+ * \file testgenres.cpp
+ * Test conversion of genres and the genre model.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testgenres.h"
+#include <QTest>
+#include <QSignalSpy>
+#include "dummysettings.h"
+#include "configstore.h"
+#include "tagconfig.h"
+#include "genres.h"
+#include "genremodel.h"
+
+TestGenres::TestGenres(QObject* parent)
+  : QObject(parent), m_settings(nullptr), m_configStore(nullptr)
+{
+  if (!ConfigStore::instance()) {
+    m_settings = new DummySettings;
+    m_configStore = new ConfigStore(m_settings);
+  }
+}
+
+TestGenres::~TestGenres()
+{
+  delete m_configStore;
+  delete m_settings;
+}
+
+void TestGenres::testGetNumber()
+{
+  QCOMPARE(Genres::getNumber(QLatin1String("Metal")), 9);
+  QCOMPARE(Genres::getNumber(QLatin1String("black metal")), 138);
+  QCOMPARE(Genres::getNumber(QLatin1String("A CAPPELLA")), 123);
+  QCOMPARE(Genres::getNumber(QLatin1String("Viking Metal")), 255);
+  QCOMPARE(Genres::getNumber(QString()), 255);
+  for (int i = 1; i < Genres::count + 1; ++i) {
+    const QString name = QString::fromLatin1(Genres::s_strList[i]);
+    const int num = Genres::getNumber(name);
+    QCOMPARE(QString::fromLatin1(Genres::getName(num)), name);
+    QCOMPARE(Genres::getIndex(num), i);
+  }
+}
+
+void TestGenres::testGetNameString()
+{
+  const QString viking(QLatin1String("(9)(138)Viking Metal"));
+  const QString names(QLatin1String("Metal|Black Metal|Viking Metal"));
+  QCOMPARE(Genres::getNameString(viking), names);
+  // The second call gets the result from the cache.
+  QCOMPARE(Genres::getNameString(viking), names);
+  QCOMPARE(Genres::getNameString(QLatin1String("9")),
+           QString(QLatin1String("Metal")));
+  QCOMPARE(Genres::getNameString(QLatin1String("(9)Metal")),
+           QString(QLatin1String("Metal")));
+  QCOMPARE(Genres::getNameString(QLatin1String("(RX)(CR)")),
+           QString(QLatin1String("RX|CR")));
+  QCOMPARE(Genres::getNameString(QString()), QString());
+}
+
+void TestGenres::testGetNumberString()
+{
+  const QString names(QLatin1String("Metal|black metal|Viking Metal"));
+  QCOMPARE(Genres::getNumberString(names, true),
+           QString(QLatin1String("(9)(138)Viking Metal")));
+  QCOMPARE(Genres::getNumberString(names, false),
+           QString(QLatin1String("9|138|Viking Metal")));
+}
+
+void TestGenres::testGenreModelUpdate()
+{
+  TagConfig& tagCfg = TagConfig::instance();
+  tagCfg.setOnlyCustomGenres(false);
+  tagCfg.setCustomGenres({});
+  GenreModel model(false);
+  const int numStandardRows = model.rowCount();
+
+  QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+  QSignalSpy insertSpy(&model, &QAbstractItemModel::rowsInserted);
+  QSignalSpy removeSpy(&model, &QAbstractItemModel::rowsRemoved);
+  tagCfg.setCustomGenres({QLatin1String("Viking Metal"),
+                          QLatin1String("Nordic Folk")});
+  QCOMPARE(model.rowCount(), numStandardRows + 2);
+  QCOMPARE(model.index(numStandardRows + 1, 0).data().toString(),
+           QString(QLatin1String("Nordic Folk")));
+  QCOMPARE(insertSpy.count(), 1);
+  QCOMPARE(insertSpy.first().at(1).toInt(), numStandardRows);
+
+  tagCfg.setCustomGenres({QLatin1String("Viking Metal")});
+  QCOMPARE(model.rowCount(), numStandardRows + 1);
+  QCOMPARE(removeSpy.count(), 1);
+  QCOMPARE(removeSpy.first().at(1).toInt(), numStandardRows + 1);
+  QCOMPARE(model.getRowForGenre(QLatin1String("Viking Metal")),
+           numStandardRows);
+  QCOMPARE(model.getRowForGenre(QLatin1String("metal")),
+           Genres::getIndex(9));
+  // The standard genres are never reset.
+  QCOMPARE(resetSpy.count(), 0);
+
+  tagCfg.setCustomGenres({});
+}
+
+void TestGenres::benchmarkGetNameString()
+{
+  const QString viking(QLatin1String("(9)(138)Viking Metal"));
+  QString names;
+  QBENCHMARK {
+    names = Genres::getNameString(viking);
+  }
+  QCOMPARE(names, QString(QLatin1String("Metal|Black Metal|Viking Metal")));
+}
@@ -0,0 +1,198 @@
+/**
+ * \file testhttprequestscheduler.cpp
+ * Test scheduling of HTTP requests.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testhttprequestscheduler.h"
+#include <QTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QElapsedTimer>
+#include <QNetworkAccessManager>
+#include "dummysettings.h"
+#include "configstore.h"
+#include "httpclient.h"
+#include "httprequestscheduler.h"
+
+namespace {
+
+/** Minimum interval between requests used in the tests */
+const int INTERVAL_MS = 200;
+/** Tolerance for measured intervals */
+const int TOLERANCE_MS = 20;
+
+/**
+ * HTTP/1.1 server which answers all GET requests with their path and keeps
+ * the connections alive.
+ */
+class HttpStubServer : public QTcpServer {
+public:
+  explicit HttpStubServer(QObject* parent = nullptr)
+    : QTcpServer(parent), m_connectionCount(0) {
+    connect(this, &QTcpServer::newConnection, this, [this]() {
+      while (QTcpSocket* socket = nextPendingConnection()) {
+        ++m_connectionCount;
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+          readRequests(socket);
+        });
+        connect(socket, &QTcpSocket::disconnected,
+                socket, &QObject::deleteLater);
+      }
+    });
+    m_timer.start();
+  }
+
+  QUrl url(const QString& path) const {
+    return QUrl(QString(QLatin1String("http://127.0.0.1:%1%2"))
+                .arg(serverPort()).arg(path));
+  }
+
+  QStringList paths() const { return m_paths; }
+  QList<qint64> requestTimes() const { return m_requestTimes; }
+  int connectionCount() const { return m_connectionCount; }
+
+private:
+  void readRequests(QTcpSocket* socket) {
+    QByteArray& buffer = m_buffers[socket];
+    buffer += socket->readAll();
+    int headerEnd;
+    while ((headerEnd = buffer.indexOf("\r\n\r\n")) >= 0) {
+      const QByteArray requestLine = buffer.left(buffer.indexOf("\r\n"));
+      buffer.remove(0, headerEnd + 4);
+      const QByteArray path = requestLine.split(' ').value(1);
+      m_paths.append(QString::fromLatin1(path));
+      m_requestTimes.append(m_timer.elapsed());
+      const QByteArray body = "response " + path;
+      socket->write("HTTP/1.1 200 OK\r\n"
+                    "Content-Type: text/plain\r\n"
+                    "Content-Length: " + QByteArray::number(body.size()) +
+                    "\r\nConnection: keep-alive\r\n\r\n" + body);
+    }
+  }
+
+  QElapsedTimer m_timer;
+  QHash<QTcpSocket*, QByteArray> m_buffers;
+  QStringList m_paths;
+  QList<qint64> m_requestTimes;
+  int m_connectionCount;
+};
+
+}
+
+TestHttpRequestScheduler::TestHttpRequestScheduler(QObject* parent)
+  : QObject(parent), m_settings(nullptr), m_configStore(nullptr)
+{
+  if (!ConfigStore::instance()) {
+    m_settings = new DummySettings;
+    m_configStore = new ConfigStore(m_settings);
+  }
+}
+
+TestHttpRequestScheduler::~TestHttpRequestScheduler()
+{
+  delete m_configStore;
+  delete m_settings;
+}
+
+void TestHttpRequestScheduler::testPriorityAndInterval()
+{
+  QStringList received;
+  QNetworkAccessManager netMgr;
+  HttpStubServer server;
+  QVERIFY(server.listen(QHostAddress::LocalHost));
+  const QString host(QLatin1String("127.0.0.1"));
+  HttpRequestScheduler* scheduler = HttpRequestScheduler::instance(&netMgr);
+  QCOMPARE(HttpRequestScheduler::instance(&netMgr), scheduler);
+  scheduler->setMinimumRequestInterval(host, INTERVAL_MS);
+
+  auto first = new HttpClient(&netMgr);
+  auto image = new HttpClient(&netMgr);
+  image->setPriority(HttpRequestScheduler::ImagePriority);
+  auto second = new HttpClient(&netMgr);
+  for (HttpClient* client : {first, image, second}) {
+    connect(client, &HttpClient::bytesReceived,
+            client, [&received](const QByteArray& data) {
+      received.append(QString::fromLatin1(data));
+    });
+  }
+
+  first->sendRequest(server.url(QLatin1String("/first")));
+  image->sendRequest(server.url(QLatin1String("/image")));
+  second->sendRequest(server.url(QLatin1String("/second")));
+  QCOMPARE(scheduler->pendingRequestCount(host), 2);
+
+  QTRY_COMPARE_WITH_TIMEOUT(received.size(), 3, 5000);
+  // The metadata request of the second client is started before the image
+  // request, although it was queued later.
+  QCOMPARE(server.paths(),
+           QStringList({QLatin1String("/first"), QLatin1String("/second"),
+                        QLatin1String("/image")}));
+  QCOMPARE(received,
+           QStringList({QLatin1String("response /first"),
+                        QLatin1String("response /second"),
+                        QLatin1String("response /image")}));
+  // The interval is enforced for all clients together.
+  const QList<qint64> times = server.requestTimes();
+  for (int i = 1; i < times.size(); ++i) {
+    QVERIFY(times.at(i) - times.at(i - 1) >= INTERVAL_MS - TOLERANCE_MS);
+  }
+  // The connection is kept alive and reused.
+  QVERIFY(server.connectionCount() < times.size());
+}
+
+void TestHttpRequestScheduler::testCancel()
+{
+  QStringList received;
+  QNetworkAccessManager netMgr;
+  HttpStubServer server;
+  QVERIFY(server.listen(QHostAddress::LocalHost));
+  const QString host(QLatin1String("127.0.0.1"));
+  HttpRequestScheduler* scheduler = HttpRequestScheduler::instance(&netMgr);
+  scheduler->setMinimumRequestInterval(host, INTERVAL_MS);
+
+  auto first = new HttpClient(&netMgr);
+  auto aborted = new HttpClient(&netMgr);
+  auto deleted = new HttpClient(&netMgr);
+  auto last = new HttpClient(&netMgr);
+  for (HttpClient* client : {first, aborted, deleted, last}) {
+    connect(client, &HttpClient::bytesReceived,
+            client, [&received](const QByteArray& data) {
+      received.append(QString::fromLatin1(data));
+    });
+  }
+
+  first->sendRequest(server.url(QLatin1String("/first")));
+  aborted->sendRequest(server.url(QLatin1String("/aborted")));
+  deleted->sendRequest(server.url(QLatin1String("/deleted")));
+  last->sendRequest(server.url(QLatin1String("/last")));
+  QCOMPARE(scheduler->pendingRequestCount(host), 3);
+  aborted->abort();
+  delete deleted;
+  QCOMPARE(scheduler->pendingRequestCount(host), 1);
+
+  QTRY_COMPARE_WITH_TIMEOUT(received.size(), 2, 5000);
+  QTest::qWait(2 * INTERVAL_MS);
+  QCOMPARE(server.paths(),
+           QStringList({QLatin1String("/first"), QLatin1String("/last")}));
+}
@@ -37,4 +37,6 @@ private slots:
   void initTestCase();
   void testParseAlbums();
   void testParseTracks();
+  void benchmarkParseAlbums();
+  void benchmarkParseTracks();
 };
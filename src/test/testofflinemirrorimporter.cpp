@@ -0,0 +1,192 @@
+/**
+ * \file testofflinemirrorimporter.cpp
+ * Test import from offline mirror.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 18 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testofflinemirrorimporter.h"
+#include <QTest>
+#include <QTemporaryDir>
+#include <QStandardPaths>
+#include <QDir>
+#include <QFile>
+#include "serverimporter.h"
+#include "serverimporterconfig.h"
+#include "trackdatamodel.h"
+
+namespace {
+
+void writeFile(const QString& filePath, const QByteArray& data)
+{
+  QFile file(filePath);
+  QVERIFY(file.open(QIODevice::WriteOnly));
+  file.write(data);
+}
+
+}
+
+void TestOfflineMirrorImporter::initTestCase()
+{
+  // Do not write the index into the user's cache folder.
+  QStandardPaths::setTestModeEnabled(true);
+  m_dumpDir = new QTemporaryDir;
+  QVERIFY(m_dumpDir->isValid());
+  const QString dirPath = m_dumpDir->path();
+  writeFile(dirPath + QLatin1String("/release"),
+    R"({"id":"3a7b8c2e-5d1f-4e6a-9b0c-1d2e3f405162","title":"Odin",)"
+    R"("date":"2003-03-24","barcode":"4001617388325",)"
+    R"("artist-credit":[{"name":"Wizard","joinphrase":""}],)"
+    R"("label-info":[{"catalog-number":"SPV 085-38832",)"
+    R"("label":{"name":"SPV"}}],)"
+    R"("media":[{"position":1,"discs":[],"tracks":[)"
+    R"({"position":1,"number":"1","title":"The Prophecy","length":95000,)"
+    R"("recording":{"isrcs":["DEB720300001"]}},)"
+    R"({"position":2,"number":"2","title":"Betrayer","length":241000,)"
+    R"("recording":{"isrcs":[]}}]}]})" "\n"
+    R"({"id":"0a1b2c3d-4e5f-4061-8293-a4b5c6d7e8f9","title":"Thor",)"
+    R"("date":"2009","artist-credit":[{"name":"Wizard","joinphrase":""}],)"
+    R"("media":[{"position":1,"tracks":[)"
+    R"({"position":1,"title":"Utgard","length":300000}]}]})" "\n");
+  QVERIFY(QDir(dirPath).mkdir(QLatin1String("rock")));
+  writeFile(dirPath + QLatin1String("/rock/920b810c"),
+    "# xmcd\n"
+    "#\n"
+    "# Track frame offsets:\n"
+    "#\t150\n"
+    "#\t2390\n"
+    "#\n"
+    "# Disc length: 100 seconds\n"
+    "#\n"
+    "DISCID=920b810c\n"
+    "DTITLE=Catharsis / Imago\n"
+    "DYEAR=2002\n"
+    "DGENRE=Metal\n"
+    "TTITLE0=Intro\n"
+    "TTITLE1=Into the\n"
+    "TTITLE1= Light\n");
+
+  setServerImporter(QLatin1String("OfflineMirrorImport"));
+  m_importer->config()->setServer(dirPath);
+}
+
+void TestOfflineMirrorImporter::cleanupTestCase()
+{
+  delete m_dumpDir;
+  m_dumpDir = nullptr;
+}
+
+void TestOfflineMirrorImporter::testQueryAlbums()
+{
+  queryAlbums(QLatin1String("wizard"), QLatin1String(""));
+
+  AlbumListModel* albumModel = m_importer->getAlbumListModel();
+  QCOMPARE(albumModel->rowCount(), 2);
+  QString text, category, id;
+  albumModel->getItem(0, text, category, id);
+  QCOMPARE(text, QString(QLatin1String("Wizard - Odin (2003)")));
+  QCOMPARE(category, QString(QLatin1String("release")));
+  QCOMPARE(id, QString(QLatin1String("3a7b8c2e-5d1f-4e6a-9b0c-1d2e3f405162")));
+
+  queryAlbums(QLatin1String("4001617388325"), QLatin1String(""));
+  QCOMPARE(albumModel->rowCount(), 1);
+  albumModel->getItem(0, text, category, id);
+  QCOMPARE(text, QString(QLatin1String("Wizard - Odin (2003)")));
+}
+
+void TestOfflineMirrorImporter::testQueryTracks()
+{
+  m_trackDataModel->setTrackData(ImportTrackDataVector());
+  queryTracks(QLatin1String("release"),
+              QLatin1String("3a7b8c2e-5d1f-4e6a-9b0c-1d2e3f405162"));
+
+  ImportTrackDataVector trackData = m_trackDataModel->getTrackData();
+  QCOMPARE(trackData.size(), 2);
+  QCOMPARE(trackData.at(0).getTitle(), QString(QLatin1String("The Prophecy")));
+  QCOMPARE(trackData.at(0).getArtist(), QString(QLatin1String("Wizard")));
+  QCOMPARE(trackData.at(0).getAlbum(), QString(QLatin1String("Odin")));
+  QCOMPARE(trackData.at(0).getYear(), 2003);
+  QCOMPARE(trackData.at(0).getTrack(), 1);
+  QCOMPARE(trackData.at(0).getImportDuration(), 95);
+  QCOMPARE(trackData.at(0).getValue(Frame::FT_Isrc),
+           QString(QLatin1String("DEB720300001")));
+  QCOMPARE(trackData.at(0).getValue(Frame::FT_Publisher),
+           QString(QLatin1String("SPV")));
+  QCOMPARE(trackData.at(1).getTitle(), QString(QLatin1String("Betrayer")));
+  QCOMPARE(trackData.at(1).getTrack(), 2);
+}
+
+void TestOfflineMirrorImporter::testQueryDiscId()
+{
+  queryAlbums(QLatin1String("920b810c"), QLatin1String(""));
+
+  AlbumListModel* albumModel = m_importer->getAlbumListModel();
+  QCOMPARE(albumModel->rowCount(), 1);
+  QString text, category, id;
+  albumModel->getItem(0, text, category, id);
+  QCOMPARE(text, QString(QLatin1String("Catharsis - Imago (2002)")));
+  QCOMPARE(category, QString(QLatin1String("rock")));
+  QCOMPARE(id, QString(QLatin1String("920b810c")));
+
+  m_trackDataModel->setTrackData(ImportTrackDataVector());
+  queryTracks(category, id);
+  ImportTrackDataVector trackData = m_trackDataModel->getTrackData();
+  QCOMPARE(trackData.size(), 2);
+  QCOMPARE(trackData.at(1).getTitle(), QString(QLatin1String("Into the Light")));
+  QCOMPARE(trackData.at(0).getImportDuration(), 29);
+  QCOMPARE(trackData.at(1).getImportDuration(), 68);
+  QCOMPARE(trackData.at(1).getGenre(), QString(QLatin1String("Metal")));
+}
+
+void TestOfflineMirrorImporter::testQueryKeys()
+{
+  AlbumListModel* albumModel = m_importer->getAlbumListModel();
+  QString text, category, id;
+  queryAlbums(QLatin1String("deb720300001"), QLatin1String(""));
+  QCOMPARE(albumModel->rowCount(), 1);
+  albumModel->getItem(0, text, category, id);
+  QCOMPARE(text, QString(QLatin1String("Wizard - Odin (2003)")));
+
+  queryAlbums(QLatin1String("0a1b2c3d-4e5f-4061-8293-a4b5c6d7e8f9"),
+              QLatin1String(""));
+  QCOMPARE(albumModel->rowCount(), 1);
+  albumModel->getItem(0, text, category, id);
+  QCOMPARE(text, QString(QLatin1String("Wizard - Thor (2009)")));
+}
+
+void TestOfflineMirrorImporter::testQueryWords()
+{
+  AlbumListModel* albumModel = m_importer->getAlbumListModel();
+  QString text, category, id;
+  queryAlbums(QLatin1String("wiz"), QLatin1String("TH"));
+  QCOMPARE(albumModel->rowCount(), 1);
+  albumModel->getItem(0, text, category, id);
+  QCOMPARE(text, QString(QLatin1String("Wizard - Thor (2009)")));
+
+  queryAlbums(QLatin1String(""), QString::fromUtf8("\xc3\x8dmago"));
+  QCOMPARE(albumModel->rowCount(), 1);
+  albumModel->getItem(0, text, category, id);
+  QCOMPARE(text, QString(QLatin1String("Catharsis - Imago (2002)")));
+
+  queryAlbums(QLatin1String("wizard"), QLatin1String("valhalla"));
+  QCOMPARE(albumModel->rowCount(), 0);
+}